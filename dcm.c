@@ -29,6 +29,8 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <time.h>
+#include <errno.h>
+#include <sys/epoll.h>
 
 #include "dcm_types.h"
 #include "dcm_utils.h"
@@ -40,6 +42,7 @@
 #include "uploadstblogs.h"
 
 static DCMDHandle *g_pdcmHandle = NULL;
+static INT32       g_sigWakeFd  = -1;
 
 /** @brief Call back function from Scheduler. This function
  *         Initiates the job
@@ -62,7 +65,9 @@ static VOID dcmRunJobs(const INT8* profileName, VOID *pHandle)
     }
 
     INT8 *pRDKPath = dcmSettingsGetRDKPath(pdcmHandle->pDcmSetHandle);
-    INT8 *pExecBuff = pdcmHandle->pExecBuff;
+    /* Jobs can run concurrently on the scheduler workers, so the command
+     * is built on the stack rather than in the shared handle buffer */
+    INT8 execBuff[EXECMD_BUFF_SIZE];
 
     if(pRDKPath == NULL) {
         DCMWarn("RDK Patch is NULL, using %s\n", DCM_LIB_PATH);
@@ -106,11 +111,10 @@ static VOID dcmRunJobs(const INT8* profileName, VOID *pHandle)
     }
     else if(strcmp(profileName, DCM_DIFD_SCHED) == 0) {
         DCMInfo("Start FW update Script\n");
-        snprintf(pExecBuff, EXECMD_BUFF_SIZE, "/bin/sh %s/swupdate_utility.sh 0 2 >> /opt/logs/swupdate.log 2>&1",
-                                               pRDKPath);
+        snprintf(execBuff, sizeof(execBuff), "/bin/sh %s/swupdate_utility.sh 0 2 >> /opt/logs/swupdate.log 2>&1",
+                                              pRDKPath);
+        dcmUtilsSysCmdExec(execBuff);
     }
-
-    dcmUtilsSysCmdExec(pExecBuff);
 }
 
 /** @brief Signal handler, un-intializes the module before exiting
@@ -127,6 +131,10 @@ static VOID sig_handler(INT32 sig)
     if ( sig == SIGINT  || sig == SIGTERM ||
          sig == SIGKILL || sig == SIGABRT) {
         DCMDebug("SIGINT received!\n");
+#ifndef GTEST_ENABLE
+        /* Let a log upload waiting to retry finish before the scheduler joins it */
+        uploadstblogs_cancel();
+#endif
         // As per the script, send MAINT_DCM_ERROR, MAINT_RFC_ERROR, MAINT_FWDOWNLOAD_ERROR,
         // MAINT_LOGUPLOAD_ERROR
         ret = dcmIARMEvntSend(DCM_IARM_ERROR);
@@ -250,6 +258,126 @@ VOID dcmDaemonMainUnInit(DCMDHandle *pdcmHandle)
     memset(pdcmHandle, 0, sizeof(DCMDHandle));
 }
 
+#ifndef GTEST_ENABLE
+/** @brief Parses the configuration pushed by telemetry and
+ *         (re)starts the jobs with its schedules.
+ *
+ *  @param[in]  pdcmHandle  daemon handle
+ *
+ *  @return  None.
+ *  @retval  None.
+ */
+static VOID dcmDaemonProcessConf(DCMDHandle *pdcmHandle)
+{
+    INT32 ret = DCM_SUCCESS;
+    INT8 *pconfPath = NULL;
+
+    DCMInfo("Start Scheduling\n");
+
+    /* Reset first: a config pushed while this one is parsed is not lost */
+    dcmRbusSchedResetStatus(pdcmHandle->pRbusHandle);
+
+    pconfPath = dcmRbusGetConfPath(pdcmHandle->pRbusHandle);
+    if(pconfPath == NULL) {
+        DCMWarn("conf file pointer is null\n");
+        return;
+    }
+
+    ret = dcmSettingParseConf(pdcmHandle->pDcmSetHandle, pconfPath,
+                              pdcmHandle->logCron,
+                              pdcmHandle->difdCron);
+    if(ret == DCM_SUCCESS) {
+        dcmSchedStartJob(pdcmHandle->pLogSchedHandle, pdcmHandle->logCron);
+        dcmSchedStartJob(pdcmHandle->pDifdSchedHandle, pdcmHandle->difdCron);
+
+        ret = dcmIARMEvntSend(DCM_IARM_COMPLETE);
+        if(ret) {
+            DCMError("Failed to send Event\n");
+        }
+    }
+    else {
+        DCMWarn("Failed to parse the conf file\n");
+    }
+}
+
+/** @brief Signal handler for the main loop, forwards the signal number to
+ *         the self-pipe so the exit path runs on the main thread
+ *
+ *  @param[in]  sig  signal type
+ *
+ *  @return  None.
+ *  @retval  None.
+ */
+static VOID dcmDaemonSigWake(INT32 sig)
+{
+    INT32 savedErrno = errno;
+    UINT8 signo      = (UINT8)sig;
+
+    if(write(g_sigWakeFd, &signo, sizeof(signo)) < 0) {
+        /* Pipe full: a wake-up is already pending */
+    }
+    errno = savedErrno;
+}
+
+/** @brief Routes SIGINT and SIGTERM to a self-pipe read by the main loop.
+ *         Nothing is blocked, so children started from the jobs keep the
+ *         default signal disposition and mask.
+ *
+ *  @param[out]  pReadFd  read end of the pipe
+ *
+ *  @return  Returns the status of the operation.
+ *  @retval  Returns DCM_SUCCESS on Success, DCM_FAILURE otherwise.
+ */
+static INT32 dcmDaemonSigPipeInit(INT32 *pReadFd)
+{
+    struct sigaction action;
+    INT32 pipeFd[2];
+    INT32 i;
+
+    if(pipe(pipeFd) < 0) {
+        DCMError("pipe failed: %s\n", strerror(errno));
+        return DCM_FAILURE;
+    }
+    for(i = 0; i < 2; i++) {
+        fcntl(pipeFd[i], F_SETFD, FD_CLOEXEC);
+        fcntl(pipeFd[i], F_SETFL, fcntl(pipeFd[i], F_GETFL) | O_NONBLOCK);
+    }
+    g_sigWakeFd = pipeFd[1];
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = dcmDaemonSigWake;
+    action.sa_flags   = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT,  &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    *pReadFd = pipeFd[0];
+    return DCM_SUCCESS;
+}
+
+/** @brief Adds a fd to the main loop epoll set.
+ *
+ *  @param[in]  epollFd  epoll instance
+ *  @param[in]  fd       fd to watch for input
+ *
+ *  @return  Returns the status of the operation.
+ *  @retval  Returns DCM_SUCCESS on success, DCM_FAILURE otherwise.
+ */
+static INT32 dcmDaemonWatchFd(INT32 epollFd, INT32 fd)
+{
+    struct epoll_event event;
+
+    memset(&event, 0, sizeof(event));
+    event.events  = EPOLLIN;
+    event.data.fd = fd;
+    if(epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        DCMError("epoll_ctl failed for fd %d: %s\n", fd, strerror(errno));
+        return DCM_FAILURE;
+    }
+    return DCM_SUCCESS;
+}
+#endif
+
 /** @brief Main function
  *
  *  @param[in]  argc   No. of arguments
@@ -264,7 +392,10 @@ int main(int argc, char* argv[])
     pid_t process_id       = 0;
     pid_t sid              = 0;
     INT32 ret              = DCM_SUCCESS;
-    INT32 count            = 0;
+    INT32 epollFd          = -1;
+    INT32 sigFd            = -1;
+    INT32 rbusFd           = -1;
+    BOOL  isSubscribed     = false;
 
     DCMLOGInit();
 
@@ -331,66 +462,91 @@ int main(int argc, char* argv[])
     }
     //#endif
 
-    while(1) {
-        if(count > 10) {
-            DCMInfo("Waiting for Telemetry to up and running to Subscribe the events\n");
-            count = 0;
-        }
-        count++;
-        if(dcmRbusGetEventSubStatus(g_pdcmHandle->pRbusHandle)) {
-            break;
-        }
-        sleep(1);
+    rbusFd  = dcmRbusGetEventFd(g_pdcmHandle->pRbusHandle);
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if(rbusFd < 0 || epollFd < 0 ||
+       dcmDaemonSigPipeInit(&sigFd) != DCM_SUCCESS ||
+       dcmDaemonWatchFd(epollFd, rbusFd) != DCM_SUCCESS ||
+       dcmDaemonWatchFd(epollFd, sigFd) != DCM_SUCCESS) {
+        DCMError("Failed to set up the main loop, closing the DCM Process!!!\n");
+        ret = DCM_FAILURE;
+        goto exit0;
     }
 
-    DCMInfo("Telemetry Events subscriptions is success\n");
+    /* Sleep until an rbus callback or a signal wakes us: the jobs run on
+     * the scheduler threads, so there is nothing to poll for here */
+    while(1) {
+        struct epoll_event events[DCM_MAX_EVENTS];
+        INT32 nEvents;
+        INT32 i;
 
-    ret = dcmRbusSendEvent(g_pdcmHandle->pRbusHandle);
-    if(ret) {
-        DCMError("Reload config event failed!!!\n");
-    }
+        /* Clear before checking: a callback after this wakes epoll again */
+        dcmRbusClearEvent(g_pdcmHandle->pRbusHandle);
 
-    DCMInfo("Sent Event to telemetry for configuraion path\n");
+        if(!isSubscribed && dcmRbusGetEventSubStatus(g_pdcmHandle->pRbusHandle)) {
+            isSubscribed = true;
+            DCMInfo("Telemetry Events subscriptions is success\n");
 
-    while(1) {
-        INT32 ret = DCM_SUCCESS;
-        INT8 *pconfPath = NULL;
+            ret = dcmRbusSendEvent(g_pdcmHandle->pRbusHandle);
+            if(ret) {
+                DCMError("Reload config event failed!!!\n");
+            }
 
-        /* Wait for event Device.DCM.Processconfig */
-        if(dcmRbusSchedJobStatus(g_pdcmHandle->pRbusHandle)) {
-            DCMInfo("Start Scheduling\n");
+            DCMInfo("Sent Event to telemetry for configuraion path\n");
+        }
 
-            pconfPath = dcmRbusGetConfPath(g_pdcmHandle->pRbusHandle);
+        /* Wait for event Device.DCM.Processconfig */
+        if(isSubscribed && dcmRbusSchedJobStatus(g_pdcmHandle->pRbusHandle)) {
+            dcmDaemonProcessConf(g_pdcmHandle);
+        }
 
-            if(pconfPath == NULL) {
-                DCMWarn("conf file pointer is null\n");
-                sleep(1);
-                continue;
+        nEvents = epoll_wait(epollFd, events, DCM_MAX_EVENTS,
+                             isSubscribed ? -1 : DCM_T2_WAIT_LOG_MS);
+        if(nEvents < 0) {
+            if(errno != EINTR) {
+                DCMError("epoll_wait failed: %s\n", strerror(errno));
+                ret = DCM_FAILURE;
+                break;
             }
+            continue;
+        }
+        if(nEvents == 0) {
+            DCMInfo("Waiting for Telemetry to up and running to Subscribe the events\n");
+            continue;
+        }
 
-            ret = dcmSettingParseConf(g_pdcmHandle->pDcmSetHandle, pconfPath,
-                                      g_pdcmHandle->logCron,
-                                      g_pdcmHandle->difdCron);
-            if(ret == DCM_SUCCESS) {
-                dcmSchedStartJob(g_pdcmHandle->pLogSchedHandle, g_pdcmHandle->logCron);
-                dcmSchedStartJob(g_pdcmHandle->pDifdSchedHandle, g_pdcmHandle->difdCron);
+        for(i = 0; i < nEvents; i++) {
+            if(events[i].data.fd == sigFd) {
+                UINT8 signo;
 
-                ret = dcmIARMEvntSend(DCM_IARM_COMPLETE);
-                if(ret) {
-                    DCMError("Failed to send Event\n");
+                if(read(sigFd, &signo, sizeof(signo)) == sizeof(signo)) {
+                    DCMInfo("Signal %u received\n", signo);
+                    /* Exit path sends the error events, as sig_handler does */
+                    ret = DCM_FAILURE;
+                    goto exit0;
                 }
             }
-            else {
-                DCMWarn("Failed to parse the conf file\n");
-            }
-
-            dcmRbusSchedResetStatus(g_pdcmHandle->pRbusHandle);
         }
-        sleep(1);
     } //while(1)
 
+exit0:
     DCMInfo("Exiting DCM Component\n");
+#ifndef GTEST_ENABLE
+    /* Uninit joins the scheduler jobs; a log upload must not sit out its retry backoff */
+    uploadstblogs_cancel();
+#endif
 
+    if(epollFd >= 0) {
+        close(epollFd);
+    }
+    if(sigFd >= 0) {
+        /* Back to sig_handler before the pipe goes away */
+        signal(SIGINT,  sig_handler);
+        signal(SIGTERM, sig_handler);
+        close(sigFd);
+        close(g_sigWakeFd);
+        g_sigWakeFd = -1;
+    }
 exit1:
     dcmDaemonMainUnInit(g_pdcmHandle);
 exit2:
@@ -28,6 +28,8 @@ extern "C"
 
 #define DCM_LOGUPLOAD_SCHED    "DCM_LOG_UPLOAD"
 #define DCM_DIFD_SCHED         "DCM_FW_UPDATE"
+#define DCM_T2_WAIT_LOG_MS     10000   /* Reminder interval while telemetry is not up */
+#define DCM_MAX_EVENTS         2       /* rbus event fd and signal fd */
 
 typedef struct _dcmdHandle
 {
@@ -255,21 +255,6 @@ static VOID dcmCronParseDelBit(UINT8* rbyte, INT32 idx)
     rbyte[j] &= ~(1 << k);
 }
 
-static UINT32 dcmCronParseNextSetBit(UINT8* bits, UINT32 max,
-                                     UINT32 from_index, INT32* notfound)
-{
-    UINT32 i;
-    if (!bits) {
-        *notfound = 1;
-        return 0;
-    }
-    for (i = from_index; i < max; i++) {
-        if (dcmCronParseGetBit(bits, i)) return i;
-    }
-    *notfound = 1;
-    return 0;
-}
-
 static UINT32* dcmCronParseGetRange(INT8* field, UINT32 min, UINT32 max, INT32 *ret)
 {
 
@@ -343,40 +328,457 @@ static VOID dcmCronParseSetBit(UINT8* rbyte, INT32 idx)
     rbyte[j] |= (1 << k);
 }
 
+static struct tm* dcmCronParseTime(time_t* date, struct tm* out)
+{
+    return gmtime_r(date, out);
+}
+
+static INT8* dcmCronParseReplaceOrdinals(INT8* value, const INT8* const * arr, UINT32 arr_len)
+{
+    UINT32 i;
+    INT8* cur = value;
+    INT8* res = NULL;
+    INT32 first = 1;
+    for (i = 0; i < arr_len; i++) {
+        INT8 strnum[4] = {0};
+        sprintf(strnum, "%d", (INT32)i);
+        res = dcmCronParseStrReplace(cur, arr[i], strnum);
+
+        if (!first) {
+            free(cur);
+        }
+        if (!res) {
+            return NULL;
+        }
+        cur = res;
+        if (first) {
+            first = 0;
+        }
+    }
+    return res;
+}
+static INT32 dcmCronParseSetNumberHits(const INT8* value, UINT8* target,
+                                       UINT32 min, UINT32 max)
+{
+    UINT32 i;
+    INT32 ret = CRON_SUCCESS;
+    UINT32 i1;
+    UINT32 len = 0;
+
+    INT8** fields = dcmCronParseStrSplit(value, ',', &len);
+    if (!fields) {
+        ret = CRON_FAILURE;
+        goto return_result;
+    }
+
+    for (i = 0; i < len; i++) {
+        if (!strchr(fields[i], '/')) {
+            /* Not an incrementer so it must be a range (possibly empty) */
+
+            UINT32* range = dcmCronParseGetRange(fields[i], min, max, &ret);
+
+            if (ret) {
+                if (range) {
+                    free(range);
+                }
+                ret = CRON_FAILURE;
+                goto return_result;
+
+            }
+
+            for (i1 = range[0]; i1 <= range[1]; i1++) {
+                dcmCronParseSetBit(target, i1);
+
+            }
+            free(range);
+
+        }
+        else {
+            UINT32 len2 = 0;
+            INT8** split = dcmCronParseStrSplit(fields[i], '/', &len2);
+            if (2 != len2) {
+                ret = CRON_FAILURE;
+                dcmCronParseFreeSplit(split, len2);
+                goto return_result;
+            }
+            UINT32* range = dcmCronParseGetRange(split[0], min, max, &ret);
+            if (ret) {
+                if (range) {
+                    free(range);
+                }
+                dcmCronParseFreeSplit(split, len2);
+                goto return_result;
+            }
+            if (!strchr(split[0], '-')) {
+                range[1] = max - 1;
+            }
+            INT32 err = 0;
+            UINT32 delta = dcmCronParseParseUint(split[1], &err);
+            if (err) {
+                ret = CRON_FAILURE;
+                free(range);
+                dcmCronParseFreeSplit(split, len2);
+                goto return_result;
+            }
+            if (0 == delta) {
+                ret = CRON_FAILURE;
+                free(range);
+                dcmCronParseFreeSplit(split, len2);
+                goto return_result;
+            }
+            for (i1 = range[0]; i1 <= range[1]; i1 += delta) {
+                dcmCronParseSetBit(target, i1);
+            }
+            dcmCronParseFreeSplit(split, len2);
+            free(range);
+
+        }
+    }
+    goto return_result;
+
+return_result:
+    dcmCronParseFreeSplit(fields, len);
+    return ret;
+
+}
+
+static INT32 dcmCronParseSetMonths(INT8* value, UINT8* targ)
+{
+    UINT32 i;
+    UINT32 max = 12;
+    INT32 ret = CRON_SUCCESS;
+
+    INT8* replaced = NULL;
+
+    dcmCronParseToUpper(value);
+    replaced = dcmCronParseReplaceOrdinals(value, MONTHS_ARR, CRON_MONTHS_ARR_LEN);
+    if (!replaced) {
+        return CRON_FAILURE;
+    }
+    ret = dcmCronParseSetNumberHits(replaced, targ, 1, max + 1);
+    free(replaced);
+
+    /* ... and then rotate it to the front of the months */
+    for (i = 1; i <= max; i++) {
+        if (dcmCronParseGetBit(targ, i)) {
+            dcmCronParseSetBit(targ, i - 1);
+            dcmCronParseDelBit(targ, i);
+        }
+    }
+    return ret;
+}
+
+static INT32 dcmCronParseSetDaysOfWeek(INT8* field, UINT8* targ)
+{
+    UINT32 max = 7;
+    INT8* replaced = NULL;
+    INT32 ret = CRON_SUCCESS;
+
+    if (1 == strlen(field) && '?' == field[0]) {
+        field[0] = '*';
+    }
+    dcmCronParseToUpper(field);
+    replaced = dcmCronParseReplaceOrdinals(field, DAYS_ARR, CRON_DAYS_ARR_LEN);
+    if (!replaced) {
+        return CRON_FAILURE;
+    }
+    ret = dcmCronParseSetNumberHits(replaced, targ, 0, max + 1);
+    free(replaced);
+    if (dcmCronParseGetBit(targ, 7)) {
+        /* Sunday can be represented as 0 or 7*/
+        dcmCronParseSetBit(targ, 0);
+        dcmCronParseDelBit(targ, 7);
+    }
+    return ret;
+}
+
+static INT32 dcmCronParseSetDaysOfMonth(INT8* field, UINT8* targ)
+{
+    INT32 ret = CRON_SUCCESS;
+    /* Days of month start with 1 (in Cron and Calendar) so add one */
+    if (1 == strlen(field) && '?' == field[0]) {
+        field[0] = '*';
+    }
+    ret = dcmCronParseSetNumberHits(field, targ, 1, CRON_MAX_DAYS_OF_MONTH);
+
+    return ret;
+}
+
+static const UINT8 CRON_MONTH_DAYS[CRON_MAX_MONTHS] = { 31, 28, 31, 30, 31, 30,
+                                                        31, 31, 30, 31, 30, 31 };
+
+/**
+ * Index of the lowest set bit at or above from, -1 if there is none.
+ */
+static INT32 dcmCronParseNextBit(uint64_t mask, UINT32 from)
+{
+    if (from >= 64) {
+        return -1;
+    }
+    mask &= ~0ULL << from;
+    return mask ? __builtin_ctzll(mask) : -1;
+}
+
+/**
+ * Days since 1970-01-01 of a proleptic Gregorian date, month 1-12.
+ */
+static INT64 dcmCronParseDaysFromCivil(INT32 year, UINT32 month, UINT32 day)
+{
+    year -= month <= 2;
+    INT32  era = (year >= 0 ? year : year - 399) / 400;
+    UINT32 yoe = (UINT32)(year - era * 400);
+    UINT32 doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    UINT32 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (INT64)era * 146097 + (INT64)doe - 719468;
+}
+
+/**
+ * Bits 1..n for the n days of the month, month 0-11.
+ */
+static uint32_t dcmCronParseMonthDays(INT32 year, UINT32 month)
+{
+    UINT32 len = CRON_MONTH_DAYS[month];
+    if (month == 1 && (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))) {
+        len = 29;
+    }
+    return (uint32_t)(((1ULL << (len + 1)) - 1) & ~1ULL);
+}
+
+/**
+ * Fill the compiled masks of expr from its bit arrays. Days of month and
+ * week are folded into one day mask per weekday of the 1st, so a month's
+ * candidate days are a single AND with its length.
+ */
+static VOID dcmCronParseCompile(dcmCronExpr* expr)
+{
+    UINT32 i;
+    UINT32 wday;
+    uint32_t dom = 0;
+    UINT32 dow = 0;
+
+    expr->secMask = 0;
+    expr->minMask = 0;
+    expr->hourMask = 0;
+    expr->monMask = 0;
+    for (i = 0; i < CRON_MAX_SECONDS; i++) {
+        if (dcmCronParseGetBit(expr->seconds, i)) expr->secMask |= 1ULL << i;
+    }
+    for (i = 0; i < CRON_MAX_MINUTES; i++) {
+        if (dcmCronParseGetBit(expr->minutes, i)) expr->minMask |= 1ULL << i;
+    }
+    for (i = 0; i < CRON_MAX_HOURS; i++) {
+        if (dcmCronParseGetBit(expr->hours, i)) expr->hourMask |= 1U << i;
+    }
+    for (i = 0; i < CRON_MAX_MONTHS; i++) {
+        if (dcmCronParseGetBit(expr->months, i)) expr->monMask |= 1U << i;
+    }
+    for (i = 1; i < CRON_MAX_DAYS_OF_MONTH; i++) {
+        if (dcmCronParseGetBit(expr->days_of_month, i)) dom |= 1U << i;
+    }
+    for (i = 0; i < CRON_MAX_DAYS_OF_WEEK - 1; i++) {
+        if (dcmCronParseGetBit(expr->days_of_week, i)) dow |= 1U << i;
+    }
+    for (wday = 0; wday < CRON_MAX_DAYS_OF_WEEK - 1; wday++) {
+        expr->dayMasks[wday] = 0;
+        for (i = 1; i < CRON_MAX_DAYS_OF_MONTH; i++) {
+            if (dow & (1U << ((wday + i - 1) % 7))) expr->dayMasks[wday] |= 1U << i;
+        }
+        expr->dayMasks[wday] &= dom;
+    }
+    expr->compiled = true;
+}
+
+/** @brief This function gets the next in the pattern
+ *
+ *  Each field jumps to its next allowed value with a bit scan; a field
+ *  without one carries into the next larger field and restarts the
+ *  smaller ones at their first value. Nothing is allocated.
+ *
+ *  @param[in]  expr      Parsed Cron pattern
+ *  @param[out] date      current date
+ *
+ *  @return  Returns the time.
+ *  @retval  Returns the first matching time after date, -1 if none
+ *           within CRON_MAX_YEARS_DIFF years.
+ */
+time_t dcmCronParseGetNext(dcmCronExpr* expr, time_t date)
+{
+    struct tm calval;
+    INT32 year;
+    INT32 lastYear;
+    INT32 mon;
+    INT32 mday;
+    INT32 hour;
+    INT32 min;
+    INT32 sec;
+    INT32 next;
+    INT64 days = 0;
+
+    if (!expr) return CRON_INVALID_INSTANT;
+    if (!expr->compiled) {
+        dcmCronParseCompile(expr);
+    }
+
+    /* Strictly after date */
+    date += 1;
+    if (!dcmCronParseTime(&date, &calval)) return CRON_INVALID_INSTANT;
+    year = calval.tm_year + 1900;
+    lastYear = year + CRON_MAX_YEARS_DIFF;
+    mon  = calval.tm_mon;
+    mday = calval.tm_mday;
+    hour = calval.tm_hour;
+    min  = calval.tm_min;
+    sec  = calval.tm_sec;
+
+    while (year <= lastYear) {
+        next = dcmCronParseNextBit(expr->monMask, mon);
+        if (next < 0) {
+            year++;
+            mon = 0; mday = 1; hour = 0; min = 0; sec = 0;
+            continue;
+        }
+        if (next != mon) {
+            mon = next; mday = 1; hour = 0; min = 0; sec = 0;
+        }
+
+        days = dcmCronParseDaysFromCivil(year, mon + 1, 1);
+        /* 1970-01-01 was a Thursday */
+        next = dcmCronParseNextBit(expr->dayMasks[((days % 7) + 11) % 7] &
+                                   dcmCronParseMonthDays(year, mon), mday);
+        if (next < 0) {
+            mon++;
+            mday = 1; hour = 0; min = 0; sec = 0;
+            continue;
+        }
+        if (next != mday) {
+            mday = next; hour = 0; min = 0; sec = 0;
+        }
+
+        next = dcmCronParseNextBit(expr->hourMask, hour);
+        if (next < 0) {
+            mday++;
+            hour = 0; min = 0; sec = 0;
+            continue;
+        }
+        if (next != hour) {
+            hour = next; min = 0; sec = 0;
+        }
+
+        next = dcmCronParseNextBit(expr->minMask, min);
+        if (next < 0) {
+            hour++;
+            min = 0; sec = 0;
+            continue;
+        }
+        if (next != min) {
+            min = next; sec = 0;
+        }
+
+        next = dcmCronParseNextBit(expr->secMask, sec);
+        if (next < 0) {
+            min++;
+            sec = 0;
+            continue;
+        }
+        sec = next;
+
+        return (time_t)(days + mday - 1) * 86400 + hour * 3600 + min * 60 + sec;
+    }
+    return CRON_INVALID_INSTANT;
+}
+
+/** @brief This function Parses the cron pattern
+ *
+ *  @param[in]  expression   Cron pattern
+ *  @param[out] target       Parsed pattern structure
+ *
+ *  @return  Returns Status of the operation.
+ *  @retval  Returns DCM_SUCCESS on success, DCM_FAILURE otherwise.
+ */
+INT32 dcmCronParseExp(const INT8* expression, dcmCronExpr* target)
+{
+    UINT32 len = 0;
+    INT8** fields = NULL;
+    INT32 i = 0;
+    INT32 ret = CRON_SUCCESS;
+
+    if (!expression) {
+        ret = CRON_FAILURE;
+        goto return_res;
+    }
+    if (!target) {
+        ret = CRON_FAILURE;
+        goto return_res;
+    }
+
+    fields = dcmCronParseStrSplit(expression, ' ', &len);
+    if (len < 5 || len > 6) {
+        ret = CRON_FAILURE;
+        goto return_res;
+    }
+
+    memset(target, 0, sizeof(*target));
+
+    if (len == 6) {
+        ret = dcmCronParseSetNumberHits(fields[0], target->seconds, 0, 60);
+        if (ret) {
+            goto return_res;
+        }
+        i = 1;
+    }
+    else if (len == 5) {
+        i = 0;
+        target->seconds[0] = 1;
+    }
+
+    ret = dcmCronParseSetNumberHits(fields[i], target->minutes, 0, 60);
+    if (ret) {
+        goto return_res;
+    }
+    ret = dcmCronParseSetNumberHits(fields[i + 1], target->hours, 0, 24);
+    if (ret) {
+        goto return_res;
+    }
+    ret = dcmCronParseSetDaysOfMonth(fields[i + 2], target->days_of_month);
+    if (ret) {
+        goto return_res;
+    }
+    ret = dcmCronParseSetMonths(fields[i + 3], target->months);
+    if (ret) {
+        goto return_res;
+    }
+    ret = dcmCronParseSetDaysOfWeek(fields[i + 4], target->days_of_week);
+    if (ret) {
+        goto return_res;
+    }
+    dcmCronParseCompile(target);
+
+return_res:
+    dcmCronParseFreeSplit(fields, len);
+    return ret;
+}
+
+#ifdef GTEST_ENABLE
+static UINT32 dcmCronParseNextSetBit(UINT8* bits, UINT32 max,
+                                     UINT32 from_index, INT32* notfound)
+{
+    UINT32 i;
+    if (!bits) {
+        *notfound = 1;
+        return 0;
+    }
+    for (i = from_index; i < max; i++) {
+        if (dcmCronParseGetBit(bits, i)) return i;
+    }
+    *notfound = 1;
+    return 0;
+}
+
 static time_t dcmCronParseMktime(struct tm* tm)
 {
     return timegm(tm);
 }
 
-static struct tm* dcmCronParseTime(time_t* date, struct tm* out)
-{
-    return gmtime_r(date, out);
-}
-
-static INT8* dcmCronParseReplaceOrdinals(INT8* value, const INT8* const * arr, UINT32 arr_len)
-{
-    UINT32 i;
-    INT8* cur = value;
-    INT8* res = NULL;
-    INT32 first = 1;
-    for (i = 0; i < arr_len; i++) {
-        INT8 strnum[4] = {0};
-        sprintf(strnum, "%d", (INT32)i);
-        res = dcmCronParseStrReplace(cur, arr[i], strnum);
-
-        if (!first) {
-            free(cur);
-        }
-        if (!res) {
-            return NULL;
-        }
-        cur = res;
-        if (first) {
-            first = 0;
-        }
-    }
-    return res;
-}
 /**
  * Reset the calendar setting all the fields provided to zero.
  */
@@ -470,91 +872,6 @@ static INT32 dcmCronParseSetField(struct tm* calendar, INT32 field, INT32 val)
     return 0;
 }
 
-static INT32 dcmCronParseSetNumberHits(const INT8* value, UINT8* target,
-                                       UINT32 min, UINT32 max)
-{
-    UINT32 i;
-    INT32 ret = CRON_SUCCESS;
-    UINT32 i1;
-    UINT32 len = 0;
-
-    INT8** fields = dcmCronParseStrSplit(value, ',', &len);
-    if (!fields) {
-        ret = CRON_FAILURE;
-        goto return_result;
-    }
-
-    for (i = 0; i < len; i++) {
-        if (!strchr(fields[i], '/')) {
-            /* Not an incrementer so it must be a range (possibly empty) */
-
-            UINT32* range = dcmCronParseGetRange(fields[i], min, max, &ret);
-
-            if (ret) {
-                if (range) {
-                    free(range);
-                }
-                ret = CRON_FAILURE;
-                goto return_result;
-
-            }
-
-            for (i1 = range[0]; i1 <= range[1]; i1++) {
-                dcmCronParseSetBit(target, i1);
-
-            }
-            free(range);
-
-        }
-        else {
-            UINT32 len2 = 0;
-            INT8** split = dcmCronParseStrSplit(fields[i], '/', &len2);
-            if (2 != len2) {
-                ret = CRON_FAILURE;
-                dcmCronParseFreeSplit(split, len2);
-                goto return_result;
-            }
-            UINT32* range = dcmCronParseGetRange(split[0], min, max, &ret);
-            if (ret) {
-                if (range) {
-                    free(range);
-                }
-                dcmCronParseFreeSplit(split, len2);
-                goto return_result;
-            }
-            if (!strchr(split[0], '-')) {
-                range[1] = max - 1;
-            }
-            INT32 err = 0;
-            UINT32 delta = dcmCronParseParseUint(split[1], &err);
-            if (err) {
-                ret = CRON_FAILURE;
-                free(range);
-                dcmCronParseFreeSplit(split, len2);
-                goto return_result;
-            }
-            if (0 == delta) {
-                ret = CRON_FAILURE;
-                free(range);
-                dcmCronParseFreeSplit(split, len2);
-                goto return_result;
-            }
-            for (i1 = range[0]; i1 <= range[1]; i1 += delta) {
-                dcmCronParseSetBit(target, i1);
-            }
-            dcmCronParseFreeSplit(split, len2);
-            free(range);
-
-        }
-    }
-    goto return_result;
-
-return_result:
-    dcmCronParseFreeSplit(fields, len);
-    return ret;
-
-}
-
 static VOID dcmCronParsePushToFieldsArr(INT32* arr, INT32 fi)
 {
     INT32 i;
@@ -606,67 +923,6 @@ static INT32 dcmCronParseAddToField(struct tm* calendar, INT32 field, INT32 val)
     }
     return 0;
 }
-static INT32 dcmCronParseSetMonths(INT8* value, UINT8* targ)
-{
-    UINT32 i;
-    UINT32 max = 12;
-    INT32 ret = CRON_SUCCESS;
-
-    INT8* replaced = NULL;
-
-    dcmCronParseToUpper(value);
-    replaced = dcmCronParseReplaceOrdinals(value, MONTHS_ARR, CRON_MONTHS_ARR_LEN);
-    if (!replaced) {
-        return CRON_FAILURE;
-    }
-    ret = dcmCronParseSetNumberHits(replaced, targ, 1, max + 1);
-    free(replaced);
-
-    /* ... and then rotate it to the front of the months */
-    for (i = 1; i <= max; i++) {
-        if (dcmCronParseGetBit(targ, i)) {
-            dcmCronParseSetBit(targ, i - 1);
-            dcmCronParseDelBit(targ, i);
-        }
-    }
-    return ret;
-}
-
-static INT32 dcmCronParseSetDaysOfWeek(INT8* field, UINT8* targ)
-{
-    UINT32 max = 7;
-    INT8* replaced = NULL;
-    INT32 ret = CRON_SUCCESS;
-
-    if (1 == strlen(field) && '?' == field[0]) {
-        field[0] = '*';
-    }
-    dcmCronParseToUpper(field);
-    replaced = dcmCronParseReplaceOrdinals(field, DAYS_ARR, CRON_DAYS_ARR_LEN);
-    if (!replaced) {
-        return CRON_FAILURE;
-    }
-    ret = dcmCronParseSetNumberHits(replaced, targ, 0, max + 1);
-    free(replaced);
-    if (dcmCronParseGetBit(targ, 7)) {
-        /* Sunday can be represented as 0 or 7*/
-        dcmCronParseSetBit(targ, 0);
-        dcmCronParseDelBit(targ, 7);
-    }
-    return ret;
-}
-
-static INT32 dcmCronParseSetDaysOfMonth(INT8* field, UINT8* targ)
-{
-    INT32 ret = CRON_SUCCESS;
-    /* Days of month start with 1 (in Cron and Calendar) so add one */
-    if (1 == strlen(field) && '?' == field[0]) {
-        field[0] = '*';
-    }
-    ret = dcmCronParseSetNumberHits(field, targ, 1, CRON_MAX_DAYS_OF_MONTH);
-
-    return ret;
-}
 
 /**
  * Search the bits provided for the next set bit after the value provided,
@@ -834,15 +1090,12 @@ return_result:
     return res;
 }
 
-/** @brief This function gets the next in the pattern
- *
- *  @param[in]  expr      Parsed Cron pattern
- *  @param[out] date      current date
- *
- *  @return  Returns the time.
- *  @retval  Returns the time.
+/**
+ * Previous dcmCronParseGetNext(): walks the calendar field by field with
+ * timegm(). Only built for the unit tests, which check the compiled
+ * evaluator against it.
  */
-time_t dcmCronParseGetNext(dcmCronExpr* expr, time_t date)
+static time_t dcmCronParseGetNextWalk(dcmCronExpr* expr, time_t date)
 {
     if (!expr) return CRON_INVALID_INSTANT;
     struct tm calval;
@@ -868,77 +1121,6 @@ time_t dcmCronParseGetNext(dcmCronExpr* expr, time_t date)
     return dcmCronParseMktime(calendar);
 }
 
-/** @brief This function Parses the cron pattern
- *
- *  @param[in]  expression   Cron pattern
- *  @param[out] target       Parsed pattern structure
- *
- *  @return  Returns Status of the operation.
- *  @retval  Returns DCM_SUCCESS on success, DCM_FAILURE otherwise.
- */
-INT32 dcmCronParseExp(const INT8* expression, dcmCronExpr* target)
-{
-    UINT32 len = 0;
-    INT8** fields = NULL;
-    INT32 i = 0;
-    INT32 ret = CRON_SUCCESS;
-
-    if (!expression) {
-        ret = CRON_FAILURE;
-        goto return_res;
-    }
-    if (!target) {
-        ret = CRON_FAILURE;
-        goto return_res;
-    }
-
-    fields = dcmCronParseStrSplit(expression, ' ', &len);
-    if (len < 5 || len > 6) {
-        ret = CRON_FAILURE;
-        goto return_res;
-    }
-
-    memset(target, 0, sizeof(*target));
-
-    if (len == 6) {
-        ret = dcmCronParseSetNumberHits(fields[0], target->seconds, 0, 60);
-        if (ret) {
-            goto return_res;
-        }
-        i = 1;
-    }
-    else if (len == 5) {
-        i = 0;
-        target->seconds[0] = 1;
-    }
-
-    ret = dcmCronParseSetNumberHits(fields[i], target->minutes, 0, 60);
-    if (ret) {
-        goto return_res;
-    }
-    ret = dcmCronParseSetNumberHits(fields[i + 1], target->hours, 0, 24);
-    if (ret) {
-        goto return_res;
-    }
-    ret = dcmCronParseSetDaysOfMonth(fields[i + 2], target->days_of_month);
-    if (ret) {
-        goto return_res;
-    }
-    ret = dcmCronParseSetMonths(fields[i + 3], target->months);
-    if (ret) {
-        goto return_res;
-    }
-    ret = dcmCronParseSetDaysOfWeek(fields[i + 4], target->days_of_week);
-    if (ret) {
-        goto return_res;
-    }
-
-return_res:
-    dcmCronParseFreeSplit(fields, len);
-    return ret;
-}
-
-#ifdef GTEST_ENABLE
 // Defining Function pointers to access static functions
 INT32 (*getdcmCronParseToUpper(void)) (INT8*) 
 {
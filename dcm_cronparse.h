@@ -27,6 +27,7 @@ extern "C"
 {
 #endif
 
+#include <stdint.h>
 #ifdef GTEST_ENABLE
 #include "dcm_types.h"
 #endif
@@ -40,6 +41,14 @@ typedef struct {
     UINT8 days_of_week[1];
     UINT8 days_of_month[4];
     UINT8 months[2];
+
+    /* Compiled from the bit arrays for dcmCronParseGetNext() */
+    uint64_t secMask;
+    uint64_t minMask;
+    uint32_t hourMask;
+    uint32_t dayMasks[7];   /* Days 1-31 matching both day fields, by weekday of the 1st */
+    uint16_t monMask;       /* Bit 0 = January */
+    BOOL     compiled;
 } dcmCronExpr;
 
 INT32 dcmCronParseExp(const INT8* expression, dcmCronExpr* target);
@@ -21,6 +21,7 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <errno.h>
 #include <stdbool.h>
 #include <string.h>
 #include <sys/types.h>
@@ -30,6 +31,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <signal.h>
+#include <sys/eventfd.h>
 #ifndef GTEST_ENABLE
 #include "rbus.h"
 #endif
@@ -51,6 +53,23 @@ static rbusDataElement_t g_dataElements = {
         {NULL, NULL, NULL, NULL, rbusSendEventCB, NULL}
 };
 
+/** @brief Wakes the daemon main loop after a state change.
+ *
+ *  @param[in]  pDCMRbusHandle  rbus handle
+ *
+ *  @return  None.
+ *  @retval  None.
+ */
+static VOID dcmRbusNotify(DCMRBusHandle *pDCMRbusHandle)
+{
+    uint64_t one = 1;
+
+    if(pDCMRbusHandle->eventFd >= 0 &&
+       write(pDCMRbusHandle->eventFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        DCMWarn("Unable to wake the main loop: %s\n", strerror(errno));
+    }
+}
+
 /** @brief set config Event function.
  *         T2 Sends the Config path
  *
@@ -137,6 +156,7 @@ static VOID rbusProcConf(rbusHandle_t handle,
     DCMInfo("Received eventName: %s, Event type: %d, Event Name: %s\n", subscription->eventName, event->type, event->name);
 
     pDCMRbusHandle->schedJob = 1;
+    dcmRbusNotify(pDCMRbusHandle);
 }
 
 /** @brief Process Event function for Device.X_RDKCENTREL-COM.Reloadconfig
@@ -210,6 +230,7 @@ static void rbusAsyncSubCB(rbusHandle_t handle,
         DCMInfo("Subscription %s event Success\n", subscription->eventName);
         pDCMRbusHandle->eventSub = 1;
     }
+    dcmRbusNotify(pDCMRbusHandle);
 }
 
 /** @brief This Function initializes the receiver rbus.
@@ -371,6 +392,48 @@ INT8*  dcmRbusGetConfPath(VOID *pDCMRbusHandle)
     return plDCMRbusHandle->confPath;
 }
 
+/** @brief This Function returns the fd signalled by the rbus callbacks.
+ *
+ *  The fd becomes readable whenever the subscription or schedule status
+ *  may have changed; the caller re-checks the status after
+ *  dcmRbusClearEvent().
+ *
+ *  @param[in]  pDCMRbusHandle - rbus handle
+ *
+ *  @return  Returns the eventfd, -1 if there is none.
+ */
+INT32 dcmRbusGetEventFd(VOID *pDCMRbusHandle)
+{
+    DCMRBusHandle *plDCMRbusHandle = (DCMRBusHandle *)pDCMRbusHandle;
+    if(plDCMRbusHandle == NULL) {
+        DCMError("Handle is null\n");
+        return -1;
+    }
+
+    return plDCMRbusHandle->eventFd;
+}
+
+/** @brief This Function drains the pending wake-ups of the event fd.
+ *
+ *  @param[in]  pDCMRbusHandle - rbus handle
+ *
+ *  @return  None.
+ */
+VOID dcmRbusClearEvent(VOID *pDCMRbusHandle)
+{
+    DCMRBusHandle *plDCMRbusHandle = (DCMRBusHandle *)pDCMRbusHandle;
+    uint64_t count;
+
+    if(plDCMRbusHandle == NULL) {
+        DCMError("Handle is null\n");
+        return;
+    }
+    if(plDCMRbusHandle->eventFd >= 0) {
+        /* Non-blocking: fails with EAGAIN when nothing is pending */
+        (VOID)read(plDCMRbusHandle->eventFd, &count, sizeof(count));
+    }
+}
+
 /** @brief This Function returns the Schedule status.
  *
  *  @param[in]  pDCMRbusHandle - rbus handle
@@ -498,6 +561,13 @@ INT32 dcmRbusInit(VOID **ppDCMRbusHandle)
 
     memset(pDCMRbusHandle, 0, sizeof(DCMRBusHandle));
 
+    pDCMRbusHandle->eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(pDCMRbusHandle->eventFd < 0) {
+        DCMError("Failed to create the event fd\n");
+        ret = DCM_FAILURE;
+        goto exit;
+    }
+
     rc = rbus_open(&handle, DCM_RBUS_RECE_NAME);
     if(rc != RBUS_ERROR_SUCCESS) {
         DCMError("rbus_open failed: %d\n", rc);
@@ -513,6 +583,9 @@ INT32 dcmRbusInit(VOID **ppDCMRbusHandle)
 
 exit:
     if(pDCMRbusHandle) {
+        if(pDCMRbusHandle->eventFd >= 0) {
+            close(pDCMRbusHandle->eventFd);
+        }
         free(pDCMRbusHandle);
         pDCMRbusHandle = NULL;
     }
@@ -558,6 +631,10 @@ VOID dcmRbusUnInit (VOID *pDCMRbusHandle)
 
     plDCMRbusHandle->pRbusHandle = NULL;
 
+    if(plDCMRbusHandle->eventFd >= 0) {
+        close(plDCMRbusHandle->eventFd);
+    }
+
     free(plDCMRbusHandle);
 
 }
@@ -43,6 +43,7 @@ typedef struct _dcmRBusHandle
     rbusHandle_t pRbusHandle;
     INT32        schedJob;
     INT32        eventSub;
+    INT32        eventFd;     /* eventfd signalled by the rbus callbacks, -1 if none */
     INT8         confPath[DCM_CONF_SIZE];
 } DCMRBusHandle;
 
@@ -54,6 +55,8 @@ INT32  dcmRbusSchedJobStatus(VOID *pDCMRbusHandle);
 VOID   dcmRbusSchedResetStatus(VOID *pDCMRbusHandle);
 INT8   dcmRbusGetEventSubStatus(VOID *pDCMRbusHandle);
 INT8*  dcmRbusGetConfPath(VOID *pDCMRbusHandle);
+INT32  dcmRbusGetEventFd(VOID *pDCMRbusHandle);
+VOID   dcmRbusClearEvent(VOID *pDCMRbusHandle);
 INT32  dcmRbusGetT2Version(VOID *pDCMRbusHandle, VOID *value);
 
 #ifdef __cplusplus
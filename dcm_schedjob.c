@@ -30,6 +30,11 @@
 #include <time.h>
 #include <pthread.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
 
 #include "dcm_types.h"
 #include "dcm_utils.h"
@@ -38,97 +43,505 @@
 #include "dcm_cronparse.h"
 #include "dcm_schedjob.h"
 
-/** @brief Scheduler thread
+#define DCM_SCHED_HEAP_INIT  8
+#define DCM_SCHED_JUMP_MIN   2   /* Wall-clock drift in seconds treated as a clock step */
+#ifndef DCM_SCHED_WORKERS
+#define DCM_SCHED_WORKERS    2   /* Threads running job callbacks */
+#endif
+
+/**
+ * Scheduler state shared by all jobs: one thread sleeping until the
+ * earliest next run in a min-heap of started jobs.
+ *
+ * The thread waits on a CLOCK_REALTIME timerfd armed with
+ * TFD_TIMER_CANCEL_ON_SET, so a settimeofday() or NTP step wakes it and
+ * every job's next run is recomputed against the new time.
+ *
+ * Fired jobs are queued to a small worker pool, so a long callback
+ * delays neither other jobs nor the timer, and no lock is held while a
+ * callback runs. A job never runs on two workers at once; its overlap
+ * policy decides what a fire does while its previous run is pending.
+ */
+typedef struct _dcmSchedQueue
+{
+    pthread_mutex_t tMutex;
+    pthread_cond_t  tIdle;      /* Signalled when a callback returns */
+    pthread_cond_t  tWork;      /* Signalled when a job is queued */
+    INT32           timerFd;    /* Fires at the earliest next run */
+    INT32           wakeFd;     /* Wakes the scheduler thread after job changes */
+    struct timespec refReal;    /* CLOCK_REALTIME / CLOCK_BOOTTIME pair taken */
+    struct timespec refBoot;    /* together, to measure clock steps */
+    DCMSchedClockStats clockStats;
+    DCMScheduler  **ppHeap;     /* Started jobs, earliest nextRun first */
+    INT32           count;
+    INT32           size;
+    DCMScheduler   *pQueueHead; /* Fired jobs waiting for a worker, in fire order */
+    DCMScheduler   *pQueueTail;
+    BOOL            running;
+    BOOL            terminated;
+    pthread_t       tId;
+    pthread_t       workers[DCM_SCHED_WORKERS];
+    INT32           nWorkers;
+}DCMSchedQueue;
+
+static DCMSchedQueue g_dcmSched = {
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    -1,
+    -1,
+};
+
+/* Timer heap helpers, called with tMutex held */
+
+static VOID dcmSchedHeapSet(DCMSchedQueue *pQueue, INT32 idx, DCMScheduler *pJob)
+{
+    pQueue->ppHeap[idx] = pJob;
+    pJob->heapIdx = idx;
+}
+
+static VOID dcmSchedHeapUp(DCMSchedQueue *pQueue, INT32 idx)
+{
+    DCMScheduler *pJob = pQueue->ppHeap[idx];
+
+    while(idx > 0) {
+        INT32 parent = (idx - 1) / 2;
+        if(pQueue->ppHeap[parent]->nextRun <= pJob->nextRun) {
+            break;
+        }
+        dcmSchedHeapSet(pQueue, idx, pQueue->ppHeap[parent]);
+        idx = parent;
+    }
+    dcmSchedHeapSet(pQueue, idx, pJob);
+}
+
+static VOID dcmSchedHeapDown(DCMSchedQueue *pQueue, INT32 idx)
+{
+    DCMScheduler *pJob = pQueue->ppHeap[idx];
+
+    while(1) {
+        INT32 child = 2 * idx + 1;
+        if(child >= pQueue->count) {
+            break;
+        }
+        if(child + 1 < pQueue->count &&
+           pQueue->ppHeap[child + 1]->nextRun < pQueue->ppHeap[child]->nextRun) {
+            child++;
+        }
+        if(pJob->nextRun <= pQueue->ppHeap[child]->nextRun) {
+            break;
+        }
+        dcmSchedHeapSet(pQueue, idx, pQueue->ppHeap[child]);
+        idx = child;
+    }
+    dcmSchedHeapSet(pQueue, idx, pJob);
+}
+
+/** @brief Queues a job or moves it after its nextRun changed
+ *
+ *  @param[in]  pQueue  Scheduler state
+ *  @param[in]  pJob    Job with nextRun set
+ *
+ *  @return  Returns Status of the operation.
+ *  @retval  Returns DCM_SUCCESS on success, DCM_FAILURE otherwise.
+ */
+static INT32 dcmSchedHeapUpdate(DCMSchedQueue *pQueue, DCMScheduler *pJob)
+{
+    if(pJob->heapIdx >= 0) {
+        dcmSchedHeapUp(pQueue, pJob->heapIdx);
+        dcmSchedHeapDown(pQueue, pJob->heapIdx);
+        return DCM_SUCCESS;
+    }
+
+    if(pQueue->count == pQueue->size) {
+        INT32 size = pQueue->size ? pQueue->size * 2 : DCM_SCHED_HEAP_INIT;
+        DCMScheduler **ppHeap = realloc(pQueue->ppHeap, size * sizeof(DCMScheduler *));
+        if(ppHeap == NULL) {
+            DCMError("Failed to allocate memeory\n");
+            return DCM_FAILURE;
+        }
+        pQueue->ppHeap = ppHeap;
+        pQueue->size   = size;
+    }
+
+    dcmSchedHeapSet(pQueue, pQueue->count++, pJob);
+    dcmSchedHeapUp(pQueue, pJob->heapIdx);
+    return DCM_SUCCESS;
+}
+
+static VOID dcmSchedHeapRemove(DCMSchedQueue *pQueue, DCMScheduler *pJob)
+{
+    INT32 idx = pJob->heapIdx;
+
+    if(idx < 0) {
+        return;
+    }
+    pJob->heapIdx = -1;
+
+    if(idx != --pQueue->count) {
+        dcmSchedHeapSet(pQueue, idx, pQueue->ppHeap[pQueue->count]);
+        dcmSchedHeapUp(pQueue, idx);
+        dcmSchedHeapDown(pQueue, pQueue->ppHeap[idx]->heapIdx);
+    }
+}
+
+/** @brief Computes the next run of a started job after currentTime and queues it
+ *
+ *  @param[in]  pQueue       Scheduler state
+ *  @param[in]  pJob         Job to schedule
+ *  @param[in]  currentTime  Time the next run must follow
+ *
+ *  @return  Returns Status of the operation.
+ *  @retval  Returns DCM_SUCCESS on success, DCM_FAILURE if the job has no next run.
+ */
+static INT32 dcmSchedQueueNext(DCMSchedQueue *pQueue, DCMScheduler *pJob, time_t currentTime)
+{
+    time_t nextRun = dcmCronParseGetNext(&pJob->parseData, currentTime);
+
+    if(nextRun == (time_t)-1 || nextRun <= currentTime) {
+        DCMWarn("%s has no next run, job stopped\n", pJob->name);
+        pJob->startSched = false;
+        dcmSchedHeapRemove(pQueue, pJob);
+        return DCM_FAILURE;
+    }
+
+    pJob->nextRun = nextRun;
+    if(dcmSchedHeapUpdate(pQueue, pJob) != DCM_SUCCESS) {
+        pJob->startSched = false;
+        return DCM_FAILURE;
+    }
+    return DCM_SUCCESS;
+}
+
+/** @brief Wakes the scheduler thread to re-check the heap
+ *
+ *  @param[in]  pQueue  Scheduler state, tMutex held
+ */
+static VOID dcmSchedWake(DCMSchedQueue *pQueue)
+{
+    uint64_t one = 1;
+
+    if(pQueue->running && write(pQueue->wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        DCMWarn("Failed to wake scheduler: %s\n", strerror(errno));
+    }
+}
+
+/** @brief Recomputes the next run of every started job
+ *
+ *  @param[in]  pQueue       Scheduler state, tMutex held
+ *  @param[in]  currentTime  Time the next runs must follow
+ */
+static VOID dcmSchedRequeueAll(DCMSchedQueue *pQueue, time_t currentTime)
+{
+    INT32 i = 0;
+
+    while(i < pQueue->count) {
+        DCMScheduler *pJob = pQueue->ppHeap[i];
+        time_t nextRun = dcmCronParseGetNext(&pJob->parseData, currentTime);
+
+        if(nextRun == (time_t)-1 || nextRun <= currentTime) {
+            DCMWarn("%s has no next run, job stopped\n", pJob->name);
+            pJob->startSched = false;
+            dcmSchedHeapRemove(pQueue, pJob);
+            continue;   // The last job moved into slot i
+        }
+        pJob->nextRun = nextRun;
+        i++;
+    }
+
+    for(i = pQueue->count / 2 - 1; i >= 0; i--) {
+        dcmSchedHeapDown(pQueue, i);
+    }
+}
+
+/** @brief Detects a step of the wall clock since the last check
+ *
+ *  CLOCK_BOOTTIME keeps running through suspend and is never stepped, so
+ *  any change of CLOCK_REALTIME beyond it is a step. On a step the
+ *  schedule is rebuilt from the cron expressions and the step counted.
+ *
+ *  @param[in]  pQueue  Scheduler state, tMutex held
+ *
+ *  @return  Returns the step in seconds, 0 if the clock was not stepped.
+ */
+static INT64 dcmSchedCheckClock(DCMSchedQueue *pQueue)
+{
+    struct timespec nowReal, nowBoot;
+    INT64 jump = 0;
+
+    clock_gettime(CLOCK_REALTIME, &nowReal);
+    clock_gettime(CLOCK_BOOTTIME, &nowBoot);
+
+    if(pQueue->refReal.tv_sec != 0) {
+        jump = (INT64)(nowReal.tv_sec - pQueue->refReal.tv_sec) -
+               (INT64)(nowBoot.tv_sec - pQueue->refBoot.tv_sec);
+    }
+    pQueue->refReal = nowReal;
+    pQueue->refBoot = nowBoot;
+
+    if(jump > -DCM_SCHED_JUMP_MIN && jump < DCM_SCHED_JUMP_MIN) {
+        return 0;
+    }
+
+    pQueue->clockStats.jumps++;
+    pQueue->clockStats.lastJump = jump;
+    if(labs(jump) > labs(pQueue->clockStats.maxJump)) {
+        pQueue->clockStats.maxJump = jump;
+    }
+    DCMInfo("Clock stepped by %ld seconds, rescheduling %d jobs (step %u)\n",
+            jump, pQueue->count, pQueue->clockStats.jumps);
+
+    dcmSchedRequeueAll(pQueue, nowReal.tv_sec);
+    return jump;
+}
+
+/** @brief Arms the timer for the earliest next run, or disarms it
+ *
+ *  @param[in]  pQueue  Scheduler state, tMutex held
+ *
+ *  @return  Returns Status of the operation.
+ *  @retval  Returns DCM_SUCCESS on success, DCM_FAILURE otherwise.
+ */
+static INT32 dcmSchedArmTimer(DCMSchedQueue *pQueue)
+{
+    struct itimerspec timer;
+
+    memset(&timer, 0, sizeof(timer));
+    if(pQueue->count > 0) {
+        timer.it_value.tv_sec = pQueue->ppHeap[0]->nextRun;
+    }
+
+    if(timerfd_settime(pQueue->timerFd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &timer, NULL) != 0) {
+        DCMWarn("timerfd_settime failed: %s\n", strerror(errno));
+        return DCM_FAILURE;
+    }
+    return DCM_SUCCESS;
+}
+
+/* Worker queue helpers, called with tMutex held */
+
+static VOID dcmSchedEnqueue(DCMSchedQueue *pQueue, DCMScheduler *pJob)
+{
+    pJob->queued      = true;
+    pJob->pNextQueued = NULL;
+    if(pQueue->pQueueTail) {
+        pQueue->pQueueTail->pNextQueued = pJob;
+    }
+    else {
+        pQueue->pQueueHead = pJob;
+    }
+    pQueue->pQueueTail = pJob;
+    pthread_cond_signal(&pQueue->tWork);
+}
+
+static VOID dcmSchedUnlink(DCMSchedQueue *pQueue, DCMScheduler *pPrev, DCMScheduler *pJob)
+{
+    if(pPrev) {
+        pPrev->pNextQueued = pJob->pNextQueued;
+    }
+    else {
+        pQueue->pQueueHead = pJob->pNextQueued;
+    }
+    if(pQueue->pQueueTail == pJob) {
+        pQueue->pQueueTail = pPrev;
+    }
+    pJob->pNextQueued = NULL;
+    pJob->queued      = false;
+}
+
+/** @brief Drops a job's queued run, if any
+ *
+ *  @param[in]  pQueue  Scheduler state
+ *  @param[in]  pJob    Job to drop
+ */
+static VOID dcmSchedDequeueJob(DCMSchedQueue *pQueue, DCMScheduler *pJob)
+{
+    DCMScheduler *pPrev = NULL;
+    DCMScheduler *pCur  = pQueue->pQueueHead;
+
+    pJob->rerun = false;
+    while(pCur) {
+        if(pCur == pJob) {
+            dcmSchedUnlink(pQueue, pPrev, pCur);
+            return;
+        }
+        pPrev = pCur;
+        pCur  = pCur->pNextQueued;
+    }
+}
+
+/** @brief Takes the first queued job that is not running already
  *
- *  @param[in]  arg  Scheduler handle
+ *  @param[in]  pQueue  Scheduler state
+ *
+ *  @return  Returns the job, NULL if none can run now.
+ */
+static DCMScheduler* dcmSchedDequeue(DCMSchedQueue *pQueue)
+{
+    DCMScheduler *pPrev = NULL;
+    DCMScheduler *pCur  = pQueue->pQueueHead;
+
+    while(pCur) {
+        if(!pCur->running) {
+            dcmSchedUnlink(pQueue, pPrev, pCur);
+            return pCur;
+        }
+        pPrev = pCur;
+        pCur  = pCur->pNextQueued;
+    }
+    return NULL;
+}
+
+/** @brief Hands a fired job to the workers, applying its overlap policy
+ *
+ *  @param[in]  pQueue  Scheduler state
+ *  @param[in]  pJob    Fired job
+ */
+static VOID dcmSchedDispatch(DCMSchedQueue *pQueue, DCMScheduler *pJob)
+{
+    if(!pJob->queued && !pJob->running) {
+        dcmSchedEnqueue(pQueue, pJob);
+        return;
+    }
+
+    switch(pJob->overlap) {
+    case DCM_SCHED_QUEUE_ONE:
+        if(!pJob->queued) {
+            dcmSchedEnqueue(pQueue, pJob);
+            return;
+        }
+        break;
+    case DCM_SCHED_COALESCE:
+        if(pJob->queued || pJob->rerun) {
+            pJob->coalesced++;
+        }
+        else {
+            pJob->rerun = true;
+        }
+        return;
+    default:
+        break;
+    }
+
+    pJob->skipped++;
+    DCMInfo("%s previous run not finished, skipped %u runs\n", pJob->name, pJob->skipped);
+}
+
+/** @brief Worker thread, runs the callbacks of fired jobs
+ *
+ *  @param[in]  arg  Scheduler state
  *
  *  @return  Returns NULL.
  *  @retval  Returns NULL.
  */
-void* dcmSchedulerThread(void *arg)
+void* dcmSchedWorkerThread(void *arg)
 {
-    DCMScheduler *pDCMSched = (DCMScheduler *)arg;
-    INT32 n = 0;
-    struct timespec _now;
-    time_t timeOffset, currentTime;
+    DCMSchedQueue *pQueue = (DCMSchedQueue *)arg;
+    DCMScheduler *pJob = NULL;
 
+    pthread_mutex_lock(&pQueue->tMutex);
     while(1) {
-        pthread_mutex_lock(&pDCMSched->tMutex);
-
-        // Check termination condition while holding the lock
-        if(pDCMSched->terminated) {
-            pthread_mutex_unlock(&pDCMSched->tMutex);
+        while(!pQueue->terminated && (pJob = dcmSchedDequeue(pQueue)) == NULL) {
+            pthread_cond_wait(&pQueue->tWork, &pQueue->tMutex);
+        }
+        if(pQueue->terminated) {
             break;
         }
 
-        // Wait for scheduling to start - use proper loop for spurious wakeups
-        while(!pDCMSched->startSched && !pDCMSched->terminated) {
-            n = pthread_cond_wait(&pDCMSched->tCond, &pDCMSched->tMutex);
-            if(n != 0) {
-                DCMWarn("%s pthread_cond_wait failed: %d (%s)\n", pDCMSched->name, n, strerror(n));
-                pthread_mutex_unlock(&pDCMSched->tMutex);
-                goto thread_exit;
+        pJob->running = true;
+        pthread_mutex_unlock(&pQueue->tMutex);
+
+        DCMInfo("Scheduling %s Job handle: %p\n", pJob->name, pJob->pUserData);
+        if(pJob->pDcmCB) {
+            pJob->pDcmCB(pJob->name, pJob->pUserData);
+        }
+        else {
+            DCMWarn("%s Scheduler call back not registered\n", pJob->name);
+        }
+
+        pthread_mutex_lock(&pQueue->tMutex);
+        pJob->running = false;
+        if(pJob->rerun) {
+            pJob->rerun = false;
+            if(pJob->startSched) {
+                dcmSchedEnqueue(pQueue, pJob);
             }
         }
-        
-        // Check termination again after wait
-        if(pDCMSched->terminated) {
-            pthread_mutex_unlock(&pDCMSched->tMutex);
-            break;
+        else if(pJob->queued) {
+            // Queued behind its own run: runnable now
+            pthread_cond_signal(&pQueue->tWork);
         }
-        
-        if(pDCMSched->startSched) {
-            memset(&_now, 0, sizeof(struct timespec));
+        pthread_cond_broadcast(&pQueue->tIdle);
+    }
+    pthread_mutex_unlock(&pQueue->tMutex);
 
-            clock_gettime(CLOCK_REALTIME, &_now);
-            currentTime = _now.tv_sec;
+    return NULL;
+}
 
-            timeOffset = dcmCronParseGetNext(&pDCMSched->parseData, currentTime);
-            _now.tv_sec += (timeOffset - currentTime);
+/** @brief Scheduler thread
+ *
+ *  Sleeps until the earliest next run of all started jobs, then queues
+ *  the job's following run and hands the job to the workers.
+ *
+ *  @param[in]  arg  Scheduler state
+ *
+ *  @return  Returns NULL.
+ *  @retval  Returns NULL.
+ */
+void* dcmSchedulerThread(void *arg)
+{
+    DCMSchedQueue *pQueue = (DCMSchedQueue *)arg;
+    DCMScheduler *pJob = NULL;
+    struct pollfd fds[2];
+    struct timespec _now;
+    uint64_t count = 0;
 
-            // Wait with predicate re-check under lock to handle spurious wakeups
-            while(pDCMSched->startSched && !pDCMSched->terminated) {
-                n = pthread_cond_timedwait(&pDCMSched->tCond, &pDCMSched->tMutex, &_now);
+    pthread_mutex_lock(&pQueue->tMutex);
+    while(!pQueue->terminated) {
+        dcmSchedCheckClock(pQueue);
 
-                if(n == ETIMEDOUT) {
-                    break;
-                }
+        memset(&_now, 0, sizeof(struct timespec));
+        clock_gettime(CLOCK_REALTIME, &_now);
 
-                if(n != 0) {
-                    DCMWarn("%s pthread_cond_timedwait failed: %d (%s)\n", pDCMSched->name, n, strerror(n));
-                    pthread_mutex_unlock(&pDCMSched->tMutex);
-                    goto thread_exit;
-                }
+        if(pQueue->count == 0 || pQueue->ppHeap[0]->nextRun > _now.tv_sec) {
+            if(dcmSchedArmTimer(pQueue) != DCM_SUCCESS) {
+                break;
             }
-
-            if(pDCMSched->terminated) {
-                pthread_mutex_unlock(&pDCMSched->tMutex);
-                goto thread_exit;
+            pthread_mutex_unlock(&pQueue->tMutex);
+
+            fds[0].fd = pQueue->timerFd;
+            fds[0].events = POLLIN;
+            fds[1].fd = pQueue->wakeFd;
+            fds[1].events = POLLIN;
+            if(poll(fds, 2, -1) < 0 && errno != EINTR) {
+                DCMWarn("poll failed: %s\n", strerror(errno));
+                pthread_mutex_lock(&pQueue->tMutex);
+                break;
             }
 
-            if(n == ETIMEDOUT) {
-                DCMInfo("Scheduling %s Job handle: %p\n", pDCMSched->name, pDCMSched->pUserData);
-                if(pDCMSched->pDcmCB) {
-                    pDCMSched->pDcmCB(pDCMSched->name, pDCMSched->pUserData);
-                }
-                else {
-                    DCMWarn("%s Scheduler call back not registered\n", pDCMSched->name);
-                }
+            // ECANCELED on the timer means the clock was set: picked up by the next check
+            if((fds[0].revents & POLLIN) && read(pQueue->timerFd, &count, sizeof(count)) < 0 &&
+               errno == ECANCELED) {
+                DCMInfo("Wall clock was set\n");
             }
-            else if (n == 0) {
-                DCMInfo("%s Interrupted before TIMEOUT for profile\n", pDCMSched->name);
-            }
-            else {
-                DCMWarn("%s pthread_cond_timedwait ERROR!!!\n", pDCMSched->name);
+            if(fds[1].revents & POLLIN) {
+                read(pQueue->wakeFd, &count, sizeof(count));
             }
+
+            pthread_mutex_lock(&pQueue->tMutex);
+            continue;
         }
-        pthread_mutex_unlock(&pDCMSched->tMutex);
+
+        pJob = pQueue->ppHeap[0];
+        dcmSchedQueueNext(pQueue, pJob, _now.tv_sec);
+        dcmSchedDispatch(pQueue, pJob);
     }
-thread_exit:
+    pthread_mutex_unlock(&pQueue->tMutex);
+
     return NULL;
 }
 
-/** @brief This function wakes up the sleeping thread
+/** @brief This function starts a job or restarts it with a new pattern
  *
  *  @param[in]  pHandle       Scheduler handle
  *  @param[in]  pCronPattern  Cron pattern
@@ -152,23 +565,28 @@ INT32 dcmSchedStartJob(VOID *pHandle, INT8 *pCronPattern)
     }
 
     /* Start the scheduler */
-    pthread_mutex_lock(&pSchedHandle->tMutex);
+    pthread_mutex_lock(&g_dcmSched.tMutex);
     ret = dcmCronParseExp(pCronPattern, &pSchedHandle->parseData);
     if(ret == DCM_SUCCESS) {
         pSchedHandle->startSched = 1;
-        pthread_cond_signal(&pSchedHandle->tCond);
+        ret = dcmSchedQueueNext(&g_dcmSched, pSchedHandle, time(NULL));
+        dcmSchedWake(&g_dcmSched);
     }
     else {
         pSchedHandle->startSched = 0;
+        dcmSchedHeapRemove(&g_dcmSched, pSchedHandle);
         ret = DCM_FAILURE;
         DCMWarn ("Failed to parse log upload cron: %s \n", pCronPattern);
     }
-    pthread_mutex_unlock(&pSchedHandle->tMutex);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
 
     return ret;
 }
 
 /** @brief This function stops the scheduler
+ *
+ *  Drops a run that is queued but not started; a running callback
+ *  finishes.
  *
  *  @param[in]  pHandle       Scheduler handle
  *
@@ -186,15 +604,48 @@ INT32 dcmSchedStopJob(VOID *pHandle)
     }
 
     /* Stop the scheduler */
-    pthread_mutex_lock(&pSchedHandle->tMutex);
+    pthread_mutex_lock(&g_dcmSched.tMutex);
     pSchedHandle->startSched = 0;
-    pthread_cond_signal(&pSchedHandle->tCond);
-    pthread_mutex_unlock(&pSchedHandle->tMutex);
+    dcmSchedHeapRemove(&g_dcmSched, pSchedHandle);
+    dcmSchedDequeueJob(&g_dcmSched, pSchedHandle);
+    dcmSchedWake(&g_dcmSched);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
 
     return ret;
 }
 
+/** @brief This function sets what a fire does while the job's previous run is pending
+ *
+ *  @param[in]  pHandle  Scheduler handle
+ *  @param[in]  overlap  Overlap policy, DCM_SCHED_SKIP by default
+ *
+ *  @return  Returns Status of the operation.
+ *  @retval  Returns DCM_SUCCESS on success, DCM_FAILURE otherwise.
+ */
+INT32 dcmSchedSetOverlap(VOID *pHandle, DCMSchedOverlap overlap)
+{
+    DCMScheduler *pSchedHandle = pHandle;
+
+    if(pHandle == NULL) {
+        DCMError("Input Handle is NULL\n");
+        return DCM_FAILURE;
+    }
+
+    if(overlap < DCM_SCHED_SKIP || overlap > DCM_SCHED_COALESCE) {
+        DCMError("Invalid overlap policy: %d\n", overlap);
+        return DCM_FAILURE;
+    }
+
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    pSchedHandle->overlap = overlap;
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+
+    return DCM_SUCCESS;
+}
+
 /** @brief This Function adds the job to the Scheduler.
+ *
+ *  The job is queued once it is started with dcmSchedStartJob().
  *
  *  @param[in]  pJobName Scheduler name
  *  @param[in]  pDcmCB   Scheduler Callback function
@@ -206,7 +657,6 @@ INT32 dcmSchedStopJob(VOID *pHandle)
 VOID* dcmSchedAddJob(INT8 *pJobName, DCMSchedCB pDcmCB, VOID *pUsrData)
 {
     DCMScheduler *pSchedHandle = NULL;
-    INT32 ret = 0;
 
     if(pJobName == NULL) {
         DCMError("Name of the Job is NULL\n");
@@ -225,46 +675,21 @@ VOID* dcmSchedAddJob(INT8 *pJobName, DCMSchedCB pDcmCB, VOID *pUsrData)
     pSchedHandle->name       = pJobName;
     pSchedHandle->pDcmCB     = pDcmCB;
     pSchedHandle->pUserData  = pUsrData;
-    pSchedHandle->terminated = false;
     pSchedHandle->startSched = false;
-
-    if(pthread_mutex_init(&pSchedHandle->tMutex, NULL) != 0) {
-        DCMError("Mutex init has failed\n");
-        goto exit;
-    }
-    ret = pthread_cond_init(&pSchedHandle->tCond, NULL);
-    if(ret) {
-        DCMError("Conditional variable init has failed\n");
-        goto exit1;
-    }
-
-    ret = pthread_create(&pSchedHandle->tId, NULL, dcmSchedulerThread, (void*)pSchedHandle);
-    if(ret) {
-        DCMError("Failed to create thread\n");
-        goto exit2;
-    }
+    pSchedHandle->heapIdx    = -1;
+    pSchedHandle->overlap    = DCM_SCHED_SKIP;
 
     return pSchedHandle;
-
-exit2:
-    pthread_cond_destroy(&pSchedHandle->tCond);
-exit1:
-    pthread_mutex_destroy(&pSchedHandle->tMutex);
-exit:
-    if(pSchedHandle) {
-        free(pSchedHandle);
-        pSchedHandle = NULL;
-    }
-
-    return NULL;
 }
 
 /** @brief This Function removes the job from the Scheduler.
+ *
+ *  Waits for a running callback of the job to return.
  *
  *  @param[in]  pHandle Scheduler handle
  *
- *  @return  Returns the handle of the scheduler.
- *  @retval  Returns handle on success, NELL otherwise.
+ *  @return  Returns None.
+ *  @retval  Returns None.
  */
 VOID dcmSchedRemoveJob(VOID *pHandle)
 {
@@ -275,22 +700,23 @@ VOID dcmSchedRemoveJob(VOID *pHandle)
         return;
     }
 
-    pthread_mutex_lock(&pSchedHandle->tMutex);
+    pthread_mutex_lock(&g_dcmSched.tMutex);
     pSchedHandle->startSched = false;
-    pSchedHandle->terminated = true;
-    pthread_cond_signal(&pSchedHandle->tCond);
-    pthread_mutex_unlock(&pSchedHandle->tMutex);
-    pthread_join(pSchedHandle->tId, NULL);
-
-    pthread_mutex_destroy(&pSchedHandle->tMutex);
-    pthread_cond_destroy(&pSchedHandle->tCond);
-    pthread_detach(pSchedHandle->tId);
+    dcmSchedHeapRemove(&g_dcmSched, pSchedHandle);
+    dcmSchedDequeueJob(&g_dcmSched, pSchedHandle);
+    while(pSchedHandle->running) {
+        pthread_cond_wait(&g_dcmSched.tIdle, &g_dcmSched.tMutex);
+    }
+    dcmSchedWake(&g_dcmSched);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
 
     free(pSchedHandle);
     pSchedHandle = NULL;
 }
 
 /** @brief This Function Initializes the Scheduler.
+ *
+ *  Starts the scheduler thread and the workers that run all jobs.
  *
  *  @param[]  None
  *
@@ -299,11 +725,59 @@ VOID dcmSchedRemoveJob(VOID *pHandle)
  */
 INT32 dcmSchedInit()
 {
-    //For Future use
-    return DCM_SUCCESS;
+    INT32 ret = DCM_SUCCESS;
+
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    if(g_dcmSched.running == false) {
+        g_dcmSched.terminated = false;
+        g_dcmSched.timerFd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC);
+        g_dcmSched.wakeFd  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if(g_dcmSched.timerFd < 0 || g_dcmSched.wakeFd < 0) {
+            DCMError("Failed to create scheduler timer: %s\n", strerror(errno));
+            ret = DCM_FAILURE;
+        }
+        else if(pthread_create(&g_dcmSched.tId, NULL, dcmSchedulerThread, (void*)&g_dcmSched)) {
+            DCMError("Failed to create thread\n");
+            ret = DCM_FAILURE;
+        }
+        else {
+            g_dcmSched.running = true;
+            for(g_dcmSched.nWorkers = 0; g_dcmSched.nWorkers < DCM_SCHED_WORKERS; g_dcmSched.nWorkers++) {
+                if(pthread_create(&g_dcmSched.workers[g_dcmSched.nWorkers], NULL,
+                                  dcmSchedWorkerThread, (void*)&g_dcmSched)) {
+                    DCMWarn("Failed to create worker %d\n", g_dcmSched.nWorkers);
+                    break;
+                }
+            }
+        }
+
+        if(ret == DCM_SUCCESS && g_dcmSched.nWorkers == 0) {
+            pthread_mutex_unlock(&g_dcmSched.tMutex);
+            dcmSchedUnInit();
+            return DCM_FAILURE;
+        }
+
+        if(ret != DCM_SUCCESS) {
+            if(g_dcmSched.timerFd >= 0) {
+                close(g_dcmSched.timerFd);
+            }
+            if(g_dcmSched.wakeFd >= 0) {
+                close(g_dcmSched.wakeFd);
+            }
+            g_dcmSched.timerFd = -1;
+            g_dcmSched.wakeFd  = -1;
+        }
+    }
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+
+    return ret;
 }
 
 /** @brief This Function de-Initializes the Scheduler.
+ *
+ *  Stops the scheduler thread and the workers after running callbacks
+ *  return. Queued runs are dropped; jobs still added are left to
+ *  dcmSchedRemoveJob().
  *
  *  @param[]  None
  *
@@ -312,5 +786,53 @@ INT32 dcmSchedInit()
  */
 VOID dcmSchedUnInit()
 {
-    //For Future use
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    if(g_dcmSched.running == false) {
+        pthread_mutex_unlock(&g_dcmSched.tMutex);
+        return;
+    }
+    g_dcmSched.terminated = true;
+    dcmSchedWake(&g_dcmSched);
+    pthread_cond_broadcast(&g_dcmSched.tWork);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+
+    pthread_join(g_dcmSched.tId, NULL);
+    while(g_dcmSched.nWorkers > 0) {
+        pthread_join(g_dcmSched.workers[--g_dcmSched.nWorkers], NULL);
+    }
+
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    while(g_dcmSched.pQueueHead) {
+        dcmSchedDequeueJob(&g_dcmSched, g_dcmSched.pQueueHead);
+    }
+    g_dcmSched.running = false;
+    close(g_dcmSched.timerFd);
+    close(g_dcmSched.wakeFd);
+    g_dcmSched.timerFd = -1;
+    g_dcmSched.wakeFd  = -1;
+    if(g_dcmSched.count == 0) {
+        free(g_dcmSched.ppHeap);
+        g_dcmSched.ppHeap = NULL;
+        g_dcmSched.size   = 0;
+    }
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+}
+
+/** @brief This Function reports the wall-clock steps handled so far.
+ *
+ *  @param[out]  pStats  Receives the step count and sizes
+ *
+ *  @return  Returns None.
+ *  @retval  Returns None.
+ */
+VOID dcmSchedGetClockStats(DCMSchedClockStats *pStats)
+{
+    if(pStats == NULL) {
+        DCMError("Input Stats is NULL\n");
+        return;
+    }
+
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    *pStats = g_dcmSched.clockStats;
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
 }
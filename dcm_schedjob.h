@@ -28,20 +28,41 @@ extern "C"
 
 typedef VOID (*DCMSchedCB)(const INT8* profileName, VOID *pUsrData);
 
+/* What a fire does while the job's previous run has not finished */
+typedef enum _dcmSchedOverlap
+{
+    DCM_SCHED_SKIP = 0,     /* Drop the fire */
+    DCM_SCHED_QUEUE_ONE,    /* Queue one more run in fire order, drop further fires */
+    DCM_SCHED_COALESCE      /* Merge the fires into one run queued when the current run returns */
+}DCMSchedOverlap;
+
 typedef struct _dcmScheduler
 {
     INT8           *name;
-    BOOL            terminated;
     BOOL            startSched;
     dcmCronExpr     parseData;
-    pthread_t       tId;
-    pthread_mutex_t tMutex;
-    pthread_cond_t  tCond;
+    time_t          nextRun;    /* Next fire time while started */
+    INT32           heapIdx;    /* Position in the timer heap, -1 if not queued */
     DCMSchedCB      pDcmCB;
     VOID           *pUserData;
+    DCMSchedOverlap overlap;
+    BOOL            queued;     /* Waiting for a worker */
+    BOOL            running;    /* Callback running on a worker */
+    BOOL            rerun;      /* Coalesced fire to queue when the run returns */
+    UINT32          skipped;    /* Fires dropped by the overlap policy */
+    UINT32          coalesced;  /* Fires merged into another run */
+    struct _dcmScheduler *pNextQueued;
 
 }DCMScheduler;
 
+typedef struct _dcmSchedClockStats
+{
+    UINT32          jumps;      /* Wall-clock steps the schedule was recomputed for */
+    INT64           lastJump;   /* Size of the last step in seconds, negative if backwards */
+    INT64           maxJump;    /* Largest step in seconds, either direction */
+
+}DCMSchedClockStats;
+
 INT32 dcmSchedInit();
 VOID  dcmSchedUnInit();
 INT32 dcmSchedParseJobs();
@@ -49,6 +70,8 @@ VOID* dcmSchedAddJob(INT8 *pJobName, DCMSchedCB pDcmCB, VOID *pUsrData);
 VOID  dcmSchedRemoveJob(VOID *pHandle);
 INT32 dcmSchedStartJob(VOID *pHandle, INT8 *pCronPattern);
 INT32 dcmSchedStopJob(VOID *pHandle);
+INT32 dcmSchedSetOverlap(VOID *pHandle, DCMSchedOverlap overlap);
+VOID  dcmSchedGetClockStats(DCMSchedClockStats *pStats);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,49 @@
+####################################################################################
+# If not stated otherwise in this file or this component's LICENSE file
+# following copyright and licenses apply:
+#
+# Copyright 2025 RDK Management
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+##################################################################################
+
+Feature: uploadSTBLogs Multipart Upload of Large Archives
+
+  @multipart @upload @positive
+  Scenario: Large archive is uploaded in parts
+    Given LOG_UPLOAD_MULTIPART_MB is set to 5 in include.properties
+    And a local stand-in server implements the metadata endpoint and S3 multipart upload
+    And log files larger than the threshold are available for upload
+    When uploadSTBLogs uploads the archive
+    Then a multipart upload should be started once
+    And the archive should be sent as parts of LOG_UPLOAD_PART_MB
+    And the multipart upload should be completed
+    And no single PUT should be sent
+    And the part manifest should be removed
+
+  @multipart @retry @negative
+  Scenario: Failed part is retried on its own
+    Given multipart upload is enabled
+    And the stand-in server fails the first PUT of part 2
+    When uploadSTBLogs uploads the archive
+    Then part 2 should be sent twice
+    And the other parts should be sent once
+    And the multipart upload should be completed
+
+  @multipart @fallback @negative
+  Scenario: Server without multipart support
+    Given multipart upload is enabled
+    And the stand-in server refuses CreateMultipartUpload with HTTP 405
+    When uploadSTBLogs uploads the archive
+    Then no part should be sent
+    And the archive should be sent in a single PUT
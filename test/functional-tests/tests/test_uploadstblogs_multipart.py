@@ -0,0 +1,190 @@
+####################################################################################
+# If not stated otherwise in this file or this component's LICENSE file the
+# following copyright and licenses apply:
+#
+# Copyright 2025 RDK Management
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+####################################################################################
+
+"""
+Test cases for uploadSTBLogs S3 multipart upload
+Covers: part upload, per-part retry, fallback to a single PUT
+"""
+
+import pytest
+import re
+import subprocess
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from uploadstblogs_helper import *
+from helper_functions import *
+
+UPLOAD_ID = "l2-upload-1"
+MULTIPART_MANIFEST = "/opt/.upload_multipart"
+
+
+class MultipartStandIn(ThreadingHTTPServer):
+    """Metadata endpoint plus the S3 multipart protocol on one local port"""
+
+    daemon_threads = True
+
+    def __init__(self):
+        super().__init__(("127.0.0.1", 0), MultipartHandler)
+        self.lock = threading.Lock()
+        self.create_status = 200
+        self.fail_part = 0
+        self.fail_times = 0
+        self.creates = 0
+        self.completes = 0
+        self.part_puts = {}
+        self.parts = {}
+        self.single_put = None
+        self.assembled = None
+
+    @property
+    def url(self):
+        return f"http://127.0.0.1:{self.server_address[1]}/"
+
+
+class MultipartHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, format, *args):
+        pass
+
+    def _body(self):
+        # Expect: 100-continue is answered by BaseHTTPRequestHandler
+        return self.rfile.read(int(self.headers.get("Content-Length", 0)))
+
+    def _reply(self, status, payload=b"", headers=None):
+        self.send_response(status)
+        for key, value in (headers or {}).items():
+            self.send_header(key, value)
+        self.send_header("Content-Length", str(len(payload)))
+        self.end_headers()
+        self.wfile.write(payload)
+
+    def do_POST(self):
+        srv = self.server
+        body = self._body()
+        with srv.lock:
+            if "uploads" in self.path.split("?", 1)[-1].split("&"):
+                srv.creates += 1
+                if srv.create_status != 200:
+                    return self._reply(srv.create_status)
+                xml = f"<InitiateMultipartUploadResult><UploadId>{UPLOAD_ID}</UploadId></InitiateMultipartUploadResult>"
+                return self._reply(200, xml.encode())
+            if f"uploadId={UPLOAD_ID}" in self.path:
+                srv.completes += 1
+                numbers = [int(n) for n in re.findall(rb"<PartNumber>(\d+)</PartNumber>", body)]
+                if numbers != sorted(srv.parts):
+                    return self._reply(400)
+                srv.assembled = b"".join(srv.parts[n] for n in numbers)
+                return self._reply(200, b"<CompleteMultipartUploadResult></CompleteMultipartUploadResult>")
+        # Metadata POST: answer with the object URL
+        return self._reply(200, f"{srv.url}bucket/logs.tgz?X-Sig=l2".encode())
+
+    def do_PUT(self):
+        srv = self.server
+        body = self._body()
+        match = re.search(r"partNumber=(\d+)", self.path)
+        with srv.lock:
+            if not match:
+                srv.single_put = body
+                return self._reply(200)
+            part = int(match.group(1))
+            srv.part_puts[part] = srv.part_puts.get(part, 0) + 1
+            if part == srv.fail_part and srv.fail_times != 0:
+                srv.fail_times -= 1
+                return self._reply(500)
+            srv.parts[part] = body
+            return self._reply(200, headers={"ETag": f'"etag-{part}"'})
+
+
+def remove_include_property(key):
+    subprocess.run(f"sed -i '/^{key}=/d' {INCLUDE_PROPERTIES}", shell=True)
+
+
+class TestMultipartUpload:
+    """Test suite for multipart upload of large archives"""
+
+    @pytest.fixture(autouse=True)
+    def setup_and_teardown(self):
+        """Start the stand-in server and enable multipart for archives above 5 MB"""
+        clear_uploadstb_logs()
+        remove_lock_file()
+        cleanup_test_log_files("large_test")
+        restore_device_properties()
+        subprocess.run(f"rm -f {MULTIPART_MANIFEST}", shell=True)
+        set_include_property("LOG_UPLOAD_MULTIPART_MB", "5")
+        set_include_property("LOG_UPLOAD_PART_MB", "5")
+        set_include_property("LOG_UPLOAD_PART_PARALLEL", "2")
+        self.server = MultipartStandIn()
+        thread = threading.Thread(target=self.server.serve_forever, daemon=True)
+        thread.start()
+        # Random data does not compress, so the archive stays above the threshold
+        create_large_test_log_files(count=2, size_mb=6)
+        yield
+        self.server.shutdown()
+        self.server.server_close()
+        for key in ("LOG_UPLOAD_MULTIPART_MB", "LOG_UPLOAD_PART_MB", "LOG_UPLOAD_PART_PARALLEL"):
+            remove_include_property(key)
+        subprocess.run(f"rm -f {MULTIPART_MANIFEST}", shell=True)
+        cleanup_test_log_files("large_test")
+        remove_lock_file()
+        kill_uploadstblogs()
+
+    def run_upload(self):
+        return subprocess.run(f"/usr/local/bin/logupload '' 1 1 true HTTP {self.server.url} >> {UPLOADSTB_LOG}",
+                              shell=True, timeout=300)
+
+    @pytest.mark.order(1)
+    def test_large_archive_uploaded_in_parts(self):
+        """Test: archive above the threshold is sent as parts and completed"""
+        result = self.run_upload()
+
+        assert result.returncode in [0, 1], "Upload process should complete"
+        assert self.server.creates == 1, "One multipart upload should be started"
+        assert len(self.server.parts) >= 3, "A 12 MB archive should be split into 5 MB parts"
+        assert self.server.completes == 1, "The multipart upload should be completed"
+        assert len(self.server.assembled) > 10 * 1024 * 1024, "All parts should reach the server"
+        assert self.server.single_put is None, "No single PUT should be sent"
+        assert not os.path.exists(MULTIPART_MANIFEST), "Manifest should be removed after completion"
+
+    @pytest.mark.order(2)
+    def test_failed_part_retried_alone(self):
+        """Test: a failed part is resent without resending the others"""
+        self.server.fail_part = 2
+        self.server.fail_times = 1
+
+        self.run_upload()
+
+        assert self.server.part_puts.get(2) == 2, "Failed part should be sent twice"
+        assert self.server.part_puts.get(1) == 1, "Other parts should be sent once"
+        assert self.server.completes == 1, "The multipart upload should be completed"
+        retry_logs = grep_uploadstb_logs_regex(r"Part 2 failed.*retrying")
+        assert len(retry_logs) > 0, "Part retry should be logged"
+
+    @pytest.mark.order(3)
+    def test_refused_multipart_falls_back_to_single_put(self):
+        """Test: server without multipart support gets the archive in one PUT"""
+        self.server.create_status = 405
+
+        self.run_upload()
+
+        assert self.server.creates == 1, "Multipart upload should be attempted"
+        assert not self.server.part_puts, "No part should be sent"
+        assert self.server.single_put is not None, "Archive should be sent in a single PUT"
+        fallback_logs = grep_uploadstb_logs_regex(r"Multipart upload not available")
+        assert len(fallback_logs) > 0, "Fallback should be logged"
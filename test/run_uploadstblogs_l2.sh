@@ -126,6 +126,11 @@ echo "8. Running Upload Strategy Tests..."
 pytest -v --json-report --json-report-summary \
     --json-report-file $RESULT_DIR/upload_strategies.json test/functional-tests/tests/test_uploadstblogs_upload_strategies.py
 
+echo ""
+echo "9. Running Multipart Upload Tests..."
+pytest -v --json-report --json-report-summary \
+    --json-report-file $RESULT_DIR/multipart.json test/functional-tests/tests/test_uploadstblogs_multipart.py
+
 echo ""
 echo "10. Running Sync Gate - backup_logs Sentinel Tests..."
 pytest -v --json-report --json-report-summary \
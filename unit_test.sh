@@ -97,6 +97,12 @@ for test in \
   ./../uploadstblogs/unittest/strategies_gtest \
   ./../uploadstblogs/unittest/strategy_handler_gtest \
   ./../uploadstblogs/unittest/uploadlogsnow_gtest \
+  ./../uploadstblogs/unittest/parallel_gzip_gtest \
+  ./../uploadstblogs/unittest/upload_index_gtest \
+  ./../uploadstblogs/unittest/upload_http_gtest \
+  ./../uploadstblogs/unittest/upload_multipart_gtest \
+  ./../uploadstblogs/unittest/upload_hedge_gtest \
+  ./../uploadstblogs/unittest/upload_spool_gtest \
   ./../usbLogUpload/unittest/usb_log_file_manager_gtest \
   ./../usbLogUpload/unittest/usb_log_validation_gtest \
   ./../usbLogUpload/unittest/usb_log_utils_gtest \
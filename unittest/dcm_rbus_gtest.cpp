@@ -92,6 +92,7 @@ TEST_F(DcmRbusTest, dcmRbusInit_Success) {
     
     EXPECT_EQ(result, DCM_SUCCESS);
     EXPECT_NE(handle, nullptr);
+    EXPECT_GE(dcmRbusGetEventFd(handle), 0);
     
     // Cleanup
     if (handle) {
@@ -442,6 +443,7 @@ protected:
         dcmRbusHandle->pRbusHandle = mockHandle;
         dcmRbusHandle->eventSub = 0;
         dcmRbusHandle->schedJob = 0; // Initially not scheduled
+        dcmRbusHandle->eventFd = -1;
         strcpy(dcmRbusHandle->confPath, "/etc/dcm.conf");
         
         // Initialize event structure
@@ -599,6 +601,33 @@ TEST_F(RbusProcConfTest , dcmRbusGetConfPath_dcmrbus_handle_null)
 {
     EXPECT_EQ(dcmRbusGetConfPath(nullptr), NULL);
 }
+TEST_F(RbusProcConfTest, EventFd_SignalledByCallbacks)
+{
+    uint64_t count = 0;
+    dcmRbusHandle->eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    ASSERT_GE(dcmRbusHandle->eventFd, 0);
+    EXPECT_EQ(dcmRbusGetEventFd(dcmRbusHandle), dcmRbusHandle->eventFd);
+
+    // Nothing pending until a callback runs
+    EXPECT_LT(read(dcmRbusHandle->eventFd, &count, sizeof(count)), 0);
+
+    get_rbusAsyncSubCB(mockHandle, &testSubscription, RBUS_ERROR_SUCCESS);
+    get_rbusProcConf(mockHandle, &testEvent, &testSubscription);
+    ASSERT_EQ(read(dcmRbusHandle->eventFd, &count, sizeof(count)), (ssize_t)sizeof(count));
+    EXPECT_EQ(count, 2u);
+
+    get_rbusProcConf(mockHandle, &testEvent, &testSubscription);
+    dcmRbusClearEvent(dcmRbusHandle);
+    EXPECT_LT(read(dcmRbusHandle->eventFd, &count, sizeof(count)), 0);
+
+    close(dcmRbusHandle->eventFd);
+}
+TEST_F(RbusProcConfTest, EventFd_NullHandle)
+{
+    EXPECT_EQ(dcmRbusGetEventFd(nullptr), -1);
+    dcmRbusClearEvent(nullptr);
+    dcmRbusClearEvent(dcmRbusHandle);
+}
 TEST_F(RbusProcConfTest , dcmRbusSchedResetStatus_success)
 {
     dcmRbusHandle->schedJob = 1;
@@ -21,6 +21,12 @@
 #include <cstring>
 #include <stdio.h>
 #include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <algorithm>
 #include "dcm_cronparse.h"
 #include "dcm_types.h"
 #include "dcm_schedjob.h"
@@ -81,331 +87,507 @@ void resetTestGlobals() {
     g_lastUserData = nullptr;
 }
 
-// ======================= Test Fixture with Proper Cron Data Initialization =======================
+// ======================= Test Fixture =======================
 class DcmSchedulerThreadTest : public ::testing::Test {
 protected:
     void SetUp() override {
         resetTestGlobals();
-        
-        // Initialize scheduler structure with proper memory management
-        memset(&scheduler, 0, sizeof(DCMScheduler));
-        
-        // Allocate and set job name safely
-        jobName = new char[32];
-        strcpy(jobName, "TestJob");
-        scheduler.name = (INT8*)jobName;
-        
-        scheduler.pDcmCB = safeTestCallback;
-        scheduler.pUserData = (void*)0x12345678;
-        scheduler.terminated = false;
-        scheduler.startSched = false;
-        
-        // Properly initialize the cron parse data
-        memset(&scheduler.parseData, 0, sizeof(scheduler.parseData));
-        
-        // Initialize with a valid cron expression BEFORE starting the thread
-        const char* validCronExpr = "*/5 * * * *"; // Every 5 minutes
-        INT32 parseResult = dcmCronParseExp(validCronExpr, &scheduler.parseData);
-        if (parseResult != DCM_SUCCESS) {
-            // Fallback to a simpler expression
-            parseResult = dcmCronParseExp("* * * * *", &scheduler.parseData);
-        }
-        ASSERT_EQ(parseResult, DCM_SUCCESS) << "Failed to parse cron expression";
-        
-        // Initialize threading primitives with error checking
-        int mutexResult = pthread_mutex_init(&scheduler.tMutex, NULL);
-        ASSERT_EQ(mutexResult, 0) << "Failed to initialize mutex: " << strerror(mutexResult);
-        
-        int condResult = pthread_cond_init(&scheduler.tCond, NULL);
-        ASSERT_EQ(condResult, 0) << "Failed to initialize condition variable: " << strerror(condResult);
-        
-        threadCreated = false;
-        mutexInitialized = true;
-        condInitialized = true;
+        memset(&g_dcmSched.clockStats, 0, sizeof(g_dcmSched.clockStats));
+        ASSERT_EQ(dcmSchedInit(), DCM_SUCCESS);
     }
-    
+
     void TearDown() override {
-        // Clean shutdown if thread was created
-        if (threadCreated) {
-            terminateThreadSafely();
-        }
-        
-        // Cleanup threading primitives
-        if (mutexInitialized) {
-            pthread_mutex_destroy(&scheduler.tMutex);
-            mutexInitialized = false;
-        }
-        
-        if (condInitialized) {
-            pthread_cond_destroy(&scheduler.tCond);
-            condInitialized = false;
-        }
-        
-        // Clean up allocated memory
-        if (jobName) {
-            delete[] jobName;
-            jobName = nullptr;
+        for (void* handle : handles) {
+            dcmSchedStopJob(handle);
+            dcmSchedRemoveJob(handle);
         }
-        
+        handles.clear();
+        dcmSchedUnInit();
         resetTestGlobals();
     }
-    
-    bool createThread() {
-        if (threadCreated) {
-            return false; // Thread already created
-        }
-        
-        int result = pthread_create(&scheduler.tId, NULL, dcmSchedulerThread, &scheduler);
-        if (result != 0) {
-            ADD_FAILURE() << "Failed to create thread: " << strerror(result);
-            return false;
-        }
-        
-        threadCreated = true;
-        usleep(20000); // Give thread more time to start
-        return true;
-    }
-    
-    void terminateThreadSafely() {
-        if (!threadCreated) return;
-        
-        // Set termination flag safely
-        if (mutexInitialized) {
-            pthread_mutex_lock(&scheduler.tMutex);
-            scheduler.terminated = true;
-            if (condInitialized) {
-                pthread_cond_signal(&scheduler.tCond);
-            }
-            pthread_mutex_unlock(&scheduler.tMutex);
-        } else {
-            scheduler.terminated = true;
-        }
-        
-        // Wait for thread with timeout
-        struct timespec timeout;
-        clock_gettime(CLOCK_REALTIME, &timeout);
-        timeout.tv_sec += 5; // 5 second timeout
-        
-        int joinResult = pthread_join(scheduler.tId, NULL);
-        if (joinResult != 0) {
-            // Force thread termination if join fails
-            pthread_cancel(scheduler.tId);
-            pthread_join(scheduler.tId, NULL);
-        }
-        
-        threadCreated = false;
-    }
-    
-    bool startScheduling() {
-        if (!mutexInitialized || !condInitialized) {
-            return false;
+
+    DCMScheduler* addJob(const char* name, DCMSchedCB cb = safeTestCallback, void* userData = (void*)0x12345678) {
+        DCMScheduler* job = (DCMScheduler*)dcmSchedAddJob((INT8*)name, cb, userData);
+        EXPECT_NE(job, nullptr);
+        if (job) {
+            handles.push_back(job);
         }
-        
-        pthread_mutex_lock(&scheduler.tMutex);
-        scheduler.startSched = true;
-        pthread_cond_signal(&scheduler.tCond);
-        pthread_mutex_unlock(&scheduler.tMutex);
-        return true;
+        return job;
     }
-    
-    bool stopScheduling() {
-        if (!mutexInitialized || !condInitialized) {
-            return false;
-        }
-        
-        pthread_mutex_lock(&scheduler.tMutex);
-        scheduler.startSched = false;
-        pthread_cond_signal(&scheduler.tCond);
-        pthread_mutex_unlock(&scheduler.tMutex);
-        return true;
+
+    // Move a started job's next run to now + offset seconds
+    void setNextRun(DCMScheduler* job, time_t offset) {
+        pthread_mutex_lock(&g_dcmSched.tMutex);
+        job->nextRun = time(NULL) + offset;
+        dcmSchedHeapUpdate(&g_dcmSched, job);
+        dcmSchedWake(&g_dcmSched);
+        pthread_mutex_unlock(&g_dcmSched.tMutex);
     }
-    
-    bool signalCondition() {
-        if (!mutexInitialized || !condInitialized) {
-            return false;
+
+    bool waitForCallbacks(int count, int timeoutMs) {
+        for (int i = 0; i < timeoutMs / 10; i++) {
+            if (g_callbackCount.load() >= count) {
+                return true;
+            }
+            usleep(10000);
         }
-        
-        pthread_mutex_lock(&scheduler.tMutex);
-        pthread_cond_signal(&scheduler.tCond);
-        pthread_mutex_unlock(&scheduler.tMutex);
-        return true;
+        return g_callbackCount.load() >= count;
     }
-    
-    DCMScheduler scheduler;
-    char* jobName;
-    bool threadCreated;
-    bool mutexInitialized;
-    bool condInitialized;
+
+    vector<void*> handles;
 };
 
-// ======================= Basic Thread Lifecycle Tests =======================
+// ======================= Scheduler Thread Tests =======================
 
 TEST_F(DcmSchedulerThreadTest, ThreadStarts_WaitsInInitialState) {
-    ASSERT_TRUE(createThread());
-    
-    // Thread should be waiting on condition variable
-    usleep(100000); // 100ms - longer wait
-    
-    // No callback should be executed yet
+    addJob("TestJob");
+    usleep(100000); // 100ms
+
+    // No callback without a started job
     EXPECT_FALSE(g_callbackExecuted);
     EXPECT_EQ(g_callbackCount.load(), 0);
-    EXPECT_FALSE(scheduler.startSched);
+    EXPECT_TRUE(g_dcmSched.running);
+    EXPECT_EQ(g_dcmSched.count, 0);
 }
 
-TEST_F(DcmSchedulerThreadTest, ThreadTerminates_WhenTerminatedFlagSet) {
-    ASSERT_TRUE(createThread());
-    
-    // Brief wait to ensure thread is running
-    usleep(50000); // 50ms
-    
-    // Signal termination
-    terminateThreadSafely();
-    
-    // Thread should have exited cleanly
-    EXPECT_TRUE(scheduler.terminated);
+TEST_F(DcmSchedulerThreadTest, InitTwice_KeepsOneThread) {
+    pthread_t tId = g_dcmSched.tId;
+    EXPECT_EQ(dcmSchedInit(), DCM_SUCCESS);
+    EXPECT_TRUE(pthread_equal(tId, g_dcmSched.tId));
 }
 
-TEST_F(DcmSchedulerThreadTest, ThreadWakesUp_OnConditionSignal_WithoutScheduling) {
-    ASSERT_TRUE(createThread());
-    
-    // Signal without starting scheduling
-    ASSERT_TRUE(signalCondition());
-    
-    // Give thread time to process
-    usleep(100000); // 100ms
-    
-    // Thread should wake up but not execute callback
-    EXPECT_FALSE(g_callbackExecuted);
-    EXPECT_FALSE(scheduler.startSched);
+TEST_F(DcmSchedulerThreadTest, UnInit_StopsThread) {
+    dcmSchedUnInit();
+    EXPECT_FALSE(g_dcmSched.running);
+    dcmSchedUnInit();
+    EXPECT_EQ(dcmSchedInit(), DCM_SUCCESS);
+    EXPECT_TRUE(g_dcmSched.running);
 }
 
-// ======================= Test with Quick Cron Expression =======================
+TEST_F(DcmSchedulerThreadTest, ThreadExecutesCallback_WhenDue) {
+    DCMScheduler* job = addJob("TestJob");
+    ASSERT_EQ(dcmSchedStartJob(job, (INT8*)"*/5 * * * *"), DCM_SUCCESS);
+    EXPECT_GT(job->nextRun, time(NULL));
+
+    setNextRun(job, 0);
+    ASSERT_TRUE(waitForCallbacks(1, 3000));
+    EXPECT_STREQ(g_lastJobName, "TestJob");
+    EXPECT_EQ(g_lastUserData.load(), (void*)0x12345678);
+
+    // The job is queued for its following run
+    usleep(50000);
+    EXPECT_EQ(g_callbackCount.load(), 1);
+    EXPECT_GT(job->nextRun, time(NULL));
+    EXPECT_EQ(job->heapIdx, 0);
+}
 
 TEST_F(DcmSchedulerThreadTest, ThreadExecutesCallback_QuickCron) {
-    // Reinitialize with a cron expression that triggers every minute
-    const char* quickCronExpr = "* * * * *"; // Every minute
-    memset(&scheduler.parseData, 0, sizeof(scheduler.parseData));
-    INT32 parseResult = dcmCronParseExp(quickCronExpr, &scheduler.parseData);
-    ASSERT_EQ(parseResult, DCM_SUCCESS);
-    
-    ASSERT_TRUE(createThread());
-    ASSERT_TRUE(startScheduling());
-    
+    DCMScheduler* job = addJob("TestJob");
+    ASSERT_EQ(dcmSchedStartJob(job, (INT8*)"* * * * *"), DCM_SUCCESS);
+
     // Wait up to 70 seconds (to account for minute boundary)
-    bool callbackReceived = false;
-    
-    for (int i = 0; i < 700; i++) { // 70 seconds
-        usleep(100000); // 100ms intervals 100000
-        if (g_callbackExecuted) {
-            callbackReceived = true;
-            break;
-        }
-        
-        if (i % 100 == 0 && i > 0) {
-            printf("DEBUG: Waiting for minute boundary... %d seconds elapsed\n", i/10);
-        }
-    }
-    EXPECT_TRUE(callbackReceived) << "Callback was not executed within 70 seconds"; 
+    EXPECT_TRUE(waitForCallbacks(1, 70000)) << "Callback was not executed within 70 seconds";
 }
 
 TEST_F(DcmSchedulerThreadTest, ThreadHandlesNullCallback_Gracefully) {
-    // Set callback to NULL
-    scheduler.pDcmCB = nullptr;
-    
-    ASSERT_TRUE(createThread());
-    ASSERT_TRUE(startScheduling());
-    
-    // Wait for timeout
-    usleep(1500000); // 1.5 seconds
-    
-    // No callback should execute, but thread should continue
-    EXPECT_FALSE(g_callbackExecuted);
-    EXPECT_EQ(g_callbackCount.load(), 0);
+    DCMScheduler* nullJob = addJob("NullJob", nullptr);
+    DCMScheduler* job = addJob("TestJob");
+    ASSERT_EQ(dcmSchedStartJob(nullJob, (INT8*)"* * * * *"), DCM_SUCCESS);
+    ASSERT_EQ(dcmSchedStartJob(job, (INT8*)"* * * * *"), DCM_SUCCESS);
+
+    setNextRun(nullJob, 0);
+    setNextRun(job, 0);
+
+    // The thread keeps going after the job without a callback
+    ASSERT_TRUE(waitForCallbacks(1, 3000));
+    EXPECT_STREQ(g_lastJobName, "TestJob");
+}
+
+TEST_F(DcmSchedulerThreadTest, ManyJobs_AllRunWhenDue) {
+    static vector<string> order;
+    static pthread_mutex_t orderLock = PTHREAD_MUTEX_INITIALIZER;
+    order.clear();
+    DCMSchedCB record = [](const INT8* name, VOID*) {
+        pthread_mutex_lock(&orderLock);
+        order.push_back(name);
+        pthread_mutex_unlock(&orderLock);
+        g_callbackCount++;
+    };
+
+    const char* names[] = {"JobA", "JobB", "JobC", "JobD"};
+    DCMScheduler* jobs[4];
+    for (int i = 0; i < 4; i++) {
+        jobs[i] = addJob(names[i], record);
+        ASSERT_EQ(dcmSchedStartJob(jobs[i], (INT8*)"0 0 1 1 *"), DCM_SUCCESS);
+    }
+    EXPECT_EQ(g_dcmSched.count, 4);
+
+    // Due in reverse order of adding
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    time_t now = time(NULL);
+    for (int i = 0; i < 4; i++) {
+        jobs[i]->nextRun = now - i;
+        dcmSchedHeapUpdate(&g_dcmSched, jobs[i]);
+    }
+    dcmSchedWake(&g_dcmSched);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+
+    // Workers run them concurrently: fire order is covered by the heap test
+    ASSERT_TRUE(waitForCallbacks(4, 3000));
+    pthread_mutex_lock(&orderLock);
+    sort(order.begin(), order.end());
+    EXPECT_EQ(order, vector<string>({"JobA", "JobB", "JobC", "JobD"}));
+    pthread_mutex_unlock(&orderLock);
 }
 
 // ======================= Start/Stop Scheduling Tests =======================
 
 TEST_F(DcmSchedulerThreadTest, ThreadResponds_ToStartScheduling) {
-    ASSERT_TRUE(createThread());
-    
-    // Initially not scheduling
-    EXPECT_FALSE(scheduler.startSched);
-    
-    // Start scheduling
-    ASSERT_TRUE(startScheduling());
-    
-    // Verify flag is set
-    EXPECT_TRUE(scheduler.startSched);
+    DCMScheduler* job = addJob("TestJob");
+    EXPECT_FALSE(job->startSched);
+    EXPECT_EQ(job->heapIdx, -1);
+
+    ASSERT_EQ(dcmSchedStartJob(job, (INT8*)"* * * * *"), DCM_SUCCESS);
+    EXPECT_TRUE(job->startSched);
+    EXPECT_EQ(job->heapIdx, 0);
+
+    // Restarting reschedules in place
+    ASSERT_EQ(dcmSchedStartJob(job, (INT8*)"*/5 * * * *"), DCM_SUCCESS);
+    EXPECT_EQ(g_dcmSched.count, 1);
 }
 
 TEST_F(DcmSchedulerThreadTest, ThreadResponds_ToStopScheduling) {
-    ASSERT_TRUE(createThread());
-    ASSERT_TRUE(startScheduling());
-    
-    // Wait for scheduling to start
-    usleep(100000); // 100ms
-    EXPECT_TRUE(scheduler.startSched);
-    
-    // Stop scheduling
-    ASSERT_TRUE(stopScheduling());
-    
-    // Verify flag is cleared
-    EXPECT_FALSE(scheduler.startSched);
-    
-    // Thread should go back to waiting state
-    usleep(100000); // 100ms
+    DCMScheduler* job = addJob("TestJob");
+    ASSERT_EQ(dcmSchedStartJob(job, (INT8*)"* * * * *"), DCM_SUCCESS);
+
+    EXPECT_EQ(dcmSchedStopJob(job), DCM_SUCCESS);
+    EXPECT_FALSE(job->startSched);
+    EXPECT_EQ(job->heapIdx, -1);
+    EXPECT_EQ(g_dcmSched.count, 0);
+
+    // A stopped job does not fire
+    job->nextRun = time(NULL);
+    usleep(100000);
+    EXPECT_EQ(g_callbackCount.load(), 0);
 }
 
 // ======================= Synchronization Tests =======================
 
-TEST_F(DcmSchedulerThreadTest, ThreadSynchronization_MutexProtection) {
-    ASSERT_TRUE(createThread());
-    
-    // Rapidly change state while thread is running
+TEST_F(DcmSchedulerThreadTest, ThreadSynchronization_RapidStartStop) {
+    DCMScheduler* job = addJob("TestJob");
+
     for (int i = 0; i < 10; i++) {
-        pthread_mutex_lock(&scheduler.tMutex);
-        scheduler.startSched = (i % 2 == 0);
-        pthread_cond_signal(&scheduler.tCond);
-        pthread_mutex_unlock(&scheduler.tMutex);
-        
+        if (i % 2 == 0) {
+            EXPECT_EQ(dcmSchedStartJob(job, (INT8*)"* * * * *"), DCM_SUCCESS);
+        } else {
+            EXPECT_EQ(dcmSchedStopJob(job), DCM_SUCCESS);
+        }
         usleep(10000); // 10ms between changes
     }
-    
-    // Thread should handle rapid state changes
-    usleep(200000); // 200ms final wait
-    
-    // No crash or deadlock should occur
+    EXPECT_EQ(g_dcmSched.count, 0);
 }
 
-// ======================= Resource Management Tests =======================
+TEST_F(DcmSchedulerThreadTest, RemoveJob_WaitsForRunningCallback) {
+    g_callbackShouldDelay = true;
+    DCMScheduler* job = addJob("TestJob");
+    handles.clear();
+    ASSERT_EQ(dcmSchedStartJob(job, (INT8*)"* * * * *"), DCM_SUCCESS);
+    setNextRun(job, 0);
 
-TEST_F(DcmSchedulerThreadTest, ThreadCleanup_ProperResourceRelease) {
-    ASSERT_TRUE(createThread());
-    ASSERT_TRUE(startScheduling());
-    
-    // Let thread run briefly
-    usleep(200000); // 200ms
-    
-    // Clean termination should release resources properly
-    terminateThreadSafely();
-    
-    // Thread should have cleaned up
-    EXPECT_TRUE(scheduler.terminated);
+    for (int i = 0; i < 300 && !g_callbackInProgress; i++) {
+        usleep(1000);
+    }
+    ASSERT_TRUE(g_callbackInProgress);
+    dcmSchedRemoveJob(job);
+    EXPECT_FALSE(g_callbackInProgress);
+    EXPECT_EQ(g_dcmSched.count, 0);
 }
 
+// ======================= Worker Pool Tests =======================
+
+static std::atomic<bool> g_release{false};
+static std::atomic<int> g_blockedRuns{0};
+
+// Runs until the test releases it
+void blockingCallback(const INT8* jobName, void* userData) {
+    g_blockedRuns++;
+    g_callbackInProgress = true;
+    while (!g_release) {
+        usleep(1000);
+    }
+    g_callbackInProgress = false;
+}
+
+class DcmSchedWorkerTest : public DcmSchedulerThreadTest {
+protected:
+    void SetUp() override {
+        g_release = false;
+        g_blockedRuns = 0;
+        DcmSchedulerThreadTest::SetUp();
+    }
+
+    void TearDown() override {
+        g_release = true;
+        DcmSchedulerThreadTest::TearDown();
+    }
+
+    void fire(DCMScheduler* job) {
+        pthread_mutex_lock(&g_dcmSched.tMutex);
+        dcmSchedDispatch(&g_dcmSched, job);
+        pthread_mutex_unlock(&g_dcmSched.tMutex);
+    }
+
+    bool waitFor(std::function<bool()> cond, int timeoutMs = 3000) {
+        for (int i = 0; i < timeoutMs && !cond(); i++) {
+            usleep(1000);
+        }
+        return cond();
+    }
+};
+
+TEST_F(DcmSchedWorkerTest, SlowJob_DoesNotDelayOtherJobs) {
+    DCMScheduler* slow = addJob("SlowJob", blockingCallback);
+    DCMScheduler* fast = addJob("FastJob");
+    ASSERT_EQ(dcmSchedStartJob(slow, (INT8*)"* * * * *"), DCM_SUCCESS);
+    ASSERT_EQ(dcmSchedStartJob(fast, (INT8*)"* * * * *"), DCM_SUCCESS);
+
+    setNextRun(slow, 0);
+    ASSERT_TRUE(waitFor([] { return g_callbackInProgress.load(); }));
+    setNextRun(fast, 0);
+    EXPECT_TRUE(waitForCallbacks(1, 1000));
+    EXPECT_STREQ(g_lastJobName, "FastJob");
+
+    // The slow job's following run was queued on time
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    EXPECT_GT(slow->nextRun, time(NULL));
+    EXPECT_GE(slow->heapIdx, 0);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+}
+
+TEST_F(DcmSchedWorkerTest, ControlPath_NotBlockedByCallback) {
+    DCMScheduler* job = addJob("SlowJob", blockingCallback);
+    ASSERT_EQ(dcmSchedStartJob(job, (INT8*)"* * * * *"), DCM_SUCCESS);
+    setNextRun(job, 0);
+    ASSERT_TRUE(waitFor([] { return g_callbackInProgress.load(); }));
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(dcmSchedStopJob(job), DCM_SUCCESS);
+    EXPECT_EQ(dcmSchedStartJob(job, (INT8*)"*/5 * * * *"), DCM_SUCCESS);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    EXPECT_LT(elapsed, 100);
+    EXPECT_TRUE(g_callbackInProgress);
+}
+
+TEST_F(DcmSchedWorkerTest, Overlap_SkipDropsFires) {
+    DCMScheduler* job = addJob("SlowJob", blockingCallback);
+    job->startSched = true;
+    fire(job);
+    ASSERT_TRUE(waitFor([] { return g_callbackInProgress.load(); }));
+    fire(job);
+    fire(job);
+    EXPECT_EQ(job->skipped, 2u);
+    EXPECT_FALSE(job->queued);
+
+    g_release = true;
+    ASSERT_TRUE(waitFor([&] { return !job->running; }));
+    usleep(50000);
+    EXPECT_EQ(g_blockedRuns.load(), 1);
+}
+
+TEST_F(DcmSchedWorkerTest, Overlap_QueueOneKeepsOneRun) {
+    DCMScheduler* job = addJob("SlowJob", blockingCallback);
+    ASSERT_EQ(dcmSchedSetOverlap(job, DCM_SCHED_QUEUE_ONE), DCM_SUCCESS);
+    job->startSched = true;
+    fire(job);
+    ASSERT_TRUE(waitFor([] { return g_callbackInProgress.load(); }));
+    fire(job);
+    fire(job);
+    EXPECT_TRUE(job->queued);
+    EXPECT_EQ(job->skipped, 1u);
+
+    // Never on two workers at once
+    usleep(50000);
+    EXPECT_EQ(g_blockedRuns.load(), 1);
+
+    g_release = true;
+    ASSERT_TRUE(waitFor([] { return g_blockedRuns.load() == 2; }));
+    ASSERT_TRUE(waitFor([&] { return !job->running && !job->queued; }));
+    EXPECT_EQ(g_blockedRuns.load(), 2);
+}
+
+TEST_F(DcmSchedWorkerTest, Overlap_CoalesceMergesFires) {
+    DCMScheduler* job = addJob("SlowJob", blockingCallback);
+    ASSERT_EQ(dcmSchedSetOverlap(job, DCM_SCHED_COALESCE), DCM_SUCCESS);
+    job->startSched = true;
+    fire(job);
+    ASSERT_TRUE(waitFor([] { return g_callbackInProgress.load(); }));
+    fire(job);
+    fire(job);
+    fire(job);
+    EXPECT_TRUE(job->rerun);
+    EXPECT_FALSE(job->queued);
+    EXPECT_EQ(job->coalesced, 2u);
+    EXPECT_EQ(job->skipped, 0u);
+
+    g_release = true;
+    ASSERT_TRUE(waitFor([] { return g_blockedRuns.load() == 2; }));
+    ASSERT_TRUE(waitFor([&] { return !job->running && !job->queued; }));
+    EXPECT_EQ(g_blockedRuns.load(), 2);
+}
+
+TEST_F(DcmSchedWorkerTest, Stop_DropsQueuedRun) {
+    DCMScheduler* job = addJob("SlowJob", blockingCallback);
+    ASSERT_EQ(dcmSchedSetOverlap(job, DCM_SCHED_QUEUE_ONE), DCM_SUCCESS);
+    job->startSched = true;
+    fire(job);
+    ASSERT_TRUE(waitFor([] { return g_callbackInProgress.load(); }));
+    fire(job);
+    EXPECT_TRUE(job->queued);
+
+    EXPECT_EQ(dcmSchedStopJob(job), DCM_SUCCESS);
+    EXPECT_FALSE(job->queued);
+    g_release = true;
+    ASSERT_TRUE(waitFor([&] { return !job->running; }));
+    usleep(50000);
+    EXPECT_EQ(g_blockedRuns.load(), 1);
+}
+
+TEST_F(DcmSchedWorkerTest, SetOverlap_RejectsBadInput) {
+    DCMScheduler* job = addJob("TestJob");
+    EXPECT_EQ(job->overlap, DCM_SCHED_SKIP);
+    EXPECT_EQ(dcmSchedSetOverlap(nullptr, DCM_SCHED_SKIP), DCM_FAILURE);
+    EXPECT_EQ(dcmSchedSetOverlap(job, (DCMSchedOverlap)7), DCM_FAILURE);
+    EXPECT_EQ(dcmSchedSetOverlap(job, DCM_SCHED_COALESCE), DCM_SUCCESS);
+    EXPECT_EQ(job->overlap, DCM_SCHED_COALESCE);
+}
+
+// ======================= Timer Heap Tests =======================
+
+TEST_F(DcmSchedulerThreadTest, Heap_KeepsEarliestFirstAcrossUpdates) {
+    DCMScheduler jobs[16];
+    dcmSchedUnInit();
+
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    for (int i = 0; i < 16; i++) {
+        memset(&jobs[i], 0, sizeof(DCMScheduler));
+        jobs[i].heapIdx = -1;
+        jobs[i].nextRun = 1000 + (i * 7) % 16;
+        ASSERT_EQ(dcmSchedHeapUpdate(&g_dcmSched, &jobs[i]), DCM_SUCCESS);
+    }
+    jobs[3].nextRun = 1;
+    dcmSchedHeapUpdate(&g_dcmSched, &jobs[3]);
+    jobs[5].nextRun = 5000;
+    dcmSchedHeapUpdate(&g_dcmSched, &jobs[5]);
+    dcmSchedHeapRemove(&g_dcmSched, &jobs[9]);
+    dcmSchedHeapRemove(&g_dcmSched, &jobs[9]);
+    EXPECT_EQ(g_dcmSched.count, 15);
+    EXPECT_EQ(g_dcmSched.ppHeap[0], &jobs[3]);
+
+    time_t last = 0;
+    while (g_dcmSched.count > 0) {
+        DCMScheduler* top = g_dcmSched.ppHeap[0];
+        EXPECT_EQ(top->heapIdx, 0);
+        EXPECT_GE(top->nextRun, last);
+        last = top->nextRun;
+        dcmSchedHeapRemove(&g_dcmSched, top);
+    }
+    EXPECT_EQ(last, 5000);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+}
+
+// ======================= Clock Step Tests =======================
+
+TEST_F(DcmSchedulerThreadTest, ClockStep_RecomputesEveryJob) {
+    DCMScheduler* yearly = addJob("Yearly");
+    DCMScheduler* hourly = addJob("Hourly");
+    ASSERT_EQ(dcmSchedStartJob(yearly, (INT8*)"30 0 1 1 *"), DCM_SUCCESS);
+    ASSERT_EQ(dcmSchedStartJob(hourly, (INT8*)"0 * * * *"), DCM_SUCCESS);
+    dcmSchedUnInit();
+
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    EXPECT_EQ(dcmSchedCheckClock(&g_dcmSched), 0);
+
+    // Runs computed against a wrong clock
+    yearly->nextRun = 100;
+    hourly->nextRun = 200;
+    dcmSchedHeapUpdate(&g_dcmSched, yearly);
+    dcmSchedHeapUpdate(&g_dcmSched, hourly);
+
+    // Wall clock stepped forward by an hour
+    g_dcmSched.refReal.tv_sec -= 3600;
+    INT64 jump = dcmSchedCheckClock(&g_dcmSched);
+    EXPECT_GE(jump, 3600 - 1);
+    EXPECT_LE(jump, 3600 + 1);
+
+    time_t now = time(NULL);
+    EXPECT_EQ(hourly->nextRun, dcmCronParseGetNext(&hourly->parseData, now));
+    EXPECT_EQ(yearly->nextRun, dcmCronParseGetNext(&yearly->parseData, now));
+    EXPECT_EQ(g_dcmSched.ppHeap[0], hourly);
+    EXPECT_EQ(g_dcmSched.count, 2);
+
+    // And back by two
+    g_dcmSched.refReal.tv_sec += 7200;
+    EXPECT_LE(dcmSchedCheckClock(&g_dcmSched), -7200 + 1);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+
+    DCMSchedClockStats stats;
+    dcmSchedGetClockStats(&stats);
+    EXPECT_EQ(stats.jumps, 2u);
+    EXPECT_LE(stats.lastJump, -7200 + 1);
+    EXPECT_EQ(stats.maxJump, stats.lastJump);
+    dcmSchedGetClockStats(nullptr);
+}
+
+TEST_F(DcmSchedulerThreadTest, ClockStep_SmallDriftIgnored) {
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    dcmSchedCheckClock(&g_dcmSched);
+    g_dcmSched.refReal.tv_sec -= DCM_SCHED_JUMP_MIN - 1;
+    EXPECT_EQ(dcmSchedCheckClock(&g_dcmSched), 0);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+
+    DCMSchedClockStats stats;
+    dcmSchedGetClockStats(&stats);
+    EXPECT_EQ(stats.jumps, 0u);
+}
+
+TEST_F(DcmSchedulerThreadTest, ClockStep_HandledByThread) {
+    DCMScheduler* job = addJob("TestJob");
+    ASSERT_EQ(dcmSchedStartJob(job, (INT8*)"0 * * * *"), DCM_SUCCESS);
+    usleep(50000);
+
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    g_dcmSched.refReal.tv_sec += 86400;
+    job->nextRun = time(NULL) + 999999;
+    dcmSchedHeapUpdate(&g_dcmSched, job);
+    dcmSchedWake(&g_dcmSched);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+
+    DCMSchedClockStats stats;
+    memset(&stats, 0, sizeof(stats));
+    for (int i = 0; i < 300 && stats.jumps == 0; i++) {
+        usleep(10000);
+        dcmSchedGetClockStats(&stats);
+    }
+    EXPECT_EQ(stats.jumps, 1u);
+    pthread_mutex_lock(&g_dcmSched.tMutex);
+    EXPECT_LE(job->nextRun, time(NULL) + 3600);
+    pthread_mutex_unlock(&g_dcmSched.tMutex);
+
+    // No callback fired for the step itself
+    EXPECT_EQ(g_callbackCount.load(), 0);
+}
 
 class DcmSchedStartJobTest : public ::testing::Test {
 protected:
-    DCMScheduler sched;
+    DCMScheduler* sched;
 
     void SetUp() override {
-        memset(&sched, 0, sizeof(sched));
-        pthread_mutex_init(&sched.tMutex, nullptr);
-        pthread_cond_init(&sched.tCond, nullptr);
+        sched = (DCMScheduler*)dcmSchedAddJob((INT8*)"TestJob", nullptr, nullptr);
+        ASSERT_NE(sched, nullptr);
     }
     void TearDown() override {
-        pthread_mutex_destroy(&sched.tMutex);
-        pthread_cond_destroy(&sched.tCond);
+        dcmSchedRemoveJob(sched);
     }
 };
 
@@ -415,37 +597,37 @@ TEST_F(DcmSchedStartJobTest, NullHandleReturnsFailure) {
 }
 
 TEST_F(DcmSchedStartJobTest, NullPatternReturnsFailure) {
-    INT32 ret = dcmSchedStartJob(&sched, nullptr);
+    INT32 ret = dcmSchedStartJob(sched, nullptr);
     EXPECT_EQ(ret, DCM_FAILURE);
 }
 
 TEST_F(DcmSchedStartJobTest, CronParseSuccessSetsStartSchedAndSignals) {
-    sched.startSched = 0;
-    INT32 ret = dcmSchedStartJob(&sched, (INT8*)"* * * * *");
+    sched->startSched = 0;
+    INT32 ret = dcmSchedStartJob(sched, (INT8*)"* * * * *");
     EXPECT_EQ(ret, DCM_SUCCESS);
-    EXPECT_EQ(sched.startSched, 1);
+    EXPECT_EQ(sched->startSched, 1);
+    EXPECT_GE(sched->heapIdx, 0);
 }
 
 TEST_F(DcmSchedStartJobTest, CronParseFailUnsetsStartSched) {
-    sched.startSched = 1;
-    INT32 ret = dcmSchedStartJob(&sched, (INT8*)"fail");
+    ASSERT_EQ(dcmSchedStartJob(sched, (INT8*)"* * * * *"), DCM_SUCCESS);
+    INT32 ret = dcmSchedStartJob(sched, (INT8*)"fail");
     EXPECT_EQ(ret, DCM_FAILURE);
-    EXPECT_EQ(sched.startSched, 0);
+    EXPECT_EQ(sched->startSched, 0);
+    EXPECT_EQ(sched->heapIdx, -1);
 }
 
 class DcmSchedStopJobTest : public ::testing::Test {
 protected:
-    DCMScheduler sched;
+    DCMScheduler* sched;
 
     void SetUp() override {
-        memset(&sched, 0, sizeof(sched));
-        pthread_mutex_init(&sched.tMutex, nullptr);
-        pthread_cond_init(&sched.tCond, nullptr);
-        sched.startSched = 1;
+        sched = (DCMScheduler*)dcmSchedAddJob((INT8*)"TestJob", nullptr, nullptr);
+        ASSERT_NE(sched, nullptr);
+        dcmSchedStartJob(sched, (INT8*)"* * * * *");
     }
     void TearDown() override {
-        pthread_mutex_destroy(&sched.tMutex);
-        pthread_cond_destroy(&sched.tCond);
+        dcmSchedRemoveJob(sched);
     }
 };
 
@@ -455,10 +637,11 @@ TEST_F(DcmSchedStopJobTest, NullHandleReturnsFailure) {
 }
 
 TEST_F(DcmSchedStopJobTest, StopJobSetsStartSchedToZeroAndReturnsSuccess) {
-    sched.startSched = 1;
-    INT32 ret = dcmSchedStopJob(&sched);
+    sched->startSched = 1;
+    INT32 ret = dcmSchedStopJob(sched);
     EXPECT_EQ(ret, DCM_SUCCESS);
-    EXPECT_EQ(sched.startSched, 0);
+    EXPECT_EQ(sched->startSched, 0);
+    EXPECT_EQ(sched->heapIdx, -1);
 }
 
 // Simple test callback
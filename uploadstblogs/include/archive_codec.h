@@ -0,0 +1,169 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file archive_codec.h
+ * @brief Compression codecs behind the TAR writer
+ *
+ * gzip is always built. zstd and lz4 are compiled in with HAVE_ZSTD and
+ * HAVE_LZ4 (configure --enable-zstd / --enable-lz4) and are selected at
+ * runtime through RuntimeContext.archive_codec.
+ */
+
+#ifndef ARCHIVE_CODEC_H
+#define ARCHIVE_CODEC_H
+
+#include "uploadstblogs_types.h"
+
+/* Archive file extensions, one per codec */
+#define ARCHIVE_EXT_GZIP    ".tgz"
+#define ARCHIVE_EXT_ZSTD    ".tar.zst"
+#define ARCHIVE_EXT_LZ4     ".tar.lz4"
+
+/**
+ * @brief Opaque compressed output stream
+ */
+typedef struct ArchiveWriter ArchiveWriter;
+
+/**
+ * @brief Parse a codec name ("gzip", "zstd" or "lz4")
+ * @param name Codec name, case-insensitive
+ * @param codec Receives the codec
+ * @return true if the name is known, false otherwise
+ */
+bool archive_codec_parse(const char* name, ArchiveCodec* codec);
+
+/**
+ * @brief Check whether a codec was compiled in
+ * @param codec Codec to check
+ * @return true if archives can be written with it
+ */
+bool archive_codec_available(ArchiveCodec codec);
+
+/**
+ * @brief Get the printable name of a codec
+ * @param codec Codec
+ * @return Codec name, "gzip" for unknown values
+ */
+const char* archive_codec_name(ArchiveCodec codec);
+
+/**
+ * @brief Get the archive file extension for a codec
+ * @param codec Codec
+ * @return Extension including the leading dot, ".tgz" for unknown values
+ */
+const char* archive_codec_extension(ArchiveCodec codec);
+
+/**
+ * @brief Check whether a file name ends in any known archive extension
+ * @param name File name
+ * @return true for .tgz, .tar.zst and .tar.lz4 names
+ */
+bool archive_codec_is_archive_name(const char* name);
+
+/**
+ * @brief Build a gzopen() write mode string such as "wb6" or "wb1R"
+ * @param buffer Buffer to store the mode
+ * @param buffer_size Size of buffer
+ * @param level gzip level 0-9
+ * @param strategy zlib strategy
+ * @return true on success, false on invalid input
+ */
+bool build_gz_mode(char* buffer, size_t buffer_size, int level, int strategy);
+
+/**
+ * @brief Create an archive file with the given codec
+ * @param codec Codec to use
+ * @param path Output file path
+ * @param level Compression level 1-9 (zstd uses it as-is, lz4 switches
+ *              to HC from level 3)
+ * @param strategy zlib strategy, ignored by other codecs
+ * @param threads Worker threads, 0/1 = single-threaded
+ * @return Writer handle, or NULL if the codec is unavailable or the file
+ *         could not be created
+ */
+ArchiveWriter* archive_writer_open(ArchiveCodec codec, const char* path,
+                                   int level, int strategy, int threads);
+
+/**
+ * @brief Compress and write data
+ *
+ * A failed write leaves the stream unusable: later writes fail and
+ * archive_writer_close() returns -1.
+ *
+ * @param writer Writer handle
+ * @param buf Uncompressed data
+ * @param len Number of bytes
+ * @return 0 on success, -1 on failure
+ */
+int archive_writer_write(ArchiveWriter* writer, const void* buf, size_t len);
+
+/**
+ * @brief Pass data through uncompressed, or go back to the open level
+ *
+ * For members that are already compressed. gzip switches to level 0
+ * (stored deflate blocks) mid-stream; the output stays one standard
+ * gzip stream. zstd and lz4 keep their level and return -1. A switch
+ * that fails part-way fails the stream as a failed write does.
+ *
+ * @param writer Writer handle
+ * @param stored true for stored blocks, false to restore the level
+ * @return 0 on success, -1 if the codec cannot change level
+ */
+int archive_writer_set_stored(ArchiveWriter* writer, bool stored);
+
+/**
+ * @brief Get the number of bytes written in stored mode so far
+ * @param writer Writer handle
+ * @return Byte count, or -1 if writer is NULL
+ */
+long archive_writer_stored_bytes(const ArchiveWriter* writer);
+
+/**
+ * @brief Get the number of uncompressed bytes written so far
+ * @param writer Writer handle
+ * @return Byte count, or -1 if writer is NULL
+ */
+long archive_writer_bytes_in(const ArchiveWriter* writer);
+
+/**
+ * @brief Describe the writer for logging, e.g. "gzip wb6" or "zstd 3x4"
+ * @param writer Writer handle
+ * @return Description string owned by the writer
+ */
+const char* archive_writer_describe(const ArchiveWriter* writer);
+
+/**
+ * @brief Finish the stream, close the file and free the writer
+ *
+ * The digests cover the archive file exactly as written and match
+ * calculate_file_md5() / calculate_file_sha256() on it. Outputs are left
+ * empty if they could not be computed.
+ *
+ * @param writer Writer handle (invalid after this call)
+ * @param md5_base64 Receives the base64 MD5 of the archive (min 25 bytes, may be NULL)
+ * @param md5_size Size of md5_base64
+ * @param sha256_hex Receives the hex SHA256 of the archive (min 65 bytes, may be NULL)
+ * @param sha256_size Size of sha256_hex
+ * @return 0 on success, -1 on failure or if any earlier write failed
+ */
+int archive_writer_close(ArchiveWriter* writer, char* md5_base64, size_t md5_size,
+                         char* sha256_hex, size_t sha256_size);
+
+#endif /* ARCHIVE_CODEC_H */
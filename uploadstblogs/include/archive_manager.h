@@ -32,7 +32,9 @@
 #ifndef ARCHIVE_MANAGER_H
 #define ARCHIVE_MANAGER_H
 
+#include <sys/types.h>
 #include "uploadstblogs_types.h"
+#include "archive_codec.h"
 
 /* ==========================
    Log Collection
@@ -124,4 +126,218 @@ int create_dri_archive(RuntimeContext* ctx, SessionState* session, const char* a
 bool generate_archive_name(char* buffer, size_t buffer_size, 
                            const char* mac_address, const char* prefix);
 
+/**
+ * @brief Called with the full archive path once the archive file is open, before any data is written
+ */
+typedef void (*ArchiveNamedHook)(RuntimeContext* ctx, SessionState* session, const char* archive_path);
+
+/**
+ * @brief Install the hook run by the create_archive functions once the archive is opened
+ * @param hook Hook to run, or NULL to remove it
+ */
+void set_archive_named_hook(ArchiveNamedHook hook);
+
+/* ==========================
+   Compression Settings
+   ========================== */
+
+/**
+ * @brief Resolve the gzip level and strategy configured for the trigger type
+ * @param ctx Runtime context (NULL = defaults)
+ * @param level Receives 1-9 or COMPRESSION_LEVEL_AUTO (may be NULL)
+ * @param strategy Receives a zlib strategy (may be NULL)
+ *
+ * Unset or out-of-range levels resolve to 9, the historical default.
+ */
+void get_compression_params(const RuntimeContext* ctx, int* level, int* strategy);
+
+/**
+ * @brief Pick the cheapest gzip level whose sample ratio meets a target
+ * @param sample Leading bytes of the input
+ * @param len Sample length
+ * @param strategy zlib strategy used for the trial
+ * @param target_pct Acceptable compressed size as % of input (0 = default)
+ * @return Level 1 if it meets the target, else level 6 if that does, else level 1
+ *
+ * Input that misses the target at both levels is treated as incompressible.
+ */
+int select_compression_level(const unsigned char* sample, size_t len, int strategy, int target_pct);
+
+/* ==========================
+   Manifest Archives
+   ========================== */
+
+/**
+ * @brief Single archive member: where to read it and what to call it
+ */
+typedef struct {
+    char* src_path;             /* Source file on disk */
+    char* arcname;              /* Member name inside the archive */
+    off_t offset;               /* First byte to archive (incremental uploads) */
+    off_t length;               /* Bytes to archive, -1 = to end of file, 0 = skip */
+    off_t omitted;              /* Leading bytes dropped by the size limits, noted in or beside the member */
+} ArchiveManifestEntry;
+
+/**
+ * @brief List of files to stream into an archive without staging copies
+ */
+typedef struct {
+    ArchiveManifestEntry* entries;
+    size_t count;
+    size_t capacity;
+    bool keep_head;             /* Size limits cut entries at the end (incremental uploads) */
+} ArchiveManifest;
+
+/**
+ * @brief Initialize an empty manifest
+ * @param manifest Manifest to initialize
+ */
+void archive_manifest_init(ArchiveManifest* manifest);
+
+/**
+ * @brief Release all entries held by a manifest
+ * @param manifest Manifest to free (left empty and reusable)
+ */
+void archive_manifest_free(ArchiveManifest* manifest);
+
+/**
+ * @brief Append a single file to the manifest
+ * @param manifest Manifest to append to
+ * @param src_path Source file path
+ * @param arcname Member name inside the archive
+ * @return 0 on success, -1 on failure
+ */
+int archive_manifest_add(ArchiveManifest* manifest, const char* src_path, const char* arcname);
+
+/**
+ * @brief Recursively append the contents of a directory to the manifest
+ * @param manifest Manifest to append to
+ * @param src_dir Source directory
+ * @param arc_prefix Member name prefix for the directory contents
+ * @return Number of entries added, or -1 on error
+ *
+ * Files under src_dir are named <arc_prefix>/<relative path> in the archive.
+ */
+int archive_manifest_add_dir(ArchiveManifest* manifest, const char* src_dir, const char* arc_prefix);
+
+/**
+ * @brief Check whether any manifest member lives under a directory name
+ * @param manifest Manifest to search
+ * @param arc_dir Top-level member directory name
+ * @return true if a member named <arc_dir>/... exists
+ */
+bool archive_manifest_has_dir(const ArchiveManifest* manifest, const char* arc_dir);
+
+/**
+ * @brief Append the most recent PCAP file to the manifest if enabled
+ * @param ctx Runtime context
+ * @param manifest Manifest to append to
+ * @return Number of files added, or -1 on error
+ */
+int collect_pcap_to_manifest(const RuntimeContext* ctx, ArchiveManifest* manifest);
+
+/**
+ * @brief Create tar.gz archive by streaming manifest entries in place
+ * @param ctx Runtime context
+ * @param session Session state
+ * @param manifest Files to archive
+ * @param output_dir Directory the archive is written to
+ * @return 0 on success, -1 on failure
+ *
+ * Sources are read directly; nothing is copied into output_dir except
+ * the archive itself. On return, each manifest entry holds the byte range
+ * that went into the archive, with length 0 for entries left out.
+ */
+int create_archive_from_manifest(RuntimeContext* ctx, SessionState* session,
+                                 ArchiveManifest* manifest, const char* output_dir);
+
+/* ==========================
+   Archive Size Limits
+   ========================== */
+
+/* Defaults when LOG_UPLOAD_MAX_ARCHIVE_MB / LOG_UPLOAD_MAX_FILE_MB are unset */
+#define ARCHIVE_BUDGET_DIRECT_MB    256     /**< Direct (S3) uploads */
+#define ARCHIVE_BUDGET_CODEBIG_MB   64      /**< CodeBig-only devices, proxied uploads */
+#define ARCHIVE_FILE_CAP_MB         32      /**< Per-file tail kept */
+
+/**
+ * @brief Resolve the archive byte budget and per-file cap
+ * @param ctx Runtime context (NULL = direct-path defaults)
+ * @param budget Receives the budget in bytes, -1 = unlimited (may be NULL)
+ * @param file_cap Receives the per-file cap in bytes, -1 = unlimited (may be NULL)
+ *
+ * An unset budget follows the endpoint: devices with the direct path
+ * blocked upload through CodeBig and get the smaller default.
+ */
+void get_archive_limits(const RuntimeContext* ctx, long long* budget, long long* file_cap);
+
+/**
+ * @brief Fit manifest entries into a byte budget
+ * @param manifest Manifest to adjust in place
+ * @param budget Max bytes of file content plus TAR headers, -1 = unlimited
+ * @param file_cap Max bytes per file, -1 = unlimited
+ * @return Number of files trimmed or dropped, or -1 on error
+ *
+ * Files over file_cap keep only their last file_cap bytes. If the total
+ * is still over budget, entries are reordered by priority (crash data,
+ * then current logs, then other files, then rotated logs) and the first
+ * entry that does not fit keeps its tail; everything after is dropped.
+ * With keep_head set, trimmed entries keep their first bytes instead, so
+ * an incremental upload can send the rest next time.
+ */
+int archive_manifest_apply_limits(ArchiveManifest* manifest, long long budget, long long file_cap);
+
+/* ==========================
+   Member Name Rules
+   ========================== */
+
+/**
+ * @brief Rewriting rule for top-level archive member names
+ *
+ * Lets strategies present timestamped names inside the archive without
+ * renaming anything on disk. Names starting with '.' or already carrying
+ * the prefix are never rewritten.
+ */
+typedef struct {
+    char prefix[32];                /* Prepended to member names, "" = none */
+    bool skip_backups;              /* Keep bak1_/bak2_/bak3_ names unchanged */
+    bool skip_stamped;              /* Keep names already containing -NN[AP]M- */
+    const char* const* keep_names;  /* NULL-terminated exact names kept unchanged */
+} ArchiveNameRule;
+
+/**
+ * @brief Initialize a rule with the script timestamp prefix
+ * @param rule Rule to initialize
+ * @param ref_time Time used for the MM-DD-YY-HH-MMAM/PM- prefix
+ * @return true on success, false if the prefix could not be formatted
+ *
+ * Backup files are skipped, other options are off.
+ */
+bool archive_name_rule_init(ArchiveNameRule* rule, time_t ref_time);
+
+/**
+ * @brief Apply a rule to a single top-level name
+ * @param rule Rule to apply (NULL = keep name)
+ * @param name Original name
+ * @param buffer Buffer to receive the member name
+ * @param buffer_size Size of buffer
+ * @return true on success, false on invalid input or truncation
+ */
+bool archive_name_rule_apply(const ArchiveNameRule* rule, const char* name,
+                             char* buffer, size_t buffer_size);
+
+/**
+ * @brief Create tar.gz archive from directory with rewritten member names
+ * @param ctx Runtime context
+ * @param session Session state
+ * @param source_dir Source directory to archive (also the output directory)
+ * @param rule Name rule for top-level members (NULL = keep names)
+ * @param extra Additional files appended as-is (may be NULL)
+ * @return 0 on success, -1 on failure
+ *
+ * Files in source_dir are read in place and never renamed.
+ */
+int create_archive_with_rule(RuntimeContext* ctx, SessionState* session, const char* source_dir,
+                             const ArchiveNameRule* rule, const ArchiveManifest* extra);
+
 #endif /* ARCHIVE_MANAGER_H */
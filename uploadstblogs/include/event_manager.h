@@ -62,6 +62,13 @@ void emit_upload_success(const RuntimeContext* ctx, const SessionState* session)
  */
 void emit_upload_failure(const RuntimeContext* ctx, const SessionState* session);
 
+/**
+ * @brief Emit the success or failure event of a finished upload cycle
+ * @param ctx Runtime context
+ * @param session Session state (session->success selects the event)
+ */
+void emit_upload_result(const RuntimeContext* ctx, const SessionState* session);
+
 /**
  * @brief Emit upload aborted event
  */
@@ -122,35 +122,6 @@ bool write_file(const char* filepath, const char* content);
  */
 int read_file(const char* filepath, char* buffer, size_t buffer_size);
 
-/**
- * @brief Add timestamp prefix to all files in directory
- * @param dir_path Directory containing files
- * @return 0 on success, -1 on failure
- *
- * Renames files with MM-DD-YY-HH-MMAM- prefix
- * Example: file.log -> 11-25-25-10-30AM-file.log
- */
-int add_timestamp_to_files(const char* dir_path);
-
-/**
- * @brief Add timestamp prefix to files with UploadLogsNow-specific exclusions
- * @param dir_path Directory containing files
- * @return 0 on success, -1 on failure
- *
- * Like add_timestamp_to_files() but skips files that already have AM/PM 
- * timestamps, reboot logs, and ABL reason logs (matches shell script logic)
- */
-int add_timestamp_to_files_uploadlogsnow(const char* dir_path);
-
-/**
- * @brief Remove timestamp prefix from all files in directory
- * @param dir_path Directory containing files
- * @return 0 on success, -1 on failure
- *
- * Restores original filenames by removing MM-DD-YY-HH-MMAM- prefix
- */
-int remove_timestamp_from_files(const char* dir_path);
-
 /**
  * @brief Move all contents from source to destination directory
  * @param src_dir Source directory
@@ -52,4 +52,49 @@ bool calculate_file_md5(const char *filepath, char *md5_base64, size_t output_si
  */
 bool calculate_file_sha256(const char *filepath, char *sha256_hex, size_t output_size);
 
+/**
+ * @brief Opaque MD5 + SHA256 digest fed incrementally
+ *
+ * Lets a writer hash data as it produces it, so the file never has to
+ * be read back to get the same values as calculate_file_md5() and
+ * calculate_file_sha256().
+ */
+typedef struct StreamDigest StreamDigest;
+
+/**
+ * @brief Create a stream digest
+ * @return Digest handle, or NULL on failure
+ */
+StreamDigest* stream_digest_new(void);
+
+/**
+ * @brief Feed data into both digests
+ * @param digest Digest handle
+ * @param buf Data
+ * @param len Number of bytes
+ * @return true on success, false on failure
+ */
+bool stream_digest_update(StreamDigest* digest, const void *buf, size_t len);
+
+/**
+ * @brief Finish both digests
+ *
+ * Either output may be NULL. The digest cannot be updated afterwards.
+ *
+ * @param digest Digest handle
+ * @param md5_base64 Output buffer for base64-encoded MD5 (min 25 bytes)
+ * @param md5_size Size of md5_base64
+ * @param sha256_hex Output buffer for hex-encoded SHA256 (min 65 bytes)
+ * @param sha256_size Size of sha256_hex
+ * @return true on success, false on failure
+ */
+bool stream_digest_final(StreamDigest* digest, char *md5_base64, size_t md5_size,
+                         char *sha256_hex, size_t sha256_size);
+
+/**
+ * @brief Free a stream digest
+ * @param digest Digest handle (may be NULL)
+ */
+void stream_digest_free(StreamDigest* digest);
+
 #endif /* MD5_UTILS_H */
@@ -0,0 +1,107 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file parallel_gzip.h
+ * @brief Block-parallel gzip writer
+ *
+ * Splits the input into fixed-size blocks that are deflated on a worker
+ * pool, each primed with the last 32 KB of the previous block. The raw
+ * deflate blocks are written in order as a single standard gzip member
+ * whose CRC32 is combined with crc32_combine().
+ */
+
+#ifndef PARALLEL_GZIP_H
+#define PARALLEL_GZIP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define PARALLEL_GZIP_BLOCK_SIZE    (128 * 1024)    /**< Uncompressed bytes per block */
+#define PARALLEL_GZIP_MAX_THREADS   8               /**< Upper bound on worker threads */
+
+/**
+ * @brief Opaque block-parallel gzip writer
+ */
+typedef struct ParallelGzip ParallelGzip;
+
+/**
+ * @brief Callback that sees every byte written to the gzip file, in order
+ */
+typedef void (*ParallelGzipSink)(void* arg, const void* buf, size_t len);
+
+/**
+ * @brief Create a gzip file and start the worker pool
+ * @param path Output file path (created or truncated)
+ * @param level Deflate level 0-9
+ * @param strategy zlib strategy
+ * @param threads Worker threads (2 to PARALLEL_GZIP_MAX_THREADS)
+ * @return Writer handle, or NULL on failure
+ */
+ParallelGzip* parallel_gzip_open(const char* path, int level, int strategy, int threads);
+
+/**
+ * @brief Observe the compressed output as it is written
+ *
+ * The gzip header already written by parallel_gzip_open() is passed to
+ * the sink immediately. The sink runs on the caller's thread.
+ *
+ * @param pgz Writer handle
+ * @param sink Callback, NULL to stop observing
+ * @param arg Passed through to sink
+ */
+void parallel_gzip_set_sink(ParallelGzip* pgz, ParallelGzipSink sink, void* arg);
+
+/**
+ * @brief Queue uncompressed data
+ * @param pgz Writer handle
+ * @param buf Data to compress
+ * @param len Number of bytes
+ * @return 0 on success, -1 on failure
+ */
+int parallel_gzip_write(ParallelGzip* pgz, const void* buf, size_t len);
+
+/**
+ * @brief Change the deflate level for data written from now on
+ *
+ * Data already queued keeps its level; a partly filled block is
+ * submitted early so the change takes effect immediately. Level 0
+ * stores the data.
+ *
+ * @param pgz Writer handle
+ * @param level Deflate level 0-9
+ * @return 0 on success, -1 on failure
+ */
+int parallel_gzip_set_level(ParallelGzip* pgz, int level);
+
+/**
+ * @brief Get the number of uncompressed bytes written so far
+ * @param pgz Writer handle
+ * @return Byte count, or -1 if pgz is NULL
+ */
+long parallel_gzip_bytes_in(const ParallelGzip* pgz);
+
+/**
+ * @brief Flush remaining blocks, write the gzip trailer and free the writer
+ * @param pgz Writer handle (invalid after this call)
+ * @return 0 on success, -1 if any write or compression failed
+ */
+int parallel_gzip_close(ParallelGzip* pgz);
+
+#endif /* PARALLEL_GZIP_H */
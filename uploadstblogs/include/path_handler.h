@@ -56,4 +56,23 @@ UploadResult execute_direct_path(RuntimeContext* ctx, SessionState* session);
  */
 UploadResult execute_codebig_path(RuntimeContext* ctx, SessionState* session);
 
+/**
+ * @brief Send the Direct metadata POST for an archive that is still being written
+ * @param ctx Runtime context
+ * @param session Session state of the upload
+ * @param archive_path Full path the archive is written to
+ *
+ * Without encryption the POST only carries the archive name, so it can
+ * run on a worker thread while the archive is compressed. The first
+ * execute_direct_path() for the same archive waits for it and uses its
+ * result instead of sending its own, and the S3 origin it returns is
+ * pre-warmed meanwhile. Does nothing when encryption is enabled.
+ */
+void start_early_metadata_post(RuntimeContext* ctx, SessionState* session, const char* archive_path);
+
+/**
+ * @brief Wait for an early metadata POST that was not used and drop its result
+ */
+void cancel_early_metadata_post(void);
+
 #endif /* PATH_HANDLER_H */
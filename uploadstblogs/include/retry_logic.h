@@ -28,8 +28,15 @@
 #ifndef RETRY_LOGIC_H
 #define RETRY_LOGIC_H
 
+#include <time.h>
 #include "uploadstblogs_types.h"
 
+#ifndef UPLOAD_NOT_BEFORE_FILE
+#define UPLOAD_NOT_BEFORE_FILE  "/opt/.upload_not_before"   /**< Persisted server-requested deferral */
+#endif
+#define RETRY_AFTER_DEFER_S     600     /**< Longer Retry-After values defer the whole upload */
+#define RETRY_AFTER_MAX_S       86400   /**< Upper bound accepted from a server */
+
 /**
  * @brief Execute retry loop for upload path
  * @param ctx Runtime context
@@ -38,9 +45,11 @@
  * @param attempt_func Function pointer to attempt upload
  * @return UploadResult code
  *
- * Implements retry logic with delays:
- * - Direct: up to N attempts with 60s delay
- * - CodeBig: up to M attempts with 10s delay
+ * Attempts are limited and spaced by ctx->direct_retry / ctx->codebig_retry.
+ * A Retry-After from the server raises the delay; one longer than
+ * RETRY_AFTER_DEFER_S, or any when no attempts are left, is persisted
+ * with defer_upload(). Returns UPLOADSTB_ABORTED if the delay is cancelled
+ * by retry_wait_cancel() or turned into a deferral.
  */
 UploadResult retry_upload(RuntimeContext* ctx, SessionState* session, 
                          UploadPath path,
@@ -56,6 +65,70 @@ UploadResult retry_upload(RuntimeContext* ctx, SessionState* session,
  */
 bool should_retry(const RuntimeContext* ctx, const SessionState* session, UploadPath path, UploadResult result);
 
+/**
+ * @brief Get the retry policy for an upload path
+ * @param ctx Runtime context
+ * @param path Upload path
+ * @return Policy, or NULL for an invalid path
+ */
+const RetryPolicy* get_retry_policy(const RuntimeContext* ctx, UploadPath path);
+
+/**
+ * @brief Compute the delay before a retry
+ * @param policy Retry policy
+ * @param retry Retry number, 1 for the delay after the first attempt
+ * @param seed rand_r() state, used only when the policy has jitter
+ * @return Delay in milliseconds
+ */
+int retry_backoff_ms(const RetryPolicy* policy, int retry, unsigned int* seed);
+
+/**
+ * @brief Wait for a retry delay unless cancelled
+ * @param delay_ms Delay in milliseconds
+ * @return true if the full delay elapsed, false if cancelled
+ */
+bool retry_wait(int delay_ms);
+
+/**
+ * @brief Wake any current retry wait and make later ones return at once
+ *
+ * Async-signal-safe, so it can be called from a SIGTERM handler or by a
+ * caller that needs the upload lock for a higher priority request.
+ */
+void retry_wait_cancel(void);
+
+/**
+ * @brief Clear a previous retry_wait_cancel() before a new upload
+ */
+void retry_wait_reset(void);
+
+/**
+ * @brief Parse a Retry-After or rate-limit reset header value
+ * @param value Header value: delta seconds, epoch seconds or an HTTP-date
+ * @param now Current time
+ * @return Seconds to wait (clamped to RETRY_AFTER_MAX_S), or -1 if unparsable
+ */
+int parse_retry_after(const char* value, time_t now);
+
+/**
+ * @brief Persist a time before which no upload should be attempted
+ * @param path Not-before file, normally UPLOAD_NOT_BEFORE_FILE
+ * @param until Earliest time for the next upload
+ * @return 0 on success, -1 on failure
+ */
+int defer_upload(const char* path, time_t until);
+
+/**
+ * @brief Check for a pending server-requested deferral
+ * @param path Not-before file, normally UPLOAD_NOT_BEFORE_FILE
+ * @param now Current time
+ * @param until Set to the deferral end if deferred (can be NULL)
+ * @return true if uploads should wait, false otherwise
+ *
+ * Expired or implausible (beyond RETRY_AFTER_MAX_S) entries are removed.
+ */
+bool upload_deferred(const char* path, time_t now, time_t* until);
+
 /**
  * @brief Increment attempt counter for path
  * @param session Session state
@@ -55,6 +55,17 @@ bool execute_upload_cycle(RuntimeContext* ctx, SessionState* session);
  */
 UploadResult attempt_upload(RuntimeContext* ctx, SessionState* session, UploadPath path);
 
+/**
+ * @brief Make one upload attempt on specified path
+ * @param ctx Runtime context
+ * @param session Session state
+ * @param path Upload path to use
+ * @return UploadResult code
+ *
+ * No retries, backoff, hedging or fallback, and no upload events.
+ */
+UploadResult attempt_upload_once(RuntimeContext* ctx, SessionState* session, UploadPath path);
+
 /**
  * @brief Determine if fallback should be attempted
  * @param ctx Runtime context
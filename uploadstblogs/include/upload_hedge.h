@@ -0,0 +1,119 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file upload_hedge.h
+ * @brief Hedged uploads: race the fallback path against a slow primary
+ *
+ * When the primary path has no metadata POST answer by a deadline, the
+ * fallback path is started next to it. The first successful upload wins;
+ * the other one aborts its S3 PUT or stops before its next retry. The deadline
+ * follows the metadata POST latency measured per path across runs.
+ */
+
+#ifndef UPLOAD_HEDGE_H
+#define UPLOAD_HEDGE_H
+
+#include "uploadstblogs_types.h"
+
+#ifndef UPLOAD_LATENCY_FILE
+#define UPLOAD_LATENCY_FILE     "/opt/.upload_latency"     /**< Metadata POST latency per path */
+#endif
+#define HEDGE_MIN_SAMPLES       3       /**< POSTs timed before the stats set the deadline */
+#define HEDGE_DEFAULT_DELAY_MS  15000   /**< Deadline until then */
+#define HEDGE_MIN_DELAY_MS      2000
+#define HEDGE_MAX_DELAY_MS      120000
+#define HEDGE_JOIN_TIMEOUT_MS   30000   /**< Time the losing attempt gets to stop before hedged_upload() returns */
+
+/**
+ * @brief Smoothed metadata POST latency of one path
+ *
+ * Kept like a TCP retransmission timer (RFC 6298): the deadline is the
+ * smoothed latency plus four times its mean deviation.
+ */
+typedef struct {
+    long srtt_ms;                   /**< Smoothed latency */
+    long rttvar_ms;                 /**< Smoothed mean deviation */
+    int samples;                    /**< POSTs measured */
+} PathLatency;
+
+/**
+ * @brief Fold one measured POST latency into the stats
+ * @param stats Stats to update
+ * @param sample_ms Measured latency
+ */
+void path_latency_update(PathLatency* stats, long sample_ms);
+
+/**
+ * @brief Read the stats of both paths
+ * @param file Stats file, normally UPLOAD_LATENCY_FILE
+ * @param stats Receives the Direct and CodeBig stats, indexed by UploadPath
+ * @return 0 on success, -1 if the file is missing (stats are zeroed)
+ */
+int path_latency_load(const char* file, PathLatency stats[2]);
+
+/**
+ * @brief Record a metadata POST latency for a path
+ * @param file Stats file, normally UPLOAD_LATENCY_FILE
+ * @param path Path the POST was sent on
+ * @param sample_ms Measured latency
+ * @return 0 on success, -1 on failure
+ */
+int path_latency_record(const char* file, UploadPath path, long sample_ms);
+
+/**
+ * @brief Time the primary path gets to answer its metadata POST
+ * @param ctx Runtime context
+ * @param stats Stats of the primary path (NULL = none)
+ * @return Delay in ms before the fallback path is started
+ *
+ * A fixed ctx->hedge_delay_ms is used as-is; HEDGE_DELAY_AUTO derives the
+ * deadline from the stats, bounded by HEDGE_MIN/MAX_DELAY_MS.
+ */
+long hedge_delay_ms(const RuntimeContext* ctx, const PathLatency* stats);
+
+/**
+ * @brief Upload on the primary path, racing the fallback path if it is slow
+ * @param ctx Runtime context
+ * @param session Session state, updated from the winning attempt
+ * @param delay_ms Time the primary path gets to answer its metadata POST
+ * @param attempt_func Uploads on one path with retries (attempt_upload())
+ * @return Result of the winning attempt, or of the primary path if no race was started
+ *
+ * If both paths ran, session->used_fallback is set whatever the outcome,
+ * so the caller does not try the fallback path a second time. The attempt
+ * that lost is waited for, up to HEDGE_JOIN_TIMEOUT_MS, before returning.
+ */
+UploadResult hedged_upload(RuntimeContext* ctx, SessionState* session, long delay_ms,
+                           UploadResult (*attempt_func)(RuntimeContext*, SessionState*, UploadPath));
+
+/**
+ * @brief Report that the metadata POST of a racing attempt was answered
+ * @param racer session->racer (NULL is ignored)
+ */
+void upload_race_post_done(struct UploadRacer* racer);
+
+/**
+ * @brief Check whether the other path already won the race
+ * @param racer session->racer (NULL = not racing)
+ * @return true if the attempt should stop
+ */
+bool upload_race_lost(const struct UploadRacer* racer);
+
+#endif /* UPLOAD_HEDGE_H */
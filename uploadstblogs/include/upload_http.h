@@ -0,0 +1,211 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file upload_http.h
+ * @brief Shared curl state for upload transfers
+ *
+ * Every handle handed out here is attached to one process-wide share
+ * handle holding the DNS cache, the TLS session cache and the connection
+ * pool. Retries, the DRI archive upload and a pre-warmed connection
+ * therefore skip the DNS lookup and resume the TLS session instead of
+ * doing a full handshake for every request.
+ */
+
+#ifndef UPLOAD_HTTP_H
+#define UPLOAD_HTTP_H
+
+#include <curl/curl.h>
+#include "uploadstblogs_types.h"
+
+#define UPLOAD_HTTP_LOW_SPEED_LIMIT 100     /**< Abort a PUT slower than this many bytes/s ... */
+#define UPLOAD_HTTP_LOW_SPEED_TIME  60      /**< ... for this many seconds */
+#define UPLOAD_HTTP_PUT_TIMEOUT     300     /**< PUT time limit in seconds, plus the body's time at UPLOAD_RATE_MIN_BPS */
+#define UPLOAD_HTTP_PREWARM_TIMEOUT 20      /**< Pre-warm request time limit in seconds */
+
+#define UPLOAD_RATE_MIN_BPS         (16 * 1024)     /**< Lowest cap, well above the stall limit */
+#define UPLOAD_RATE_CHUNK           (16 * 1024)     /**< Bytes a read callback waits for at most */
+#define UPLOAD_RATE_ADAPT_MS        500     /**< Adaptive mode: interval between rate changes */
+#define UPLOAD_RATE_QUEUE_US        50000   /**< Adaptive mode: RTT above its floor that counts as queueing */
+
+/**
+ * @brief Client certificate for an upload request
+ */
+typedef struct {
+    const char* cert_file;          /**< Certificate path (NULL = no client authentication) */
+    const char* cert_type;          /**< "P12", "PEM", ... (NULL = curl default) */
+    const char* key_pass;           /**< Certificate password (can be NULL) */
+} UploadHttpCert;
+
+/**
+ * @brief Check polled while a transfer runs; the transfer stops once it returns true
+ */
+typedef struct {
+    bool (*stop)(const void* arg);  /**< Called with arg from curl's progress callback */
+    const void* arg;
+} UploadHttpCancel;
+
+/**
+ * @brief Token bucket pacing the request bodies of upload transfers
+ *
+ * In adaptive mode the rate drops by a quarter whenever the TCP RTT of
+ * the transfer sits UPLOAD_RATE_QUEUE_US above the lowest RTT seen, i.e.
+ * the upload is filling a queue on the uplink, and climbs back to the cap
+ * in steps of an eighth while it does not.
+ */
+typedef struct {
+    long cap_bps;                   /**< Configured rate in bytes/s (0 = uncapped) */
+    long rate_bps;                  /**< Current rate, below the cap while adaptive mode backs off */
+    bool adaptive;                  /**< Follow the RTT */
+    long long tokens;               /**< Bytes that may be sent now */
+    long long refill_ms;            /**< Time of the last refill */
+    long base_rtt_us;               /**< Lowest RTT seen (0 = none yet) */
+    long long adapt_ms;             /**< Time of the last rate change */
+} UploadRateLimit;
+
+/**
+ * @brief Initialize a token bucket
+ * @param limit Bucket to initialize
+ * @param cap_bps Rate in bytes/s, raised to UPLOAD_RATE_MIN_BPS (0 = uncapped)
+ * @param adaptive Back off while the RTT rises
+ * @param now_ms Current monotonic time in ms
+ */
+void upload_rate_init(UploadRateLimit* limit, long cap_bps, bool adaptive, long long now_ms);
+
+/**
+ * @brief Take tokens for up to want bytes
+ * @param limit Bucket
+ * @param want Bytes the caller would like to send
+ * @param now_ms Current monotonic time in ms
+ * @param wait_ms Receives the time until a retry can succeed when 0 is returned (may be NULL)
+ * @return Bytes that may be sent now (0 = wait)
+ */
+size_t upload_rate_take(UploadRateLimit* limit, size_t want, long long now_ms, long* wait_ms);
+
+/**
+ * @brief Feed an RTT sample to an adaptive bucket
+ * @param limit Bucket (ignored unless adaptive and capped)
+ * @param rtt_us Measured RTT (<= 0 is ignored)
+ * @param now_ms Current monotonic time in ms
+ */
+void upload_rate_adapt(UploadRateLimit* limit, long rtt_us, long long now_ms);
+
+/**
+ * @brief Set the rate cap shared by every upload transfer of the process
+ * @param cap_bps Rate in bytes/s (0 = uncapped)
+ * @param adaptive Back off while the RTT rises
+ *
+ * Concurrent transfers (multipart parts, the DRI upload) draw from the
+ * same bucket, so the cap holds for the device as a whole. Setting the
+ * same values again keeps the current bucket.
+ */
+void upload_http_set_rate_limit(long cap_bps, bool adaptive);
+
+/**
+ * @brief Wait until the shared bucket allows sending part of a request body
+ * @param curl Transfer asking, used for its RTT in adaptive mode (may be NULL)
+ * @param want Bytes the read callback could send
+ * @return Bytes to send now, at least 1 and at most want (want if uncapped)
+ *
+ * Blocks the calling transfer for at most the time UPLOAD_RATE_CHUNK
+ * bytes take at the current rate.
+ */
+size_t upload_http_throttle(CURL* curl, size_t want);
+
+/**
+ * @brief Get an easy handle attached to the shared caches
+ * @return Handle to give back with upload_http_release(), or NULL on failure
+ *
+ * The share handle is created on first use.
+ */
+CURL* upload_http_acquire(void);
+
+/**
+ * @brief Release a handle from upload_http_acquire()
+ * @param curl Handle (NULL is ignored)
+ *
+ * Its connection stays in the shared pool for the next request.
+ */
+void upload_http_release(CURL* curl);
+
+/**
+ * @brief Apply client certificate, OCSP, connect timeout and stall limit to a handle
+ * @param curl Handle from upload_http_acquire()
+ * @param cert Client certificate, or NULL
+ * @param ocsp Require a stapled OCSP response
+ * @param connect_timeout_s Connect timeout in seconds (0 = curl default)
+ */
+void upload_http_set_transfer_opts(CURL* curl, const UploadHttpCert* cert, bool ocsp, int connect_timeout_s);
+
+/**
+ * @brief Stop a transfer with CURLE_ABORTED_BY_CALLBACK once cancel->stop() returns true
+ * @param curl Handle from upload_http_acquire()
+ * @param cancel Check to poll, must outlive the transfer (NULL = never stop)
+ */
+void upload_http_set_cancel(CURL* curl, const UploadHttpCancel* cancel);
+
+/**
+ * @brief PUT a file to a (pre-signed) URL over a shared handle
+ * @param url Destination URL
+ * @param src_file File to upload
+ * @param cert Client certificate, or NULL
+ * @param ocsp Require a stapled OCSP response
+ * @param connect_timeout_s Connect timeout in seconds (0 = curl default)
+ * @param cancel Stops the transfer early (NULL = never)
+ * @param resp Filled with HTTP code, curl code, elapsed time, bytes sent and retry hint
+ * @return curl code (0 = transfer completed, check resp->http_code)
+ *
+ * The body is paced by the rate cap set with upload_http_set_rate_limit().
+ */
+int upload_http_put(const char* url, const char* src_file, const UploadHttpCert* cert,
+                    bool ocsp, int connect_timeout_s, const UploadHttpCancel* cancel,
+                    UploadResponse* resp);
+
+/**
+ * @brief curl header callback collecting the server's retry hint
+ * @param userdata int* receiving the delay in seconds (largest value wins)
+ *
+ * Accepts Retry-After and the RateLimit-Reset / X-RateLimit-Reset headers
+ * sent by rate limiters.
+ */
+size_t upload_http_retry_after_header(char* buffer, size_t size, size_t nitems, void* userdata);
+
+/**
+ * @brief Open a connection to an upload origin in the background
+ * @param url URL whose origin to connect to
+ * @param cert Client certificate the PUT will present, or NULL
+ * @param ocsp Require a stapled OCSP response, as the PUT will
+ * @param connect_timeout_s Connect timeout in seconds (0 = 10)
+ *
+ * Sends a HEAD request to the origin with the PUT's TLS settings, leaving
+ * the connection in the shared pool. Only worth calling once the PUT's
+ * certificate is known: libcurl does not hand a connection to a request
+ * presenting a different one. The PUT never waits for it. Does nothing if
+ * the URL has no origin.
+ */
+void upload_http_prewarm(const char* url, const UploadHttpCert* cert, bool ocsp, int connect_timeout_s);
+
+/**
+ * @brief Join the pre-warm thread and free the shared caches
+ *
+ * Called once per upload run; the next acquire starts with empty caches.
+ */
+void upload_http_cleanup(void);
+
+#endif /* UPLOAD_HTTP_H */
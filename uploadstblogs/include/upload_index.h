@@ -0,0 +1,114 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file upload_index.h
+ * @brief Per-file high-watermark index for incremental log uploads
+ *
+ * Records, for every log file already uploaded, how many bytes of it the
+ * server has. Files are tracked by device and inode so that a rotated
+ * file (messages.log -> messages.log.1) keeps its watermark. The index
+ * is only written back after an upload succeeded.
+ */
+
+#ifndef UPLOAD_INDEX_H
+#define UPLOAD_INDEX_H
+
+#include "uploadstblogs_types.h"
+#include "archive_manager.h"
+
+#define UPLOAD_INDEX_FILE   "/opt/.upload_index"     /**< Persistent watermark index */
+
+/**
+ * @brief Watermark for one log file
+ */
+typedef struct {
+    char* path;                     /* Path the file was last seen under */
+    unsigned long long dev;         /* st_dev */
+    unsigned long long ino;         /* st_ino */
+    long long offset;               /* Bytes already uploaded */
+    unsigned int generation;        /* Times the path was rotated or truncated */
+    bool seen;                      /* Present in the current manifest */
+    size_t item;                    /* Manifest entry matched by the last apply */
+} UploadIndexEntry;
+
+/**
+ * @brief In-memory copy of the index file
+ */
+typedef struct {
+    UploadIndexEntry* entries;
+    size_t count;
+    size_t capacity;
+} UploadIndex;
+
+/**
+ * @brief Initialize an empty index
+ * @param index Index to initialize
+ */
+void upload_index_init(UploadIndex* index);
+
+/**
+ * @brief Release all entries held by an index
+ * @param index Index to free (left empty and reusable)
+ */
+void upload_index_free(UploadIndex* index);
+
+/**
+ * @brief Load the index from disk
+ * @param index Index to fill (previous contents are released)
+ * @param path Index file path
+ * @return 0 on success or if the file does not exist, -1 on failure
+ *
+ * Malformed lines are skipped; a damaged index only causes a full upload.
+ */
+int upload_index_load(UploadIndex* index, const char* path);
+
+/**
+ * @brief Atomically write the entries seen by the last apply to disk
+ * @param index Index to save
+ * @param path Index file path
+ * @return 0 on success, -1 on failure
+ */
+int upload_index_save(const UploadIndex* index, const char* path);
+
+/**
+ * @brief Restrict manifest entries to the bytes appended since the last upload
+ * @param index Index loaded from disk, matched against the manifest in memory
+ * @param manifest Manifest whose entries get offset/length set
+ * @return Number of bytes skipped, or -1 on failure
+ *
+ * Entries with nothing new get length 0 and are left out of the archive.
+ * A file found under a new inode, or shorter than its watermark, starts
+ * again from offset 0 with its generation bumped.
+ */
+long long upload_index_apply(UploadIndex* index, ArchiveManifest* manifest);
+
+/**
+ * @brief Move the watermarks past the bytes that went into the archive
+ * @param index Index matched by upload_index_apply()
+ * @param manifest Same manifest, holding the ranges actually archived
+ * @return 0 on success, -1 on failure
+ *
+ * Call after create_archive_from_manifest() and before upload_index_save().
+ * Entries trimmed by the size limits advance only over the part archived;
+ * entries left out keep their old watermark.
+ */
+int upload_index_commit(UploadIndex* index, const ArchiveManifest* manifest);
+
+#endif /* UPLOAD_INDEX_H */
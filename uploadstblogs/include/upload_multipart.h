@@ -0,0 +1,85 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file upload_multipart.h
+ * @brief S3 multipart upload of large archives
+ *
+ * The archive is sent as fixed-size parts (CreateMultipartUpload,
+ * UploadPart, CompleteMultipartUpload) with several parts in flight at
+ * once. A failed part is resent on its own, and every finished part is
+ * recorded in a small manifest so that a retry, or a later run uploading
+ * the same file, only sends the parts still missing.
+ */
+
+#ifndef UPLOAD_MULTIPART_H
+#define UPLOAD_MULTIPART_H
+
+#include "uploadstblogs_types.h"
+#include "upload_http.h"
+
+#ifndef UPLOAD_MULTIPART_FILE
+#define UPLOAD_MULTIPART_FILE       "/opt/.upload_multipart"   /**< Part manifest of an unfinished upload */
+#endif
+#define MULTIPART_MIN_PART_MB       5       /**< S3 minimum size of all parts but the last */
+#define MULTIPART_DEFAULT_PART_MB   8       /**< Part size unless LOG_UPLOAD_PART_MB is set */
+#define MULTIPART_DEFAULT_PARALLEL  3       /**< Parts in flight unless LOG_UPLOAD_PART_PARALLEL is set */
+#define MULTIPART_MAX_PARALLEL      8
+#define MULTIPART_MAX_PARTS         10000   /**< S3 limit, the part size grows to stay below it */
+#define MULTIPART_PART_ATTEMPTS     3       /**< Tries per part before the upload is given up */
+
+/**
+ * @brief Outcome of a multipart upload
+ */
+typedef enum {
+    MULTIPART_OK = 0,               /**< Completed, resp holds the CompleteMultipartUpload result */
+    MULTIPART_FAILED = -1,          /**< Failed, finished parts are kept in the manifest */
+    MULTIPART_UNSUPPORTED = -2      /**< Server refused to start one, use a single PUT */
+} MultipartResult;
+
+/**
+ * @brief Multipart upload settings
+ */
+typedef struct {
+    long long part_size;            /**< Bytes per part (raised to the S3 minimum) */
+    int parallel;                   /**< Parts uploaded concurrently */
+    int part_attempts;              /**< Tries per part */
+    const char* manifest_path;      /**< Part manifest, normally UPLOAD_MULTIPART_FILE */
+    const UploadHttpCancel* cancel; /**< Stops the parts in flight (NULL = never) */
+} MultipartConfig;
+
+/**
+ * @brief Upload a file as an S3 multipart upload
+ * @param url Object URL; the multipart sub-resources are added to its query
+ * @param src_file File to upload
+ * @param cert Client certificate, or NULL
+ * @param ocsp Require a stapled OCSP response
+ * @param connect_timeout_s Connect timeout in seconds (0 = curl default)
+ * @param config Part size, concurrency, attempts and manifest path
+ * @param resp Filled with the HTTP/curl code of the last request that decided the outcome
+ * @return MultipartResult
+ *
+ * An upload recorded in the manifest for the same object and the same
+ * file (path, size and mtime) is resumed instead of started again.
+ */
+MultipartResult upload_multipart_put(const char* url, const char* src_file, const UploadHttpCert* cert,
+                                     bool ocsp, int connect_timeout_s, const MultipartConfig* config,
+                                     UploadResponse* resp);
+
+#endif /* UPLOAD_MULTIPART_H */
@@ -0,0 +1,114 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file upload_spool.h
+ * @brief On-disk spool of archives whose upload failed
+ *
+ * An archive that could not be uploaded on any path is moved into the
+ * spool with its digests instead of being deleted by the strategy
+ * cleanup. The next scheduled run whose own upload succeeds retries the
+ * spooled archives, oldest first and with a growing delay per archive. The spool
+ * is bounded in size and age; the oldest archives are dropped first.
+ */
+
+#ifndef UPLOAD_SPOOL_H
+#define UPLOAD_SPOOL_H
+
+#include <time.h>
+#include "uploadstblogs_types.h"
+
+#ifndef UPLOAD_SPOOL_DIR
+#define UPLOAD_SPOOL_DIR        "/opt/.upload_spool"    /**< Spooled archives and their records */
+#endif
+#define SPOOL_DEFAULT_MB        32      /**< Spool size unless LOG_UPLOAD_SPOOL_MB is set */
+#define SPOOL_DEFAULT_DAYS      7       /**< Archive lifetime unless LOG_UPLOAD_SPOOL_DAYS is set */
+#define SPOOL_RETRY_BASE_S      900     /**< Delay after the first failed retry, doubled per failure */
+#define SPOOL_RETRY_CAP_S       (24 * 3600)
+#define SPOOL_META_EXT          ".meta" /**< Record next to each archive; the archive counts once it exists */
+
+/**
+ * @brief One spooled archive
+ */
+typedef struct {
+    char archive[MAX_PATH_LENGTH];  /**< Archive path inside the spool */
+    Strategy strategy;              /**< Strategy that created the archive */
+    time_t spooled;                 /**< Time the archive entered the spool */
+    time_t next_try;                /**< Earliest time of the next retry */
+    int attempts;                   /**< Retries that failed so far */
+    long long size;                 /**< Archive size in bytes */
+    char md5[32];                   /**< Base64 MD5 (empty = hash on demand) */
+    char sha256[65];                /**< Hex SHA256 (empty = hash on demand) */
+} SpoolEntry;
+
+/**
+ * @brief Move a failed archive into the spool
+ * @param ctx Runtime context (spool limits)
+ * @param session Session of the failed upload (strategy and digests)
+ * @param archive_path Archive to spool; it is gone from there on success
+ * @return 0 on success, -1 if the archive was left in place
+ *
+ * The archive is renamed, or copied and synced when the spool is on
+ * another file system, before its record is committed with a rename.
+ * Limits are applied afterwards, which may evict the oldest archives.
+ */
+int upload_spool_add(const RuntimeContext* ctx, const SessionState* session, const char* archive_path);
+
+/**
+ * @brief List the spooled archives, oldest first
+ * @param dir Spool directory, normally UPLOAD_SPOOL_DIR
+ * @param entries Receives a malloc'd array to free() (NULL when empty)
+ * @return Number of entries, or -1 on error
+ *
+ * Archives without a record and records without an archive are left
+ * over from an interrupted spool operation and are removed.
+ */
+int upload_spool_list(const char* dir, SpoolEntry** entries);
+
+/**
+ * @brief Drop spooled archives over the age or size limit
+ * @param dir Spool directory
+ * @param max_bytes Total archive bytes kept (<= 0 = drop everything)
+ * @param max_age_s Oldest archive kept in seconds (<= 0 = no age limit)
+ * @param now Current time
+ * @return Number of archives dropped, or -1 on error
+ */
+int upload_spool_evict(const char* dir, long long max_bytes, long max_age_s, time_t now);
+
+/**
+ * @brief Retry the spooled archives that are due
+ * @param ctx Runtime context
+ * @return Number of archives uploaded, or -1 on error
+ *
+ * Each due archive gets a single attempt on its primary path, without
+ * retries, backoff, hedging or fallback. Stops at the first archive that
+ * fails again, which is rescheduled with twice its previous delay; the
+ * others keep their schedule. The retries emit no upload events, those
+ * belong to the run's own archive.
+ */
+int upload_spool_drain(RuntimeContext* ctx);
+
+/**
+ * @brief Delay before the next retry of an archive
+ * @param attempts Retries that failed so far (>= 1)
+ * @return Seconds, SPOOL_RETRY_BASE_S doubled per earlier failure up to SPOOL_RETRY_CAP_S
+ */
+long upload_spool_backoff_s(int attempts);
+
+#endif /* UPLOAD_SPOOL_H */
@@ -80,6 +80,15 @@ void release_lock(void);
  */
 int uploadstblogs_run(const UploadSTBLogsParams* params);
 
+/**
+ * @brief Abandon the retries of an upload in progress
+ *
+ * Wakes a running uploadstblogs_run() out of its retry backoff so it
+ * finishes and releases the upload lock without further attempts. An
+ * attempt already on the wire is not interrupted. Async-signal-safe.
+ */
+void uploadstblogs_cancel(void);
+
 /**
  * @brief Internal API for executing STB log upload with argc/argv (used by main)
  * 
@@ -183,6 +183,16 @@ typedef enum {
     UPLOADSTB_RETRY = 3
 } UploadResult;
 
+/**
+ * @enum ArchiveCodec
+ * @brief Compression codec used under the TAR writer
+ */
+typedef enum {
+    ARCHIVE_CODEC_GZIP = 0,    /**< gzip (.tgz), always available */
+    ARCHIVE_CODEC_ZSTD,        /**< Zstandard (.tar.zst), needs HAVE_ZSTD */
+    ARCHIVE_CODEC_LZ4          /**< LZ4 frame (.tar.lz4), needs HAVE_LZ4 */
+} ArchiveCodec;
+
 /* ==========================
    Configuration & Context Structures
    ========================== */
@@ -263,19 +273,60 @@ typedef struct {
     char ca_cert_path[MAX_CERT_PATH_LENGTH];  /**< CA certificate path */
 } CertificateConfig;
 
+/**
+ * @struct RetryPolicy
+ * @brief Exponential backoff between attempts on one upload path
+ *
+ * The n-th retry waits up to min(cap_ms, base_ms * multiplier^(n-1)).
+ * With jitter the actual wait is uniform in [0, that bound] ("full
+ * jitter"), so devices failing together do not retry together.
+ */
+typedef struct {
+    int max_attempts;               /**< Attempts including the first one */
+    int base_ms;                    /**< Bound for the first retry delay */
+    int multiplier;                 /**< Bound growth factor per retry */
+    int cap_ms;                     /**< Upper bound for any single delay */
+    bool jitter;                    /**< Randomize each delay in [0, bound] */
+} RetryPolicy;
+
+/* Default retry policies (NUM_UPLOAD_ATTEMPTS / CB_NUM_UPLOAD_ATTEMPTS from the script) */
+#define RETRY_DIRECT_ATTEMPTS       3
+#define RETRY_DIRECT_BASE_MS        60000
+#define RETRY_DIRECT_CAP_MS         300000
+#define RETRY_CODEBIG_ATTEMPTS      1
+#define RETRY_CODEBIG_BASE_MS       10000
+#define RETRY_CODEBIG_CAP_MS        60000
+#define RETRY_MULTIPLIER            2
+
 /**
  * @struct RetryConfig
  * @brief Retry and timeout configuration
  */
 typedef struct {
-    int direct_max_attempts;        /**< Max attempts for direct path */
-    int codebig_max_attempts;       /**< Max attempts for CodeBig path */
+    RetryPolicy direct_retry;       /**< Retry policy for direct path */
+    RetryPolicy codebig_retry;      /**< Retry policy for CodeBig path */
     int direct_retry_delay;         /**< Retry delay for direct (seconds) */
     int codebig_retry_delay;        /**< Retry delay for CodeBig (seconds) */
     int curl_timeout;               /**< Curl operation timeout */
     int curl_tls_timeout;           /**< TLS handshake timeout */
 } RetryConfig;
 
+/* Compression level sentinels for RuntimeContext.compression_level */
+#define COMPRESSION_LEVEL_DEFAULT   0       /**< Not configured: historical level 9 */
+#define COMPRESSION_LEVEL_AUTO      (-1)    /**< Choose level from a sample of the input */
+#define COMPRESSION_TRIGGER_SLOTS   7       /**< One slot per TriggerType value */
+
+/* Archive size limits for RuntimeContext.archive_budget_mb / archive_file_cap_mb */
+#define ARCHIVE_LIMIT_DEFAULT       0       /**< Not configured: derive from the endpoint */
+#define ARCHIVE_LIMIT_NONE          (-1)    /**< No limit */
+
+/* Upload rate caps in RuntimeContext.upload_rate_kbit */
+#define UPLOAD_RATE_UNCAPPED        0       /**< No cap */
+
+/* Hedged upload sentinels for RuntimeContext.hedge_delay_ms */
+#define HEDGE_DELAY_OFF             0       /**< Fallback path only after the primary is exhausted */
+#define HEDGE_DELAY_AUTO            (-1)    /**< Deadline from the measured POST latency */
+
 /**
  * @struct RuntimeContext
  * @brief Complete runtime context with all configuration fields flattened
@@ -333,18 +384,52 @@ typedef struct {
     char ca_cert_path[MAX_CERT_PATH_LENGTH];  /**< CA certificate path */
     
     // Retry configuration
-    int direct_max_attempts;        /**< Max attempts for direct path */
-    int codebig_max_attempts;       /**< Max attempts for CodeBig path */
+    RetryPolicy direct_retry;       /**< Retry policy for direct path */
+    RetryPolicy codebig_retry;      /**< Retry policy for CodeBig path */
     int direct_retry_delay;         /**< Retry delay for direct (seconds) */
     int codebig_retry_delay;        /**< Retry delay for CodeBig (seconds) */
     int curl_timeout;               /**< Curl operation timeout */
     int curl_tls_timeout;           /**< TLS handshake timeout */
+
+    // Compression configuration (indexed by TriggerType)
+    int compression_level[COMPRESSION_TRIGGER_SLOTS];     /**< gzip level 1-9, COMPRESSION_LEVEL_AUTO or COMPRESSION_LEVEL_DEFAULT */
+    int compression_strategy[COMPRESSION_TRIGGER_SLOTS];  /**< zlib strategy (0 = Z_DEFAULT_STRATEGY) */
+    int compression_target_pct;     /**< Auto mode: acceptable compressed size as % of input (0 = default) */
+    int compression_threads;        /**< Compression worker threads (0/1 = single-threaded) */
+    ArchiveCodec archive_codec;     /**< Archive codec, selects the file extension too */
+
+    bool incremental_upload;        /**< DCM uploads send only bytes appended since the last success */
+    int archive_budget_mb;          /**< Max uncompressed archive content in MB, or ARCHIVE_LIMIT_* */
+    int archive_file_cap_mb;        /**< Max MB kept per file (its tail), or ARCHIVE_LIMIT_* */
+    bool upload_early_post;         /**< Send the metadata POST while the archive is built (no encryption only) */
+    int multipart_threshold_mb;     /**< Archives of at least this many MB use multipart upload (0 = never) */
+    int multipart_part_mb;          /**< Multipart part size in MB */
+    int multipart_parallel;         /**< Parts uploaded concurrently */
+    int hedge_delay_ms;             /**< Start the fallback path if the primary POST is unanswered this long, or HEDGE_DELAY_* */
+    int upload_rate_kbit[COMPRESSION_TRIGGER_SLOTS];  /**< S3 PUT rate cap in kbit/s by TriggerType, or UPLOAD_RATE_UNCAPPED */
+    int upload_rate_rrd_kbit;       /**< S3 PUT rate cap for RRD uploads, or UPLOAD_RATE_UNCAPPED */
+    bool upload_rate_adaptive;      /**< Lower the capped rate while the upload RTT rises */
+    int spool_max_mb;               /**< Failed archives kept for a retry, in MB (0 = discard them) */
+    int spool_max_days;             /**< Days a failed archive is kept (0 = until evicted by size) */
 } RuntimeContext;
 
 /* ==========================
    Session State Structures
    ========================== */
 
+/**
+ * @struct UploadResponse
+ * @brief Outcome of one HTTP exchange of an upload attempt
+ */
+typedef struct {
+    int http_code;                  /**< HTTP response code (0 = no response) */
+    int curl_code;                  /**< curl return code */
+    long elapsed_ms;                /**< Wall time of the exchange */
+    int retry_after;                /**< Server retry hint in seconds (0 = none) */
+    long long bytes;                /**< Request body bytes sent (S3 PUT) */
+    char presigned_url[MAX_URL_LENGTH];  /**< S3 URL returned by a metadata POST */
+} UploadResponse;
+
 /**
  * @struct SessionState
  * @brief Tracks the state of an upload session
@@ -357,9 +442,17 @@ typedef struct {
     int codebig_attempts;           /**< Number of CodeBig path attempts */
     int http_code;                  /**< Last HTTP response code */
     int curl_code;                  /**< Last curl return code */
+    int retry_after;                /**< Seconds the server asked to wait before retrying (0 = none) */
+    UploadResponse post;            /**< Metadata POST of the current attempt */
+    UploadResponse put;             /**< S3 PUT of the current attempt */
     bool used_fallback;             /**< Whether fallback was used */
     bool success;                   /**< Overall success status */
+    bool defer_events;              /**< Caller emits the upload result (concurrent uploads) */
+    bool no_spool;                  /**< Sources are kept for a re-upload, so a failed archive is not spooled */
+    struct UploadRacer* racer;      /**< Set while the session races the other path (hedged upload) */
     char archive_file[MAX_FILENAME_LENGTH];  /**< Generated archive filename */
+    char archive_md5[32];           /**< Base64 MD5 of the archive as written (empty = hash on demand) */
+    char archive_sha256[65];        /**< Hex SHA256 of the archive as written (empty = hash on demand) */
 } SessionState;
 
 #define THUNDER_JSONRPC_URL       "http://127.0.0.1:9998/jsonrpc"
@@ -56,6 +56,13 @@ bool is_http_success(int http_code);
  */
 bool is_terminal_failure(int http_code);
 
+/**
+ * @brief Check if HTTP code means the server is shedding load
+ * @param http_code HTTP response code
+ * @return true for 429 Too Many Requests and 503 Service Unavailable
+ */
+bool is_throttled_response(int http_code);
+
 /**
  * @brief Check if curl code indicates success
  * @param curl_code Curl return code
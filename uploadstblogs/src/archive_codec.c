@@ -0,0 +1,630 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file archive_codec.c
+ * @brief Compression codecs behind the TAR writer
+ *
+ * Each codec provides open/write/close over a common ArchiveWriter.
+ * gzip drives zlib's deflate directly, or the block-parallel writer when
+ * more than one thread is requested.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef HAVE_LZ4
+#include <lz4frame.h>
+#endif
+#include "archive_codec.h"
+#include "parallel_gzip.h"
+#include "md5_utils.h"
+#include "rdk_debug.h"
+
+#define CODEC_CHUNK_SIZE    (64 * 1024)
+
+typedef struct {
+    ArchiveCodec codec;
+    const char* name;
+    const char* extension;
+    bool (*open)(ArchiveWriter* writer, const char* path, int level, int strategy, int threads);
+    int (*write)(ArchiveWriter* writer, const void* buf, size_t len);
+    int (*close)(ArchiveWriter* writer);
+    int (*set_level)(ArchiveWriter* writer, int level);    // NULL = level fixed for the stream
+} CodecOps;
+
+struct ArchiveWriter {
+    const CodecOps* ops;
+    long bytes_in;
+    long stored_bytes;              // Bytes written while in stored mode
+    int level;
+    int strategy;
+    bool stored;
+    bool failed;                    // A write or level switch failed, the stream is unusable
+    char describe[24];
+    char path[MAX_PATH_LENGTH];
+    StreamDigest* digest;           // Hashes the compressed output, NULL if unavailable
+
+    // gzip
+    z_stream* zs;
+    ParallelGzip* pgz;
+
+    // gzip / zstd / lz4: plain file plus codec context and output buffer
+    int fd;
+    void* cctx;
+    unsigned char* out;
+    size_t out_size;
+#ifdef HAVE_LZ4
+    LZ4F_preferences_t lz4_prefs;
+#endif
+};
+
+/**
+ * @brief Write the whole buffer, retrying on short writes and EINTR
+ */
+static int write_fd(int fd, const unsigned char* buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Write compressed output to the archive file and the digest
+ */
+static int writer_emit(ArchiveWriter* writer, const unsigned char* buf, size_t len)
+{
+    if (write_fd(writer->fd, buf, len) != 0) {
+        return -1;
+    }
+    if (writer->digest) {
+        stream_digest_update(writer->digest, buf, len);
+    }
+    return 0;
+}
+
+static void digest_sink(void* arg, const void* buf, size_t len)
+{
+    stream_digest_update((StreamDigest*)arg, buf, len);
+}
+
+/* ==========================
+   gzip
+   ========================== */
+
+bool build_gz_mode(char* buffer, size_t buffer_size, int level, int strategy)
+{
+    if (!buffer || buffer_size == 0 || level < 0 || level > 9) {
+        return false;
+    }
+
+    const char* suffix = "";
+    switch (strategy) {
+        case Z_FILTERED:     suffix = "f"; break;
+        case Z_HUFFMAN_ONLY: suffix = "h"; break;
+        case Z_RLE:          suffix = "R"; break;
+        case Z_FIXED:        suffix = "F"; break;
+        default:             break;
+    }
+
+    int ret = snprintf(buffer, buffer_size, "wb%d%s", level, suffix);
+    return (ret > 0 && ret < (int)buffer_size);
+}
+
+/**
+ * @brief Run deflate until all pending input is consumed
+ *
+ * Z_FINISH also drains the trailer; Z_BLOCK completes the current
+ * block so the parameters can change.
+ */
+static int gzip_deflate(ArchiveWriter* writer, int flush)
+{
+    z_stream* zs = writer->zs;
+    int zret;
+
+    do {
+        zs->next_out = writer->out;
+        zs->avail_out = (uInt)writer->out_size;
+        zret = deflate(zs, flush);
+        if (zret == Z_STREAM_ERROR) {
+            RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                    "[%s:%d] deflate failed (msg=%s)\n",
+                    __FUNCTION__, __LINE__, zs->msg ? zs->msg : "(null)");
+            return -1;
+        }
+        if (writer_emit(writer, writer->out, writer->out_size - zs->avail_out) != 0) {
+            return -1;
+        }
+    } while (zs->avail_out == 0 || (flush == Z_FINISH && zret != Z_STREAM_END));
+
+    return 0;
+}
+
+static bool gzip_open(ArchiveWriter* writer, const char* path, int level, int strategy, int threads)
+{
+    if (threads > 1) {
+        writer->pgz = parallel_gzip_open(path, level, strategy, threads);
+        if (writer->pgz) {
+            if (writer->digest) {
+                parallel_gzip_set_sink(writer->pgz, digest_sink, writer->digest);
+            }
+            snprintf(writer->describe, sizeof(writer->describe), "gzip %dx%d", level,
+                     threads > PARALLEL_GZIP_MAX_THREADS ? PARALLEL_GZIP_MAX_THREADS : threads);
+            return true;
+        }
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] Parallel gzip unavailable, compressing single-threaded\n",
+                __FUNCTION__, __LINE__);
+    }
+
+    char mode[8];
+    if (!build_gz_mode(mode, sizeof(mode), level, strategy)) {
+        strcpy(mode, "wb9");
+        level = 9;
+        strategy = Z_DEFAULT_STRATEGY;
+        writer->level = level;
+        writer->strategy = strategy;
+    }
+
+    writer->zs = (z_stream*)calloc(1, sizeof(z_stream));
+    if (!writer->zs) {
+        return false;
+    }
+    // windowBits 15 + 16 writes the same gzip wrapper as gzopen()
+    if (deflateInit2(writer->zs, level, Z_DEFLATED, 15 + 16, 8, strategy) != Z_OK) {
+        free(writer->zs);
+        writer->zs = NULL;
+        return false;
+    }
+
+    writer->out_size = CODEC_CHUNK_SIZE;
+    writer->out = (unsigned char*)malloc(writer->out_size);
+    writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (!writer->out || writer->fd < 0) {
+        deflateEnd(writer->zs);
+        free(writer->zs);
+        writer->zs = NULL;
+        return false;
+    }
+    snprintf(writer->describe, sizeof(writer->describe), "gzip %s", mode);
+    return true;
+}
+
+static int gzip_write(ArchiveWriter* writer, const void* buf, size_t len)
+{
+    if (writer->pgz) {
+        return parallel_gzip_write(writer->pgz, buf, len);
+    }
+
+    const unsigned char* src = (const unsigned char*)buf;
+    while (len > 0) {
+        size_t chunk = (len < CODEC_CHUNK_SIZE) ? len : CODEC_CHUNK_SIZE;
+        writer->zs->next_in = (Bytef*)src;
+        writer->zs->avail_in = (uInt)chunk;
+        if (gzip_deflate(writer, Z_NO_FLUSH) != 0) {
+            return -1;
+        }
+        src += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+static int gzip_set_level(ArchiveWriter* writer, int level)
+{
+    if (writer->pgz) {
+        return parallel_gzip_set_level(writer->pgz, level);
+    }
+    // Finish the block at the old level first, as gzsetparams() does
+    if (gzip_deflate(writer, Z_BLOCK) != 0) {
+        return -1;
+    }
+    writer->zs->next_out = writer->out;
+    writer->zs->avail_out = (uInt)writer->out_size;
+    int zret = deflateParams(writer->zs, level, writer->strategy);
+    if (writer_emit(writer, writer->out, writer->out_size - writer->zs->avail_out) != 0) {
+        return -1;
+    }
+    return (zret == Z_OK) ? 0 : -1;
+}
+
+static int gzip_close(ArchiveWriter* writer)
+{
+    if (writer->pgz) {
+        return parallel_gzip_close(writer->pgz);
+    }
+    int ret = gzip_deflate(writer, Z_FINISH);
+    deflateEnd(writer->zs);
+    free(writer->zs);
+    if (close(writer->fd) != 0) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] close failed: %s\n", __FUNCTION__, __LINE__, strerror(errno));
+        ret = -1;
+    }
+    free(writer->out);
+    return ret;
+}
+
+/* ==========================
+   zstd
+   ========================== */
+
+#ifdef HAVE_ZSTD
+static bool zstd_open(ArchiveWriter* writer, const char* path, int level, int strategy, int threads)
+{
+    (void)strategy;
+
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    if (!cctx) {
+        return false;
+    }
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+    if (threads > 1 && ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, threads))) {
+        // libzstd built without multithreading, stay single-threaded
+        threads = 1;
+    }
+
+    writer->out_size = ZSTD_CStreamOutSize();
+    writer->out = (unsigned char*)malloc(writer->out_size);
+    writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (!writer->out || writer->fd < 0) {
+        ZSTD_freeCCtx(cctx);
+        return false;
+    }
+
+    writer->cctx = cctx;
+    snprintf(writer->describe, sizeof(writer->describe), "zstd %dx%d", level, threads > 1 ? threads : 1);
+    return true;
+}
+
+static int zstd_stream(ArchiveWriter* writer, const void* buf, size_t len, ZSTD_EndDirective mode)
+{
+    ZSTD_inBuffer in = { buf, len, 0 };
+    size_t remaining;
+
+    do {
+        ZSTD_outBuffer out = { writer->out, writer->out_size, 0 };
+        remaining = ZSTD_compressStream2((ZSTD_CCtx*)writer->cctx, &out, &in, mode);
+        if (ZSTD_isError(remaining)) {
+            RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                    "[%s:%d] zstd compression failed: %s\n",
+                    __FUNCTION__, __LINE__, ZSTD_getErrorName(remaining));
+            return -1;
+        }
+        if (writer_emit(writer, writer->out, out.pos) != 0) {
+            return -1;
+        }
+    } while (mode == ZSTD_e_end ? remaining != 0 : in.pos < in.size);
+
+    return 0;
+}
+
+static int zstd_write(ArchiveWriter* writer, const void* buf, size_t len)
+{
+    return zstd_stream(writer, buf, len, ZSTD_e_continue);
+}
+
+static int zstd_close(ArchiveWriter* writer)
+{
+    int ret = zstd_stream(writer, NULL, 0, ZSTD_e_end);
+    ZSTD_freeCCtx((ZSTD_CCtx*)writer->cctx);
+    if (close(writer->fd) != 0) {
+        ret = -1;
+    }
+    free(writer->out);
+    return ret;
+}
+#endif /* HAVE_ZSTD */
+
+/* ==========================
+   lz4
+   ========================== */
+
+#ifdef HAVE_LZ4
+static bool lz4_open(ArchiveWriter* writer, const char* path, int level, int strategy, int threads)
+{
+    (void)strategy;
+    (void)threads;
+
+    LZ4F_cctx* cctx = NULL;
+    if (LZ4F_isError(LZ4F_createCompressionContext(&cctx, LZ4F_VERSION))) {
+        return false;
+    }
+
+    memset(&writer->lz4_prefs, 0, sizeof(writer->lz4_prefs));
+    writer->lz4_prefs.compressionLevel = level;
+    writer->lz4_prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+
+    writer->out_size = LZ4F_compressBound(CODEC_CHUNK_SIZE, &writer->lz4_prefs);
+    if (writer->out_size < LZ4F_HEADER_SIZE_MAX) {
+        writer->out_size = LZ4F_HEADER_SIZE_MAX;
+    }
+    writer->out = (unsigned char*)malloc(writer->out_size);
+    writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (!writer->out || writer->fd < 0) {
+        LZ4F_freeCompressionContext(cctx);
+        return false;
+    }
+
+    size_t n = LZ4F_compressBegin(cctx, writer->out, writer->out_size, &writer->lz4_prefs);
+    if (LZ4F_isError(n) || writer_emit(writer, writer->out, n) != 0) {
+        LZ4F_freeCompressionContext(cctx);
+        return false;
+    }
+
+    writer->cctx = cctx;
+    snprintf(writer->describe, sizeof(writer->describe), "lz4 %d", level);
+    return true;
+}
+
+static int lz4_write(ArchiveWriter* writer, const void* buf, size_t len)
+{
+    const unsigned char* src = (const unsigned char*)buf;
+
+    while (len > 0) {
+        size_t chunk = (len < CODEC_CHUNK_SIZE) ? len : CODEC_CHUNK_SIZE;
+        size_t n = LZ4F_compressUpdate((LZ4F_cctx*)writer->cctx, writer->out, writer->out_size,
+                                       src, chunk, NULL);
+        if (LZ4F_isError(n)) {
+            RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                    "[%s:%d] lz4 compression failed: %s\n",
+                    __FUNCTION__, __LINE__, LZ4F_getErrorName(n));
+            return -1;
+        }
+        if (writer_emit(writer, writer->out, n) != 0) {
+            return -1;
+        }
+        src += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+static int lz4_close(ArchiveWriter* writer)
+{
+    int ret = 0;
+    size_t n = LZ4F_compressEnd((LZ4F_cctx*)writer->cctx, writer->out, writer->out_size, NULL);
+    if (LZ4F_isError(n) || writer_emit(writer, writer->out, n) != 0) {
+        ret = -1;
+    }
+    LZ4F_freeCompressionContext((LZ4F_cctx*)writer->cctx);
+    if (close(writer->fd) != 0) {
+        ret = -1;
+    }
+    free(writer->out);
+    return ret;
+}
+#endif /* HAVE_LZ4 */
+
+/* ==========================
+   Codec Table
+   ========================== */
+
+static const CodecOps codec_table[] = {
+    { ARCHIVE_CODEC_GZIP, "gzip", ARCHIVE_EXT_GZIP, gzip_open, gzip_write, gzip_close, gzip_set_level },
+#ifdef HAVE_ZSTD
+    { ARCHIVE_CODEC_ZSTD, "zstd", ARCHIVE_EXT_ZSTD, zstd_open, zstd_write, zstd_close, NULL },
+#else
+    { ARCHIVE_CODEC_ZSTD, "zstd", ARCHIVE_EXT_ZSTD, NULL, NULL, NULL, NULL },
+#endif
+#ifdef HAVE_LZ4
+    { ARCHIVE_CODEC_LZ4, "lz4", ARCHIVE_EXT_LZ4, lz4_open, lz4_write, lz4_close, NULL },
+#else
+    { ARCHIVE_CODEC_LZ4, "lz4", ARCHIVE_EXT_LZ4, NULL, NULL, NULL, NULL },
+#endif
+};
+
+static const CodecOps* find_codec(ArchiveCodec codec)
+{
+    for (size_t i = 0; i < sizeof(codec_table) / sizeof(codec_table[0]); i++) {
+        if (codec_table[i].codec == codec) {
+            return &codec_table[i];
+        }
+    }
+    return NULL;
+}
+
+bool archive_codec_parse(const char* name, ArchiveCodec* codec)
+{
+    if (!name || !codec) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(codec_table) / sizeof(codec_table[0]); i++) {
+        if (strcasecmp(name, codec_table[i].name) == 0) {
+            *codec = codec_table[i].codec;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool archive_codec_available(ArchiveCodec codec)
+{
+    const CodecOps* ops = find_codec(codec);
+    return ops && ops->open;
+}
+
+const char* archive_codec_name(ArchiveCodec codec)
+{
+    const CodecOps* ops = find_codec(codec);
+    return ops ? ops->name : codec_table[0].name;
+}
+
+const char* archive_codec_extension(ArchiveCodec codec)
+{
+    const CodecOps* ops = find_codec(codec);
+    return ops ? ops->extension : codec_table[0].extension;
+}
+
+bool archive_codec_is_archive_name(const char* name)
+{
+    if (!name) {
+        return false;
+    }
+    size_t len = strlen(name);
+    for (size_t i = 0; i < sizeof(codec_table) / sizeof(codec_table[0]); i++) {
+        size_t ext_len = strlen(codec_table[i].extension);
+        if (len > ext_len && strcmp(name + len - ext_len, codec_table[i].extension) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ==========================
+   Writer
+   ========================== */
+
+ArchiveWriter* archive_writer_open(ArchiveCodec codec, const char* path,
+                                   int level, int strategy, int threads)
+{
+    const CodecOps* ops = find_codec(codec);
+    if (!path || !ops || !ops->open) {
+        return NULL;
+    }
+
+    ArchiveWriter* writer = (ArchiveWriter*)calloc(1, sizeof(ArchiveWriter));
+    if (!writer) {
+        return NULL;
+    }
+    writer->ops = ops;
+    writer->fd = -1;
+    writer->level = level;
+    writer->strategy = strategy;
+    snprintf(writer->path, sizeof(writer->path), "%s", path);
+    writer->digest = stream_digest_new();
+
+    if (!ops->open(writer, path, level, strategy, threads)) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to open %s archive: %s\n", __FUNCTION__, __LINE__, ops->name, path);
+        if (writer->fd >= 0) {
+            close(writer->fd);
+        }
+        free(writer->zs);
+        stream_digest_free(writer->digest);
+        free(writer->out);
+        free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+int archive_writer_write(ArchiveWriter* writer, const void* buf, size_t len)
+{
+    if (!writer || writer->failed || (!buf && len > 0)) {
+        return -1;
+    }
+    if (len == 0) {
+        return 0;
+    }
+    if (writer->ops->write(writer, buf, len) != 0) {
+        writer->failed = true;
+        return -1;
+    }
+    writer->bytes_in += (long)len;
+    if (writer->stored) {
+        writer->stored_bytes += (long)len;
+    }
+    return 0;
+}
+
+int archive_writer_set_stored(ArchiveWriter* writer, bool stored)
+{
+    if (!writer || writer->failed || !writer->ops->set_level) {
+        return -1;
+    }
+    if (writer->stored == stored) {
+        return 0;
+    }
+    if (writer->ops->set_level(writer, stored ? 0 : writer->level) != 0) {
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] Failed to switch %s stream to level %d\n", __FUNCTION__, __LINE__,
+                writer->ops->name, stored ? 0 : writer->level);
+        writer->failed = true;
+        return -1;
+    }
+    writer->stored = stored;
+    return 0;
+}
+
+long archive_writer_stored_bytes(const ArchiveWriter* writer)
+{
+    return writer ? writer->stored_bytes : -1;
+}
+
+long archive_writer_bytes_in(const ArchiveWriter* writer)
+{
+    return writer ? writer->bytes_in : -1;
+}
+
+const char* archive_writer_describe(const ArchiveWriter* writer)
+{
+    return writer ? writer->describe : "";
+}
+
+int archive_writer_close(ArchiveWriter* writer, char* md5_base64, size_t md5_size,
+                         char* sha256_hex, size_t sha256_size)
+{
+    if (md5_base64 && md5_size > 0) {
+        md5_base64[0] = '\0';
+    }
+    if (sha256_hex && sha256_size > 0) {
+        sha256_hex[0] = '\0';
+    }
+    if (!writer) {
+        return -1;
+    }
+
+    int ret = writer->ops->close(writer);
+    if (writer->failed) {
+        // Earlier data is missing from the stream, the archive is incomplete
+        ret = -1;
+    }
+    if (ret == 0 && writer->digest && (md5_base64 || sha256_hex)) {
+        if (!stream_digest_final(writer->digest, md5_base64, md5_size, sha256_hex, sha256_size)) {
+            if (md5_base64 && md5_size > 0) {
+                md5_base64[0] = '\0';
+            }
+            if (sha256_hex && sha256_size > 0) {
+                sha256_hex[0] = '\0';
+            }
+        }
+    }
+    stream_digest_free(writer->digest);
+    free(writer);
+    return ret;
+}
@@ -30,6 +30,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/stat.h>
 #include <dirent.h>
 #include <time.h>
@@ -37,8 +38,12 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <limits.h>
+#include <ctype.h>
+#include <fnmatch.h>
+#include <math.h>
 #include <zlib.h>
 #include "archive_manager.h"
+#include "archive_codec.h"
 #include "file_operations.h"
 #ifndef GTEST_ENABLE
 #include "system_utils.h"
@@ -240,34 +245,25 @@ int collect_previous_logs(const char* src_dir, const char* dest_dir)
     return count;
 }
 
-int collect_pcap_logs(const RuntimeContext* ctx, const char* dest_dir)
+/**
+ * @brief Find the most recent PCAP file in LOG_PATH
+ * @param log_path Directory to search
+ * @param newest_pcap Buffer to receive the full path
+ * @param size Size of buffer
+ * @return true if a PCAP file was found
+ */
+static bool find_newest_pcap(const char* log_path, char* newest_pcap, size_t size)
 {
-    if (!ctx || !dest_dir) {
-        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
-        return -1;
-    }
-
-    if (!ctx->include_pcap) {
-        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] PCAP collection not enabled\n", __FUNCTION__, __LINE__);
-        return 0;
-    }
-
-    // Shell script behavior: Only collect LAST (most recent) pcap file if device is mediaclient
-    // Script: lastPcapCapture=`ls -lst $LOG_PATH/*.pcap | head -n 1`
-    
-    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, "[%s:%d] Collecting most recent PCAP file from: %s\n", 
-            __FUNCTION__, __LINE__, ctx->log_path);
-
-    DIR* dir = opendir(ctx->log_path);
+    DIR* dir = opendir(log_path);
     if (!dir) {
         RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, "[%s:%d] Failed to open LOG_PATH: %s\n", 
-                __FUNCTION__, __LINE__, ctx->log_path);
-        return 0;
+                __FUNCTION__, __LINE__, log_path);
+        return false;
     }
 
     struct dirent* entry;
     time_t newest_time = 0;
-    char newest_pcap[1024] = {0};
+    newest_pcap[0] = '\0';
     
     // Find the most recent .pcap file (specifically looking for -moca.pcap pattern)
     while ((entry = readdir(dir)) != NULL) {
@@ -281,7 +277,7 @@ int collect_pcap_logs(const RuntimeContext* ctx, const char* dest_dir)
         }
 
         char full_path[2048];
-        int ret = snprintf(full_path, sizeof(full_path), "%s/%s", ctx->log_path, entry->d_name);
+        int ret = snprintf(full_path, sizeof(full_path), "%s/%s", log_path, entry->d_name);
         
         if (ret < 0 || ret >= (int)sizeof(full_path)) {
             continue;
@@ -291,16 +287,44 @@ int collect_pcap_logs(const RuntimeContext* ctx, const char* dest_dir)
         if (stat(full_path, &st) == 0 && S_ISREG(st.st_mode)) {
             if (st.st_mtime > newest_time) {
                 newest_time = st.st_mtime;
-                strncpy(newest_pcap, full_path, sizeof(newest_pcap) - 1);
-                newest_pcap[sizeof(newest_pcap) - 1] = '\0';
+                strncpy(newest_pcap, full_path, size - 1);
+                newest_pcap[size - 1] = '\0';
             }
         }
     }
 
     closedir(dir);
 
-    // Copy the most recent PCAP file if found
     if (newest_time > 0 && strlen(newest_pcap) > 0) {
+        return true;
+    }
+
+    RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] No PCAP files found\n", __FUNCTION__, __LINE__);
+    return false;
+}
+
+int collect_pcap_logs(const RuntimeContext* ctx, const char* dest_dir)
+{
+    if (!ctx || !dest_dir) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    if (!ctx->include_pcap) {
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] PCAP collection not enabled\n", __FUNCTION__, __LINE__);
+        return 0;
+    }
+
+    // Shell script behavior: Only collect LAST (most recent) pcap file if device is mediaclient
+    // Script: lastPcapCapture=`ls -lst $LOG_PATH/*.pcap | head -n 1`
+    
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, "[%s:%d] Collecting most recent PCAP file from: %s\n", 
+            __FUNCTION__, __LINE__, ctx->log_path);
+
+    char newest_pcap[1024] = {0};
+
+    // Copy the most recent PCAP file if found
+    if (find_newest_pcap(ctx->log_path, newest_pcap, sizeof(newest_pcap))) {
         if (copy_log_file(newest_pcap, dest_dir)) {
             RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, "[%s:%d] Collected most recent PCAP file: %s\n", 
                     __FUNCTION__, __LINE__, newest_pcap);
@@ -309,13 +333,40 @@ int collect_pcap_logs(const RuntimeContext* ctx, const char* dest_dir)
             RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, "[%s:%d] Failed to copy PCAP file: %s\n", 
                     __FUNCTION__, __LINE__, newest_pcap);
         }
-    } else {
-        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] No PCAP files found\n", __FUNCTION__, __LINE__);
     }
 
     return 0;
 }
 
+int collect_pcap_to_manifest(const RuntimeContext* ctx, ArchiveManifest* manifest)
+{
+    if (!ctx || !manifest) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    if (!ctx->include_pcap) {
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] PCAP collection not enabled\n", __FUNCTION__, __LINE__);
+        return 0;
+    }
+
+    char newest_pcap[1024] = {0};
+    if (!find_newest_pcap(ctx->log_path, newest_pcap, sizeof(newest_pcap))) {
+        return 0;
+    }
+
+    const char* filename = strrchr(newest_pcap, '/');
+    filename = filename ? filename + 1 : newest_pcap;
+
+    if (archive_manifest_add(manifest, newest_pcap, filename) != 0) {
+        return -1;
+    }
+
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, "[%s:%d] Added most recent PCAP file: %s\n", 
+            __FUNCTION__, __LINE__, newest_pcap);
+    return 1;
+}
+
 int collect_dri_logs(const RuntimeContext* ctx, const char* dest_dir)
 {
     if (!ctx || !dest_dir) {
@@ -381,14 +432,46 @@ struct tar_header {
 };
 
 #define TAR_BLOCK_SIZE 512
+#define ARCHIVE_MARKER_MAX (MAX_PATH_LENGTH + 96)   /* Truncation note at the start of a member */
+
+/* Members at least this large are checked for already-compressed content
+ * and passed through as stored deflate blocks; below it the level switch
+ * costs more than it saves. */
+#define STORED_MIN_SIZE     (16 * 1024)
+#define STORED_ENTROPY_MIN  7.5         /* Bits per byte in the first block */
+
+static const char* const precompressed_extensions[] = {
+    ".gz", ".tgz", ".zip", ".bz2", ".xz", ".zst", ".lz4", ".7z", ".jpg", ".png", NULL
+};
+
+/* One TAR archive being written, with counters for its members so far */
+typedef struct {
+    ArchiveWriter* out;
+    int stored_members;         /* Members written as stored blocks */
+    /* Files that changed between fstat() and the end of their read.
+     * Members always match their header; these only say how far the
+     * archived copy is from what is on disk now. */
+    int grew;                   /* Appended to after the snapshot */
+    int shrank;                 /* Truncated, missing bytes zero-filled */
+    int rotated;                /* Renamed away, read from the open fd */
+    long long padded_bytes;     /* Zero bytes written for shrunk files */
+} TarWriter;
+
+static ArchiveNamedHook archive_named_hook;
 
 /* Forward declarations */
 static int create_archive_with_options(RuntimeContext* ctx, SessionState* session, 
                                        const char* source_dir, const char* output_dir,
-                                       const char* prefix);
+                                       const char* prefix, const ArchiveNameRule* rule,
+                                       const ArchiveManifest* manifest, ArchiveManifest* ranges);
 static bool generate_archive_name_at(char* buffer, size_t buffer_size,
                                      const char* mac_address, const char* prefix,
-                                     time_t ref_time);
+                                     const char* extension, time_t ref_time);
+
+void set_archive_named_hook(ArchiveNamedHook hook)
+{
+    archive_named_hook = hook;
+}
 
 /**
  * @brief Generate archive filename with MAC and timestamp (script format)
@@ -401,6 +484,7 @@ static bool generate_archive_name_at(char* buffer, size_t buffer_size,
  * Format: <MAC>_<prefix>_<MM-DD-YY-HH-MMAM/PM>.tgz
  * Example: AA-BB-CC-DD-EE-FF_Logs_11-25-25-02-30PM.tgz
  *          AA-BB-CC-DD-EE-FF_DRI_Logs_11-25-25-02-30PM.tgz
+ * Archives written with another codec use that codec's extension.
  */
 bool generate_archive_name(char* buffer, size_t buffer_size, 
                           const char* mac_address, const char* prefix)
@@ -418,12 +502,13 @@ bool generate_archive_name(char* buffer, size_t buffer_size,
         return false;
     }
 
-    return generate_archive_name_at(buffer, buffer_size, mac_address, prefix, time(NULL));
+    return generate_archive_name_at(buffer, buffer_size, mac_address, prefix,
+                                    ARCHIVE_EXT_GZIP, time(NULL));
 }
 
 static bool generate_archive_name_at(char* buffer, size_t buffer_size,
                                      const char* mac_address, const char* prefix,
-                                     time_t ref_time)
+                                     const char* extension, time_t ref_time)
 {
     struct tm tm_utc;
     if (gmtime_r(&ref_time, &tm_utc) == NULL) {
@@ -449,8 +534,8 @@ static bool generate_archive_name_at(char* buffer, size_t buffer_size,
     }
     *dst = '\0';
     
-    // Format: <MAC>_<prefix>_<timestamp>.tgz (matches script format)
-    snprintf(buffer, buffer_size, "%s_%s_%s.tgz", mac_clean, prefix, timestamp);
+    // Format: <MAC>_<prefix>_<timestamp><extension> (.tgz matches script format for gzip)
+    snprintf(buffer, buffer_size, "%s_%s_%s%s", mac_clean, prefix, timestamp, extension);
     
     RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB,
             "[%s:%d] Generated archive name: %s (MAC=%s, prefix=%s)\n",
@@ -481,7 +566,7 @@ static unsigned int calculate_tar_checksum(struct tar_header* header)
 /**
  * @brief Write TAR header for a file or symlink
  */
-static int write_tar_header(gzFile gz, const char* filename, struct stat* st, const char* link_target)
+static int write_tar_header(ArchiveWriter* out, const char* filename, struct stat* st, const char* link_target)
 {
     struct tar_header header;
     memset(&header, 0, sizeof(header));
@@ -509,19 +594,128 @@ static int write_tar_header(gzFile gz, const char* filename, struct stat* st, co
     unsigned int checksum = calculate_tar_checksum(&header);
     snprintf(header.checksum, sizeof(header.checksum), "%06o", checksum);
     
-    if (gzwrite(gz, &header, sizeof(header)) != sizeof(header)) {
+    if (archive_writer_write(out, &header, sizeof(header)) != 0) {
         return -1;
     }
     
     return 0;
 }
 
+/**
+ * @brief Check for a file name that says the content is already compressed
+ */
+static bool is_precompressed_name(const char* name)
+{
+    size_t len = strlen(name);
+    for (int i = 0; precompressed_extensions[i]; i++) {
+        size_t ext_len = strlen(precompressed_extensions[i]);
+        if (len > ext_len && strcasecmp(name + len - ext_len, precompressed_extensions[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Estimate whether data would not deflate, from its byte entropy
+ *
+ * Compressed and encrypted data is close to 8 bits per byte; text logs
+ * are around 5.
+ */
+static bool looks_incompressible(const unsigned char* data, size_t len)
+{
+    if (len == 0) {
+        return false;
+    }
+
+    unsigned int counts[256] = {0};
+    for (size_t i = 0; i < len; i++) {
+        counts[data[i]]++;
+    }
+
+    double entropy = 0.0;
+    for (int i = 0; i < 256; i++) {
+        if (counts[i] > 0) {
+            double p = (double)counts[i] / (double)len;
+            entropy -= p * log2(p);
+        }
+    }
+    return entropy >= STORED_ENTROPY_MIN;
+}
+
+/**
+ * @brief Check whether a member can take a text line in its body
+ *
+ * Compressed or binary content (pcaps, cores, .gz files) would be
+ * corrupted by one, so only data with no NUL bytes in its first block
+ * that also would deflate counts as text.
+ */
+static bool is_text_member(int fd, const char* filepath, off_t offset, off_t length)
+{
+    if (is_precompressed_name(filepath)) {
+        return false;
+    }
+
+    unsigned char peek[4096];
+    size_t want = (length < (off_t)sizeof(peek)) ? (size_t)length : sizeof(peek);
+    ssize_t n = pread(fd, peek, want, offset);
+    if (n <= 0) {
+        return n == 0;
+    }
+    return memchr(peek, '\0', (size_t)n) == NULL && !looks_incompressible(peek, (size_t)n);
+}
+
+/**
+ * @brief Add a small generated text member to the TAR archive
+ */
+static int add_note_to_tar(TarWriter* tar, const char* arcname, const char* text, size_t len,
+                           time_t mtime)
+{
+    struct stat st;
+    memset(&st, 0, sizeof(st));
+    st.st_mode = S_IFREG | 0644;
+    st.st_size = (off_t)len;
+    st.st_mtime = mtime;
+
+    if (write_tar_header(tar->out, arcname, &st, NULL) != 0 ||
+        archive_writer_write(tar->out, text, len) != 0) {
+        return -1;
+    }
+    size_t padding = (TAR_BLOCK_SIZE - (len % TAR_BLOCK_SIZE)) % TAR_BLOCK_SIZE;
+    if (padding > 0) {
+        char pad[TAR_BLOCK_SIZE] = {0};
+        if (archive_writer_write(tar->out, pad, padding) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
 /**
  * @brief Add file content to TAR archive
+ *
+ * The member is a snapshot of the first fstat(): exactly the size in its
+ * header is written, zero-filled if the file shrinks while being read.
+ * The file is read through the fd opened here, so a rotation during the
+ * read still archives the original file. Already-compressed content,
+ * judged by extension or by the entropy of its first block, is written
+ * as stored blocks and the level is restored after the member.
+ *
+ * @param offset First byte of the file to archive; updated to the first byte archived
+ * @param length Bytes to archive, -1 for everything from offset on;
+ *               updated to the bytes archived
+ * @param omitted Bytes dropped before offset by the size limits; when
+ *                non-zero a text member starts with a marker line saying
+ *                so, other members get a <arcname>.truncated member with
+ *                that line instead
+ * @return 0 on success, -1 if nothing was written or the archive stream failed
  */
-static int add_file_to_tar(gzFile gz, const char* filepath, const char* arcname)
+static int add_file_to_tar(TarWriter* tar, const char* filepath, const char* arcname,
+                           off_t* range_offset, off_t* range_length, off_t omitted)
 {
     struct stat st;
+    off_t offset = *range_offset;
+    off_t length = *range_length;
     
     int fd = open(filepath, O_RDONLY | O_NOFOLLOW);
     if (fd < 0) {
@@ -543,19 +737,50 @@ static int add_file_to_tar(gzFile gz, const char* filepath, const char* arcname)
     
     // Skip non-regular files
     if (!S_ISREG(st.st_mode)) {
+        *range_length = 0;
         close(fd);
         return 0;
     }
-    
-    // Write TAR header
-    if (write_tar_header(gz, arcname, &st, NULL) != 0) {
+
+    // Archive only [offset, offset + length); a file truncated since the
+    // range was chosen is sent whole
+    if (offset > st.st_size) {
+        offset = 0;
+        length = -1;
+        omitted = 0;
+    }
+    if (length < 0 || offset + length > st.st_size) {
+        length = st.st_size - offset;
+    }
+    if (offset > 0 && lseek(fd, offset, SEEK_SET) != offset) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
-                "[%s:%d] Failed to write TAR header\n", __FUNCTION__, __LINE__);
+                "[%s:%d] Failed to seek in file: %s\n", __FUNCTION__, __LINE__, filepath);
         close(fd);
         return -1;
     }
+    *range_offset = offset;
+    *range_length = length;
+    dev_t snap_dev = st.st_dev;
+    ino_t snap_ino = st.st_ino;
+
+    char marker[ARCHIVE_MARKER_MAX];
+    size_t marker_len = 0;
+    size_t note_len = 0;
+    if (omitted > 0) {
+        int n = snprintf(marker, sizeof(marker),
+                         "[uploadstblogs] %lld bytes omitted from the start of %s to fit the upload size limit\n",
+                         (long long)omitted, filepath);
+        n = (n > 0) ? ((size_t)n < sizeof(marker) ? n : (int)sizeof(marker) - 1) : 0;
+        if (is_text_member(fd, filepath, offset, length)) {
+            marker_len = (size_t)n;
+        } else {
+            note_len = (size_t)n;
+        }
+    }
+    st.st_size = (off_t)marker_len + length;
     
-    // Convert file descriptor to FILE* for reading
+    // Convert file descriptor to FILE* for reading, before anything is
+    // written so a failure here leaves the stream intact
     FILE* fp = fdopen(fd, "rb");
     if (!fp) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
@@ -564,25 +789,109 @@ static int add_file_to_tar(gzFile gz, const char* filepath, const char* arcname)
         return -1;
     }
     
+    // Write TAR header
+    if (write_tar_header(tar->out, arcname, &st, NULL) != 0) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to write TAR header\n", __FUNCTION__, __LINE__);
+        fclose(fp);
+        return -1;
+    }
+    
+    if (marker_len > 0 && archive_writer_write(tar->out, marker, marker_len) != 0) {
+        fclose(fp);
+        return -1;
+    }
+
     char buffer[8192];
     size_t bytes_read;
     size_t total_written = 0;
+    bool stored = false;
     
-    while ((bytes_read = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
-        if (gzwrite(gz, buffer, bytes_read) != (int)bytes_read) {
+    // Stop at the size recorded in the header even if the file grew
+    while (total_written < (size_t)length) {
+        size_t want = (size_t)length - total_written;
+        if (want > sizeof(buffer)) {
+            want = sizeof(buffer);
+        }
+        bytes_read = fread(buffer, 1, want, fp);
+        if (bytes_read == 0) {
+            break;
+        }
+        if (total_written == 0 && length >= STORED_MIN_SIZE &&
+            (is_precompressed_name(filepath) ||
+             looks_incompressible((const unsigned char*)buffer, bytes_read)) &&
+            archive_writer_set_stored(tar->out, true) == 0) {
+            stored = true;
+            tar->stored_members++;
+        }
+        if (archive_writer_write(tar->out, buffer, bytes_read) != 0) {
             fclose(fp);
             return -1;
         }
         total_written += bytes_read;
     }
+
+    // Shrunk or unreadable: fill up to the header size, otherwise every
+    // member after this one would be misaligned
+    if (total_written < (size_t)length) {
+        size_t missing = (size_t)length - total_written;
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] %s shrank by %zu bytes while archiving (%s), zero-filling\n",
+                __FUNCTION__, __LINE__, filepath, missing,
+                ferror(fp) ? "read error" : "truncated");
+        memset(buffer, 0, sizeof(buffer));
+        while (total_written < (size_t)length) {
+            size_t chunk = (size_t)length - total_written;
+            if (chunk > sizeof(buffer)) {
+                chunk = sizeof(buffer);
+            }
+            if (archive_writer_write(tar->out, buffer, chunk) != 0) {
+                fclose(fp);
+                return -1;
+            }
+            total_written += chunk;
+        }
+        tar->shrank++;
+        tar->padded_bytes += (long long)missing;
+    }
+
+    if (stored && archive_writer_set_stored(tar->out, false) != 0) {
+        fclose(fp);
+        return -1;
+    }
+
+    // Report how far the live file has moved on from the snapshot
+    struct stat now;
+    if (fstat(fileno(fp), &now) == 0 && now.st_size > offset + length) {
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB,
+                "[%s:%d] %s grew by %lld bytes while archiving\n", __FUNCTION__, __LINE__,
+                filepath, (long long)(now.st_size - (offset + length)));
+        tar->grew++;
+    }
+    if (lstat(filepath, &now) != 0 || now.st_dev != snap_dev || now.st_ino != snap_ino) {
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                "[%s:%d] %s was rotated while archiving, archived the original file\n",
+                __FUNCTION__, __LINE__, filepath);
+        tar->rotated++;
+    }
     
     fclose(fp);
     
     // Pad to 512-byte boundary
+    total_written += marker_len;
     size_t padding = (TAR_BLOCK_SIZE - (total_written % TAR_BLOCK_SIZE)) % TAR_BLOCK_SIZE;
     if (padding > 0) {
         char pad[TAR_BLOCK_SIZE] = {0};
-        if (gzwrite(gz, pad, padding) != (int)padding) {
+        if (archive_writer_write(tar->out, pad, padding) != 0) {
+            return -1;
+        }
+    }
+
+    // Binary content keeps its bytes intact; the truncation note goes alongside
+    if (note_len > 0) {
+        char note_name[MAX_PATH_LENGTH];
+        snprintf(note_name, sizeof(note_name), "%s.truncated", arcname);
+        if (add_note_to_tar(tar, note_name, marker, note_len, st.st_mtime) != 0) {
             return -1;
         }
     }
@@ -590,10 +899,91 @@ static int add_file_to_tar(gzFile gz, const char* filepath, const char* arcname)
     return 0;
 }
 
+/* ==========================
+   Member Name Rules
+   ========================== */
+
+bool archive_name_rule_init(ArchiveNameRule* rule, time_t ref_time)
+{
+    if (!rule) {
+        return false;
+    }
+
+    memset(rule, 0, sizeof(*rule));
+    rule->skip_backups = true;
+
+    // Script format: MM-DD-YY-HH-MMAM/PM-
+    struct tm tm_utc;
+    if (gmtime_r(&ref_time, &tm_utc) == NULL ||
+        strftime(rule->prefix, sizeof(rule->prefix), "%m-%d-%y-%I-%M%p-", &tm_utc) == 0) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to format UTC timestamp\n", __FUNCTION__, __LINE__);
+        rule->prefix[0] = '\0';
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check whether a name already carries a -NN[AP]M- timestamp
+ */
+static bool has_ampm_timestamp(const char* name)
+{
+    size_t len = strlen(name);
+    if (len <= 6) {
+        return false;
+    }
+    for (size_t i = 0; i < len - 6; i++) {
+        if (name[i] == '-' &&
+            isdigit((unsigned char)name[i+1]) && isdigit((unsigned char)name[i+2]) &&
+            (name[i+3] == 'A' || name[i+3] == 'P') &&
+            name[i+4] == 'M' && name[i+5] == '-') {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool archive_name_rule_apply(const ArchiveNameRule* rule, const char* name,
+                             char* buffer, size_t buffer_size)
+{
+    if (!name || !buffer || buffer_size == 0) {
+        return false;
+    }
+
+    bool keep = (!rule || rule->prefix[0] == '\0' || name[0] == '.' ||
+                 strncmp(name, rule->prefix, strlen(rule->prefix)) == 0);
+
+    if (!keep && rule->skip_backups &&
+        (strncmp(name, "bak1_", 5) == 0 ||
+         strncmp(name, "bak2_", 5) == 0 ||
+         strncmp(name, "bak3_", 5) == 0)) {
+        keep = true;
+    }
+
+    if (!keep && rule->skip_stamped && has_ampm_timestamp(name)) {
+        keep = true;
+    }
+
+    for (int i = 0; !keep && rule->keep_names && rule->keep_names[i]; i++) {
+        if (strcmp(name, rule->keep_names[i]) == 0) {
+            keep = true;
+        }
+    }
+
+    int ret = keep ? snprintf(buffer, buffer_size, "%s", name)
+                   : snprintf(buffer, buffer_size, "%s%s", rule->prefix, name);
+    return (ret >= 0 && ret < (int)buffer_size);
+}
+
 /**
- * @brief Recursively add directory to TAR archive
+ * @brief Recursively add directory contents to an archive manifest
+ * @param arc_dir Member directory for dirpath's contents ("" at top level)
+ * @param rule Name rule for top-level members (NULL = keep names)
  */
-static int add_directory_to_tar(gzFile gz, const char* dirpath, const char* base_path, const char* exclude_file)
+static int add_directory_to_manifest(ArchiveManifest* plan, const char* dirpath, const char* arc_dir,
+                                     const char* exclude_file, const ArchiveNameRule* rule)
 {
     int dirfd = open(dirpath, O_RDONLY | O_DIRECTORY);
     if (dirfd < 0) {
@@ -605,68 +995,621 @@ static int add_directory_to_tar(gzFile gz, const char* dirpath, const char* base
         close(dirfd);
         return -1;
     }
-    
+
     struct dirent* entry;
-    int base_len = strlen(base_path);
-    
+
     while ((entry = readdir(dir)) != NULL) {
         if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
             continue;
         }
-        
+
         char fullpath[MAX_PATH_LENGTH];
         snprintf(fullpath, sizeof(fullpath), "%s/%s", dirpath, entry->d_name);
-        
+
         // Skip excluded file
         if (exclude_file && strcmp(fullpath, exclude_file) == 0) {
             continue;
         }
-        
+
         struct stat st;
         if (fstatat(dirfd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
             continue;
         }
-        
-        // Calculate archive path (relative path)
-        const char* arcname = fullpath + base_len;
-        if (arcname[0] == '/') {
-            arcname++;
+
+        // Calculate archive path; only top-level names are rewritten
+        char arcname[MAX_PATH_LENGTH];
+        if (arc_dir[0] == '\0') {
+            if (!archive_name_rule_apply(rule, entry->d_name, arcname, sizeof(arcname))) {
+                continue;
+            }
+        } else {
+            snprintf(arcname, sizeof(arcname), "%s/%s", arc_dir, entry->d_name);
         }
-        
+
         if (S_ISDIR(st.st_mode)) {
-            if (add_directory_to_tar(gz, fullpath, base_path, exclude_file) != 0) {
+            if (add_directory_to_manifest(plan, fullpath, arcname, exclude_file, NULL) != 0) {
                 closedir(dir);
                 return -1;
             }
-        } else if (S_ISLNK(st.st_mode)) {
+        } else if (S_ISLNK(st.st_mode) || S_ISREG(st.st_mode)) {
+            // Symlinks and files are written by add_manifest_to_tar()
+            if (archive_manifest_add(plan, fullpath, arcname) != 0) {
+                closedir(dir);
+                return -1;
+            }
+        }
+    }
+
+    closedir(dir);
+    return 0;
+}
+
+/* ==========================
+   Manifest Functions
+   ========================== */
+
+void archive_manifest_init(ArchiveManifest* manifest)
+{
+    if (!manifest) {
+        return;
+    }
+    manifest->entries = NULL;
+    manifest->count = 0;
+    manifest->capacity = 0;
+    manifest->keep_head = false;
+}
+
+void archive_manifest_free(ArchiveManifest* manifest)
+{
+    if (!manifest) {
+        return;
+    }
+    for (size_t i = 0; i < manifest->count; i++) {
+        free(manifest->entries[i].src_path);
+        free(manifest->entries[i].arcname);
+    }
+    free(manifest->entries);
+    archive_manifest_init(manifest);
+}
+
+int archive_manifest_add(ArchiveManifest* manifest, const char* src_path, const char* arcname)
+{
+    if (!manifest || !src_path || !arcname || arcname[0] == '\0') {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    if (manifest->count == manifest->capacity) {
+        size_t new_capacity = manifest->capacity ? manifest->capacity * 2 : 64;
+        ArchiveManifestEntry* entries = realloc(manifest->entries, new_capacity * sizeof(*entries));
+        if (!entries) {
+            RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Failed to grow manifest\n", __FUNCTION__, __LINE__);
+            return -1;
+        }
+        manifest->entries = entries;
+        manifest->capacity = new_capacity;
+    }
+
+    char* src_copy = strdup(src_path);
+    char* arc_copy = strdup(arcname);
+    if (!src_copy || !arc_copy) {
+        free(src_copy);
+        free(arc_copy);
+        return -1;
+    }
+
+    manifest->entries[manifest->count].src_path = src_copy;
+    manifest->entries[manifest->count].arcname = arc_copy;
+    manifest->entries[manifest->count].offset = 0;
+    manifest->entries[manifest->count].length = -1;
+    manifest->entries[manifest->count].omitted = 0;
+    manifest->count++;
+    return 0;
+}
+
+int archive_manifest_add_dir(ArchiveManifest* manifest, const char* src_dir, const char* arc_prefix)
+{
+    if (!manifest || !src_dir || !arc_prefix) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    DIR* dir = opendir(src_dir);
+    if (!dir) {
+        return -1;
+    }
+
+    struct dirent* entry;
+    int count = 0;
+
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        char src_path[MAX_PATH_LENGTH];
+        char arcname[MAX_PATH_LENGTH];
+        int src_ret = snprintf(src_path, sizeof(src_path), "%s/%s", src_dir, entry->d_name);
+        int arc_ret = snprintf(arcname, sizeof(arcname), "%s/%s", arc_prefix, entry->d_name);
+        if (src_ret < 0 || src_ret >= (int)sizeof(src_path) ||
+            arc_ret < 0 || arc_ret >= (int)sizeof(arcname)) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, "[%s:%d] Path too long, skipping: %s/%s\n", 
+                    __FUNCTION__, __LINE__, src_dir, entry->d_name);
+            continue;
+        }
+
+        if (entry->d_type == DT_DIR) {
+            int ret = archive_manifest_add_dir(manifest, src_path, arcname);
+            if (ret > 0) count += ret;
+        } else if (archive_manifest_add(manifest, src_path, arcname) == 0) {
+            count++;
+        }
+    }
+
+    closedir(dir);
+    return count;
+}
+
+bool archive_manifest_has_dir(const ArchiveManifest* manifest, const char* arc_dir)
+{
+    if (!manifest || !arc_dir) {
+        return false;
+    }
+
+    size_t len = strlen(arc_dir);
+    for (size_t i = 0; i < manifest->count; i++) {
+        const char* name = manifest->entries[i].arcname;
+        if (strncmp(name, arc_dir, len) == 0 && name[len] == '/') {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Append copies of all entries of src, keeping their ranges
+ */
+static int manifest_append(ArchiveManifest* dst, const ArchiveManifest* src)
+{
+    for (size_t i = 0; i < src->count; i++) {
+        const ArchiveManifestEntry* entry = &src->entries[i];
+        if (archive_manifest_add(dst, entry->src_path, entry->arcname) != 0) {
+            return -1;
+        }
+        dst->entries[dst->count - 1].offset = entry->offset;
+        dst->entries[dst->count - 1].length = entry->length;
+        dst->entries[dst->count - 1].omitted = entry->omitted;
+    }
+    return 0;
+}
+
+/**
+ * @brief Copy the archived byte ranges from plan back to the caller's entries
+ *
+ * The size limits may have reordered plan, so entries are matched by
+ * source path and member name.
+ */
+static void manifest_report_ranges(ArchiveManifest* dst, const ArchiveManifest* plan)
+{
+    for (size_t i = 0; i < dst->count; i++) {
+        ArchiveManifestEntry* entry = &dst->entries[i];
+        entry->length = 0;
+        for (size_t j = 0; j < plan->count; j++) {
+            const ArchiveManifestEntry* done = &plan->entries[j];
+            if (strcmp(done->src_path, entry->src_path) == 0 &&
+                strcmp(done->arcname, entry->arcname) == 0) {
+                entry->offset = done->offset;
+                entry->length = done->length;
+                entry->omitted = done->omitted;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Stream every manifest entry into the TAR archive
+ *
+ * Each regular file entry is left holding the byte range that was
+ * archived, with length 0 if it was skipped.
+ */
+static int add_manifest_to_tar(TarWriter* tar, ArchiveManifest* manifest)
+{
+    for (size_t i = 0; i < manifest->count; i++) {
+        ArchiveManifestEntry* entry = &manifest->entries[i];
+        struct stat st;
+
+        if (entry->length == 0) {
+            // Nothing appended since the last upload, or over budget
+            continue;
+        }
+
+        if (lstat(entry->src_path, &st) != 0) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                    "[%s:%d] Skipping vanished file: %s\n", __FUNCTION__, __LINE__, entry->src_path);
+            entry->length = 0;
+            continue;
+        }
+
+        if (S_ISLNK(st.st_mode)) {
             char target[PATH_MAX];
-            ssize_t len = readlinkat(dirfd, entry->d_name, target, sizeof(target) - 1);
+            ssize_t len = readlink(entry->src_path, target, sizeof(target) - 1);
             if (len < 0) {
                 RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
-                        "[%s:%d] Failed to readlink: %s\n", __FUNCTION__, __LINE__, fullpath);
+                        "[%s:%d] Failed to readlink: %s\n", __FUNCTION__, __LINE__, entry->src_path);
                 continue;
             }
             target[len] = '\0';
             RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
-                    "Processing file...%s\n", arcname);
-            if (write_tar_header(gz, arcname, &st, target) != 0) {
-                RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
-                        "[%s:%d] Failed to add symlink: %s\n", __FUNCTION__, __LINE__, fullpath);
+                    "Processing file...%s\n", entry->arcname);
+            if (write_tar_header(tar->out, entry->arcname, &st, target) != 0) {
+                return -1;
             }
         } else if (S_ISREG(st.st_mode)) {
             RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
-                    "Processing file...%s\n", arcname);
-            if (add_file_to_tar(gz, fullpath, arcname) != 0) {
+                    "Processing file...%s\n", entry->arcname);
+            if (add_file_to_tar(tar, entry->src_path, entry->arcname,
+                                &entry->offset, &entry->length, entry->omitted) != 0) {
                 RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
-                        "[%s:%d] Failed to add file: %s\n", __FUNCTION__, __LINE__, fullpath);
+                        "[%s:%d] Failed to add file: %s\n", __FUNCTION__, __LINE__, entry->src_path);
+                entry->length = 0;
             }
+        } else {
+            entry->length = 0;
         }
     }
-    
-    closedir(dir);
+
     return 0;
 }
 
+/* ==========================
+   Archive Size Limits
+   ========================== */
+
+#define ARCHIVE_MIN_TAIL    (64 * 1024)     /* Smaller leftovers are dropped, not trimmed */
+
+/* Member priority when over budget, lower is kept first. Matched against
+ * the member's base name, first match wins, unmatched names get 2. */
+static const struct {
+    const char* pattern;
+    int priority;
+} member_priorities[] = {
+    { "*crash*",        0 },
+    { "*minidump*",     0 },
+    { "*.dmp",          0 },
+    { "core.*",         0 },
+    { "*_core*",        0 },
+    { "*.log.[0-9]*",   3 },
+    { "*.txt.[0-9]*",   3 },
+    { "*.[0-9]",        3 },
+    { "*.log",          1 },
+    { "*.txt",          1 },
+};
+
+typedef struct {
+    int priority;
+    size_t index;
+} MemberOrder;
+
+static int member_priority(const char* arcname)
+{
+    const char* base = strrchr(arcname, '/');
+    base = base ? base + 1 : arcname;
+
+    for (size_t i = 0; i < sizeof(member_priorities) / sizeof(member_priorities[0]); i++) {
+        if (fnmatch(member_priorities[i].pattern, base, 0) == 0) {
+            return member_priorities[i].priority;
+        }
+    }
+    return 2;
+}
+
+static int compare_member_order(const void* a, const void* b)
+{
+    const MemberOrder* x = (const MemberOrder*)a;
+    const MemberOrder* y = (const MemberOrder*)b;
+
+    if (x->priority != y->priority) {
+        return x->priority - y->priority;
+    }
+    // Stable: keep directory order within a priority
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+/**
+ * @brief Bytes an entry takes in the TAR stream, header and padding included
+ */
+static long long member_cost(const ArchiveManifestEntry* entry)
+{
+    long long body = (long long)entry->length;
+    if (entry->omitted > 0) {
+        body += ARCHIVE_MARKER_MAX;
+    }
+    return TAR_BLOCK_SIZE + ((body + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE) * TAR_BLOCK_SIZE;
+}
+
+/**
+ * @brief Keep only keep bytes of an entry's range, the last ones unless keep_head
+ */
+static void trim_entry(ArchiveManifestEntry* entry, off_t keep, bool keep_head)
+{
+    off_t drop = entry->length - keep;
+    if (!keep_head) {
+        entry->offset += drop;
+        entry->omitted += drop;
+    }
+    entry->length = keep;
+}
+
+void get_archive_limits(const RuntimeContext* ctx, long long* budget, long long* file_cap)
+{
+    int budget_mb = ctx ? ctx->archive_budget_mb : ARCHIVE_LIMIT_DEFAULT;
+    int cap_mb = ctx ? ctx->archive_file_cap_mb : ARCHIVE_LIMIT_DEFAULT;
+
+    if (budget_mb == ARCHIVE_LIMIT_DEFAULT) {
+        budget_mb = (ctx && ctx->direct_blocked) ? ARCHIVE_BUDGET_CODEBIG_MB : ARCHIVE_BUDGET_DIRECT_MB;
+    }
+    if (cap_mb == ARCHIVE_LIMIT_DEFAULT) {
+        cap_mb = ARCHIVE_FILE_CAP_MB;
+    }
+
+    if (budget) {
+        *budget = (budget_mb > 0) ? (long long)budget_mb * 1024 * 1024 : -1;
+    }
+    if (file_cap) {
+        *file_cap = (cap_mb > 0) ? (long long)cap_mb * 1024 * 1024 : -1;
+    }
+}
+
+int archive_manifest_apply_limits(ArchiveManifest* manifest, long long budget, long long file_cap)
+{
+    if (!manifest) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    int limited = 0;
+    long long total = 0;
+
+    // Resolve every range against the file as it is now, then apply the cap
+    for (size_t i = 0; i < manifest->count; i++) {
+        ArchiveManifestEntry* entry = &manifest->entries[i];
+        struct stat st;
+
+        if (entry->length == 0 || lstat(entry->src_path, &st) != 0 || !S_ISREG(st.st_mode)) {
+            total += (entry->length == 0) ? 0 : TAR_BLOCK_SIZE;
+            continue;
+        }
+        if (entry->offset > st.st_size) {
+            entry->offset = 0;
+            entry->length = -1;
+        }
+        if (entry->length < 0 || entry->offset + entry->length > st.st_size) {
+            entry->length = st.st_size - entry->offset;
+        }
+
+        if (file_cap > 0 && entry->length > file_cap) {
+            RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                    "[%s:%d] %s is %lld bytes, keeping the %s %lld\n", __FUNCTION__, __LINE__,
+                    entry->src_path, (long long)entry->length,
+                    manifest->keep_head ? "first" : "last", file_cap);
+            trim_entry(entry, (off_t)file_cap, manifest->keep_head);
+            limited++;
+        }
+        total += member_cost(entry);
+    }
+
+    if (budget < 0 || total <= budget) {
+        return limited;
+    }
+
+    RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+            "[%s:%d] Logs need %lld bytes, over the %lld byte budget; keeping by priority\n",
+            __FUNCTION__, __LINE__, total, budget);
+
+    // Reorder by priority so what is kept also leads the archive
+    MemberOrder* order = malloc(manifest->count * sizeof(*order));
+    ArchiveManifestEntry* sorted = malloc(manifest->count * sizeof(*sorted));
+    if (!order || !sorted) {
+        free(order);
+        free(sorted);
+        return -1;
+    }
+    for (size_t i = 0; i < manifest->count; i++) {
+        order[i].priority = member_priority(manifest->entries[i].arcname);
+        order[i].index = i;
+    }
+    qsort(order, manifest->count, sizeof(*order), compare_member_order);
+    for (size_t i = 0; i < manifest->count; i++) {
+        sorted[i] = manifest->entries[order[i].index];
+    }
+    memcpy(manifest->entries, sorted, manifest->count * sizeof(*sorted));
+    free(sorted);
+    free(order);
+
+    long long used = 0;
+    for (size_t i = 0; i < manifest->count; i++) {
+        ArchiveManifestEntry* entry = &manifest->entries[i];
+        if (entry->length == 0) {
+            continue;
+        }
+
+        long long cost = (entry->length > 0) ? member_cost(entry) : TAR_BLOCK_SIZE;
+        if (used + cost <= budget) {
+            used += cost;
+            continue;
+        }
+
+        // Keep part of the first file that does not fit
+        long long room = budget - used - 2 * TAR_BLOCK_SIZE - ARCHIVE_MARKER_MAX;
+        if (entry->length > 0 && room >= ARCHIVE_MIN_TAIL) {
+            trim_entry(entry, (off_t)(room & ~(long long)(TAR_BLOCK_SIZE - 1)), manifest->keep_head);
+            used += member_cost(entry);
+        } else {
+            RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                    "[%s:%d] Over budget, leaving out %s\n", __FUNCTION__, __LINE__, entry->src_path);
+            entry->length = 0;
+        }
+        limited++;
+    }
+
+    return limited;
+}
+
+/* ==========================
+   Compression Settings
+   ========================== */
+
+#define COMPRESSION_SAMPLE_SIZE     (128 * 1024)
+#define COMPRESSION_AUTO_FAST_LEVEL 1
+#define COMPRESSION_AUTO_MID_LEVEL  6
+#define COMPRESSION_TARGET_PCT      20
+
+void get_compression_params(const RuntimeContext* ctx, int* level, int* strategy)
+{
+    int lvl = COMPRESSION_LEVEL_DEFAULT;
+    int strat = Z_DEFAULT_STRATEGY;
+
+    if (ctx && ctx->trigger_type >= 0 && ctx->trigger_type < COMPRESSION_TRIGGER_SLOTS) {
+        lvl = ctx->compression_level[ctx->trigger_type];
+        strat = ctx->compression_strategy[ctx->trigger_type];
+    }
+
+    if (lvl != COMPRESSION_LEVEL_AUTO && (lvl < 1 || lvl > 9)) {
+        lvl = 9;
+    }
+    if (strat < Z_DEFAULT_STRATEGY || strat > Z_FIXED) {
+        strat = Z_DEFAULT_STRATEGY;
+    }
+
+    if (level) {
+        *level = lvl;
+    }
+    if (strategy) {
+        *strategy = strat;
+    }
+}
+
+/**
+ * @brief Deflate a buffer in memory and return the compressed size
+ * @return Compressed size in bytes, or 0 on error
+ */
+static size_t deflated_size(const unsigned char* data, size_t len, int level, int strategy)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, level, Z_DEFLATED, 15, 8, strategy) != Z_OK) {
+        return 0;
+    }
+
+    unsigned char out[16384];
+    size_t total = 0;
+    int zret;
+
+    zs.next_in = (Bytef*)data;
+    zs.avail_in = (uInt)len;
+    do {
+        zs.next_out = out;
+        zs.avail_out = sizeof(out);
+        zret = deflate(&zs, Z_FINISH);
+        total += sizeof(out) - zs.avail_out;
+    } while (zret == Z_OK);
+
+    deflateEnd(&zs);
+    return (zret == Z_STREAM_END) ? total : 0;
+}
+
+int select_compression_level(const unsigned char* sample, size_t len, int strategy, int target_pct)
+{
+    if (!sample || len == 0) {
+        return COMPRESSION_AUTO_MID_LEVEL;
+    }
+    if (target_pct <= 0 || target_pct > 100) {
+        target_pct = COMPRESSION_TARGET_PCT;
+    }
+
+    size_t target = len * (size_t)target_pct;
+
+    size_t fast = deflated_size(sample, len, COMPRESSION_AUTO_FAST_LEVEL, strategy);
+    if (fast > 0 && fast * 100 <= target) {
+        return COMPRESSION_AUTO_FAST_LEVEL;
+    }
+
+    size_t mid = deflated_size(sample, len, COMPRESSION_AUTO_MID_LEVEL, strategy);
+    if (mid > 0 && mid * 100 <= target) {
+        return COMPRESSION_AUTO_MID_LEVEL;
+    }
+
+    // Input that misses the target even at level 6 will not reward more CPU
+    return (fast > 0) ? COMPRESSION_AUTO_FAST_LEVEL : COMPRESSION_AUTO_MID_LEVEL;
+}
+
+/**
+ * @brief Read up to size bytes from the files that will lead the archive
+ * @return Number of bytes read
+ */
+static size_t read_archive_sample(const char* source_dir, const ArchiveManifest* manifest,
+                                  unsigned char* buffer, size_t size)
+{
+    size_t used = 0;
+
+    DIR* dir = source_dir ? opendir(source_dir) : NULL;
+    if (dir) {
+        struct dirent* entry;
+        while (used < size && (entry = readdir(dir)) != NULL) {
+            char path[MAX_PATH_LENGTH];
+            snprintf(path, sizeof(path), "%s/%s", source_dir, entry->d_name);
+            struct stat st;
+            if (lstat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+                continue;
+            }
+            FILE* fp = fopen(path, "rb");
+            if (fp) {
+                used += fread(buffer + used, 1, size - used, fp);
+                fclose(fp);
+            }
+        }
+        closedir(dir);
+    }
+
+    for (size_t i = 0; manifest && i < manifest->count && used < size; i++) {
+        FILE* fp = fopen(manifest->entries[i].src_path, "rb");
+        if (fp) {
+            used += fread(buffer + used, 1, size - used, fp);
+            fclose(fp);
+        }
+    }
+
+    return used;
+}
+
+/**
+ * @brief Resolve the gzip level to use for this archive, sampling input in auto mode
+ */
+static int resolve_archive_level(const RuntimeContext* ctx, const char* source_dir,
+                                 const ArchiveManifest* manifest, int strategy)
+{
+    int level;
+    get_compression_params(ctx, &level, NULL);
+    if (level != COMPRESSION_LEVEL_AUTO) {
+        return level;
+    }
+
+    unsigned char* sample = (unsigned char*)malloc(COMPRESSION_SAMPLE_SIZE);
+    if (!sample) {
+        return COMPRESSION_AUTO_MID_LEVEL;
+    }
+
+    size_t len = read_archive_sample(source_dir, manifest, sample, COMPRESSION_SAMPLE_SIZE);
+    level = select_compression_level(sample, len, strategy, ctx->compression_target_pct);
+    free(sample);
+
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] Auto compression picked level %d from %zu byte sample\n",
+            __FUNCTION__, __LINE__, level, len);
+    return level;
+}
+
 long get_archive_size(const char* archive_path)
 {
     if (!archive_path) {
@@ -682,7 +1625,7 @@ long get_archive_size(const char* archive_path)
 }
 
 /**
- * @brief Create tar.gz archive from directory using zlib
+ * @brief Create compressed TAR archive from directory
  * @param ctx Runtime context
  * @param session Session state (optional, can be NULL for DRI archives)
  * @param source_dir Source directory to archive
@@ -697,26 +1640,65 @@ int create_archive(RuntimeContext* ctx, SessionState* session, const char* sourc
                 "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
         return -1;
     }
-    return create_archive_with_options(ctx, session, source_dir, NULL, "Logs");
+    return create_archive_with_options(ctx, session, source_dir, NULL, "Logs", NULL, NULL, NULL);
+}
+
+int create_archive_with_rule(RuntimeContext* ctx, SessionState* session, const char* source_dir,
+                             const ArchiveNameRule* rule, const ArchiveManifest* extra)
+{
+    if (!ctx || !session || !source_dir) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
+                "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+    return create_archive_with_options(ctx, session, source_dir, NULL, "Logs", rule, extra, NULL);
+}
+
+int create_archive_from_manifest(RuntimeContext* ctx, SessionState* session,
+                                 ArchiveManifest* manifest, const char* output_dir)
+{
+    if (!ctx || !session || !manifest || !output_dir) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
+                "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
+            "[%s:%d] Creating archive from manifest with %zu entries\n", 
+            __FUNCTION__, __LINE__, manifest->count);
+
+    return create_archive_with_options(ctx, session, NULL, output_dir, "Logs", NULL, manifest, manifest);
 }
 
 /**
  * @brief Create archive with custom options
+ *
+ * source_dir (if given) is walked with its top-level member names rewritten
+ * by rule; manifest entries (if given) are appended after it. Without
+ * source_dir, output_dir must be given. ranges (if given) receives the
+ * byte range archived for each of its entries.
  */
 static int create_archive_with_options(RuntimeContext* ctx, SessionState* session, 
                                        const char* source_dir, const char* output_dir,
-                                       const char* prefix)
+                                       const char* prefix, const ArchiveNameRule* rule,
+                                       const ArchiveManifest* manifest, ArchiveManifest* ranges)
 {
-    if (!ctx || !session || !source_dir || !prefix) {
+    if (!ctx || !session || !prefix || (!source_dir && !manifest) ||
+        (!source_dir && !output_dir)) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
                 "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
         return -1;
     }
 
-    if (!dir_exists(source_dir)) {
+    // Digests belong to the archive written below, never a previous one
+    session->archive_md5[0] = '\0';
+    session->archive_sha256[0] = '\0';
+
+    const char* check_dir = source_dir ? source_dir : output_dir;
+    if (!dir_exists(check_dir)) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                "[%s:%d] Source directory does not exist: %s\n", 
-                __FUNCTION__, __LINE__, source_dir);
+                "[%s:%d] %s directory does not exist: %s\n", 
+                __FUNCTION__, __LINE__, source_dir ? "Source" : "Output", check_dir);
         return -1;
     }
 
@@ -727,10 +1709,20 @@ static int create_archive_with_options(RuntimeContext* ctx, SessionState* sessio
             (ctx->mac_address[0] != '\0') ? ctx->mac_address : "(NULL)", 
             prefix);
     
+    // Unavailable codecs fall back to gzip; the extension follows the codec
+    ArchiveCodec codec = ctx->archive_codec;
+    if (!archive_codec_available(codec)) {
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] %s codec not built in, using gzip\n",
+                __FUNCTION__, __LINE__, archive_codec_name(codec));
+        codec = ARCHIVE_CODEC_GZIP;
+    }
+
     char archive_filename[MAX_FILENAME_LENGTH];
     time_t ref_time = (ctx->archive_ref_time != 0) ? ctx->archive_ref_time : time(NULL);
     if (!generate_archive_name_at(archive_filename, sizeof(archive_filename),
-                                   ctx->mac_address, prefix, ref_time)) {
+                                   ctx->mac_address, prefix,
+                                   archive_codec_extension(codec), ref_time)) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
                 "[%s:%d] Failed to generate archive filename\n", __FUNCTION__, __LINE__);
         return -1;
@@ -745,38 +1737,80 @@ static int create_archive_with_options(RuntimeContext* ctx, SessionState* sessio
 
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
             "[%s:%d] Creating archive: %s from %s\n", 
-            __FUNCTION__, __LINE__, archive_path, source_dir);
+            __FUNCTION__, __LINE__, archive_path, source_dir ? source_dir : "manifest");
+
+    // Open the archive at the level configured for this trigger
+    int strategy = Z_DEFAULT_STRATEGY;
+    get_compression_params(ctx, NULL, &strategy);
+    int level = resolve_archive_level(ctx, source_dir, manifest, strategy);
+
+    struct timespec start_ts;
+    clock_gettime(CLOCK_MONOTONIC, &start_ts);
 
-    // Create gzip file
-    gzFile gz = gzopen(archive_path, "wb9");
-    if (!gz) {
+    ArchiveWriter* out = archive_writer_open(codec, archive_path, level, strategy,
+                                             ctx->compression_threads);
+    if (!out) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                "[%s:%d] Failed to create gzip file\n", __FUNCTION__, __LINE__);
+                "[%s:%d] Failed to create archive file\n", __FUNCTION__, __LINE__);
         return -1;
     }
 
-    // Add all files from directory
-    int ret = add_directory_to_tar(gz, source_dir, source_dir, archive_path);
+    // The archive exists now; let the upload side start work that only needs the name
+    if (archive_named_hook) {
+        archive_named_hook(ctx, session, archive_path);
+    }
+
+    TarWriter tar;
+    memset(&tar, 0, sizeof(tar));
+    tar.out = out;
+
+    // List the directory, then any manifest entries, and fit them to the size limits
+    int ret = 0;
+    ArchiveManifest plan;
+    archive_manifest_init(&plan);
+    plan.keep_head = manifest ? manifest->keep_head : false;
+    if (source_dir) {
+        ret = add_directory_to_manifest(&plan, source_dir, "", archive_path, rule);
+    }
+    if (ret == 0 && manifest) {
+        ret = manifest_append(&plan, manifest);
+    }
+    if (ret == 0) {
+        long long budget = -1;
+        long long file_cap = -1;
+        get_archive_limits(ctx, &budget, &file_cap);
+        int limited = archive_manifest_apply_limits(&plan, budget, file_cap);
+        if (limited > 0) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                    "[%s:%d] Size limits trimmed or left out %d of %zu files\n",
+                    __FUNCTION__, __LINE__, limited, plan.count);
+        }
+
+        ret = add_manifest_to_tar(&tar, &plan);
+    }
+    if (ranges) {
+        manifest_report_ranges(ranges, &plan);
+    }
+    archive_manifest_free(&plan);
     
     // Write two 512-byte blocks of zeros (TAR EOF marker)
     char eof_blocks[TAR_BLOCK_SIZE * 2];
     memset(eof_blocks, 0, sizeof(eof_blocks));
-    if (gzwrite(gz, eof_blocks, sizeof(eof_blocks)) != sizeof(eof_blocks)) {
-        int zerr = Z_OK;
-        const char* zmsg = gzerror(gz, &zerr);
+    if (archive_writer_write(out, eof_blocks, sizeof(eof_blocks)) != 0) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
-                "[%s:%d] gzwrite failed to write EOF blocks (zerr=%d, msg=%s)\n",
-                __FUNCTION__, __LINE__, zerr, zmsg ? zmsg : "(null)");
+                "[%s:%d] Failed to write TAR EOF blocks\n", __FUNCTION__, __LINE__);
         ret = -1;
     }
     
-    // Close gzip file
-    int gzclose_ret = gzclose(gz);
-    if (gzclose_ret != Z_OK) {
-        const char* zmsg = zError(gzclose_ret);
+    // Close archive file, keeping the digests of the bytes written
+    long raw_bytes = archive_writer_bytes_in(out);
+    long stored_bytes = archive_writer_stored_bytes(out);
+    char out_mode[24];
+    snprintf(out_mode, sizeof(out_mode), "%s", archive_writer_describe(out));
+    if (archive_writer_close(out, session->archive_md5, sizeof(session->archive_md5),
+                             session->archive_sha256, sizeof(session->archive_sha256)) != 0) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
-            "[%s:%d] gzclose failed (zret=%d, msg=%s)\n",
-            __FUNCTION__, __LINE__, gzclose_ret, zmsg ? zmsg : "(null)");
+                "[%s:%d] Failed to finish archive stream\n", __FUNCTION__, __LINE__);
         ret = -1;
     }
 
@@ -797,6 +1831,23 @@ static int create_archive_with_options(RuntimeContext* ctx, SessionState* sessio
         RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
                 "[%s:%d] Archive created successfully, size: %ld bytes\n", 
                 __FUNCTION__, __LINE__, size);
+
+        struct timespec end_ts;
+        clock_gettime(CLOCK_MONOTONIC, &end_ts);
+        double elapsed = (double)(end_ts.tv_sec - start_ts.tv_sec) +
+                         (double)(end_ts.tv_nsec - start_ts.tv_nsec) / 1e9;
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                "[%s:%d] Compression %s: %ld -> %ld bytes in %.2fs (%.2f MB/s), "
+                "%ld bytes stored uncompressed from %d members\n",
+                __FUNCTION__, __LINE__, out_mode, raw_bytes, size, elapsed,
+                elapsed > 0 ? ((double)raw_bytes / (1024.0 * 1024.0)) / elapsed : 0.0,
+                stored_bytes, tar.stored_members);
+        if (tar.grew || tar.shrank || tar.rotated) {
+            RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                    "[%s:%d] Live files changed while archiving: %d grew, %d shrank "
+                    "(%lld bytes zero-filled), %d rotated\n", __FUNCTION__, __LINE__,
+                    tar.grew, tar.shrank, tar.padded_bytes, tar.rotated);
+        }
         
         // Store archive filename in session
         strncpy(session->archive_file, archive_filename, sizeof(session->archive_file) - 1);
@@ -806,6 +1857,8 @@ static int create_archive_with_options(RuntimeContext* ctx, SessionState* sessio
     } else {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
                 "[%s:%d] Failed to create archive\n", __FUNCTION__, __LINE__);
+        session->archive_md5[0] = '\0';
+        session->archive_sha256[0] = '\0';
         return -1;
     }
 }
@@ -841,5 +1894,5 @@ int create_dri_archive(RuntimeContext* ctx, SessionState* session, const char* a
             "[%s:%d] Creating DRI archive from %s to %s\n", 
             __FUNCTION__, __LINE__, ctx->dri_log_path, ctx->dri_log_path);
 
-    return create_archive_with_options(ctx, session, ctx->dri_log_path, ctx->dri_log_path, "DRI_Logs");
+    return create_archive_with_options(ctx, session, ctx->dri_log_path, ctx->dri_log_path, "DRI_Logs", NULL, NULL, NULL);
 }
@@ -39,6 +39,7 @@
 #include <regex.h>
 #include <ctype.h>
 #include "cleanup_handler.h"
+#include "archive_codec.h"
 #include "context_manager.h"
 #include "event_manager.h"
 #include "file_operations.h"
@@ -48,6 +49,24 @@
    Internal Helper Functions
    ========================== */
 
+/**
+ * @brief Check whether a file name carries an archive extension of any codec
+ */
+static bool has_archive_extension(const char* name)
+{
+    static const char* const extensions[] = {
+        ARCHIVE_EXT_GZIP, ARCHIVE_EXT_ZSTD, ARCHIVE_EXT_LZ4
+    };
+    size_t len = strlen(name);
+    for (size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++) {
+        size_t ext_len = strlen(extensions[i]);
+        if (len > ext_len && strcmp(name + len - ext_len, extensions[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * @brief Recursively remove directory and contents
  */
@@ -256,8 +275,7 @@ int cleanup_old_archives(const char *log_path)
                 removed_count += sub_count;
             }
         } else if (S_ISREG(st.st_mode)) {
-            size_t len = strlen(entry->d_name);
-            if (len < 5 || strcmp(entry->d_name + len - 4, ".tgz") != 0) {
+            if (!has_archive_extension(entry->d_name)) {
                 continue;
             }
 
@@ -290,7 +308,7 @@ int cleanup_old_archives(const char *log_path)
     closedir(dir);
     
     RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB,
-            "[%s:%d] Archive cleanup complete: removed %d .tgz files from %s\n",
+            "[%s:%d] Archive cleanup complete: removed %d archives from %s\n",
             __FUNCTION__, __LINE__, removed_count, log_path);
     
     return removed_count;
@@ -30,8 +30,11 @@
 #include <sys/stat.h>
 #include <time.h>
 #include <errno.h>
+#include <zlib.h>
 #include "context_manager.h"
 #include "file_operations.h"
+#include "upload_multipart.h"
+#include "upload_spool.h"
 #ifndef GTEST_ENABLE
 #include "rdk_fwdl_utils.h"
 #include "common_device_api.h"
@@ -152,6 +155,190 @@ bool is_codebig_blocked(int block_time)
     }
 }
 
+/**
+ * @brief Parse a "<level>[:<strategy>]" compression property value
+ * @param value Property value, e.g. "6", "auto" or "1:rle"
+ * @param level Receives 1-9 or COMPRESSION_LEVEL_AUTO
+ * @param strategy Receives the zlib strategy
+ * @return true if the value was valid
+ */
+static bool parse_compression_value(const char* value, int* level, int* strategy)
+{
+    char level_str[16] = {0};
+    const char* colon = strchr(value, ':');
+    size_t level_len = colon ? (size_t)(colon - value) : strlen(value);
+
+    if (level_len == 0 || level_len >= sizeof(level_str)) {
+        return false;
+    }
+    memcpy(level_str, value, level_len);
+
+    if (strcasecmp(level_str, "auto") == 0) {
+        *level = COMPRESSION_LEVEL_AUTO;
+    } else {
+        char* end = NULL;
+        long parsed = strtol(level_str, &end, 10);
+        if (*end != '\0' || parsed < 1 || parsed > 9) {
+            return false;
+        }
+        *level = (int)parsed;
+    }
+
+    *strategy = Z_DEFAULT_STRATEGY;
+    if (colon) {
+        const char* name = colon + 1;
+        if (strcasecmp(name, "filtered") == 0) {
+            *strategy = Z_FILTERED;
+        } else if (strcasecmp(name, "huffman") == 0) {
+            *strategy = Z_HUFFMAN_ONLY;
+        } else if (strcasecmp(name, "rle") == 0) {
+            *strategy = Z_RLE;
+        } else if (strcasecmp(name, "fixed") == 0) {
+            *strategy = Z_FIXED;
+        } else if (strcasecmp(name, "default") != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Load archive compression settings from /etc/include.properties
+ *
+ * LOG_COMPRESSION applies to every trigger; LOG_COMPRESSION_<TRIGGER>
+ * overrides it for one trigger type. Unset entries keep level 9 gzip on
+ * a single thread.
+ */
+static void load_compression_config(RuntimeContext* ctx)
+{
+    static const struct {
+        int trigger;
+        const char* key;
+    } overrides[] = {
+        { TRIGGER_SCHEDULED,  "LOG_COMPRESSION_CRON" },
+        { TRIGGER_MANUAL,     "LOG_COMPRESSION_MANUAL" },
+        { TRIGGER_REBOOT,     "LOG_COMPRESSION_REBOOT" },
+        { TRIGGER_ONDEMAND,   "LOG_COMPRESSION_ONDEMAND" },
+        { TRIGGER_MEMCAPTURE, "LOG_COMPRESSION_MEMCAPTURE" },
+    };
+    char buffer[32] = {0};
+    int level = COMPRESSION_LEVEL_DEFAULT;
+    int strategy = Z_DEFAULT_STRATEGY;
+
+    if (getIncludePropertyData("LOG_COMPRESSION", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        if (!parse_compression_value(buffer, &level, &strategy)) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, "[%s:%d] Invalid LOG_COMPRESSION '%s', using level 9\n",
+                    __FUNCTION__, __LINE__, buffer);
+            level = COMPRESSION_LEVEL_DEFAULT;
+            strategy = Z_DEFAULT_STRATEGY;
+        }
+    }
+    for (int i = 0; i < COMPRESSION_TRIGGER_SLOTS; i++) {
+        ctx->compression_level[i] = level;
+        ctx->compression_strategy[i] = strategy;
+    }
+
+    for (size_t i = 0; i < sizeof(overrides) / sizeof(overrides[0]); i++) {
+        memset(buffer, 0, sizeof(buffer));
+        if (getIncludePropertyData(overrides[i].key, buffer, sizeof(buffer)) != UTILS_SUCCESS) {
+            continue;
+        }
+        if (parse_compression_value(buffer, &level, &strategy)) {
+            ctx->compression_level[overrides[i].trigger] = level;
+            ctx->compression_strategy[overrides[i].trigger] = strategy;
+            RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] %s=%s\n", __FUNCTION__, __LINE__,
+                    overrides[i].key, buffer);
+        } else {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, "[%s:%d] Ignoring invalid %s '%s'\n",
+                    __FUNCTION__, __LINE__, overrides[i].key, buffer);
+        }
+    }
+
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_COMPRESSION_TARGET_PCT", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        ctx->compression_target_pct = atoi(buffer);
+    }
+
+    // LOG_COMPRESSION_THREADS: worker count, or "auto" for one per online CPU
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_COMPRESSION_THREADS", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        if (strcasecmp(buffer, "auto") == 0) {
+            long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            ctx->compression_threads = (cpus > 0) ? (int)cpus : 1;
+        } else {
+            ctx->compression_threads = atoi(buffer);
+        }
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] LOG_COMPRESSION_THREADS=%d\n",
+                __FUNCTION__, __LINE__, ctx->compression_threads);
+    }
+
+    // LOG_COMPRESSION_CODEC: gzip (default), zstd or lz4
+    ctx->archive_codec = ARCHIVE_CODEC_GZIP;
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_COMPRESSION_CODEC", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        if (strcasecmp(buffer, "zstd") == 0) {
+            ctx->archive_codec = ARCHIVE_CODEC_ZSTD;
+        } else if (strcasecmp(buffer, "lz4") == 0) {
+            ctx->archive_codec = ARCHIVE_CODEC_LZ4;
+        } else if (strcasecmp(buffer, "gzip") != 0) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, "[%s:%d] Unknown LOG_COMPRESSION_CODEC '%s', using gzip\n",
+                    __FUNCTION__, __LINE__, buffer);
+        }
+    }
+}
+
+/**
+ * @brief Load S3 PUT rate caps from /etc/include.properties
+ *
+ * LOG_UPLOAD_RATE_KBIT caps the background triggers (scheduled, reboot,
+ * crash, debug, memcapture); manual and on-demand uploads, which someone
+ * waits for, and RRD uploads stay uncapped. LOG_UPLOAD_RATE_KBIT_<TRIGGER>
+ * and LOG_UPLOAD_RATE_KBIT_RRD override one of them; 0 removes the cap.
+ */
+static void load_upload_rate_config(RuntimeContext* ctx)
+{
+    static const struct {
+        int trigger;
+        const char* key;
+    } overrides[] = {
+        { TRIGGER_SCHEDULED,  "LOG_UPLOAD_RATE_KBIT_CRON" },
+        { TRIGGER_MANUAL,     "LOG_UPLOAD_RATE_KBIT_MANUAL" },
+        { TRIGGER_REBOOT,     "LOG_UPLOAD_RATE_KBIT_REBOOT" },
+        { TRIGGER_ONDEMAND,   "LOG_UPLOAD_RATE_KBIT_ONDEMAND" },
+        { TRIGGER_MEMCAPTURE, "LOG_UPLOAD_RATE_KBIT_MEMCAPTURE" },
+    };
+    char buffer[32] = {0};
+    int kbit = UPLOAD_RATE_UNCAPPED;
+
+    if (getIncludePropertyData("LOG_UPLOAD_RATE_KBIT", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        kbit = atoi(buffer) > 0 ? atoi(buffer) : UPLOAD_RATE_UNCAPPED;
+    }
+    for (int i = 0; i < COMPRESSION_TRIGGER_SLOTS; i++) {
+        bool interactive = (i == TRIGGER_MANUAL || i == TRIGGER_ONDEMAND);
+        ctx->upload_rate_kbit[i] = interactive ? UPLOAD_RATE_UNCAPPED : kbit;
+    }
+    ctx->upload_rate_rrd_kbit = UPLOAD_RATE_UNCAPPED;
+
+    for (size_t i = 0; i < sizeof(overrides) / sizeof(overrides[0]); i++) {
+        memset(buffer, 0, sizeof(buffer));
+        if (getIncludePropertyData(overrides[i].key, buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+            ctx->upload_rate_kbit[overrides[i].trigger] = atoi(buffer) > 0 ? atoi(buffer) : UPLOAD_RATE_UNCAPPED;
+            RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] %s=%s\n", __FUNCTION__, __LINE__,
+                    overrides[i].key, buffer);
+        }
+    }
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_RATE_KBIT_RRD", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        ctx->upload_rate_rrd_kbit = atoi(buffer) > 0 ? atoi(buffer) : UPLOAD_RATE_UNCAPPED;
+    }
+
+    // LOG_UPLOAD_RATE_ADAPTIVE=true: back off below the cap while the RTT rises
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_RATE_ADAPTIVE", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        ctx->upload_rate_adaptive = (strcasecmp(buffer, "true") == 0);
+    }
+}
+
 bool init_context(RuntimeContext* ctx)
 {
     // Initialize RDK Logger
@@ -293,11 +480,108 @@ bool load_environment(RuntimeContext* ctx)
     }
 
     // Set hardcoded retry attempts and timeouts from script
-    ctx->direct_max_attempts = 3;      // NUM_UPLOAD_ATTEMPTS=3
-    ctx->codebig_max_attempts = 1;     // CB_NUM_UPLOAD_ATTEMPTS=1
+    ctx->direct_retry.max_attempts = RETRY_DIRECT_ATTEMPTS;     // NUM_UPLOAD_ATTEMPTS=3
+    ctx->direct_retry.base_ms = RETRY_DIRECT_BASE_MS;
+    ctx->direct_retry.multiplier = RETRY_MULTIPLIER;
+    ctx->direct_retry.cap_ms = RETRY_DIRECT_CAP_MS;
+    ctx->direct_retry.jitter = true;
+    ctx->codebig_retry.max_attempts = RETRY_CODEBIG_ATTEMPTS;   // CB_NUM_UPLOAD_ATTEMPTS=1
+    ctx->codebig_retry.base_ms = RETRY_CODEBIG_BASE_MS;
+    ctx->codebig_retry.multiplier = RETRY_MULTIPLIER;
+    ctx->codebig_retry.cap_ms = RETRY_CODEBIG_CAP_MS;
+    ctx->codebig_retry.jitter = true;
     ctx->curl_timeout = 10;            // CURL_TIMEOUT=10
     ctx->curl_tls_timeout = 30;        // CURL_TLS_TIMEOUT=30
 
+    // Archive compression level/strategy per trigger type
+    load_compression_config(ctx);
+
+    // LOG_UPLOAD_INCREMENTAL=true: scheduled uploads skip already uploaded bytes
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_INCREMENTAL", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        ctx->incremental_upload = (strcasecmp(buffer, "true") == 0);
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] LOG_UPLOAD_INCREMENTAL=%s\n",
+                __FUNCTION__, __LINE__, ctx->incremental_upload ? "true" : "false");
+    }
+
+    // LOG_UPLOAD_EARLY_POST=false: request the presigned URL only after the archive is written
+    ctx->upload_early_post = true;
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_EARLY_POST", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        ctx->upload_early_post = (strcasecmp(buffer, "false") != 0);
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] LOG_UPLOAD_EARLY_POST=%s\n",
+                __FUNCTION__, __LINE__, ctx->upload_early_post ? "true" : "false");
+    }
+
+    // LOG_UPLOAD_MULTIPART_MB: archives this large go up in parts (unset or 0 = single PUT)
+    ctx->multipart_part_mb = MULTIPART_DEFAULT_PART_MB;
+    ctx->multipart_parallel = MULTIPART_DEFAULT_PARALLEL;
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_MULTIPART_MB", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        int mb = atoi(buffer);
+        ctx->multipart_threshold_mb = (mb > 0) ? mb : 0;
+    }
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_PART_MB", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        int mb = atoi(buffer);
+        ctx->multipart_part_mb = (mb >= MULTIPART_MIN_PART_MB) ? mb : MULTIPART_MIN_PART_MB;
+    }
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_PART_PARALLEL", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        int parallel = atoi(buffer);
+        if (parallel >= 1 && parallel <= MULTIPART_MAX_PARALLEL) {
+            ctx->multipart_parallel = parallel;
+        }
+    }
+    RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] Multipart upload: threshold %d MB, parts %d MB x %d\n",
+            __FUNCTION__, __LINE__, ctx->multipart_threshold_mb, ctx->multipart_part_mb, ctx->multipart_parallel);
+
+    // LOG_UPLOAD_HEDGE_MS: start the fallback path when the primary POST is this slow ("auto" = measured)
+    ctx->hedge_delay_ms = HEDGE_DELAY_OFF;
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_HEDGE_MS", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        int ms = atoi(buffer);
+        ctx->hedge_delay_ms = (strcasecmp(buffer, "auto") == 0) ? HEDGE_DELAY_AUTO :
+                              (ms > 0) ? ms : HEDGE_DELAY_OFF;
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] LOG_UPLOAD_HEDGE_MS=%d\n",
+                __FUNCTION__, __LINE__, ctx->hedge_delay_ms);
+    }
+
+    // S3 PUT rate caps per trigger type
+    load_upload_rate_config(ctx);
+
+    // LOG_UPLOAD_SPOOL_MB / LOG_UPLOAD_SPOOL_DAYS: failed archives kept for the next run (0 MB = none)
+    ctx->spool_max_mb = SPOOL_DEFAULT_MB;
+    ctx->spool_max_days = SPOOL_DEFAULT_DAYS;
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_SPOOL_MB", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        int mb = atoi(buffer);
+        ctx->spool_max_mb = (mb > 0) ? mb : 0;
+    }
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_SPOOL_DAYS", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        int days = atoi(buffer);
+        ctx->spool_max_days = (days > 0) ? days : 0;
+    }
+    RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] Upload spool: %d MB, %d days\n",
+            __FUNCTION__, __LINE__, ctx->spool_max_mb, ctx->spool_max_days);
+
+    // Archive size limits in MB; 0 or negative disables a limit, unset keeps the default
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_MAX_ARCHIVE_MB", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        int mb = atoi(buffer);
+        ctx->archive_budget_mb = (mb > 0) ? mb : ARCHIVE_LIMIT_NONE;
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] LOG_UPLOAD_MAX_ARCHIVE_MB=%d\n",
+                __FUNCTION__, __LINE__, ctx->archive_budget_mb);
+    }
+    memset(buffer, 0, sizeof(buffer));
+    if (getIncludePropertyData("LOG_UPLOAD_MAX_FILE_MB", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
+        int mb = atoi(buffer);
+        ctx->archive_file_cap_mb = (mb > 0) ? mb : ARCHIVE_LIMIT_NONE;
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] LOG_UPLOAD_MAX_FILE_MB=%d\n",
+                __FUNCTION__, __LINE__, ctx->archive_file_cap_mb);
+    }
+
     // Load DEVICE_TYPE from /etc/device.properties
     memset(buffer, 0, sizeof(buffer));
     if (getDevicePropertyData("DEVICE_TYPE", buffer, sizeof(buffer)) == UTILS_SUCCESS) {
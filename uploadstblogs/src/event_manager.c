@@ -181,6 +181,15 @@ void emit_upload_failure(const RuntimeContext* ctx, const SessionState* session)
     }
 }
 
+void emit_upload_result(const RuntimeContext* ctx, const SessionState* session)
+{
+    if (session && session->success) {
+        emit_upload_success(ctx, session);
+    } else {
+        emit_upload_failure(ctx, session);
+    }
+}
+
 void emit_upload_aborted(void)
 {
     RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
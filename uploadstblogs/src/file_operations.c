@@ -28,7 +28,6 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <dirent.h>
-#include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
 #include "file_operations.h"
@@ -330,341 +329,6 @@ int read_file(const char* filepath, char* buffer, size_t buffer_size)
     return (int)bytes_read;
 }
 
-/**
- * @brief Add timestamp prefix to all files in directory
- * @param dir_path Directory containing files to rename
- * @return 0 on success, -1 on failure
- */
-// Global to store timestamp prefix for removal
-static char g_timestamp_prefix[32] = {0};
-
-int add_timestamp_to_files(const char* dir_path)
-{
-    if (!dir_path || !dir_exists(dir_path)) {
-        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                "[%s:%d] Invalid or non-existent directory: %s\n", 
-                __FUNCTION__, __LINE__, dir_path ? dir_path : "NULL");
-        return -1;
-    }
-
-    // Get current timestamp in script format: MM-DD-YY-HH-MMAM/PM-
-    time_t now = time(NULL);
-    struct tm tm_utc;
-    if (gmtime_r(&now, &tm_utc) == NULL) {
-        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Failed to get UTC time\n", __FUNCTION__, __LINE__);
-        return -1;
-    }
-    char timestamp[32];
-    size_t timestamp_len = strftime(timestamp, sizeof(timestamp), "%m-%d-%y-%I-%M%p-", &tm_utc);
-    if (timestamp_len == 0) {
-        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
-                "[%s:%d] Failed to format UTC timestamp\n",
-                __FUNCTION__, __LINE__);
-        return -1;
-    }
-
-    // Store timestamp prefix globally for removal later (matches script behavior)
-
-    strncpy(g_timestamp_prefix, timestamp, sizeof(g_timestamp_prefix) - 1);
-
-    g_timestamp_prefix[sizeof(g_timestamp_prefix) - 1] = '\0';
-
-    DIR* dir = opendir(dir_path);
-    if (!dir) {
-        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                "[%s:%d] Failed to open directory: %s\n", 
-                __FUNCTION__, __LINE__, dir_path);
-        return -1;
-    }
-
-    int success_count = 0;
-    int error_count = 0;
-    struct dirent* entry;
-
-    while ((entry = readdir(dir)) != NULL) {
-        // Skip directories and special entries
-        if (entry->d_name[0] == '.' || 
-            strcmp(entry->d_name, "..") == 0 ||
-            strncmp(entry->d_name, timestamp, strlen(timestamp)) == 0) {
-            continue;
-        }
-        // Skip backup files (bak1_, bak2_, bak3_)
-        if (strncmp(entry->d_name, "bak1_", 5) == 0 ||
-            strncmp(entry->d_name, "bak2_", 5) == 0 ||
-            strncmp(entry->d_name, "bak3_", 5) == 0) {
-            continue;
-        }
-        char old_path[MAX_PATH_LENGTH] = "\0";
-        char new_path[MAX_PATH_LENGTH] = "\0";
-        
-        int old_ret = snprintf(old_path, sizeof(old_path), "%s/%s", dir_path, entry->d_name);
-        int new_ret = snprintf(new_path, sizeof(new_path), "%s/%s%s", dir_path, timestamp, entry->d_name);
-        
-        // Check for snprintf truncation
-        if (old_ret < 0 || old_ret >= (int)sizeof(old_path) ||
-            new_ret < 0 || new_ret >= (int)sizeof(new_path)) {
-            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
-                    "[%s:%d] Path too long, skipping: %s\n", 
-                    __FUNCTION__, __LINE__, entry->d_name);
-            continue;
-        }
-
-        // Rename directly without pre-check to avoid TOCTOU issue
-        if (rename(old_path, new_path) == 0) {
-            RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, 
-                    "[%s:%d] Renamed: %s -> %s\n", 
-                    __FUNCTION__, __LINE__, entry->d_name, new_path);
-            success_count++;
-        } else {
-            RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                    "[%s:%d] Failed to rename %s: %s\n", 
-                    __FUNCTION__, __LINE__, old_path, strerror(errno));
-            error_count++;
-        }
-    }
-
-    closedir(dir);
-
-    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-            "[%s:%d] Timestamp added to %d files, %d errors\n", 
-            __FUNCTION__, __LINE__, success_count, error_count);
-
-    return (error_count > 0) ? -1 : 0;
-}
-
-/**
- * @brief Remove timestamp prefix from all files in directory
- * @param dir_path Directory containing files to rename
- * @return 0 on success, -1 on failure
- */
-int remove_timestamp_from_files(const char* dir_path)
-{
-    if (!dir_path || !dir_exists(dir_path)) {
-        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                "[%s:%d] Invalid or non-existent directory: %s\n", 
-                __FUNCTION__, __LINE__, dir_path ? dir_path : "NULL");
-        return -1;
-    }
-
-    DIR* dir = opendir(dir_path);
-    if (!dir) {
-        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                "[%s:%d] Failed to open directory: %s\n", 
-                __FUNCTION__, __LINE__, dir_path);
-        return -1;
-    }
-
-    // Get stored timestamp prefix length (matches script behavior: cut -c$len-)
-    size_t prefix_len = strlen(g_timestamp_prefix);
-    
-    if (prefix_len == 0) {
-        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
-                "[%s:%d] No timestamp prefix stored, attempting pattern detection\n", 
-                __FUNCTION__, __LINE__);
-    }
-
-    int success_count = 0;
-    int error_count = 0;
-    struct dirent* entry;
-
-    while ((entry = readdir(dir)) != NULL) {
-        // Skip directories and special entries
-        if (entry->d_name[0] == '.' || strcmp(entry->d_name, "..") == 0) {
-            continue;
-        }
-
-        // Look for files with timestamp prefix matching script pattern
-        // Pattern: MM-DD-YY-HH-MMAM/PM- (matches script modifyTimestampPrefixWithOriginalName)
-        int has_timestamp = 0;
-        size_t cut_pos = prefix_len;
-        
-        if (prefix_len > 0 && strlen(entry->d_name) > prefix_len) {
-            // Use stored prefix length (matches script: cut -c$len-)
-            has_timestamp = (strncmp(entry->d_name, g_timestamp_prefix, prefix_len) == 0);
-        } else if (strlen(entry->d_name) > 19) {
-            // Fallback pattern detection: XX-XX-XX-XX-XXAM/PM- or XX-XX-XX-XX-XXPM-
-            has_timestamp = (entry->d_name[2] == '-' && entry->d_name[5] == '-' && 
-                            entry->d_name[8] == '-' && entry->d_name[11] == '-');
-            if (has_timestamp) {
-                // Find the end of timestamp (look for AM- or PM-)
-                const char* am_pos = strstr(entry->d_name, "AM-");
-                const char* pm_pos = strstr(entry->d_name, "PM-");
-                if (am_pos) {
-                    cut_pos = (am_pos - entry->d_name) + 3;
-                } else if (pm_pos) {
-                    cut_pos = (pm_pos - entry->d_name) + 3;
-                } else {
-                    has_timestamp = 0;
-                }
-            }
-        }
-
-        if (has_timestamp && cut_pos > 0 && strlen(entry->d_name) > cut_pos) {
-            char old_path[MAX_PATH_LENGTH];
-            char new_path[MAX_PATH_LENGTH];
-            
-            int old_ret = snprintf(old_path, sizeof(old_path), "%s/%s", dir_path, entry->d_name);
-            int new_ret = snprintf(new_path, sizeof(new_path), "%s/%s", dir_path, entry->d_name + cut_pos);
-            
-            // Check for snprintf truncation
-            if (old_ret < 0 || old_ret >= (int)sizeof(old_path) ||
-                new_ret < 0 || new_ret >= (int)sizeof(new_path)) {
-                RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
-                        "[%s:%d] Path too long, skipping: %s\n", 
-                        __FUNCTION__, __LINE__, entry->d_name);
-                continue;
-            }
-
-            if (rename(old_path, new_path) == 0) {
-                RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, 
-                        "[%s:%d] Removed timestamp: %s -> %s\n", 
-                        __FUNCTION__, __LINE__, entry->d_name, entry->d_name + cut_pos);
-                success_count++;
-            } else {
-                RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                        "[%s:%d] Failed to rename %s: %s\n", 
-                        __FUNCTION__, __LINE__, old_path, strerror(errno));
-                error_count++;
-            }
-        }
-    }
-
-    closedir(dir);
-
-    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-            "[%s:%d] Timestamp removed from %d files, %d errors\n", 
-            __FUNCTION__, __LINE__, success_count, error_count);
-
-    return (error_count > 0) ? -1 : 0;
-}
-
-/**
- * @brief Add timestamp prefix to files with UploadLogsNow-specific exclusions
- * @param dir_path Directory containing files to rename
- * @return 0 on success, -1 on failure
- * 
- * This function implements the same logic as the shell script's modifyFileWithTimestamp()
- * function, including exclusions for files that already have timestamps or special log types.
- */
-int add_timestamp_to_files_uploadlogsnow(const char* dir_path)
-{
-    if (!dir_path || !dir_exists(dir_path)) {
-        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                "[%s:%d] Invalid or non-existent directory: %s\n", 
-                __FUNCTION__, __LINE__, dir_path ? dir_path : "NULL");
-        return -1;
-    }
-
-    // Get current timestamp in script format: MM-DD-YY-HH-MMAM/PM-
-    time_t now = time(NULL);
-    struct tm tm_utc;
-    if (gmtime_r(&now, &tm_utc) == NULL) {
-        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Failed to get UTC time\n", __FUNCTION__, __LINE__);
-        return -1;
-    }
-    char timestamp[32];
-    strftime(timestamp, sizeof(timestamp), "%m-%d-%y-%I-%M%p-", &tm_utc);
-    
-    // Store timestamp prefix globally for removal later (matches script behavior)
-    strncpy(g_timestamp_prefix, timestamp, sizeof(g_timestamp_prefix) - 1);
-    g_timestamp_prefix[sizeof(g_timestamp_prefix) - 1] = '\0';
-
-    DIR* dir = opendir(dir_path);
-    if (!dir) {
-        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                "[%s:%d] Failed to open directory: %s\n", 
-                __FUNCTION__, __LINE__, dir_path);
-        return -1;
-    }
-
-    int success_count = 0;
-    int error_count = 0;
-    struct dirent* entry;
-
-    while ((entry = readdir(dir)) != NULL) {
-        // Skip directories and special entries
-        if (entry->d_name[0] == '.' || 
-            strcmp(entry->d_name, "..") == 0 ||
-            strncmp(entry->d_name, timestamp, strlen(timestamp)) == 0) {
-            continue;
-        }
-
-        // Check conditions that should skip timestamp modification (matches shell script logic)
-        int should_skip = 0;
-        const char* filename = entry->d_name;
-        size_t filename_len = strlen(filename);
-        
-        // Check for existing AM/PM timestamp pattern: .*-[0-9][0-9][AP]M-.* (combined check)
-        if (filename_len > 6) {
-            for (size_t i = 0; i < filename_len - 6; i++) {
-                if (filename[i] == '-' && 
-                    isdigit(filename[i+1]) && isdigit(filename[i+2]) && 
-                    (filename[i+3] == 'A' || filename[i+3] == 'P') && 
-                    filename[i+4] == 'M' && filename[i+5] == '-') {
-                    should_skip = 1;
-                    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-                            "[%s:%d] Processing file...%s\n", 
-                            __FUNCTION__, __LINE__, filename);
-                    break;
-                }
-            }
-        }
-        
-        // Check for reboot log pattern: reboot.log
-        if (!should_skip && strcmp(filename, "reboot.log") == 0) {
-            should_skip = 1;
-            RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-                    "[%s:%d] Processing file...%s\n", 
-                    __FUNCTION__, __LINE__, filename);
-        }
-        
-        // Check for abl reason log pattern: ABLReason.txt
-        if (!should_skip && strcmp(filename, "ABLReason.txt") == 0) {
-            should_skip = 1;
-            RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-                    "[%s:%d] Processing file...%s\n", 
-                    __FUNCTION__, __LINE__, filename);
-        }
-        
-        if (should_skip) {
-            continue;
-        }
-
-        char old_path[MAX_PATH_LENGTH];
-        char new_path[MAX_PATH_LENGTH];
-        
-        int old_ret = snprintf(old_path, sizeof(old_path), "%s/%s", dir_path, entry->d_name);
-        int new_ret = snprintf(new_path, sizeof(new_path), "%s/%s%s", dir_path, timestamp, entry->d_name);
-        
-        // Check for snprintf truncation
-        if (old_ret < 0 || old_ret >= (int)sizeof(old_path) ||
-            new_ret < 0 || new_ret >= (int)sizeof(new_path)) {
-            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
-                    "[%s:%d] Path too long, skipping: %s\n", 
-                    __FUNCTION__, __LINE__, entry->d_name);
-            continue;
-        }
-
-        // Rename directly without pre-check to avoid TOCTOU issue
-        if (rename(old_path, new_path) == 0) {
-            success_count++;
-        } else {
-            RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
-                    "[%s:%d] Failed to rename %s: %s\n", 
-                    __FUNCTION__, __LINE__, old_path, strerror(errno));
-            error_count++;
-        }
-    }
-
-    closedir(dir);
-
-    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-            "[%s:%d] Timestamp added to %d files, %d errors\n", 
-            __FUNCTION__, __LINE__, success_count, error_count);
-
-    return (error_count > 0) ? -1 : 0;
-}
-
 /**
  * @brief Move all contents from source directory to destination directory
  * @param src_dir Source directory
@@ -218,3 +218,95 @@ bool calculate_file_sha256(const char *filepath, char *sha256_hex, size_t output
     
     return true;
 }
+
+/* ==========================
+   Stream Digest
+   ========================== */
+
+struct StreamDigest {
+    EVP_MD_CTX *md5;
+    EVP_MD_CTX *sha256;
+    bool failed;
+};
+
+StreamDigest* stream_digest_new(void)
+{
+    StreamDigest *digest = (StreamDigest *)calloc(1, sizeof(StreamDigest));
+    if (!digest) {
+        return NULL;
+    }
+
+    digest->md5 = EVP_MD_CTX_new();
+    digest->sha256 = EVP_MD_CTX_new();
+    if (!digest->md5 || !digest->sha256 ||
+        EVP_DigestInit_ex(digest->md5, EVP_md5(), NULL) != 1 ||
+        EVP_DigestInit_ex(digest->sha256, EVP_sha256(), NULL) != 1) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to initialize stream digest\n", __FUNCTION__, __LINE__);
+        stream_digest_free(digest);
+        return NULL;
+    }
+
+    return digest;
+}
+
+bool stream_digest_update(StreamDigest* digest, const void *buf, size_t len)
+{
+    if (!digest || (!buf && len > 0) || digest->failed) {
+        return false;
+    }
+
+    if (EVP_DigestUpdate(digest->md5, buf, len) != 1 ||
+        EVP_DigestUpdate(digest->sha256, buf, len) != 1) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to update stream digest\n", __FUNCTION__, __LINE__);
+        digest->failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool stream_digest_final(StreamDigest* digest, char *md5_base64, size_t md5_size,
+                         char *sha256_hex, size_t sha256_size)
+{
+    if (!digest || digest->failed ||
+        (md5_base64 && md5_size < 25) || (sha256_hex && sha256_size < 65)) {
+        return false;
+    }
+    digest->failed = true;  // Finalized contexts cannot be reused
+
+    unsigned char md5_binary[EVP_MAX_MD_SIZE];
+    unsigned char sha256_binary[EVP_MAX_MD_SIZE];
+    unsigned int md5_len = 0;
+    unsigned int sha256_len = 0;
+    if (EVP_DigestFinal_ex(digest->md5, md5_binary, &md5_len) != 1 ||
+        EVP_DigestFinal_ex(digest->sha256, sha256_binary, &sha256_len) != 1) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to finalize stream digest\n", __FUNCTION__, __LINE__);
+        return false;
+    }
+
+    if (md5_base64 && !base64_encode(md5_binary, md5_len, md5_base64, md5_size)) {
+        return false;
+    }
+
+    if (sha256_hex) {
+        for (unsigned int i = 0; i < sha256_len; i++) {
+            snprintf(sha256_hex + (i * 2), sha256_size - (i * 2), "%02x", sha256_binary[i]);
+        }
+        sha256_hex[sha256_len * 2] = '\0';
+    }
+
+    return true;
+}
+
+void stream_digest_free(StreamDigest* digest)
+{
+    if (!digest) {
+        return;
+    }
+    EVP_MD_CTX_free(digest->md5);
+    EVP_MD_CTX_free(digest->sha256);
+    free(digest);
+}
@@ -0,0 +1,522 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file parallel_gzip.c
+ * @brief Block-parallel gzip writer implementation
+ *
+ * The caller fills one block at a time. Full blocks are queued for the
+ * workers and written back strictly in submission order, so at most
+ * 2 * threads blocks are held in memory at once.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
+#include <zlib.h>
+#include "parallel_gzip.h"
+#include "uploadstblogs_types.h"
+#include "rdk_debug.h"
+
+#define GZIP_DICT_SIZE      32768
+#define GZIP_HEADER_SIZE    10
+#define GZIP_TRAILER_SIZE   8
+
+typedef struct GzipBlock {
+    struct GzipBlock* next;         /* Work queue link */
+    struct GzipBlock* order_next;   /* Submission order link */
+    unsigned char* in;
+    size_t in_len;
+    unsigned char dict[GZIP_DICT_SIZE];
+    size_t dict_len;
+    unsigned char* out;
+    size_t out_len;
+    unsigned long crc;
+    int level;                      /* Deflate level in effect when submitted */
+    bool last;
+    bool done;
+    bool failed;
+} GzipBlock;
+
+struct ParallelGzip {
+    int fd;
+    int level;
+    int strategy;
+    pthread_t workers[PARALLEL_GZIP_MAX_THREADS];
+    int worker_count;
+    int max_in_flight;
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+    GzipBlock* queue_head;          /* Blocks waiting for a worker */
+    GzipBlock* queue_tail;
+    GzipBlock* order_head;          /* Blocks not yet written, oldest first */
+    GzipBlock* order_tail;
+    int in_flight;
+    bool shutdown;
+
+    GzipBlock* current;             /* Block being filled by the caller */
+    unsigned char dict[GZIP_DICT_SIZE];
+    size_t dict_len;
+    unsigned long crc;
+    unsigned long long total_in;
+    bool error;
+
+    unsigned char header[GZIP_HEADER_SIZE];
+    ParallelGzipSink sink;          /* Optional observer of the output */
+    void* sink_arg;
+};
+
+/**
+ * @brief Write the whole buffer, retrying on short writes and EINTR
+ */
+static int write_all(int fd, const unsigned char* buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Write output to the file and pass it to the sink
+ */
+static int emit(ParallelGzip* pgz, const unsigned char* buf, size_t len)
+{
+    if (write_all(pgz->fd, buf, len) != 0) {
+        return -1;
+    }
+    if (pgz->sink) {
+        pgz->sink(pgz->sink_arg, buf, len);
+    }
+    return 0;
+}
+
+static void free_block(GzipBlock* block)
+{
+    if (block) {
+        free(block->in);
+        free(block->out);
+        free(block);
+    }
+}
+
+static GzipBlock* alloc_block(void)
+{
+    GzipBlock* block = (GzipBlock*)calloc(1, sizeof(GzipBlock));
+    if (!block) {
+        return NULL;
+    }
+    block->in = (unsigned char*)malloc(PARALLEL_GZIP_BLOCK_SIZE);
+    if (!block->in) {
+        free(block);
+        return NULL;
+    }
+    return block;
+}
+
+/**
+ * @brief Deflate one block as raw deflate data
+ *
+ * Non-final blocks end with a sync flush so they are byte aligned and can
+ * be concatenated; the final block is finished normally.
+ */
+static void compress_block(const ParallelGzip* pgz, GzipBlock* block)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+
+    block->crc = crc32(crc32(0L, Z_NULL, 0), block->in, (uInt)block->in_len);
+
+    if (deflateInit2(&zs, block->level, Z_DEFLATED, -15, 8, pgz->strategy) != Z_OK) {
+        block->failed = true;
+        return;
+    }
+    if (block->dict_len > 0 &&
+        deflateSetDictionary(&zs, block->dict, (uInt)block->dict_len) != Z_OK) {
+        deflateEnd(&zs);
+        block->failed = true;
+        return;
+    }
+
+    size_t capacity = deflateBound(&zs, block->in_len) + 16;
+    block->out = (unsigned char*)malloc(capacity);
+    if (!block->out) {
+        deflateEnd(&zs);
+        block->failed = true;
+        return;
+    }
+
+    int flush = block->last ? Z_FINISH : Z_SYNC_FLUSH;
+    zs.next_in = block->in;
+    zs.avail_in = (uInt)block->in_len;
+    zs.next_out = block->out;
+    zs.avail_out = (uInt)capacity;
+
+    for (;;) {
+        if (zs.avail_out == 0) {
+            unsigned char* grown = (unsigned char*)realloc(block->out, capacity * 2);
+            if (!grown) {
+                block->failed = true;
+                break;
+            }
+            block->out = grown;
+            zs.next_out = block->out + capacity;
+            zs.avail_out = (uInt)capacity;
+            capacity *= 2;
+        }
+        int ret = deflate(&zs, flush);
+        if (ret == Z_STREAM_ERROR) {
+            block->failed = true;
+            break;
+        }
+        if (zs.avail_out != 0 && (!block->last || ret == Z_STREAM_END)) {
+            break;
+        }
+    }
+
+    block->out_len = capacity - zs.avail_out;
+    deflateEnd(&zs);
+}
+
+static void* gzip_worker(void* arg)
+{
+    ParallelGzip* pgz = (ParallelGzip*)arg;
+
+    pthread_mutex_lock(&pgz->lock);
+    for (;;) {
+        while (!pgz->queue_head && !pgz->shutdown) {
+            pthread_cond_wait(&pgz->work_cond, &pgz->lock);
+        }
+        if (!pgz->queue_head) {
+            break;
+        }
+
+        GzipBlock* block = pgz->queue_head;
+        pgz->queue_head = block->next;
+        if (!pgz->queue_head) {
+            pgz->queue_tail = NULL;
+        }
+        pthread_mutex_unlock(&pgz->lock);
+
+        compress_block(pgz, block);
+
+        pthread_mutex_lock(&pgz->lock);
+        block->done = true;
+        pthread_cond_broadcast(&pgz->done_cond);
+    }
+    pthread_mutex_unlock(&pgz->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Write finished blocks in order
+ * @param wait_all Wait for every outstanding block instead of only
+ *                 enough to get back under the in-flight limit
+ */
+static void drain_blocks(ParallelGzip* pgz, bool wait_all)
+{
+    pthread_mutex_lock(&pgz->lock);
+    while (pgz->order_head &&
+           (pgz->order_head->done || wait_all || pgz->in_flight >= pgz->max_in_flight)) {
+        GzipBlock* block = pgz->order_head;
+        if (!block->done) {
+            pthread_cond_wait(&pgz->done_cond, &pgz->lock);
+            continue;
+        }
+
+        pgz->order_head = block->order_next;
+        if (!pgz->order_head) {
+            pgz->order_tail = NULL;
+        }
+        pgz->in_flight--;
+        pthread_mutex_unlock(&pgz->lock);
+
+        if (block->failed) {
+            RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                    "[%s:%d] Block compression failed\n", __FUNCTION__, __LINE__);
+            pgz->error = true;
+        }
+        if (!pgz->error) {
+            if (emit(pgz, block->out, block->out_len) != 0) {
+                RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                        "[%s:%d] Failed to write compressed block (errno=%d)\n",
+                        __FUNCTION__, __LINE__, errno);
+                pgz->error = true;
+            }
+            pgz->crc = crc32_combine(pgz->crc, block->crc, (z_off_t)block->in_len);
+        }
+        free_block(block);
+
+        pthread_mutex_lock(&pgz->lock);
+    }
+    pthread_mutex_unlock(&pgz->lock);
+}
+
+/**
+ * @brief Hand the current block to the workers
+ */
+static void submit_block(ParallelGzip* pgz, bool last)
+{
+    GzipBlock* block = pgz->current;
+    pgz->current = NULL;
+
+    block->last = last;
+    block->level = pgz->level;
+    memcpy(block->dict, pgz->dict, pgz->dict_len);
+    block->dict_len = pgz->dict_len;
+
+    // The next block is primed with the last 32 KB seen so far
+    if (block->in_len >= GZIP_DICT_SIZE) {
+        memcpy(pgz->dict, block->in + block->in_len - GZIP_DICT_SIZE, GZIP_DICT_SIZE);
+        pgz->dict_len = GZIP_DICT_SIZE;
+    } else {
+        size_t keep = pgz->dict_len;
+        if (keep + block->in_len > GZIP_DICT_SIZE) {
+            keep = GZIP_DICT_SIZE - block->in_len;
+        }
+        memmove(pgz->dict, pgz->dict + pgz->dict_len - keep, keep);
+        memcpy(pgz->dict + keep, block->in, block->in_len);
+        pgz->dict_len = keep + block->in_len;
+    }
+
+    pthread_mutex_lock(&pgz->lock);
+    if (pgz->queue_tail) {
+        pgz->queue_tail->next = block;
+    } else {
+        pgz->queue_head = block;
+    }
+    pgz->queue_tail = block;
+    if (pgz->order_tail) {
+        pgz->order_tail->order_next = block;
+    } else {
+        pgz->order_head = block;
+    }
+    pgz->order_tail = block;
+    pgz->in_flight++;
+    pthread_cond_signal(&pgz->work_cond);
+    pthread_mutex_unlock(&pgz->lock);
+}
+
+static void stop_workers(ParallelGzip* pgz)
+{
+    pthread_mutex_lock(&pgz->lock);
+    pgz->shutdown = true;
+    pthread_cond_broadcast(&pgz->work_cond);
+    pthread_mutex_unlock(&pgz->lock);
+
+    for (int i = 0; i < pgz->worker_count; i++) {
+        pthread_join(pgz->workers[i], NULL);
+    }
+    pgz->worker_count = 0;
+}
+
+static void destroy(ParallelGzip* pgz)
+{
+    free_block(pgz->current);
+    while (pgz->order_head) {
+        GzipBlock* next = pgz->order_head->order_next;
+        free_block(pgz->order_head);
+        pgz->order_head = next;
+    }
+    pthread_cond_destroy(&pgz->done_cond);
+    pthread_cond_destroy(&pgz->work_cond);
+    pthread_mutex_destroy(&pgz->lock);
+    if (pgz->fd >= 0) {
+        close(pgz->fd);
+    }
+    free(pgz);
+}
+
+ParallelGzip* parallel_gzip_open(const char* path, int level, int strategy, int threads)
+{
+    if (!path || level < 0 || level > 9 || threads < 2) {
+        return NULL;
+    }
+    if (threads > PARALLEL_GZIP_MAX_THREADS) {
+        threads = PARALLEL_GZIP_MAX_THREADS;
+    }
+
+    ParallelGzip* pgz = (ParallelGzip*)calloc(1, sizeof(ParallelGzip));
+    if (!pgz) {
+        return NULL;
+    }
+    pgz->level = level;
+    pgz->strategy = strategy;
+    pgz->max_in_flight = threads * 2;
+    pgz->crc = crc32(0L, Z_NULL, 0);
+    pthread_mutex_init(&pgz->lock, NULL);
+    pthread_cond_init(&pgz->work_cond, NULL);
+    pthread_cond_init(&pgz->done_cond, NULL);
+
+    pgz->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (pgz->fd < 0) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to create %s (errno=%d)\n", __FUNCTION__, __LINE__, path, errno);
+        destroy(pgz);
+        return NULL;
+    }
+
+    // Fixed gzip header: deflate, no name, no mtime, OS = Unix
+    const unsigned char header[GZIP_HEADER_SIZE] = {
+        0x1f, 0x8b, 8, 0, 0, 0, 0, 0,
+        (unsigned char)(level == 9 ? 2 : (level == 1 ? 4 : 0)), 3
+    };
+    memcpy(pgz->header, header, sizeof(header));
+    if (write_all(pgz->fd, pgz->header, sizeof(pgz->header)) != 0) {
+        destroy(pgz);
+        return NULL;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&pgz->workers[i], NULL, gzip_worker, pgz) != 0) {
+            RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                    "[%s:%d] Failed to start compression worker %d\n", __FUNCTION__, __LINE__, i);
+            stop_workers(pgz);
+            destroy(pgz);
+            return NULL;
+        }
+        pgz->worker_count++;
+    }
+
+    return pgz;
+}
+
+void parallel_gzip_set_sink(ParallelGzip* pgz, ParallelGzipSink sink, void* arg)
+{
+    if (!pgz) {
+        return;
+    }
+    pgz->sink = sink;
+    pgz->sink_arg = arg;
+    if (sink) {
+        sink(arg, pgz->header, sizeof(pgz->header));
+    }
+}
+
+int parallel_gzip_write(ParallelGzip* pgz, const void* buf, size_t len)
+{
+    if (!pgz || (!buf && len > 0) || pgz->error) {
+        return -1;
+    }
+
+    const unsigned char* src = (const unsigned char*)buf;
+    while (len > 0) {
+        if (!pgz->current) {
+            pgz->current = alloc_block();
+            if (!pgz->current) {
+                pgz->error = true;
+                return -1;
+            }
+        }
+
+        size_t room = PARALLEL_GZIP_BLOCK_SIZE - pgz->current->in_len;
+        size_t n = (len < room) ? len : room;
+        memcpy(pgz->current->in + pgz->current->in_len, src, n);
+        pgz->current->in_len += n;
+        pgz->total_in += n;
+        src += n;
+        len -= n;
+
+        if (pgz->current->in_len == PARALLEL_GZIP_BLOCK_SIZE) {
+            submit_block(pgz, false);
+            drain_blocks(pgz, false);
+        }
+    }
+
+    return pgz->error ? -1 : 0;
+}
+
+int parallel_gzip_set_level(ParallelGzip* pgz, int level)
+{
+    if (!pgz || level < 0 || level > 9 || pgz->error) {
+        return -1;
+    }
+    if (level == pgz->level) {
+        return 0;
+    }
+
+    // Close the partial block so the new level starts at a block boundary
+    if (pgz->current && pgz->current->in_len > 0) {
+        submit_block(pgz, false);
+        drain_blocks(pgz, false);
+    }
+    pgz->level = level;
+    return pgz->error ? -1 : 0;
+}
+
+long parallel_gzip_bytes_in(const ParallelGzip* pgz)
+{
+    return pgz ? (long)pgz->total_in : -1;
+}
+
+int parallel_gzip_close(ParallelGzip* pgz)
+{
+    if (!pgz) {
+        return -1;
+    }
+
+    // Always end with a final block, even an empty one, to close the stream
+    if (!pgz->current) {
+        pgz->current = alloc_block();
+    }
+    if (pgz->current) {
+        submit_block(pgz, true);
+    } else {
+        pgz->error = true;
+    }
+    drain_blocks(pgz, true);
+    stop_workers(pgz);
+
+    if (!pgz->error) {
+        unsigned char trailer[GZIP_TRAILER_SIZE];
+        uint32_t isize = (uint32_t)(pgz->total_in & 0xffffffffULL);
+        for (int i = 0; i < 4; i++) {
+            trailer[i] = (unsigned char)((pgz->crc >> (8 * i)) & 0xff);
+            trailer[4 + i] = (unsigned char)((isize >> (8 * i)) & 0xff);
+        }
+        if (emit(pgz, trailer, sizeof(trailer)) != 0) {
+            pgz->error = true;
+        }
+    }
+
+    if (close(pgz->fd) != 0) {
+        pgz->error = true;
+    }
+    pgz->fd = -1;
+
+    int ret = pgz->error ? -1 : 0;
+    destroy(pgz);
+    return ret;
+}
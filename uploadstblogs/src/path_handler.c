@@ -25,9 +25,17 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <curl/curl.h>
 #include "path_handler.h"
 #include "verification.h"
 #include "md5_utils.h"
+#include "upload_http.h"
+#include "upload_multipart.h"
+#include "upload_hedge.h"
 #include "rdk_debug.h"
 
 // Include the upload library headers
@@ -40,12 +48,242 @@
 
 /* Output file paths */
 #define HTTP_RESULTS_FILE(scenario) ((scenario) == STRAT_RRD ? "/tmp/rrd_httpresults.txt" : "/tmp/httpresults.txt")
+/* Private per-attempt results file for the Direct metadata POST (mkstemp template) */
+#define HTTP_RESULTS_TEMPLATE(scenario) ((scenario) == STRAT_RRD ? "/tmp/rrd_httpresults.XXXXXX" : "/tmp/httpresults.XXXXXX")
 
 /* Forward declarations */
 static UploadResult attempt_proxy_fallback(RuntimeContext* ctx, SessionState* session, const char* archive_filepath, const char* md5_ptr);
 static UploadResult perform_metadata_post(RuntimeContext* ctx, SessionState* session, const char* endpoint_url, const char* archive_filepath, const char* md5_ptr, MtlsAuth_t* auth);
 static UploadResult perform_s3_put_with_fallback(RuntimeContext* ctx, SessionState* session, const char* archive_filepath, const char* md5_ptr, MtlsAuth_t* auth);
 
+static long elapsed_ms_since(const struct timespec* start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long)(now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+/**
+ * @brief Rate cap configured for this upload
+ * @return Cap in bytes/s, 0 = uncapped
+ */
+static long upload_rate_bps(const RuntimeContext* ctx, const SessionState* session)
+{
+    int kbit = UPLOAD_RATE_UNCAPPED;
+
+    if (session->strategy == STRAT_RRD) {
+        kbit = ctx->upload_rate_rrd_kbit;
+    } else if (ctx->trigger_type >= 0 && ctx->trigger_type < COMPRESSION_TRIGGER_SLOTS) {
+        kbit = ctx->upload_rate_kbit[ctx->trigger_type];
+    }
+    return kbit > 0 ? (long)kbit * 1000 / 8 : 0;
+}
+
+/**
+ * @brief Report the throughput achieved by a successful S3 PUT
+ * @param put PUT response with bytes sent and elapsed time
+ */
+static void report_put_throughput(const UploadResponse* put)
+{
+    if (put->bytes <= 0 || put->elapsed_ms <= 0) {
+        return;
+    }
+
+    // Bits per millisecond are kbit/s
+    char value[32];
+    snprintf(value, sizeof(value), "%lld", put->bytes * 8 / put->elapsed_ms);
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, "[%s:%d] S3 PUT throughput: %lld bytes in %ld ms, %s kbit/s\n",
+            __FUNCTION__, __LINE__, put->bytes, put->elapsed_ms, value);
+    t2_val_notify("LUThroughput_split", value);
+}
+
+static bool race_lost_check(const void* racer)
+{
+    return upload_race_lost((const struct UploadRacer*)racer);
+}
+
+/**
+ * @brief PUT the archive to the presigned URL, in parts once it reaches the multipart threshold
+ * @return curl code of the transfer, session->put holds the response
+ *
+ * While racing the other path, the transfer stops as soon as that path has won.
+ */
+static int put_archive(RuntimeContext* ctx, SessionState* session, const char* archive_filepath,
+                       const UploadHttpCert* cert)
+{
+    struct stat st;
+    UploadHttpCancel race_cancel = { race_lost_check, session->racer };
+    const UploadHttpCancel* cancel = session->racer ? &race_cancel : NULL;
+
+    upload_http_set_rate_limit(upload_rate_bps(ctx, session), ctx->upload_rate_adaptive);
+
+    if (ctx->multipart_threshold_mb > 0 && stat(archive_filepath, &st) == 0 &&
+        (long long)st.st_size >= (long long)ctx->multipart_threshold_mb * 1024 * 1024) {
+        MultipartConfig config = {
+            .part_size = (long long)ctx->multipart_part_mb * 1024 * 1024,
+            .parallel = ctx->multipart_parallel,
+            .part_attempts = MULTIPART_PART_ATTEMPTS,
+            .manifest_path = UPLOAD_MULTIPART_FILE,
+            .cancel = cancel,
+        };
+        MultipartResult result = upload_multipart_put(session->post.presigned_url, archive_filepath, cert,
+                                                      ctx->ocsp_enabled, ctx->curl_tls_timeout,
+                                                      &config, &session->put);
+        if (result != MULTIPART_UNSUPPORTED) {
+            return session->put.curl_code;
+        }
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] Multipart upload not available, sending %s in a single PUT\n",
+                __FUNCTION__, __LINE__, archive_filepath);
+    }
+
+    return upload_http_put(session->post.presigned_url, archive_filepath, cert,
+                           ctx->ocsp_enabled, ctx->curl_tls_timeout, cancel, &session->put);
+}
+
+/**
+ * @brief Get the archive SHA256, hashing the file only if it is not known yet
+ *
+ * Archives created by this run carry their digests in the session from
+ * archive_manager; RRD archives are hashed on first use and cached so
+ * retries do not read the file again.
+ */
+static const char* get_archive_sha256(SessionState* session, const char* archive_filepath)
+{
+    if (session->archive_sha256[0] == '\0' &&
+        !calculate_file_sha256(archive_filepath, session->archive_sha256, sizeof(session->archive_sha256))) {
+        session->archive_sha256[0] = '\0';
+        return NULL;
+    }
+    return session->archive_sha256;
+}
+
+/**
+ * @brief Get the base64 archive MD5, hashing the file only if it is not known yet
+ */
+static const char* get_archive_md5(SessionState* session, const char* archive_filepath)
+{
+    if (session->archive_md5[0] == '\0' &&
+        !calculate_file_md5(archive_filepath, session->archive_md5, sizeof(session->archive_md5))) {
+        session->archive_md5[0] = '\0';
+        return NULL;
+    }
+    return session->archive_md5;
+}
+
+/* The upload library keeps the last transfer status process-wide, and
+ * CodeBig responses go to one shared results file, so concurrent sessions
+ * (DRI next to the main reboot upload) take turns for the metadata POSTs.
+ * The two paths use separate locks so that a hedged CodeBig attempt is not
+ * held up by the slow Direct POST it races. */
+static pthread_mutex_t uploadutil_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t codebig_results_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Direct metadata POST started while the archive is being written */
+static pthread_mutex_t early_post_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct {
+    pthread_t tid;
+    bool running;                   /* Thread started and not joined yet */
+    RuntimeContext* ctx;
+    SessionState session;           /* Private copy the POST writes its results to */
+    MtlsAuth_t cert;                /* Certificate accepted by the POST */
+    UploadResult result;
+    char endpoint_url[MAX_URL_LENGTH];
+} early_post;
+
+static void* early_post_thread(void* arg)
+{
+    (void)arg;
+    early_post.result = perform_metadata_post(early_post.ctx, &early_post.session, early_post.endpoint_url,
+                                              early_post.session.archive_file, NULL, &early_post.cert);
+    // Connect to the S3 origin with the PUT's certificate while the archive is still being written
+    if (early_post.result == UPLOADSTB_SUCCESS) {
+        UploadHttpCert cert = {
+            .cert_file = early_post.cert.cert_name,
+            .cert_type = early_post.cert.cert_type,
+            .key_pass = early_post.cert.key_pas,
+        };
+        upload_http_prewarm(early_post.session.post.presigned_url, &cert,
+                            early_post.ctx->ocsp_enabled, early_post.ctx->curl_tls_timeout);
+    }
+    return NULL;
+}
+
+void start_early_metadata_post(RuntimeContext* ctx, SessionState* session, const char* archive_path)
+{
+    if (!ctx || !session || !archive_path || ctx->encryption_enable) {
+        return;
+    }
+
+    const char* endpoint_url = (strlen(ctx->endpoint_url) > 0) ? ctx->endpoint_url : ctx->upload_http_link;
+    if (strlen(endpoint_url) == 0 || strlen(archive_path) >= sizeof(early_post.session.archive_file)) {
+        return;
+    }
+
+    cancel_early_metadata_post();
+
+    pthread_mutex_lock(&early_post_lock);
+    early_post.ctx = ctx;
+    early_post.session = *session;
+    memset(&early_post.session.post, 0, sizeof(early_post.session.post));
+    strcpy(early_post.session.archive_file, archive_path);
+    strcpy(early_post.endpoint_url, endpoint_url);
+    memset(&early_post.cert, 0, sizeof(early_post.cert));
+    early_post.result = UPLOADSTB_FAILED;
+
+    if (pthread_create(&early_post.tid, NULL, early_post_thread, NULL) != 0) {
+        pthread_mutex_unlock(&early_post_lock);
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] Could not start metadata POST thread, POST follows the archive\n",
+                __FUNCTION__, __LINE__);
+        return;
+    }
+    early_post.running = true;
+    pthread_mutex_unlock(&early_post_lock);
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] Metadata POST for %s sent while the archive is written\n",
+            __FUNCTION__, __LINE__, archive_path);
+}
+
+void cancel_early_metadata_post(void)
+{
+    pthread_mutex_lock(&early_post_lock);
+    if (early_post.running) {
+        pthread_join(early_post.tid, NULL);
+        early_post.running = false;
+    }
+    pthread_mutex_unlock(&early_post_lock);
+}
+
+/**
+ * @brief Take the result of the early metadata POST if it was sent for this archive
+ * @return true if session and cert now hold the POST outcome in *result
+ *
+ * A POST for another archive is left for the session uploading that one.
+ */
+static bool take_early_metadata_post(SessionState* session, const char* archive_filepath,
+                                     MtlsAuth_t* cert, UploadResult* result)
+{
+    pthread_mutex_lock(&early_post_lock);
+    if (!early_post.running || strcmp(early_post.session.archive_file, archive_filepath) != 0) {
+        pthread_mutex_unlock(&early_post_lock);
+        return false;
+    }
+    pthread_join(early_post.tid, NULL);
+    early_post.running = false;
+    pthread_mutex_unlock(&early_post_lock);
+
+    session->http_code = early_post.session.http_code;
+    session->curl_code = early_post.session.curl_code;
+    session->post = early_post.session.post;
+    *cert = early_post.cert;
+    *result = early_post.result;
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] Using metadata POST sent during archive creation (HTTP %d, %ld ms)\n",
+            __FUNCTION__, __LINE__, session->post.http_code, session->post.elapsed_ms);
+    return true;
+}
+
 UploadResult execute_direct_path(RuntimeContext* ctx, SessionState* session)
 {
     RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB,
@@ -62,6 +300,9 @@ UploadResult execute_direct_path(RuntimeContext* ctx, SessionState* session)
             "[%s:%d] Executing Direct (mTLS) upload path for file: %s\n",
             __FUNCTION__, __LINE__, session->archive_file);
 
+    memset(&session->post, 0, sizeof(session->post));
+    memset(&session->put, 0, sizeof(session->put));
+
     // Prepare upload parameters
     char *archive_filepath = session->archive_file;
     
@@ -77,9 +318,9 @@ UploadResult execute_direct_path(RuntimeContext* ctx, SessionState* session)
         return UPLOADSTB_FAILED;
     }
     
-    // Calculate SHA256 hash of the archive for integrity validation
-    char sha256_hex[65] = {0}; // 64 hex chars + null terminator
-    if (calculate_file_sha256(archive_filepath, sha256_hex, sizeof(sha256_hex))) {
+    // SHA256 of the archive for integrity validation
+    const char *sha256_hex = get_archive_sha256(session, archive_filepath);
+    if (sha256_hex) {
         RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
                 "[%s:%d] Archive SHA256: %s\n",
                 __FUNCTION__, __LINE__, sha256_hex);
@@ -89,15 +330,14 @@ UploadResult execute_direct_path(RuntimeContext* ctx, SessionState* session)
                 __FUNCTION__, __LINE__);
     }
     
-    // Calculate MD5 if encryption enabled (matches script line 440)
-    char md5_base64[64] = {0};
+    // MD5 if encryption enabled (matches script line 440)
     const char *md5_ptr = NULL;
     if (ctx->encryption_enable) {
-        if (calculate_file_md5(archive_filepath, md5_base64, sizeof(md5_base64))) {
-            md5_ptr = md5_base64;
+        md5_ptr = get_archive_md5(session, archive_filepath);
+        if (md5_ptr) {
             RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
                     "[%s:%d] RFC_EncryptCloudUpload_Enable: true, MD5: %s\n",
-                    __FUNCTION__, __LINE__, md5_base64);
+                    __FUNCTION__, __LINE__, md5_ptr);
         } else {
             RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
                     "[%s:%d] Failed to calculate MD5 for encryption\n",
@@ -119,10 +359,14 @@ UploadResult execute_direct_path(RuntimeContext* ctx, SessionState* session)
     // - If S3 PUT fails, proxy fallback is attempted
     
     // Stage 1: Metadata POST (this will be retried by retry_upload)
-    // Certificate will be obtained and stored for Stage 2
+    // Certificate will be obtained and stored for Stage 2; the first attempt
+    // may find the POST already done while the archive was written
     MtlsAuth_t cert_for_s3;
     memset(&cert_for_s3, 0, sizeof(MtlsAuth_t));
-    UploadResult post_result = perform_metadata_post(ctx, session, endpoint_url, archive_filepath, md5_ptr, &cert_for_s3);
+    UploadResult post_result;
+    if (!take_early_metadata_post(session, archive_filepath, &cert_for_s3, &post_result)) {
+        post_result = perform_metadata_post(ctx, session, endpoint_url, archive_filepath, md5_ptr, &cert_for_s3);
+    }
     
     if (post_result != UPLOADSTB_SUCCESS) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
@@ -130,6 +374,13 @@ UploadResult execute_direct_path(RuntimeContext* ctx, SessionState* session)
                 __FUNCTION__, __LINE__, session->http_code, session->curl_code);
         return post_result;  // Return to retry_upload for potential retry
     }
+
+    upload_race_post_done(session->racer);
+    if (upload_race_lost(session->racer)) {
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                "[%s:%d] CodeBig path already uploaded the archive, skipping S3 PUT\n", __FUNCTION__, __LINE__);
+        return UPLOADSTB_ABORTED;
+    }
     
     // Stage 2: S3 PUT (done once, with proxy fallback if it fails)
     // Matches script lines 576-650
@@ -153,18 +404,20 @@ UploadResult execute_codebig_path(RuntimeContext* ctx, SessionState* session)
         return UPLOADSTB_FAILED;
     }
 
+    memset(&session->post, 0, sizeof(session->post));
+    memset(&session->put, 0, sizeof(session->put));
+
     // Prepare upload parameters
     char *archive_filepath = session->archive_file;
     
-    // Calculate MD5 if encryption enabled (matches script line 440)
-    char md5_base64[64] = {0};
+    // MD5 if encryption enabled (matches script line 440)
     const char *md5_ptr = NULL;
     if (ctx->encryption_enable) {
-        if (calculate_file_md5(archive_filepath, md5_base64, sizeof(md5_base64))) {
-            md5_ptr = md5_base64;
+        md5_ptr = get_archive_md5(session, archive_filepath);
+        if (md5_ptr) {
             RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
                     "[%s:%d] RFC_EncryptCloudUpload_Enable: true, MD5: %s\n",
-                    __FUNCTION__, __LINE__, md5_base64);
+                    __FUNCTION__, __LINE__, md5_ptr);
         } else {
             RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
                     "[%s:%d] Failed to calculate MD5 for encryption\n",
@@ -177,15 +430,31 @@ UploadResult execute_codebig_path(RuntimeContext* ctx, SessionState* session)
     }
     
     // Stage 1: Metadata POST
+    // Pass a shared handle so the response headers (Retry-After) reach the session
+    // and retries resume the TLS session; if it cannot be created the library
+    // falls back to its own
+    CURL* curl = upload_http_acquire();
+    if (curl) {
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, upload_http_retry_after_header);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &session->retry_after);
+    }
+
     // performCodeBigMetadataPost signature: (curl, filepath, extra_fields, server_type, http_code_out)
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
     long http_code = 0;
+    pthread_mutex_lock(&codebig_results_lock);
     int metadata_result = performCodeBigMetadataPost(
-        NULL,                             // curl (NULL = library will init/cleanup)
+        curl,                             // curl (NULL = library will init/cleanup)
         archive_filepath,                 // filepath
         md5_ptr,                          // extra_fields (MD5 hash, can be NULL)
         HTTP_SSR_CODEBIG,                 // server_type parameter
         &http_code                        // http_code_out
     );
+    upload_http_release(curl);
+    session->post.elapsed_ms = elapsed_ms_since(&start);
+    session->post.http_code = (int)http_code;
+    session->post.curl_code = metadata_result;
 
     if (metadata_result != 0) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
@@ -193,13 +462,16 @@ UploadResult execute_codebig_path(RuntimeContext* ctx, SessionState* session)
                 __FUNCTION__, __LINE__, metadata_result, http_code);
         session->curl_code = metadata_result;
         session->http_code = (int)http_code;
+        pthread_mutex_unlock(&codebig_results_lock);
         return UPLOADSTB_FAILED;
     }
 
-    // Read S3 presigned URL from appropriate output file
-    char s3_url[1024] = {0};
+    // The CodeBig library writes its response to the shared results file; read it once
     const char* results_file = HTTP_RESULTS_FILE(session->strategy);
-    if (extractS3PresignedUrl(results_file, s3_url, sizeof(s3_url)) != 0) {
+    int extract_result = extractS3PresignedUrl(results_file, session->post.presigned_url,
+                                               sizeof(session->post.presigned_url));
+    pthread_mutex_unlock(&codebig_results_lock);
+    if (extract_result != 0) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
                 "[%s:%d] Failed to extract S3 URL from %s\n",
                 __FUNCTION__, __LINE__, results_file);
@@ -208,15 +480,26 @@ UploadResult execute_codebig_path(RuntimeContext* ctx, SessionState* session)
 
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
             "[%s:%d] CodeBig metadata POST succeeded. S3 URL: %s\n",
-            __FUNCTION__, __LINE__, s3_url);
+            __FUNCTION__, __LINE__, session->post.presigned_url);
+
+    upload_race_post_done(session->racer);
+    if (upload_race_lost(session->racer)) {
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                "[%s:%d] Direct path already uploaded the archive, skipping S3 PUT\n", __FUNCTION__, __LINE__);
+        return UPLOADSTB_ABORTED;
+    }
 
     // Stage 2: S3 PUT
     // performCodeBigS3Put signature: (s3_url, src_file)
-    int s3_result = performCodeBigS3Put(s3_url, archive_filepath);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int s3_result = performCodeBigS3Put(session->post.presigned_url, archive_filepath);
 
     // Update session state with result
     session->curl_code = s3_result;
     session->http_code = (s3_result == 0) ? 200 : 0;  // Assume 200 on success
+    session->put.elapsed_ms = elapsed_ms_since(&start);
+    session->put.http_code = session->http_code;
+    session->put.curl_code = s3_result;
 
     if (s3_result != 0) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
@@ -231,6 +514,12 @@ UploadResult execute_codebig_path(RuntimeContext* ctx, SessionState* session)
         return UPLOADSTB_FAILED;
     }
 
+    struct stat st;
+    if (stat(archive_filepath, &st) == 0) {
+        session->put.bytes = (long long)st.st_size;
+        report_put_throughput(&session->put);
+    }
+
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
             "[%s:%d] CodeBig upload completed successfully\n", __FUNCTION__, __LINE__);
     return UPLOADSTB_SUCCESS;
@@ -257,20 +546,17 @@ static UploadResult attempt_proxy_fallback(RuntimeContext* ctx, SessionState* se
             "[%s:%d] Trying logupload through Proxy server: %s\n",
             __FUNCTION__, __LINE__, ctx->proxy_bucket);
     
-    // Read S3 URL from appropriate results file (saved during presign step)
-    char s3_url[1024] = {0};
+    // S3 URL returned by the metadata POST of this attempt
+    char s3_url[MAX_URL_LENGTH] = {0};
     char proxy_url[1024] = {0};
     
-    const char* results_file = HTTP_RESULTS_FILE(session->strategy);
-    FILE* result_file = fopen(results_file, "r");
-    if (!result_file || !fgets(s3_url, sizeof(s3_url), result_file)) {
+    if (session->post.presigned_url[0] == '\0') {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
-                "[%s:%d] Could not read S3 URL from %s for proxy fallback\n",
-                __FUNCTION__, __LINE__, results_file);
-        if (result_file) fclose(result_file);
+                "[%s:%d] No S3 URL from the metadata POST for proxy fallback\n",
+                __FUNCTION__, __LINE__);
         return UPLOADSTB_FAILED;
     }
-    fclose(result_file);
+    strncpy(s3_url, session->post.presigned_url, sizeof(s3_url) - 1);
     
     // Remove trailing newline
     char* newline = strchr(s3_url, '\n');
@@ -302,12 +588,8 @@ static UploadResult attempt_proxy_fallback(RuntimeContext* ctx, SessionState* se
         // Query comes before path, no path part
         path_part = "";
     } else if (query_start && path_start && query_start > path_start) {
-        // Remove query parameters from path
-        size_t path_len = query_start - path_start;
-        static char clean_path[512];
-        strncpy(clean_path, path_start, path_len);
-        clean_path[path_len] = '\0';
-        path_part = clean_path;
+        // Remove query parameters from path (s3_url is this call's own copy)
+        *query_start = '\0';
     }
     
     // Check if the combined URL will fit in the buffer
@@ -341,12 +623,17 @@ static UploadResult attempt_proxy_fallback(RuntimeContext* ctx, SessionState* se
     
     // Upload to proxy using enhanced function
     UploadStatusDetail proxy_status;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
     int proxy_result = performS3PutUploadEx(proxy_url, archive_filepath, NULL, 
                                             md5_ptr, ctx->ocsp_enabled, &proxy_status);
     
     // Update session state with real status codes
     session->curl_code = proxy_status.curl_code;
     session->http_code = proxy_status.http_code;
+    session->put.elapsed_ms = elapsed_ms_since(&start);
+    session->put.http_code = proxy_status.http_code;
+    session->put.curl_code = proxy_status.curl_code;
     
     // Report curl error if present
     if (proxy_status.curl_code != 0) {
@@ -384,17 +671,23 @@ static UploadResult attempt_proxy_fallback(RuntimeContext* ctx, SessionState* se
  * @return UploadResult code
  * 
  * Matches script sendTLSSSRRequest (line 344-370): POST filename to get presigned URL
- * Result saved to appropriate HTTP results file based on strategy
+ * The library writes the response to a private temporary file, which is
+ * read into session->post.presigned_url and removed before returning.
  */
 static UploadResult perform_metadata_post(RuntimeContext* ctx, SessionState* session, 
                                           const char* endpoint_url, const char* archive_filepath, 
                                           const char* md5_ptr, MtlsAuth_t* auth)
 {
-    // Set OCSP if enabled (uploadutils will read this via __uploadutil_get_ocsp)
-    __uploadutil_set_ocsp(ctx->ocsp_enabled);
-    
-    // Determine output file based on upload scenario
-    const char* outfile = HTTP_RESULTS_FILE(session->strategy);
+    // Unique output file so concurrent uploads (e.g. RRD during a scheduled run) never share one
+    char outfile[32];
+    strcpy(outfile, HTTP_RESULTS_TEMPLATE(session->strategy));
+    int outfile_fd = mkstemp(outfile);
+    if (outfile_fd < 0) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to create results file (errno=%d)\n", __FUNCTION__, __LINE__, errno);
+        return UPLOADSTB_FAILED;
+    }
+    close(outfile_fd);
     
     RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB,
             "[%s:%d] Using output file for strategy %d: %s\n",
@@ -419,7 +712,12 @@ static UploadResult perform_metadata_post(RuntimeContext* ctx, SessionState* ses
     // - certificate selector management  
     // - certificate rotation loop
     // - cleanup
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
     long http_code = 0;
+    pthread_mutex_lock(&uploadutil_lock);
+    // Set OCSP if enabled (uploadutils will read this via __uploadutil_get_ocsp)
+    __uploadutil_set_ocsp(ctx->ocsp_enabled);
     int result = performMetadataPostWithCertRotationEx(
         endpoint_url,                   // upload URL
         outfile,                        // outfile for HTTP results (RRD or standard)
@@ -432,10 +730,14 @@ static UploadResult perform_metadata_post(RuntimeContext* ctx, SessionState* ses
     long http_status = 0;
     int curl_code = 0;
     __uploadutil_get_status(&http_status, &curl_code);
+    pthread_mutex_unlock(&uploadutil_lock);
     
     // Update session with results
     session->http_code = (int)http_code;
     session->curl_code = curl_code;
+    session->post.elapsed_ms = elapsed_ms_since(&start);
+    session->post.http_code = (int)http_code;
+    session->post.curl_code = curl_code;
     
     // Report curl error if present
     if (curl_code != 0) {
@@ -475,8 +777,18 @@ static UploadResult perform_metadata_post(RuntimeContext* ctx, SessionState* ses
             "[%s:%d] Metadata POST result - HTTP: %d, Curl: %d, Result: %d\n",
             __FUNCTION__, __LINE__, session->http_code, session->curl_code, result);
     
-    // Verify result
-    return verify_upload(session);
+    // Verify result, then keep the presigned URL in memory for the PUT
+    UploadResult verified = verify_upload(session);
+    if (verified == UPLOADSTB_SUCCESS &&
+        extractS3PresignedUrl(outfile, session->post.presigned_url, sizeof(session->post.presigned_url)) != 0) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to extract S3 URL from metadata POST response\n",
+                __FUNCTION__, __LINE__);
+        session->post.presigned_url[0] = '\0';
+        verified = UPLOADSTB_FAILED;
+    }
+    unlink(outfile);
+    return verified;
 }
 
 /**
@@ -494,13 +806,11 @@ static UploadResult perform_s3_put_with_fallback(RuntimeContext* ctx, SessionSta
                                                   const char* archive_filepath, const char* md5_ptr,
                                                   MtlsAuth_t* auth)
 {
-    // Extract S3 presigned URL from appropriate output file
-    char s3_url[1024] = {0};
-    const char* results_file = HTTP_RESULTS_FILE(session->strategy);
-    if (extractS3PresignedUrl(results_file, s3_url, sizeof(s3_url)) != 0) {
+    // Presigned URL kept in memory by the metadata POST
+    if (session->post.presigned_url[0] == '\0') {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
-                "[%s:%d] Failed to extract S3 URL from %s\n",
-                __FUNCTION__, __LINE__, results_file);
+                "[%s:%d] No S3 URL from the metadata POST\n",
+                __FUNCTION__, __LINE__);
         return UPLOADSTB_FAILED;
     }
     
@@ -508,40 +818,24 @@ static UploadResult perform_s3_put_with_fallback(RuntimeContext* ctx, SessionSta
             "[%s:%d] S3 upload query success. Got S3 URL successfully\n",
             __FUNCTION__, __LINE__);
     
-    // Perform S3 PUT upload with the certificate from Stage 1
-    int s3_result = performS3PutWithCert(s3_url, archive_filepath, auth);
-    
-    // Get HTTP code from curl info (script line 608)
-    // Note: performS3PutUpload already updates session state via __uploadutil_set_status
-    
-    // Read curl info file to get codes (matches script pattern)
-    FILE* curl_info = fopen("/tmp/logupload_curl_info", "r");
-    if (curl_info) {
-        long http_code = 0;
-        int scan_result;
-        errno = 0;
-        scan_result = fscanf(curl_info, "%ld", &http_code);
-        if (scan_result == 1) {
-            session->http_code = (int)http_code;
-        } else {
-            if (ferror(curl_info)) {
-                RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
-                        "[%s:%d] Failed to read HTTP code from curl info file due to I/O error errno=%d (%s)\n",
-                        __FUNCTION__, __LINE__, errno, strerror(errno));
-            } else if (feof(curl_info)) {
-                RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
-                        "[%s:%d] Failed to read HTTP code from curl info file: unexpected EOF\n",
-                        __FUNCTION__, __LINE__);
-            } else {
-                RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
-                        "[%s:%d] Failed to parse HTTP code from curl info file (scan_result=%d)\n",
-                        __FUNCTION__, __LINE__, scan_result);
-            }
-            session->http_code = -1;
-        }
-        fclose(curl_info);
+    // Perform S3 PUT upload with the certificate from Stage 1 over the shared
+    // connection pool, so a retry or the DRI upload reuses the connection
+    UploadHttpCert cert = {
+        .cert_file = auth->cert_name,
+        .cert_type = auth->cert_type,
+        .key_pass = auth->key_pas,
+    };
+    int s3_result = put_archive(ctx, session, archive_filepath, &cert);
+    if (s3_result != 0 && upload_race_lost(session->racer)) {
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                "[%s:%d] CodeBig path uploaded the archive first, S3 PUT stopped\n", __FUNCTION__, __LINE__);
+        return UPLOADSTB_ABORTED;
     }
+    session->http_code = session->put.http_code;
     session->curl_code = s3_result;
+    if (session->put.retry_after > session->retry_after) {
+        session->retry_after = session->put.retry_after;
+    }
     
     // Report curl error
     if (s3_result != 0) {
@@ -562,6 +856,7 @@ static UploadResult perform_s3_put_with_fallback(RuntimeContext* ctx, SessionSta
     
     if (s3_verified == UPLOADSTB_SUCCESS) {
         t2_count_notify("TEST_lu_success");  // Script line 616
+        report_put_throughput(&session->put);
         session->success = true;
         RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, "[%s:%d] Direct log upload Success: httpcode= %d\n", __FUNCTION__, __LINE__, session->http_code);
         return UPLOADSTB_SUCCESS;
@@ -22,12 +22,180 @@
  * @brief Retry logic implementation
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
 #include <unistd.h>
+#include <sys/eventfd.h>
 #include "retry_logic.h"
+#include "upload_hedge.h"
 #include "verification.h"
 #include "rdk_debug.h"
 
+/* Without an eventfd, waits re-check the cancel flag this often */
+#define RETRY_WAIT_POLL_MS  1000
+
+static int retry_event_fd = -1;
+static volatile sig_atomic_t retry_cancelled = 0;
+static pthread_once_t retry_event_once = PTHREAD_ONCE_INIT;
+
+static void retry_event_create(void)
+{
+    retry_event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (retry_event_fd < 0) {
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] eventfd failed (errno=%d), retry waits will poll for cancellation\n",
+                __FUNCTION__, __LINE__, errno);
+    }
+}
+
+static long long monotonic_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Seed the jitter so that devices failing at the same moment diverge
+ */
+static unsigned int retry_seed(const RuntimeContext* ctx)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    unsigned int seed = (unsigned int)ts.tv_sec ^ (unsigned int)ts.tv_nsec ^ ((unsigned int)getpid() << 16);
+    for (const char* p = ctx->mac_address; *p; p++) {
+        seed = seed * 31 + (unsigned char)*p;
+    }
+    return seed;
+}
+
+const RetryPolicy* get_retry_policy(const RuntimeContext* ctx, UploadPath path)
+{
+    if (!ctx) {
+        return NULL;
+    }
+    switch (path) {
+        case PATH_DIRECT:
+            return &ctx->direct_retry;
+        case PATH_CODEBIG:
+            return &ctx->codebig_retry;
+        case PATH_NONE:
+        default:
+            return NULL;
+    }
+}
+
+int retry_backoff_ms(const RetryPolicy* policy, int retry, unsigned int* seed)
+{
+    if (!policy || retry < 1 || policy->base_ms <= 0) {
+        return 0;
+    }
+
+    long long cap = (policy->cap_ms > 0) ? policy->cap_ms : INT_MAX;
+    long long bound = policy->base_ms;
+    for (int i = 1; i < retry && policy->multiplier > 1 && bound < cap; i++) {
+        bound *= policy->multiplier;
+    }
+    if (bound > cap) {
+        bound = cap;
+    }
+
+    if (policy->jitter && seed) {
+        // Two draws: RAND_MAX may be as small as 32767
+        unsigned long long r = ((unsigned long long)rand_r(seed) << 16) ^ (unsigned long long)rand_r(seed);
+        bound = (long long)(r % (unsigned long long)(bound + 1));
+    }
+    return (int)bound;
+}
+
+bool retry_wait(int delay_ms)
+{
+    pthread_once(&retry_event_once, retry_event_create);
+
+    long long deadline = monotonic_ms() + (delay_ms > 0 ? delay_ms : 0);
+    while (!retry_cancelled) {
+        long long remaining = deadline - monotonic_ms();
+        if (remaining <= 0) {
+            return true;
+        }
+
+        int timeout = (remaining > INT_MAX) ? INT_MAX : (int)remaining;
+        if (retry_event_fd < 0 && timeout > RETRY_WAIT_POLL_MS) {
+            timeout = RETRY_WAIT_POLL_MS;
+        }
+
+        // A negative fd is ignored by poll(), which then just sleeps
+        struct pollfd pfd = { .fd = retry_event_fd, .events = POLLIN, .revents = 0 };
+        int rc = poll(&pfd, 1, timeout);
+        if (rc > 0) {
+            break;
+        }
+        if (rc < 0 && errno != EINTR) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                    "[%s:%d] poll failed (errno=%d)\n", __FUNCTION__, __LINE__, errno);
+            return !retry_cancelled;
+        }
+    }
+    return false;
+}
+
+void retry_wait_cancel(void)
+{
+    // Flag first: a wait that has not created the eventfd yet still sees it
+    retry_cancelled = 1;
+    if (retry_event_fd >= 0) {
+        uint64_t one = 1;
+        ssize_t rc = write(retry_event_fd, &one, sizeof(one));
+        (void)rc;
+    }
+}
+
+void retry_wait_reset(void)
+{
+    pthread_once(&retry_event_once, retry_event_create);
+    retry_cancelled = 0;
+    if (retry_event_fd >= 0) {
+        uint64_t count;
+        ssize_t rc = read(retry_event_fd, &count, sizeof(count));
+        (void)rc;
+    }
+}
+
+/**
+ * @brief Retry delay that also ends once the other path of a hedged upload won
+ * @return true if the full delay passed
+ */
+static bool retry_wait_session(const SessionState* session, int delay_ms)
+{
+    if (!session->racer) {
+        return retry_wait(delay_ms);
+    }
+    while (!upload_race_lost(session->racer)) {
+        if (delay_ms <= 0) {
+            return true;
+        }
+        int slice = (delay_ms < RETRY_WAIT_POLL_MS) ? delay_ms : RETRY_WAIT_POLL_MS;
+        if (!retry_wait(slice)) {
+            return false;
+        }
+        delay_ms -= slice;
+    }
+    return false;
+}
+
 UploadResult retry_upload(RuntimeContext* ctx, SessionState* session, 
                          UploadPath path,
                          UploadResult (*attempt_func)(RuntimeContext*, SessionState*, UploadPath))
@@ -46,10 +214,12 @@ UploadResult retry_upload(RuntimeContext* ctx, SessionState* session,
             path == PATH_CODEBIG ? "CodeBig" : "Unknown");
 
     UploadResult result = UPLOADSTB_FAILED;
+    unsigned int seed = retry_seed(ctx);
     
     do {
         // Increment attempt counter before trying
         increment_attempts(session, path);
+        session->retry_after = 0;
         
         // Report upload attempt telemetry (matches script line 511)
         t2_count_notify("SYST_INFO_LUattempt");
@@ -68,21 +238,42 @@ UploadResult retry_upload(RuntimeContext* ctx, SessionState* session,
         
         // Check if we should continue retrying
         if (should_retry(ctx, session, path, result)) {
-            // Determine retry delay based on path (matches script behavior)
-            int retry_delay = (path == PATH_DIRECT) ? 60 : 10;  // Direct: 60s, CodeBig: 10s
+            int attempts = (path == PATH_DIRECT) ? session->direct_attempts : session->codebig_attempts;
+            // Throttled without a Retry-After: go straight to the capped delay
+            int backoff_retry = is_throttled_response(session->http_code) ? INT_MAX : attempts;
+            int retry_delay_ms = retry_backoff_ms(get_retry_policy(ctx, path), backoff_retry, &seed);
+
+            if (session->retry_after > RETRY_AFTER_DEFER_S) {
+                RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                        "[%s:%d] Server asked to retry after %d seconds, deferring upload\n",
+                        __FUNCTION__, __LINE__, session->retry_after);
+                defer_upload(UPLOAD_NOT_BEFORE_FILE, time(NULL) + session->retry_after);
+                return UPLOADSTB_ABORTED;
+            }
+            if (session->retry_after > 0 && session->retry_after * 1000 > retry_delay_ms) {
+                retry_delay_ms = session->retry_after * 1000;
+            }
             
             RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
-                    "[%s:%d] Upload failed, retrying after %d seconds (attempt %d)\n",
-                    __FUNCTION__, __LINE__, retry_delay,
-                    path == PATH_DIRECT ? session->direct_attempts : session->codebig_attempts);
+                    "[%s:%d] Upload failed, retrying after %d ms (attempt %d)\n",
+                    __FUNCTION__, __LINE__, retry_delay_ms, attempts);
             
-            // Sleep before retry (matches script line 522 for direct, line 473 for codebig)
-            sleep(retry_delay);
+            // Cancellable so shutdown does not hold the upload lock for the whole backoff
+            if (!retry_wait_session(session, retry_delay_ms)) {
+                RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                        "[%s:%d] Retry wait cancelled, abandoning upload\n",
+                        __FUNCTION__, __LINE__);
+                return UPLOADSTB_ABORTED;
+            }
         } else {
             RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
                     "[%s:%d] Upload failed, no more retries (total attempts: %d)\n",
                     __FUNCTION__, __LINE__,
                     path == PATH_DIRECT ? session->direct_attempts : session->codebig_attempts);
+            // Keep the next run from coming back before the server wants it
+            if (result != UPLOADSTB_SUCCESS && result != UPLOADSTB_ABORTED && session->retry_after > 0) {
+                defer_upload(UPLOAD_NOT_BEFORE_FILE, time(NULL) + session->retry_after);
+            }
             break;
         }
         
@@ -91,6 +282,102 @@ UploadResult retry_upload(RuntimeContext* ctx, SessionState* session,
     return result;
 }
 
+int parse_retry_after(const char* value, time_t now)
+{
+    if (!value) {
+        return -1;
+    }
+    while (*value == ' ' || *value == '\t') {
+        value++;
+    }
+
+    long long seconds;
+    const char* end;
+    if (isdigit((unsigned char)*value)) {
+        char* num_end = NULL;
+        seconds = strtoll(value, &num_end, 10);
+        end = num_end;
+        // Some rate limiters send the reset as an epoch timestamp
+        if (seconds > 1000000000LL) {
+            seconds -= (long long)now;
+        }
+    } else {
+        struct tm tm;
+        memset(&tm, 0, sizeof(tm));
+        end = strptime(value, "%a, %d %b %Y %H:%M:%S GMT", &tm);
+        if (!end) {
+            return -1;
+        }
+        seconds = (long long)timegm(&tm) - (long long)now;
+    }
+
+    while (*end == ' ' || *end == '\t' || *end == '\r' || *end == '\n') {
+        end++;
+    }
+    if (*end != '\0') {
+        return -1;
+    }
+
+    if (seconds < 0) {
+        seconds = 0;
+    }
+    if (seconds > RETRY_AFTER_MAX_S) {
+        seconds = RETRY_AFTER_MAX_S;
+    }
+    return (int)seconds;
+}
+
+int defer_upload(const char* path, time_t until)
+{
+    if (!path) {
+        return -1;
+    }
+
+    time_t current = 0;
+    if (upload_deferred(path, time(NULL), &current) && current >= until) {
+        return 0;
+    }
+
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to write %s (errno=%d)\n", __FUNCTION__, __LINE__, path, errno);
+        return -1;
+    }
+    fprintf(fp, "%lld\n", (long long)until);
+    fclose(fp);
+
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] Uploads deferred until %lld\n", __FUNCTION__, __LINE__, (long long)until);
+    return 0;
+}
+
+bool upload_deferred(const char* path, time_t now, time_t* until)
+{
+    if (!path) {
+        return false;
+    }
+
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        return false;
+    }
+    long long value = 0;
+    int scanned = fscanf(fp, "%lld", &value);
+    fclose(fp);
+
+    // Expired, garbage, or set before a large clock change
+    if (scanned != 1 || value <= (long long)now || value - (long long)now > RETRY_AFTER_MAX_S) {
+        unlink(path);
+        return false;
+    }
+
+    if (until) {
+        *until = (time_t)value;
+    }
+    return true;
+}
+
 bool should_retry(const RuntimeContext* ctx, const SessionState* session, UploadPath path, UploadResult result)
 {
     if (!ctx || !session) {
@@ -122,21 +409,21 @@ bool should_retry(const RuntimeContext* ctx, const SessionState* session, Upload
     // Check attempt limits based on path
     switch (path) {
         case PATH_DIRECT:
-            if (session->direct_attempts >= ctx->direct_max_attempts) {
+            if (session->direct_attempts >= ctx->direct_retry.max_attempts) {
                 RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
                         "[%s:%d] Direct path max attempts reached (%d/%d)\n",
                         __FUNCTION__, __LINE__, 
-                        session->direct_attempts, ctx->direct_max_attempts);
+                        session->direct_attempts, ctx->direct_retry.max_attempts);
                 return false;
             }
             break;
             
         case PATH_CODEBIG:
-            if (session->codebig_attempts >= ctx->codebig_max_attempts) {
+            if (session->codebig_attempts >= ctx->codebig_retry.max_attempts) {
                 RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
                         "[%s:%d] CodeBig path max attempts reached (%d/%d)\n",
                         __FUNCTION__, __LINE__,
-                        session->codebig_attempts, ctx->codebig_max_attempts);
+                        session->codebig_attempts, ctx->codebig_retry.max_attempts);
                 return false;
             }
             break;
@@ -40,6 +40,7 @@
 #include <time.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/select.h>
 #include <sys/time.h>
@@ -47,6 +48,7 @@
 #include <curl/curl.h>
 #include "strategy_handler.h"
 #include "archive_manager.h"
+#include "upload_index.h"
 #include "upload_engine.h"
 #include "file_operations.h"
 #include "common_device_api.h"
@@ -366,77 +368,20 @@ const StrategyHandler dcm_strategy_handler = {
     .cleanup_phase = dcm_cleanup
 };
 
-/* Copy regular files (not directories) from LOG_PATH to DCM_LOG_PATH.
- * Equivalent to script copyOptLogsFiles(). */
-static int copy_opt_logs_files(const char* src_dir, const char* dest_dir)
-{
-    DIR* dir = opendir(src_dir);
-    if (!dir) {
-        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
-                "[%s:%d] Failed to open source dir: %s\n", __FUNCTION__, __LINE__, src_dir);
-        return -1;
-    }
-
-    struct dirent* entry;
-    int count = 0;
-    char src_path[MAX_PATH_LENGTH];
-    char dest_path[MAX_PATH_LENGTH];
-
-    while ((entry = readdir(dir)) != NULL) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
-            continue;
-        if (entry->d_type == DT_DIR)
-            continue;
-
-        snprintf(src_path, sizeof(src_path), "%s/%s", src_dir, entry->d_name);
-        snprintf(dest_path, sizeof(dest_path), "%s/%s", dest_dir, entry->d_name);
-        if (copy_file(src_path, dest_path))
-            count++;
-    }
-    closedir(dir);
-    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
-            "[%s:%d] Copied %d files from %s to %s\n",
-            __FUNCTION__, __LINE__, count, src_dir, dest_dir);
-    return count;
-}
-
-/* Recursively copy directory contents from src to dest. */
-static int copy_dir_recursive(const char* src_dir, const char* dest_dir)
-{
-    DIR* dir = opendir(src_dir);
-    if (!dir) return -1;
-
-    struct dirent* entry;
-    int count = 0;
-    char src_path[MAX_PATH_LENGTH];
-    char dest_path[MAX_PATH_LENGTH];
-
-    while ((entry = readdir(dir)) != NULL) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
-            continue;
+/* Files to archive for the current DCM run. Populated in setup, streamed
+ * in place by the archive phase and released in cleanup, so no staging
+ * copy of LOG_PATH is made under DCM_LOG_PATH. */
+static ArchiveManifest dcm_manifest = {0};
 
-        snprintf(src_path, sizeof(src_path), "%s/%s", src_dir, entry->d_name);
-        snprintf(dest_path, sizeof(dest_path), "%s/%s", dest_dir, entry->d_name);
-
-        if (entry->d_type == DT_DIR) {
-            if (!create_directory(dest_path)) {
-                continue;
-            }
-            int ret = copy_dir_recursive(src_path, dest_path);
-            if (ret > 0) count += ret;
-        } else {
-            if (copy_file(src_path, dest_path))
-                count++;
-        }
-    }
-    closedir(dir);
-    return count;
-}
+/* Incremental mode: watermarks for dcm_manifest, matched by setup and
+ * advanced over the archived ranges only after a successful upload. */
+static UploadIndex dcm_index = {0};
 
-/* Copy all files/directories from LOG_PATH to DCM_LOG_PATH, excluding
- * dcm, PreviousLogs, PreviousLogs_backup.
- * Equivalent to script copyAllFiles(). */
-static int copy_all_files_to_dcm(const char* src_dir, const char* dest_dir)
+/* Add LOG_PATH entries to the DCM manifest. With all_files set, directories
+ * are included recursively except dcm, PreviousLogs and PreviousLogs_backup
+ * (script copyAllFiles()); otherwise only top-level files are taken (script
+ * copyOptLogsFiles()). */
+static int add_log_path_to_manifest(const char* src_dir, const ArchiveNameRule* rule, bool all_files)
 {
     static const char* exclude[] = {"dcm", "PreviousLogs_backup", "PreviousLogs", NULL};
 
@@ -450,14 +395,16 @@ static int copy_all_files_to_dcm(const char* src_dir, const char* dest_dir)
     struct dirent* entry;
     int count = 0;
     char src_path[MAX_PATH_LENGTH];
-    char dest_path[MAX_PATH_LENGTH];
+    char arcname[MAX_PATH_LENGTH];
 
     while ((entry = readdir(dir)) != NULL) {
         if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
             continue;
+        if (entry->d_type == DT_DIR && !all_files)
+            continue;
 
         bool skip = false;
-        for (int i = 0; exclude[i]; i++) {
+        for (int i = 0; all_files && exclude[i]; i++) {
             if (strcmp(entry->d_name, exclude[i]) == 0) {
                 skip = true;
                 break;
@@ -466,27 +413,25 @@ static int copy_all_files_to_dcm(const char* src_dir, const char* dest_dir)
         if (skip) continue;
 
         snprintf(src_path, sizeof(src_path), "%s/%s", src_dir, entry->d_name);
-        snprintf(dest_path, sizeof(dest_path), "%s/%s", dest_dir, entry->d_name);
+        if (!archive_name_rule_apply(rule, entry->d_name, arcname, sizeof(arcname)))
+            continue;
 
         if (entry->d_type == DT_DIR) {
-            if (!create_directory(dest_path)) {
-                continue;
-            }
-            int ret = copy_dir_recursive(src_path, dest_path);
+            int ret = archive_manifest_add_dir(&dcm_manifest, src_path, arcname);
             if (ret > 0) count += ret;
         } else {
-            if (copy_file(src_path, dest_path))
+            if (archive_manifest_add(&dcm_manifest, src_path, arcname) == 0)
                 count++;
         }
     }
     closedir(dir);
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
-            "[%s:%d] Copied %d items from %s to %s (with exclusions)\n",
-            __FUNCTION__, __LINE__, count, src_dir, dest_dir);
+            "[%s:%d] Added %d files from %s to DCM manifest\n",
+            __FUNCTION__, __LINE__, count, src_dir);
     return count;
 }
 
-/* Read DCM_UPLOAD_LIST, copy listed directories to DCM_LOG_PATH, clear list.
+/* Read DCM_UPLOAD_LIST, add listed directories to the DCM manifest, clear list.
  * Equivalent to script lines 1026-1032. */
 static int process_dcm_upload_list(RuntimeContext* ctx)
 {
@@ -505,29 +450,18 @@ static int process_dcm_upload_list(RuntimeContext* ctx)
         if (strlen(line) == 0) continue;
 
         if (dir_exists(line)) {
-            /* cp -R $line $DCM_LOG_PATH copies the directory itself, not just contents */
+            /* cp -R $line $DCM_LOG_PATH archives the directory itself, not just contents */
             const char* basename = strrchr(line, '/');
             basename = basename ? basename + 1 : line;
 
-            char dest_subdir[MAX_PATH_LENGTH + MAX_PATH_LENGTH];
-            int n = snprintf(dest_subdir, sizeof(dest_subdir), "%s/%s", ctx->dcm_log_path, basename);
-            if (n < 0 || (size_t)n >= sizeof(dest_subdir)) {
-                RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
-                        "[%s:%d] Destination path too long, skipping: %s\n", __FUNCTION__, __LINE__, line);
-                continue;
-            }
-
             /* Skip duplicate entries */
-            if (dir_exists(dest_subdir)) {
-                continue;
-            }
-            if (!create_directory(dest_subdir)) {
+            if (archive_manifest_has_dir(&dcm_manifest, basename)) {
                 continue;
             }
 
             RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
-                    "[%s:%d] Copying batched logs from %s to %s\n", __FUNCTION__, __LINE__, line, dest_subdir);
-            copy_dir_recursive(line, dest_subdir);
+                    "[%s:%d] Adding batched logs from %s as %s/\n", __FUNCTION__, __LINE__, line, basename);
+            archive_manifest_add_dir(&dcm_manifest, line, basename);
             count++;
         }
     }
@@ -550,10 +484,12 @@ static int process_dcm_upload_list(RuntimeContext* ctx)
  * @brief Setup phase for DCM strategy
  * 
  * Shell script equivalent (main flow lines 1022-1041 + uploadDCMLogs lines 698-705):
- * 1. Clean and recreate DCM_LOG_PATH
- * 2. Populate DCM_LOG_PATH: process DCM_UPLOAD_LIST + copy log files, or copy all files
- * 3. Check upload_flag
- * 4. Add timestamps to files in DCM_LOG_PATH
+ * 1. Clean and recreate DCM_LOG_PATH (holds only the output archive)
+ * 2. Check upload_flag
+ * 3. Build the archive manifest from LOG_PATH with timestamped member names
+ * 4. Add DCM_UPLOAD_LIST directories to the manifest
+ *
+ * Log files are archived in place; nothing is copied or renamed.
  */
 static int dcm_setup(RuntimeContext* ctx, SessionState* session)
 {
@@ -577,15 +513,6 @@ static int dcm_setup(RuntimeContext* ctx, SessionState* session)
         return -1;
     }
 
-    // Populate DCM_LOG_PATH with log files (script main flow lines 1022-1041)
-    if (ctx->upload_on_reboot == 1) {
-        // copyAllFiles: copy LOG_PATH/* excluding dcm, PreviousLogs, PreviousLogs_backup
-        copy_all_files_to_dcm(ctx->log_path, ctx->dcm_log_path);
-    } else {
-        // Copy current opt logs first, then batched directories
-        copy_opt_logs_files(ctx->log_path, ctx->dcm_log_path);
-    }
-
     // Check upload_flag from DCMSettings.conf (matches script behavior)
     if (!read_dcm_upload_flag()) {
         RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
@@ -594,25 +521,44 @@ static int dcm_setup(RuntimeContext* ctx, SessionState* session)
         return -1;  // Signal to skip upload
     }
 
-    // Add timestamps to files already in DCM_LOG_PATH (before adding batched dirs)
-    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-            "[%s:%d] Adding timestamps to files in DCM_LOG_PATH\n", 
-            __FUNCTION__, __LINE__);
-    
-    int ret = add_timestamp_to_files(ctx->dcm_log_path);
-    if (ret != 0) {
+    // Timestamp prefix for archive member names (script format: MM-DD-YY-HH-MMAM/PM-)
+    ArchiveNameRule rule;
+    if (!archive_name_rule_init(&rule, time(NULL))) {
         RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
-                "[%s:%d] Failed to add timestamps to some files\n", 
+                "[%s:%d] Failed to format timestamp, archiving original names\n", 
                 __FUNCTION__, __LINE__);
     }
 
-    // Copy batched directories AFTER timestamping (they already have timestamps)
+    // Build manifest from LOG_PATH (script main flow lines 1022-1041)
+    archive_manifest_free(&dcm_manifest);
+    add_log_path_to_manifest(ctx->log_path, &rule, ctx->upload_on_reboot == 1);
+
+    // Batched directories are added AFTER the timestamped files (they already have timestamps)
     if (ctx->upload_on_reboot == 0) {
         process_dcm_upload_list(ctx);
     }
 
+    // Incremental mode: archive only what was appended since the last upload
+    if (ctx->incremental_upload) {
+        if (upload_index_load(&dcm_index, UPLOAD_INDEX_FILE) != 0 ||
+            upload_index_apply(&dcm_index, &dcm_manifest) < 0) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
+                    "[%s:%d] Upload index unavailable, uploading full logs\n", 
+                    __FUNCTION__, __LINE__);
+            upload_index_free(&dcm_index);
+            for (size_t i = 0; i < dcm_manifest.count; i++) {
+                dcm_manifest.entries[i].offset = 0;
+                dcm_manifest.entries[i].length = -1;
+            }
+        } else {
+            // Trim oversized files from the end so the rest goes next time
+            dcm_manifest.keep_head = true;
+        }
+    }
+
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-            "[%s:%d] DCM: Setup phase complete\n", __FUNCTION__, __LINE__);
+            "[%s:%d] DCM: Setup phase complete (%zu files in manifest)\n", 
+            __FUNCTION__, __LINE__, dcm_manifest.count);
 
     return 0;
 }
@@ -621,9 +567,8 @@ static int dcm_setup(RuntimeContext* ctx, SessionState* session)
  * @brief Archive phase for DCM strategy
  * 
  * Shell script equivalent (uploadDCMLogs lines 706-717):
- * - Collect PCAP files to DCM_LOG_PATH if mediaclient
- * - Create tar.gz archive from all files in DCM_LOG_PATH
- * - Sleep 60 seconds
+ * - Add the latest PCAP file to the manifest if mediaclient
+ * - Stream all manifest files into a tar.gz archive in DCM_LOG_PATH
  */
 static int dcm_archive(RuntimeContext* ctx, SessionState* session)
 {
@@ -637,19 +582,19 @@ static int dcm_archive(RuntimeContext* ctx, SessionState* session)
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
             "[%s:%d] DCM: Starting archive phase\n", __FUNCTION__, __LINE__);
 
-    // Collect PCAP files directly to DCM_LOG_PATH if mediaclient
+    // Add PCAP file to the manifest if mediaclient
     if (ctx->include_pcap) {
         RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-                "[%s:%d] Collecting PCAP file to DCM_LOG_PATH\n", __FUNCTION__, __LINE__);
-        int count = collect_pcap_logs(ctx, ctx->dcm_log_path);
+                "[%s:%d] Adding PCAP file to DCM manifest\n", __FUNCTION__, __LINE__);
+        int count = collect_pcap_to_manifest(ctx, &dcm_manifest);
         if (count > 0) {
             RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
                     "[%s:%d] Collected %d PCAP file\n", __FUNCTION__, __LINE__, count);
         }
     }
 
-    // Create archive from DCM_LOG_PATH (files already have timestamps)
-    int ret = create_archive(ctx, session, ctx->dcm_log_path);
+    // Archive manifest files in place, writing the archive to DCM_LOG_PATH
+    int ret = create_archive_from_manifest(ctx, session, &dcm_manifest, ctx->dcm_log_path);
     if (ret != 0) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
                 "[%s:%d] Failed to create archive\n", __FUNCTION__, __LINE__);
@@ -693,9 +638,22 @@ static int dcm_upload(RuntimeContext* ctx, SessionState* session)
             "[%s:%d] Uploading DCM logs: %s\n", 
             __FUNCTION__, __LINE__, archive_path);
 
+    // An uncommitted index resends the same ranges next run, spooling would send them twice
+    session->no_spool = ctx->incremental_upload && dcm_index.count > 0;
+
     // Upload the archive (session->success is set by execute_upload_cycle)
     int ret = upload_archive(ctx, session, archive_path);
 
+    // The server now has every byte range that went into the archive
+    if (ret == 0 && ctx->incremental_upload && dcm_index.count > 0) {
+        if (upload_index_commit(&dcm_index, &dcm_manifest) != 0 ||
+            upload_index_save(&dcm_index, UPLOAD_INDEX_FILE) != 0) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
+                    "[%s:%d] Failed to commit upload index, next upload will resend\n", 
+                    __FUNCTION__, __LINE__);
+        }
+    }
+
     // Clear old packet captures
     if (ctx->include_pcap) {
         RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, 
@@ -715,7 +673,7 @@ static int dcm_upload(RuntimeContext* ctx, SessionState* session)
  * Shell script equivalent (uploadDCMLogs lines 735-737):
  * - Delete entire DCM_LOG_PATH directory
  * - No permanent backup created
- * - No timestamp removal (directory deleted anyway)
+ * - No timestamp removal (source files were never renamed)
  */
 static int dcm_cleanup(RuntimeContext* ctx, SessionState* session, bool upload_success)
 {
@@ -729,6 +687,9 @@ static int dcm_cleanup(RuntimeContext* ctx, SessionState* session, bool upload_s
             "[%s:%d] DCM: Starting cleanup phase (upload_success=%d)\n", 
             __FUNCTION__, __LINE__, upload_success);
 
+    archive_manifest_free(&dcm_manifest);
+    upload_index_free(&dcm_index);
+
     // Delete entire DCM_LOG_PATH directory
     if (dir_exists(ctx->dcm_log_path)) {
         RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
@@ -1053,6 +1014,18 @@ static int reboot_cleanup(RuntimeContext* ctx, SessionState* session, bool uploa
 /* Static storage for permanent log path (used across phases) */
 static char perm_log_path_storage[MAX_PATH_LENGTH] = {0};
 
+/* Timestamp rule for PREV_LOG_PATH member names (set in setup, used in archive) */
+static ArchiveNameRule reboot_name_rule = {{0}};
+
+/**
+ * @brief DRI log upload running next to the main reboot upload
+ */
+typedef struct {
+    RuntimeContext* ctx;
+    SessionState session;           /* Own attempts, retry and fallback state */
+    bool uploaded;                  /* Upload cycle ran, its events are still due */
+} DriUpload;
+
 /* Handler definition */
 const StrategyHandler reboot_strategy_handler = {
     .setup_phase = reboot_setup,
@@ -1070,7 +1043,7 @@ const StrategyHandler reboot_strategy_handler = {
  * 3. Create PERM_LOG_PATH timestamp
  * 4. Log to lastlog_path
  * 5. Delete old tar file
- * 6. Add timestamps to all files in PREV_LOG_PATH
+ * 6. Fix the timestamp prefix for archive member names (files are not renamed)
  */
 static int reboot_setup(RuntimeContext* ctx, SessionState* session)
 {
@@ -1266,15 +1239,11 @@ static int reboot_setup(RuntimeContext* ctx, SessionState* session)
         remove_file(BACKUP_LOGS_LOG_FILE);
     }
 
-    // Add timestamps to all files in PREV_LOG_PATH
-    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-            "[%s:%d] Adding timestamps to files in PREV_LOG_PATH\n", 
-            __FUNCTION__, __LINE__);
-    
-    int ret = add_timestamp_to_files(ctx->prev_log_path);
-    if (ret != 0) {
+    // Timestamps are applied to member names inside the archive only, so
+    // PREV_LOG_PATH is never renamed and needs no restore after upload
+    if (!archive_name_rule_init(&reboot_name_rule, time(NULL))) {
         RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
-                "[%s:%d] Failed to add timestamps to some files\n", 
+                "[%s:%d] Failed to prepare timestamp prefix, archiving original names\n", 
                 __FUNCTION__, __LINE__);
         // Continue anyway, not critical
     }
@@ -1289,28 +1258,31 @@ static int reboot_setup(RuntimeContext* ctx, SessionState* session)
  * @brief Archive phase for REBOOT/NON_DCM strategy
  * 
  * Shell script equivalent (uploadLogOnReboot lines 853-869):
- * - Collect PCAP files to PREV_LOG_PATH if mediaclient
- * - Create tar.gz archive from PREV_LOG_PATH
- * - Sleep 60 seconds
+ * - Add the latest PCAP file to the archive if mediaclient
+ * - Create tar.gz archive from PREV_LOG_PATH with timestamped member names
  */
 static int reboot_archive(RuntimeContext* ctx, SessionState* session)
 {
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
             "[%s:%d] REBOOT/NON_DCM: Starting archive phase\n", __FUNCTION__, __LINE__);
 
-    // Collect PCAP files directly to PREV_LOG_PATH if mediaclient
+    // PCAP file is archived in place under its own name (no copy into PREV_LOG_PATH)
+    ArchiveManifest pcap_manifest;
+    archive_manifest_init(&pcap_manifest);
     if (ctx->include_pcap) {
         RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-                "[%s:%d] Collecting PCAP file to PREV_LOG_PATH\n", __FUNCTION__, __LINE__);
-        int count = collect_pcap_logs(ctx, ctx->prev_log_path);
+                "[%s:%d] Adding PCAP file to archive\n", __FUNCTION__, __LINE__);
+        int count = collect_pcap_to_manifest(ctx, &pcap_manifest);
         if (count > 0) {
             RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
                     "[%s:%d] Collected %d PCAP file\n", __FUNCTION__, __LINE__, count);
         }
     }
     
-    // Create archive from PREV_LOG_PATH (files already have timestamps)
-    int ret = create_archive(ctx, session, ctx->prev_log_path);
+    // Create archive from PREV_LOG_PATH; timestamps exist only inside the archive
+    int ret = create_archive_with_rule(ctx, session, ctx->prev_log_path,
+                                       &reboot_name_rule, &pcap_manifest);
+    archive_manifest_free(&pcap_manifest);
     if (ret != 0) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
                 "[%s:%d] Failed to create archive\n", __FUNCTION__, __LINE__);
@@ -1322,6 +1294,67 @@ static int reboot_archive(RuntimeContext* ctx, SessionState* session)
     return 0;
 }
 
+/**
+ * @brief Prepare the DRI upload with a session of its own
+ */
+static void start_dri_upload(DriUpload* dri, RuntimeContext* ctx, const SessionState* session)
+{
+    memset(dri, 0, sizeof(*dri));
+    dri->ctx = ctx;
+    dri->session.strategy = session->strategy;
+    dri->session.primary = session->primary;
+    dri->session.fallback = session->fallback;
+    dri->session.defer_events = true;
+}
+
+/**
+ * @brief Create the DRI archive and upload it (worker thread)
+ *
+ * Runs while the main archive uploads, so only state of its own is
+ * touched; the upload events are left to reboot_upload().
+ */
+static void* dri_upload_worker(void* arg)
+{
+    DriUpload* dri = (DriUpload*)arg;
+    RuntimeContext* ctx = dri->ctx;
+
+    // Create DRI archive (output goes to ctx->dri_log_path)
+    if (create_dri_archive(ctx, &dri->session, ctx->dri_log_path) != 0) {
+        return NULL;
+    }
+
+    // Construct full archive path from dri_log_path + generated filename
+    char dri_archive[MAX_PATH_LENGTH];
+    int written = snprintf(dri_archive, sizeof(dri_archive), "%s/%s", ctx->dri_log_path, dri->session.archive_file);
+    if (written >= (int)sizeof(dri_archive)) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] DRI archive path too long\n", __FUNCTION__, __LINE__);
+        return NULL;
+    }
+
+    // The DRI directory is kept for the next run if this fails, so the archive is not spooled
+    dri->session.no_spool = true;
+    int dri_ret = upload_archive(ctx, &dri->session, dri_archive);
+    dri->uploaded = true;
+
+    // Send telemetry for DRI upload (matches script lines 883, 886)
+    // Script sends SYST_INFO_PDRILogUpload for both success and failure
+    t2_count_notify("SYST_INFO_PDRILogUpload");
+
+    if (dri_ret == 0) {
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
+                "[%s:%d] DRI log upload succeeded, removing DRI directory\n", 
+                __FUNCTION__, __LINE__);
+        remove_directory(ctx->dri_log_path);
+    } else {
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
+                "[%s:%d] DRI log upload failed\n", __FUNCTION__, __LINE__);
+    }
+
+    // Clean up DRI archive
+    remove_file(dri_archive);
+    return NULL;
+}
+
 /**
  * @brief Upload phase for REBOOT/NON_DCM strategy
  * 
@@ -1411,58 +1444,49 @@ static int reboot_upload(RuntimeContext* ctx, SessionState* session)
         return 0;
     }
 
+    // DRI logs are archived and uploaded on a worker while the main logs upload
+    DriUpload dri;
+    pthread_t dri_tid;
+    bool dri_wanted = ctx->include_dri && dir_exists(ctx->dri_log_path);
+    bool dri_concurrent = false;
+    if (dri_wanted) {
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
+                "[%s:%d] DRI log directory exists, uploading DRI logs\n", 
+                __FUNCTION__, __LINE__);
+        start_dri_upload(&dri, ctx, session);
+        dri_concurrent = (pthread_create(&dri_tid, NULL, dri_upload_worker, &dri) == 0);
+        if (!dri_concurrent) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
+                    "[%s:%d] Could not start DRI upload worker, uploading DRI logs afterwards\n", 
+                    __FUNCTION__, __LINE__);
+        }
+    }
+
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
             "[%s:%d] Uploading main logs: %s\n", 
             __FUNCTION__, __LINE__, archive_path);
 
-    // Upload main logs (session->success is set by execute_upload_cycle)
+    // Upload main logs (session->success is set by execute_upload_cycle); with a
+    // DRI upload in flight both results are reported together once it is done
+    session->defer_events = dri_wanted;
     int ret = upload_archive(ctx, session, archive_path);
     
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
             "[%s:%d] Main log upload complete (result=%d)\n", 
             __FUNCTION__, __LINE__, ret);
 
-    // Upload DRI logs if directory exists (using separate session to avoid state corruption)
-    if (ctx->include_dri && dir_exists(ctx->dri_log_path)) {
-        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-                "[%s:%d] DRI log directory exists, uploading DRI logs\n", 
-                __FUNCTION__, __LINE__);
-
-        // Upload DRI logs using separate session state
-        SessionState dri_session = *session;  // Copy current session config
-        dri_session.direct_attempts = 0;       // Reset attempt counters
-        dri_session.codebig_attempts = 0;
-
-        // Create DRI archive (output goes to ctx->dri_log_path)
-        int dri_ret = create_dri_archive(ctx, &dri_session, ctx->dri_log_path);
-
-        if (dri_ret == 0) {
-            // Construct full archive path from dri_log_path + generated filename
-            char dri_archive[MAX_PATH_LENGTH];
-            int written = snprintf(dri_archive, sizeof(dri_archive), "%s/%s", ctx->dri_log_path, dri_session.archive_file);
+    if (dri_wanted) {
+        if (dri_concurrent) {
+            pthread_join(dri_tid, NULL);
+        } else {
+            dri_upload_worker(&dri);
+        }
 
-            if (written >= (int)sizeof(dri_archive)) {
-                RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] DRI archive path too long\n", __FUNCTION__, __LINE__);
-            } else {
-                dri_ret = upload_archive(ctx, &dri_session, dri_archive);
-            
-                // Send telemetry for DRI upload (matches script lines 883, 886)
-                // Script sends SYST_INFO_PDRILogUpload for both success and failure
-                t2_count_notify("SYST_INFO_PDRILogUpload");
-                
-                if (dri_ret == 0) {
-                    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-                            "[%s:%d] DRI log upload succeeded, removing DRI directory\n", 
-                            __FUNCTION__, __LINE__);
-                    remove_directory(ctx->dri_log_path);
-                } else {
-                    RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
-                            "[%s:%d] DRI log upload failed\n", __FUNCTION__, __LINE__);
-                }
-            
-                // Clean up DRI archive
-                remove_file(dri_archive);
-            }
+        // Main logs first, then DRI logs, as when they were uploaded one after the other
+        session->defer_events = false;
+        emit_upload_result(ctx, session);
+        if (dri.uploaded) {
+            emit_upload_result(ctx, &dri.session);
         }
     }
 
@@ -1485,7 +1509,6 @@ static int reboot_upload(RuntimeContext* ctx, SessionState* session)
  * Shell script equivalent (uploadLogOnReboot lines 893-906):
  * - Always runs (regardless of upload success)
  * - Delete tar file
- * - Remove timestamps from filenames (restore original names)
  * - Create permanent backup directory
  * - Move all files to permanent backup
  * - Clean PREV_LOG_PATH
@@ -1506,18 +1529,6 @@ static int reboot_cleanup(RuntimeContext* ctx, SessionState* session, bool uploa
         remove_file(session->archive_file);
     }
 
-    // Remove timestamps from filenames (restore original names)
-    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-            "[%s:%d] Removing timestamps from filenames\n", __FUNCTION__, __LINE__);
-    
-    int ret = remove_timestamp_from_files(ctx->prev_log_path);
-    if (ret != 0) {
-        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
-                "[%s:%d] Failed to remove timestamps from some files\n", 
-                __FUNCTION__, __LINE__);
-        // Continue anyway
-    }
-
     // Get permanent backup path (stored in setup phase)
     const char* perm_log_path = perm_log_path_storage;
 
@@ -1537,7 +1548,7 @@ static int reboot_cleanup(RuntimeContext* ctx, SessionState* session, bool uploa
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
             "[%s:%d] Moving files to permanent backup\n", __FUNCTION__, __LINE__);
     
-    ret = move_directory_contents(ctx->prev_log_path, perm_log_path);
+    int ret = move_directory_contents(ctx->prev_log_path, perm_log_path);
     if (ret != 0) {
         RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
                 "[%s:%d] Failed to move some files to permanent backup\n", 
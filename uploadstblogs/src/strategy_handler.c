@@ -23,8 +23,13 @@
  */
 
 #include <stdio.h>
+#include <time.h>
 #include "strategy_handler.h"
 #include "cleanup_handler.h"
+#include "archive_manager.h"
+#include "path_handler.h"
+#include "retry_logic.h"
+#include "upload_spool.h"
 #include "rdk_debug.h"
 #include <string.h>
 
@@ -63,6 +68,40 @@ const StrategyHandler* get_strategy_handler(Strategy strategy)
     }
 }
 
+/**
+ * @brief Whether the metadata POST can be sent while the archive is built
+ *
+ * Only when the POST needs nothing but the archive name (no MD5), the
+ * Direct path goes first, and the upload phase is known to upload the
+ * archive; a POST for an archive that is never sent is a wasted request.
+ */
+static bool early_post_wanted(const RuntimeContext* ctx, const SessionState* session)
+{
+    if (!ctx->upload_early_post || ctx->encryption_enable ||
+        ctx->direct_blocked || session->primary != PATH_DIRECT) {
+        return false;
+    }
+
+    // Skipped anyway by execute_upload_cycle while the server defers uploads
+    if (ctx->trigger_type != TRIGGER_ONDEMAND && ctx->trigger_type != TRIGGER_MANUAL &&
+        upload_deferred(UPLOAD_NOT_BEFORE_FILE, time(NULL), NULL)) {
+        return false;
+    }
+
+    switch (session->strategy) {
+        case STRAT_DCM:
+            return true;
+        case STRAT_ONDEMAND:
+            return ctx->flag != 0;
+        case STRAT_REBOOT:
+        case STRAT_NON_DCM:
+            // Other reboots depend on the reboot reason read in the upload phase
+            return ctx->dcm_flag == 0 || ctx->upload_on_reboot == 1;
+        default:
+            return false;
+    }
+}
+
 int execute_strategy_workflow(RuntimeContext* ctx, SessionState* session)
 {
     if (!ctx || !session) {
@@ -94,6 +133,7 @@ int execute_strategy_workflow(RuntimeContext* ctx, SessionState* session)
 
     int ret = 0;
     bool upload_success = false;
+    bool early_post = false;
 
     // Phase 1: Setup
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
@@ -112,8 +152,17 @@ int execute_strategy_workflow(RuntimeContext* ctx, SessionState* session)
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
             "[%s:%d] Phase 2: Archive\n", __FUNCTION__, __LINE__);
     
+    // Request the presigned URL as soon as the archive has its name
+    early_post = early_post_wanted(ctx, session);
+    if (early_post) {
+        set_archive_named_hook(start_early_metadata_post);
+    }
+
     if (handler->archive_phase) {
         ret = handler->archive_phase(ctx, session);
+        if (early_post) {
+            set_archive_named_hook(NULL);
+        }
         if (ret != 0) {
             RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
                     "[%s:%d] Archive phase failed\n", __FUNCTION__, __LINE__);
@@ -141,6 +190,11 @@ cleanup:
     // Phase 4: Cleanup (always runs)
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
             "[%s:%d] Phase 4: Cleanup\n", __FUNCTION__, __LINE__);
+
+    // A POST the upload phase did not use (archive or upload skipped) is only waited for
+    if (early_post) {
+        cancel_early_metadata_post();
+    }
     
     if (handler->cleanup_phase) {
         int cleanup_ret = handler->cleanup_phase(ctx, session, upload_success);
@@ -154,6 +208,13 @@ cleanup:
         }
     }
 
+    // Archives that failed on an earlier run follow once the server took this one;
+    // a user waiting for their upload does not wait for them too
+    if (upload_success && ctx->trigger_type != TRIGGER_ONDEMAND &&
+        ctx->trigger_type != TRIGGER_MANUAL) {
+        upload_spool_drain(ctx);
+    }
+
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
             "[%s:%d] Workflow complete. Result: %d, Upload success: %d\n", 
             __FUNCTION__, __LINE__, ret, upload_success);
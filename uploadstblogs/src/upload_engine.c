@@ -25,10 +25,13 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
+#include <time.h>
 #include <sys/stat.h>
 #include "upload_engine.h"
 #include "path_handler.h"
 #include "retry_logic.h"
+#include "upload_hedge.h"
+#include "upload_spool.h"
 #include "event_manager.h"
 #include "file_operations.h"
 #include "rdk_debug.h"
@@ -36,6 +39,35 @@
 /* Forward declaration for internal function */
 static UploadResult single_attempt_upload(RuntimeContext* ctx, SessionState* session, UploadPath path);
 
+/**
+ * @brief Emit the cycle's success or failure events unless the caller reports them
+ */
+static void report_cycle_result(const RuntimeContext* ctx, const SessionState* session)
+{
+    if (!session->defer_events) {
+        emit_upload_result(ctx, session);
+    }
+}
+
+/**
+ * @brief Upload on the primary path, hedged with the fallback path when configured
+ */
+static UploadResult attempt_primary_upload(RuntimeContext* ctx, SessionState* session)
+{
+    if (ctx->hedge_delay_ms == HEDGE_DELAY_OFF || session->used_fallback ||
+        session->fallback == PATH_NONE || session->fallback == session->primary) {
+        return attempt_upload(ctx, session, session->primary);
+    }
+
+    PathLatency stats[2];
+    path_latency_load(UPLOAD_LATENCY_FILE, stats);
+    long delay_ms = hedge_delay_ms(ctx, (session->primary == PATH_NONE) ? NULL : &stats[session->primary]);
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] Fallback path starts if the primary metadata POST is unanswered after %ld ms\n",
+            __FUNCTION__, __LINE__, delay_ms);
+    return hedged_upload(ctx, session, delay_ms, attempt_upload);
+}
+
 bool execute_upload_cycle(RuntimeContext* ctx, SessionState* session)
 {
     if (!ctx || !session) {
@@ -48,14 +80,27 @@ bool execute_upload_cycle(RuntimeContext* ctx, SessionState* session)
             "[%s:%d] Starting upload cycle for archive: %s\n", 
             __FUNCTION__, __LINE__, session->archive_file);
 
+    // A throttling server asked us to stay away; user requested uploads still go
+    time_t not_before = 0;
+    if (ctx->trigger_type != TRIGGER_ONDEMAND && ctx->trigger_type != TRIGGER_MANUAL &&
+        upload_deferred(UPLOAD_NOT_BEFORE_FILE, time(NULL), &not_before)) {
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] Uploads deferred by server for another %lld seconds, skipping\n",
+                __FUNCTION__, __LINE__, (long long)(not_before - time(NULL)));
+        session->success = false;
+        report_cycle_result(ctx, session);
+        return false;
+    }
+
     // Try primary path first
-    UploadResult primary_result = attempt_upload(ctx, session, session->primary);
+    UploadResult primary_result = attempt_primary_upload(ctx, session);
     
     if (primary_result == UPLOADSTB_SUCCESS) {
         RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
-                "[%s:%d] Upload successful on primary path\n", __FUNCTION__, __LINE__);
+                "[%s:%d] Upload successful on %s path\n", __FUNCTION__, __LINE__,
+                session->used_fallback ? "fallback" : "primary");
         session->success = true;
-        emit_upload_success(ctx, session);
+        report_cycle_result(ctx, session);
         return true;
     }
 
@@ -72,7 +117,7 @@ bool execute_upload_cycle(RuntimeContext* ctx, SessionState* session)
                     "[%s:%d] Upload successful on fallback path\n", __FUNCTION__, __LINE__);
             session->used_fallback = true;
             session->success = true;
-            emit_upload_success(ctx, session);
+            report_cycle_result(ctx, session);
             return true;
         }
     }
@@ -80,7 +125,7 @@ bool execute_upload_cycle(RuntimeContext* ctx, SessionState* session)
     RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
             "[%s:%d] Upload failed on all available paths\n", __FUNCTION__, __LINE__);
     session->success = false;
-    emit_upload_failure(ctx, session);
+    report_cycle_result(ctx, session);
     return false;
 }
 
@@ -101,6 +146,17 @@ UploadResult attempt_upload(RuntimeContext* ctx, SessionState* session, UploadPa
     return retry_upload(ctx, session, path, single_attempt_upload);
 }
 
+UploadResult attempt_upload_once(RuntimeContext* ctx, SessionState* session, UploadPath path)
+{
+    if (!ctx || !session) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
+                "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return UPLOADSTB_FAILED;
+    }
+
+    return single_attempt_upload(ctx, session, path);
+}
+
 /**
  * @brief Single upload attempt function for retry logic
  * @param ctx Runtime context
@@ -114,13 +170,17 @@ static UploadResult single_attempt_upload(RuntimeContext* ctx, SessionState* ses
         return UPLOADSTB_FAILED;
     }
 
+    UploadResult result;
+
     // Execute the appropriate upload path without retry logic
     switch (path) {
         case PATH_DIRECT:
-            return execute_direct_path(ctx, session);
+            result = execute_direct_path(ctx, session);
+            break;
         
         case PATH_CODEBIG:
-            return execute_codebig_path(ctx, session);
+            result = execute_codebig_path(ctx, session);
+            break;
         
         case PATH_NONE:
         default:
@@ -128,6 +188,18 @@ static UploadResult single_attempt_upload(RuntimeContext* ctx, SessionState* ses
                     "[%s:%d] Invalid upload path: %d\n", __FUNCTION__, __LINE__, path);
             return UPLOADSTB_FAILED;
     }
+
+    // Timed-out POSTs count too: they are what the hedge deadline has to catch
+    if (session->post.http_code != 0 || session->post.curl_code == 28) {
+        path_latency_record(UPLOAD_LATENCY_FILE, path, session->post.elapsed_ms);
+    }
+
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] Attempt result %d: POST HTTP %d in %ld ms, PUT HTTP %d in %ld ms\n",
+            __FUNCTION__, __LINE__, result,
+            session->post.http_code, session->post.elapsed_ms,
+            session->put.http_code, session->put.elapsed_ms);
+    return result;
 }
 
 bool should_fallback(const RuntimeContext* ctx, const SessionState* session, UploadResult result)
@@ -235,6 +307,11 @@ int upload_archive(RuntimeContext* ctx, SessionState* session, const char* archi
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
                 "[%s:%d] Archive upload failed\n", 
                 __FUNCTION__, __LINE__);
+        // Keep the archive for the next run unless its sources already are
+        // (MEMCAPTURE archives are kept in place anyway)
+        if (ctx->trigger_type != TRIGGER_MEMCAPTURE && !session->no_spool) {
+            upload_spool_add(ctx, session, archive_path);
+        }
         return -1;
     }
 }
@@ -0,0 +1,448 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file upload_hedge.c
+ * @brief Hedged uploads: race the fallback path against a slow primary
+ *
+ * Latency file format, one record per path:
+ *   <direct|codebig> <srtt_ms> <rttvar_ms> <samples>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "upload_hedge.h"
+#include "rdk_debug.h"
+
+static const char* const latency_names[2] = { "direct", "codebig" };
+
+/* Racing attempts record their POSTs into the same file */
+static pthread_mutex_t latency_lock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef UploadResult (*AttemptFunc)(RuntimeContext*, SessionState*, UploadPath);
+
+struct UploadRace;
+
+/**
+ * @brief One path taking part in a race
+ *
+ * Context and session are private copies: an attempt that lost may still
+ * be inside a request it cannot abort when hedged_upload() stops waiting.
+ */
+struct UploadRacer {
+    struct UploadRace* race;
+    UploadPath path;
+    AttemptFunc attempt_func;
+    RuntimeContext ctx;
+    SessionState session;
+    UploadResult result;
+    pthread_t tid;
+    bool started;
+    bool post_done;                 /* Metadata POST answered */
+    bool done;                      /* attempt_func returned, session no longer written */
+};
+
+/**
+ * @brief Race state shared by the caller and both attempts, freed by the last user
+ */
+typedef struct UploadRace {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int refs;
+    UploadPath winner;              /* PATH_NONE until an attempt succeeds */
+    struct UploadRacer racers[2];   /* Primary, fallback */
+} UploadRace;
+
+static const char* path_name(UploadPath path)
+{
+    return path == PATH_DIRECT ? "Direct" : path == PATH_CODEBIG ? "CodeBig" : "Unknown";
+}
+
+/* ==========================
+   Latency Stats
+   ========================== */
+
+void path_latency_update(PathLatency* stats, long sample_ms)
+{
+    if (!stats || sample_ms < 0) {
+        return;
+    }
+
+    if (stats->samples <= 0) {
+        stats->srtt_ms = sample_ms;
+        stats->rttvar_ms = sample_ms / 2;
+        stats->samples = 1;
+        return;
+    }
+
+    long err = sample_ms - stats->srtt_ms;
+    if (err < 0) {
+        err = -err;
+    }
+    stats->rttvar_ms = (3 * stats->rttvar_ms + err) / 4;
+    stats->srtt_ms = (7 * stats->srtt_ms + sample_ms) / 8;
+    if (stats->samples < INT_MAX) {
+        stats->samples++;
+    }
+}
+
+int path_latency_load(const char* file, PathLatency stats[2])
+{
+    if (!stats) {
+        return -1;
+    }
+    memset(stats, 0, 2 * sizeof(PathLatency));
+    if (!file) {
+        return -1;
+    }
+
+    FILE* fp = fopen(file, "r");
+    if (!fp) {
+        return -1;
+    }
+
+    char name[16];
+    long srtt, rttvar;
+    int samples;
+    while (fscanf(fp, "%15s %ld %ld %d", name, &srtt, &rttvar, &samples) == 4) {
+        for (int i = 0; i < 2; i++) {
+            if (strcmp(name, latency_names[i]) == 0 && srtt >= 0 && rttvar >= 0 && samples >= 0) {
+                stats[i].srtt_ms = srtt;
+                stats[i].rttvar_ms = rttvar;
+                stats[i].samples = samples;
+            }
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+int path_latency_record(const char* file, UploadPath path, long sample_ms)
+{
+    if (!file || (path != PATH_DIRECT && path != PATH_CODEBIG) || sample_ms < 0) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&latency_lock);
+
+    PathLatency stats[2];
+    path_latency_load(file, stats);
+    path_latency_update(&stats[path], sample_ms);
+
+    // Written aside and renamed so a crash never leaves half a file
+    char tmp[MAX_PATH_LENGTH];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", file);
+    FILE* fp = fopen(tmp, "w");
+    if (!fp) {
+        pthread_mutex_unlock(&latency_lock);
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] Failed to write %s (errno=%d)\n", __FUNCTION__, __LINE__, tmp, errno);
+        return -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        fprintf(fp, "%s %ld %ld %d\n", latency_names[i],
+                stats[i].srtt_ms, stats[i].rttvar_ms, stats[i].samples);
+    }
+    int ret = (fclose(fp) == 0 && rename(tmp, file) == 0) ? 0 : -1;
+    if (ret != 0) {
+        unlink(tmp);
+    }
+
+    pthread_mutex_unlock(&latency_lock);
+
+    RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB,
+            "[%s:%d] %s metadata POST took %ld ms (smoothed %ld ms, deviation %ld ms)\n",
+            __FUNCTION__, __LINE__, path_name(path), sample_ms,
+            stats[path].srtt_ms, stats[path].rttvar_ms);
+    return ret;
+}
+
+long hedge_delay_ms(const RuntimeContext* ctx, const PathLatency* stats)
+{
+    if (ctx && ctx->hedge_delay_ms > 0) {
+        return ctx->hedge_delay_ms;
+    }
+    if (!stats || stats->samples < HEDGE_MIN_SAMPLES) {
+        return HEDGE_DEFAULT_DELAY_MS;
+    }
+
+    long delay = stats->srtt_ms + 4 * stats->rttvar_ms;
+    if (delay < HEDGE_MIN_DELAY_MS) {
+        delay = HEDGE_MIN_DELAY_MS;
+    }
+    if (delay > HEDGE_MAX_DELAY_MS) {
+        delay = HEDGE_MAX_DELAY_MS;
+    }
+    return delay;
+}
+
+/* ==========================
+   Race
+   ========================== */
+
+static void race_release(UploadRace* race)
+{
+    pthread_mutex_lock(&race->lock);
+    bool last = (--race->refs == 0);
+    pthread_mutex_unlock(&race->lock);
+
+    if (last) {
+        pthread_cond_destroy(&race->cond);
+        pthread_mutex_destroy(&race->lock);
+        free(race);
+    }
+}
+
+static void* racer_thread(void* arg)
+{
+    struct UploadRacer* racer = (struct UploadRacer*)arg;
+    UploadRace* race = racer->race;
+
+    UploadResult result = racer->attempt_func(&racer->ctx, &racer->session, racer->path);
+
+    pthread_mutex_lock(&race->lock);
+    racer->result = result;
+    racer->done = true;
+    if (result == UPLOADSTB_SUCCESS && race->winner == PATH_NONE) {
+        race->winner = racer->path;
+    }
+    pthread_cond_broadcast(&race->cond);
+    pthread_mutex_unlock(&race->lock);
+
+    race_release(race);
+    return NULL;
+}
+
+/**
+ * @brief Start an attempt on a joinable thread
+ * @return true if the thread runs
+ */
+static bool racer_start(struct UploadRacer* racer)
+{
+    UploadRace* race = racer->race;
+
+    pthread_mutex_lock(&race->lock);
+    race->refs++;
+    racer->started = true;
+    pthread_mutex_unlock(&race->lock);
+
+    int rc = pthread_create(&racer->tid, NULL, racer_thread, racer);
+    if (rc == 0) {
+        return true;
+    }
+
+    RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+            "[%s:%d] Could not start %s upload thread (error %d)\n",
+            __FUNCTION__, __LINE__, path_name(racer->path), rc);
+    pthread_mutex_lock(&race->lock);
+    race->refs--;
+    racer->started = false;
+    pthread_mutex_unlock(&race->lock);
+    return false;
+}
+
+/**
+ * @brief Wait up to HEDGE_JOIN_TIMEOUT_MS for a started attempt to return, then join it
+ *
+ * The loser's S3 PUT is aborted by its race check, so it normally returns
+ * at once. One stuck in a request that cannot be aborted is detached and
+ * finishes on its private copies.
+ */
+static void racer_join(struct UploadRacer* racer)
+{
+    UploadRace* race = racer->race;
+    if (!racer->started) {
+        return;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += HEDGE_JOIN_TIMEOUT_MS / 1000;
+    deadline.tv_nsec += (HEDGE_JOIN_TIMEOUT_MS % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&race->lock);
+    int rc = 0;
+    while (!racer->done && rc != ETIMEDOUT) {
+        rc = pthread_cond_timedwait(&race->cond, &race->lock, &deadline);
+    }
+    bool done = racer->done;
+    pthread_mutex_unlock(&race->lock);
+
+    if (done) {
+        pthread_join(racer->tid, NULL);
+    } else {
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] %s upload did not stop within %d ms, leaving it to finish\n",
+                __FUNCTION__, __LINE__, path_name(racer->path), HEDGE_JOIN_TIMEOUT_MS);
+        pthread_detach(racer->tid);
+    }
+}
+
+static int* path_attempts(SessionState* session, UploadPath path)
+{
+    return (path == PATH_DIRECT) ? &session->direct_attempts : &session->codebig_attempts;
+}
+
+UploadResult hedged_upload(RuntimeContext* ctx, SessionState* session, long delay_ms,
+                           UploadResult (*attempt_func)(RuntimeContext*, SessionState*, UploadPath))
+{
+    if (!ctx || !session || !attempt_func) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return UPLOADSTB_FAILED;
+    }
+
+    UploadRace* race = (UploadRace*)calloc(1, sizeof(*race));
+    if (!race) {
+        return attempt_func(ctx, session, session->primary);
+    }
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&race->cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    pthread_mutex_init(&race->lock, NULL);
+    race->refs = 1;
+    race->winner = PATH_NONE;
+
+    UploadPath paths[2] = { session->primary, session->fallback };
+    for (int i = 0; i < 2; i++) {
+        struct UploadRacer* racer = &race->racers[i];
+        racer->race = race;
+        racer->path = paths[i];
+        racer->attempt_func = attempt_func;
+        racer->ctx = *ctx;
+        racer->session = *session;
+        racer->session.racer = racer;
+        racer->result = UPLOADSTB_FAILED;
+    }
+    struct UploadRacer* primary = &race->racers[0];
+    struct UploadRacer* fallback = &race->racers[1];
+
+    if (!racer_start(primary)) {
+        race_release(race);
+        return attempt_func(ctx, session, session->primary);
+    }
+
+    // Give the primary path until the deadline to answer its metadata POST
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += delay_ms / 1000;
+    deadline.tv_nsec += (delay_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&race->lock);
+    int rc = 0;
+    while (!primary->post_done && !primary->done && rc != ETIMEDOUT) {
+        rc = pthread_cond_timedwait(&race->cond, &race->lock, &deadline);
+    }
+    bool hedge = !primary->post_done && !primary->done;
+    pthread_mutex_unlock(&race->lock);
+
+    if (hedge) {
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] No %s metadata POST answer after %ld ms, starting %s upload in parallel\n",
+                __FUNCTION__, __LINE__, path_name(primary->path), delay_ms, path_name(fallback->path));
+        hedge = racer_start(fallback);
+    }
+
+    pthread_mutex_lock(&race->lock);
+    while (race->winner == PATH_NONE && !(primary->done && (!hedge || fallback->done))) {
+        pthread_cond_wait(&race->cond, &race->lock);
+    }
+
+    // The decisive attempt has finished, so its session is no longer written
+    struct UploadRacer* decisive;
+    if (race->winner != PATH_NONE) {
+        decisive = (race->winner == primary->path) ? primary : fallback;
+    } else {
+        decisive = hedge ? fallback : primary;
+    }
+    struct UploadRacer* other = (decisive == primary) ? fallback : primary;
+
+    UploadResult result = decisive->result;
+    int other_attempts = *path_attempts(session, other->path);
+    if (other->done) {
+        other_attempts = *path_attempts(&other->session, other->path);
+    } else if (other->started) {
+        other_attempts++;
+    }
+
+    UploadPath session_primary = session->primary;
+    UploadPath session_fallback = session->fallback;
+    *session = decisive->session;
+    session->racer = NULL;
+    session->primary = session_primary;
+    session->fallback = session_fallback;
+    *path_attempts(session, other->path) = other_attempts;
+    if (hedge) {
+        session->used_fallback = true;
+    }
+    pthread_mutex_unlock(&race->lock);
+
+    if (hedge) {
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                "[%s:%d] Hedged upload %s on %s path\n",
+                __FUNCTION__, __LINE__, result == UPLOADSTB_SUCCESS ? "won" : "failed",
+                path_name(decisive->path));
+    }
+
+    // Neither attempt may still use the shared upload state once the caller cleans up
+    racer_join(decisive);
+    racer_join(other);
+
+    race_release(race);
+    return result;
+}
+
+void upload_race_post_done(struct UploadRacer* racer)
+{
+    if (!racer) {
+        return;
+    }
+    pthread_mutex_lock(&racer->race->lock);
+    racer->post_done = true;
+    pthread_cond_broadcast(&racer->race->cond);
+    pthread_mutex_unlock(&racer->race->lock);
+}
+
+bool upload_race_lost(const struct UploadRacer* racer)
+{
+    if (!racer) {
+        return false;
+    }
+    pthread_mutex_lock(&racer->race->lock);
+    bool lost = (racer->race->winner != PATH_NONE && racer->race->winner != racer->path);
+    pthread_mutex_unlock(&racer->race->lock);
+    return lost;
+}
@@ -0,0 +1,620 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file upload_http.c
+ * @brief Shared curl state for upload transfers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "upload_http.h"
+#include "retry_logic.h"
+#include "rdk_debug.h"
+
+static pthread_mutex_t state_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t share_locks[CURL_LOCK_DATA_LAST];
+static pthread_once_t global_once = PTHREAD_ONCE_INIT;
+static CURLSH* share = NULL;
+
+static pthread_t prewarm_tid;
+static bool prewarm_running = false;
+
+/* Rate cap shared by all transfers */
+static pthread_mutex_t rate_lock = PTHREAD_MUTEX_INITIALIZER;
+static UploadRateLimit rate_limit;
+
+static void global_init_once(void)
+{
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+static void share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+{
+    (void)handle;
+    (void)access;
+    (void)userptr;
+    pthread_mutex_lock(&share_locks[data]);
+}
+
+static void share_unlock(CURL* handle, curl_lock_data data, void* userptr)
+{
+    (void)handle;
+    (void)userptr;
+    pthread_mutex_unlock(&share_locks[data]);
+}
+
+/**
+ * @brief Create the share handle on first use (state_lock held)
+ */
+static CURLSH* get_share(void)
+{
+    if (share) {
+        return share;
+    }
+
+    pthread_once(&global_once, global_init_once);
+
+    CURLSH* sh = curl_share_init();
+    if (!sh) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Failed to create curl share handle\n", __FUNCTION__, __LINE__);
+        return NULL;
+    }
+
+    for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+        pthread_mutex_init(&share_locks[i], NULL);
+    }
+    curl_share_setopt(sh, CURLSHOPT_LOCKFUNC, share_lock);
+    curl_share_setopt(sh, CURLSHOPT_UNLOCKFUNC, share_unlock);
+    curl_share_setopt(sh, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(sh, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    curl_share_setopt(sh, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+
+    share = sh;
+    return share;
+}
+
+static long long monotonic_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Largest burst the bucket holds: a quarter second, at least one chunk
+ */
+static long long rate_burst(const UploadRateLimit* limit)
+{
+    long long burst = limit->rate_bps / 4;
+    return burst < UPLOAD_RATE_CHUNK ? UPLOAD_RATE_CHUNK : burst;
+}
+
+void upload_rate_init(UploadRateLimit* limit, long cap_bps, bool adaptive, long long now_ms)
+{
+    if (!limit) {
+        return;
+    }
+    memset(limit, 0, sizeof(*limit));
+    if (cap_bps > 0 && cap_bps < UPLOAD_RATE_MIN_BPS) {
+        cap_bps = UPLOAD_RATE_MIN_BPS;
+    }
+    limit->cap_bps = cap_bps > 0 ? cap_bps : 0;
+    limit->rate_bps = limit->cap_bps;
+    limit->adaptive = adaptive;
+    limit->tokens = limit->cap_bps ? rate_burst(limit) : 0;
+    limit->refill_ms = now_ms;
+    limit->adapt_ms = now_ms;
+}
+
+size_t upload_rate_take(UploadRateLimit* limit, size_t want, long long now_ms, long* wait_ms)
+{
+    if (wait_ms) {
+        *wait_ms = 0;
+    }
+    if (!limit || limit->rate_bps <= 0 || want == 0) {
+        return want;
+    }
+
+    if (now_ms > limit->refill_ms) {
+        limit->tokens += (long long)limit->rate_bps * (now_ms - limit->refill_ms) / 1000;
+        limit->refill_ms = now_ms;
+        if (limit->tokens > rate_burst(limit)) {
+            limit->tokens = rate_burst(limit);
+        }
+    }
+
+    // Wait for a whole chunk rather than trickling out a few bytes per call
+    long long need = (want < UPLOAD_RATE_CHUNK) ? (long long)want : UPLOAD_RATE_CHUNK;
+    if (limit->tokens < need) {
+        if (wait_ms) {
+            *wait_ms = (long)((need - limit->tokens) * 1000 / limit->rate_bps) + 1;
+        }
+        return 0;
+    }
+
+    size_t grant = ((long long)want < limit->tokens) ? want : (size_t)limit->tokens;
+    limit->tokens -= (long long)grant;
+    return grant;
+}
+
+void upload_rate_adapt(UploadRateLimit* limit, long rtt_us, long long now_ms)
+{
+    if (!limit || !limit->adaptive || limit->cap_bps <= 0 || rtt_us <= 0) {
+        return;
+    }
+    if (limit->base_rtt_us == 0 || rtt_us < limit->base_rtt_us) {
+        limit->base_rtt_us = rtt_us;
+    }
+    if (now_ms - limit->adapt_ms < UPLOAD_RATE_ADAPT_MS) {
+        return;
+    }
+    limit->adapt_ms = now_ms;
+
+    long rate = limit->rate_bps;
+    if (rtt_us - limit->base_rtt_us > UPLOAD_RATE_QUEUE_US) {
+        rate -= rate / 4;
+        if (rate < UPLOAD_RATE_MIN_BPS) {
+            rate = UPLOAD_RATE_MIN_BPS;
+        }
+    } else {
+        rate += limit->cap_bps / 8;
+        if (rate > limit->cap_bps) {
+            rate = limit->cap_bps;
+        }
+    }
+    if (rate != limit->rate_bps) {
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] RTT %ld us (floor %ld us), upload rate %ld -> %ld bytes/s\n",
+                __FUNCTION__, __LINE__, rtt_us, limit->base_rtt_us, limit->rate_bps, rate);
+        limit->rate_bps = rate;
+    }
+}
+
+/**
+ * @brief Smoothed TCP RTT of the connection a transfer is using
+ * @return RTT in microseconds, or -1 if not available
+ */
+static long transfer_rtt_us(CURL* curl)
+{
+#if defined(TCP_INFO) && LIBCURL_VERSION_NUM >= 0x072d00
+    curl_socket_t sock = CURL_SOCKET_BAD;
+    struct tcp_info info;
+    socklen_t len = sizeof(info);
+
+    if (!curl || curl_easy_getinfo(curl, CURLINFO_ACTIVESOCKET, &sock) != CURLE_OK || sock == CURL_SOCKET_BAD) {
+        return -1;
+    }
+    if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, &info, &len) != 0) {
+        return -1;
+    }
+    return (long)info.tcpi_rtt;
+#else
+    (void)curl;
+    return -1;
+#endif
+}
+
+void upload_http_set_rate_limit(long cap_bps, bool adaptive)
+{
+    if (cap_bps > 0 && cap_bps < UPLOAD_RATE_MIN_BPS) {
+        cap_bps = UPLOAD_RATE_MIN_BPS;
+    }
+    if (cap_bps < 0) {
+        cap_bps = 0;
+    }
+
+    pthread_mutex_lock(&rate_lock);
+    if (rate_limit.cap_bps != cap_bps || rate_limit.adaptive != adaptive) {
+        upload_rate_init(&rate_limit, cap_bps, adaptive, monotonic_ms());
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, "[%s:%d] Upload rate cap %ld bytes/s%s\n", __FUNCTION__, __LINE__,
+                cap_bps, (cap_bps && adaptive) ? ", adaptive" : "");
+    }
+    pthread_mutex_unlock(&rate_lock);
+}
+
+size_t upload_http_throttle(CURL* curl, size_t want)
+{
+    for (;;) {
+        long wait_ms = 0;
+
+        pthread_mutex_lock(&rate_lock);
+        long long now = monotonic_ms();
+        if (rate_limit.adaptive && rate_limit.cap_bps > 0 && now - rate_limit.adapt_ms >= UPLOAD_RATE_ADAPT_MS) {
+            upload_rate_adapt(&rate_limit, transfer_rtt_us(curl), now);
+        }
+        size_t grant = upload_rate_take(&rate_limit, want, now, &wait_ms);
+        pthread_mutex_unlock(&rate_lock);
+
+        if (grant > 0 || want == 0) {
+            return grant;
+        }
+        usleep((useconds_t)wait_ms * 1000);
+    }
+}
+
+CURL* upload_http_acquire(void)
+{
+    pthread_mutex_lock(&state_lock);
+    CURLSH* sh = get_share();
+    pthread_mutex_unlock(&state_lock);
+
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Failed to create curl handle\n", __FUNCTION__, __LINE__);
+        return NULL;
+    }
+
+    if (sh) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, sh);
+    }
+    curl_easy_setopt(curl, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    return curl;
+}
+
+void upload_http_release(CURL* curl)
+{
+    if (curl) {
+        curl_easy_cleanup(curl);
+    }
+}
+
+void upload_http_set_transfer_opts(CURL* curl, const UploadHttpCert* cert, bool ocsp, int connect_timeout_s)
+{
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, (long)UPLOAD_HTTP_LOW_SPEED_LIMIT);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, (long)UPLOAD_HTTP_LOW_SPEED_TIME);
+    if (connect_timeout_s > 0) {
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, (long)connect_timeout_s);
+    }
+    if (cert && cert->cert_file && cert->cert_file[0] != '\0') {
+        curl_easy_setopt(curl, CURLOPT_SSLCERT, cert->cert_file);
+        if (cert->cert_type && cert->cert_type[0] != '\0') {
+            curl_easy_setopt(curl, CURLOPT_SSLCERTTYPE, cert->cert_type);
+        }
+        if (cert->key_pass && cert->key_pass[0] != '\0') {
+            curl_easy_setopt(curl, CURLOPT_KEYPASSWD, cert->key_pass);
+        }
+    }
+    if (ocsp) {
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYSTATUS, 1L);
+    }
+}
+
+static int cancel_xferinfo(void* clientp, curl_off_t dltotal, curl_off_t dlnow,
+                           curl_off_t ultotal, curl_off_t ulnow)
+{
+    const UploadHttpCancel* cancel = (const UploadHttpCancel*)clientp;
+    (void)dltotal;
+    (void)dlnow;
+    (void)ultotal;
+    (void)ulnow;
+    return cancel->stop(cancel->arg) ? 1 : 0;
+}
+
+void upload_http_set_cancel(CURL* curl, const UploadHttpCancel* cancel)
+{
+    if (!curl || !cancel || !cancel->stop) {
+        return;
+    }
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, cancel_xferinfo);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, (void*)cancel);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+}
+
+size_t upload_http_retry_after_header(char* buffer, size_t size, size_t nitems, void* userdata)
+{
+    static const char* const names[] = { "Retry-After:", "RateLimit-Reset:", "X-RateLimit-Reset:" };
+    int* retry_after = (int*)userdata;
+    size_t len = size * nitems;
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        size_t name_len = strlen(names[i]);
+        if (len <= name_len || strncasecmp(buffer, names[i], name_len) != 0) {
+            continue;
+        }
+
+        char value[128];
+        size_t value_len = len - name_len;
+        if (value_len >= sizeof(value)) {
+            value_len = sizeof(value) - 1;
+        }
+        memcpy(value, buffer + name_len, value_len);
+        value[value_len] = '\0';
+
+        int seconds = parse_retry_after(value, time(NULL));
+        if (seconds > *retry_after) {
+            RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                    "[%s:%d] Server retry hint %.*s: %d seconds\n",
+                    __FUNCTION__, __LINE__, (int)(name_len - 1), names[i], seconds);
+            *retry_after = seconds;
+        }
+        break;
+    }
+    return len;
+}
+
+/**
+ * @brief Request body source of upload_http_put()
+ */
+typedef struct {
+    FILE* fp;
+    CURL* curl;
+} PutSource;
+
+static size_t put_read(char* buffer, size_t size, size_t nitems, void* userdata)
+{
+    PutSource* src = (PutSource*)userdata;
+    size_t want = upload_http_throttle(src->curl, size * nitems);
+    size_t n = fread(buffer, 1, want, src->fp);
+
+    if (n == 0 && ferror(src->fp)) {
+        return CURL_READFUNC_ABORT;
+    }
+    return n;
+}
+
+static int put_seek(void* userdata, curl_off_t offset, int origin)
+{
+    PutSource* src = (PutSource*)userdata;
+    return fseeko(src->fp, (off_t)offset, origin) == 0 ? CURL_SEEKFUNC_OK : CURL_SEEKFUNC_FAIL;
+}
+
+static size_t discard_body(char* ptr, size_t size, size_t nmemb, void* userdata)
+{
+    (void)ptr;
+    (void)userdata;
+    return size * nmemb;
+}
+
+/**
+ * @brief Copy the scheme://host[:port]/ part of a URL
+ * @return true if the URL has a scheme and host
+ */
+static bool url_origin(const char* url, char* origin, size_t origin_size)
+{
+    const char* host = strstr(url, "://");
+    if (!host || host == url) {
+        return false;
+    }
+    host += 3;
+
+    size_t host_len = strcspn(host, "/?#");
+    size_t len = (size_t)(host - url) + host_len;
+    if (host_len == 0 || len + 2 > origin_size) {
+        return false;
+    }
+    memcpy(origin, url, len);
+    origin[len] = '/';
+    origin[len + 1] = '\0';
+    return true;
+}
+
+/**
+ * @brief Join the pre-warm thread if one is running
+ */
+static void prewarm_wait(void)
+{
+    pthread_mutex_lock(&state_lock);
+    bool join = prewarm_running;
+    prewarm_running = false;
+    pthread_mutex_unlock(&state_lock);
+
+    if (join) {
+        pthread_join(prewarm_tid, NULL);
+    }
+}
+
+int upload_http_put(const char* url, const char* src_file, const UploadHttpCert* cert,
+                    bool ocsp, int connect_timeout_s, const UploadHttpCancel* cancel,
+                    UploadResponse* resp)
+{
+    if (!url || !src_file || !resp) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return CURLE_BAD_FUNCTION_ARGUMENT;
+    }
+
+    resp->http_code = 0;
+    resp->curl_code = CURLE_FAILED_INIT;
+    resp->elapsed_ms = 0;
+    resp->retry_after = 0;
+    resp->bytes = 0;
+
+    FILE* fp = fopen(src_file, "rb");
+    if (!fp) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Cannot open %s (errno=%d)\n", __FUNCTION__, __LINE__, src_file, errno);
+        resp->curl_code = CURLE_READ_ERROR;
+        return resp->curl_code;
+    }
+    struct stat st;
+    if (fstat(fileno(fp), &st) != 0) {
+        fclose(fp);
+        resp->curl_code = CURLE_READ_ERROR;
+        return resp->curl_code;
+    }
+
+    CURL* curl = upload_http_acquire();
+    if (!curl) {
+        fclose(fp);
+        return resp->curl_code;
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+    PutSource src = { fp, curl };
+    curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+    curl_easy_setopt(curl, CURLOPT_READFUNCTION, put_read);
+    curl_easy_setopt(curl, CURLOPT_READDATA, &src);
+    curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, put_seek);
+    curl_easy_setopt(curl, CURLOPT_SEEKDATA, &src);
+    curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)st.st_size);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard_body);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, upload_http_retry_after_header);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &resp->retry_after);
+    upload_http_set_transfer_opts(curl, cert, ocsp, connect_timeout_s);
+    upload_http_set_cancel(curl, cancel);
+    // Long enough for the body at the lowest rate cap, but a hung transfer still ends
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT,
+                     (long)(UPLOAD_HTTP_PUT_TIMEOUT + st.st_size / UPLOAD_RATE_MIN_BPS));
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    CURLcode rc = curl_easy_perform(curl);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    long http_code = 0;
+    long new_connections = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &new_connections);
+    upload_http_release(curl);
+    fclose(fp);
+
+    resp->http_code = (int)http_code;
+    resp->curl_code = (int)rc;
+    resp->elapsed_ms = (long)(end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    resp->bytes = (rc == CURLE_OK) ? (long long)st.st_size : 0;
+
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] PUT %lld bytes: HTTP %ld, curl %d, %ld ms, %s connection\n",
+            __FUNCTION__, __LINE__, (long long)st.st_size, http_code, (int)rc,
+            resp->elapsed_ms, new_connections ? "new" : "reused");
+    return (int)rc;
+}
+
+/**
+ * @brief Private copy of what prewarm_thread() connects with
+ */
+typedef struct {
+    char* url;
+    char* cert_file;
+    char* cert_type;
+    char* key_pass;
+    bool ocsp;
+    int connect_timeout_s;
+} PrewarmRequest;
+
+static char* strdup_or_null(const char* s)
+{
+    return s ? strdup(s) : NULL;
+}
+
+static void prewarm_request_free(PrewarmRequest* req)
+{
+    if (req) {
+        free(req->url);
+        free(req->cert_file);
+        free(req->cert_type);
+        free(req->key_pass);
+        free(req);
+    }
+}
+
+static void* prewarm_thread(void* arg)
+{
+    PrewarmRequest* req = (PrewarmRequest*)arg;
+    CURL* curl = upload_http_acquire();
+
+    if (curl) {
+        // A real request with the PUT's TLS settings, so the pooled connection matches it
+        UploadHttpCert cert = { req->cert_file, req->cert_type, req->key_pass };
+        curl_easy_setopt(curl, CURLOPT_URL, req->url);
+        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard_body);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, (long)UPLOAD_HTTP_PREWARM_TIMEOUT);
+        upload_http_set_transfer_opts(curl, &cert, req->ocsp,
+                                      req->connect_timeout_s > 0 ? req->connect_timeout_s : 10);
+        CURLcode rc = curl_easy_perform(curl);
+        long http_code = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB,
+                "[%s:%d] Pre-warmed %s: HTTP %ld, curl %d\n", __FUNCTION__, __LINE__,
+                req->url, http_code, (int)rc);
+        upload_http_release(curl);
+    }
+
+    prewarm_request_free(req);
+    return NULL;
+}
+
+void upload_http_prewarm(const char* url, const UploadHttpCert* cert, bool ocsp, int connect_timeout_s)
+{
+    char origin[MAX_URL_LENGTH];
+
+    if (!url || !url_origin(url, origin, sizeof(origin))) {
+        return;
+    }
+
+    PrewarmRequest* req = (PrewarmRequest*)calloc(1, sizeof(*req));
+    if (!req) {
+        return;
+    }
+    req->url = strdup(origin);
+    req->ocsp = ocsp;
+    req->connect_timeout_s = connect_timeout_s;
+    bool copied = (req->url != NULL);
+    if (cert) {
+        req->cert_file = strdup_or_null(cert->cert_file);
+        req->cert_type = strdup_or_null(cert->cert_type);
+        req->key_pass = strdup_or_null(cert->key_pass);
+        copied = copied && (!cert->cert_file || req->cert_file) &&
+                 (!cert->cert_type || req->cert_type) && (!cert->key_pass || req->key_pass);
+    }
+    if (!copied) {
+        prewarm_request_free(req);
+        return;
+    }
+
+    pthread_mutex_lock(&state_lock);
+    if (!prewarm_running && pthread_create(&prewarm_tid, NULL, prewarm_thread, req) == 0) {
+        prewarm_running = true;
+        req = NULL;
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, "[%s:%d] Pre-warming %s\n", __FUNCTION__, __LINE__, origin);
+    }
+    pthread_mutex_unlock(&state_lock);
+    prewarm_request_free(req);
+}
+
+void upload_http_cleanup(void)
+{
+    prewarm_wait();
+
+    pthread_mutex_lock(&state_lock);
+    if (share) {
+        if (curl_share_cleanup(share) == CURLSHE_OK) {
+            for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+                pthread_mutex_destroy(&share_locks[i]);
+            }
+            share = NULL;
+        } else {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, "[%s:%d] curl share handle still in use\n", __FUNCTION__, __LINE__);
+        }
+    }
+    pthread_mutex_unlock(&state_lock);
+}
@@ -0,0 +1,328 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file upload_index.c
+ * @brief Per-file high-watermark index for incremental log uploads
+ *
+ * File format, one line per log file:
+ *   <dev> <ino> <offset> <generation> <path>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "upload_index.h"
+#include "rdk_debug.h"
+
+#define UPLOAD_INDEX_LINE_MAX   (MAX_PATH_LENGTH + 128)
+
+void upload_index_init(UploadIndex* index)
+{
+    if (!index) {
+        return;
+    }
+    index->entries = NULL;
+    index->count = 0;
+    index->capacity = 0;
+}
+
+void upload_index_free(UploadIndex* index)
+{
+    if (!index) {
+        return;
+    }
+    for (size_t i = 0; i < index->count; i++) {
+        free(index->entries[i].path);
+    }
+    free(index->entries);
+    upload_index_init(index);
+}
+
+/**
+ * @brief Append an entry, taking a copy of path
+ */
+static UploadIndexEntry* index_add(UploadIndex* index, const char* path,
+                                   unsigned long long dev, unsigned long long ino)
+{
+    if (index->count == index->capacity) {
+        size_t new_capacity = index->capacity ? index->capacity * 2 : 64;
+        UploadIndexEntry* entries = realloc(index->entries, new_capacity * sizeof(*entries));
+        if (!entries) {
+            RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Failed to grow upload index\n", __FUNCTION__, __LINE__);
+            return NULL;
+        }
+        index->entries = entries;
+        index->capacity = new_capacity;
+    }
+
+    char* path_copy = strdup(path);
+    if (!path_copy) {
+        return NULL;
+    }
+
+    UploadIndexEntry* entry = &index->entries[index->count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->path = path_copy;
+    entry->dev = dev;
+    entry->ino = ino;
+    return entry;
+}
+
+static UploadIndexEntry* find_by_inode(UploadIndex* index, unsigned long long dev, unsigned long long ino)
+{
+    for (size_t i = 0; i < index->count; i++) {
+        if (index->entries[i].dev == dev && index->entries[i].ino == ino) {
+            return &index->entries[i];
+        }
+    }
+    return NULL;
+}
+
+static UploadIndexEntry* find_by_path(UploadIndex* index, const char* path)
+{
+    for (size_t i = 0; i < index->count; i++) {
+        if (strcmp(index->entries[i].path, path) == 0) {
+            return &index->entries[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Length of path without its numeric rotation suffixes (X.1, X.2.0 -> X)
+ */
+static size_t rotation_base_len(const char* path)
+{
+    size_t len = strlen(path);
+    for (;;) {
+        size_t digits = len;
+        while (digits > 0 && isdigit((unsigned char)path[digits - 1])) {
+            digits--;
+        }
+        if (digits == len || digits < 2 || path[digits - 1] != '.') {
+            return len;
+        }
+        len = digits - 1;
+    }
+}
+
+/**
+ * @brief Check whether a path is the same file or a rotation of it
+ *
+ * Rotation renames X to X.1, then X.1 to X.2 and so on, so both names
+ * are compared without their numeric suffixes. An inode found under an
+ * unrelated name was freed and reused, so its watermark does not apply.
+ */
+static bool is_same_or_rotated(const char* recorded, const char* path)
+{
+    size_t len = rotation_base_len(recorded);
+    return len == rotation_base_len(path) && strncmp(recorded, path, len) == 0;
+}
+
+int upload_index_load(UploadIndex* index, const char* path)
+{
+    if (!index || !path) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    upload_index_free(index);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        if (errno == ENOENT) {
+            RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                    "[%s:%d] No upload index yet, uploading full logs\n", __FUNCTION__, __LINE__);
+            return 0;
+        }
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to open upload index %s (errno=%d)\n", __FUNCTION__, __LINE__, path, errno);
+        return -1;
+    }
+
+    char line[UPLOAD_INDEX_LINE_MAX];
+    while (fgets(line, sizeof(line), fp)) {
+        unsigned long long dev = 0;
+        unsigned long long ino = 0;
+        long long offset = 0;
+        unsigned int generation = 0;
+        int consumed = 0;
+
+        line[strcspn(line, "\n")] = '\0';
+        if (sscanf(line, "%llu %llu %lld %u %n", &dev, &ino, &offset, &generation, &consumed) != 4 ||
+            consumed == 0 || line[consumed] == '\0' || offset < 0) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                    "[%s:%d] Ignoring malformed upload index line\n", __FUNCTION__, __LINE__);
+            continue;
+        }
+
+        UploadIndexEntry* entry = index_add(index, line + consumed, dev, ino);
+        if (!entry) {
+            fclose(fp);
+            upload_index_free(index);
+            return -1;
+        }
+        entry->offset = offset;
+        entry->generation = generation;
+    }
+
+    fclose(fp);
+    RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB,
+            "[%s:%d] Loaded %zu upload index entries\n", __FUNCTION__, __LINE__, index->count);
+    return 0;
+}
+
+int upload_index_save(const UploadIndex* index, const char* path)
+{
+    if (!index || !path) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    char tmp_path[MAX_PATH_LENGTH];
+    int written = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    if (written < 0 || written >= (int)sizeof(tmp_path)) {
+        return -1;
+    }
+
+    FILE* fp = fopen(tmp_path, "w");
+    if (!fp) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to create %s (errno=%d)\n", __FUNCTION__, __LINE__, tmp_path, errno);
+        return -1;
+    }
+
+    // Files that disappeared since the last run are dropped here
+    for (size_t i = 0; i < index->count; i++) {
+        const UploadIndexEntry* entry = &index->entries[i];
+        if (entry->seen) {
+            fprintf(fp, "%llu %llu %lld %u %s\n", entry->dev, entry->ino,
+                    entry->offset, entry->generation, entry->path);
+        }
+    }
+
+    // Write, flush and rename so a power cut leaves either index intact
+    bool ok = (fflush(fp) == 0 && fsync(fileno(fp)) == 0);
+    if (fclose(fp) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(tmp_path, path) != 0) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to commit upload index %s (errno=%d)\n", __FUNCTION__, __LINE__, path, errno);
+        unlink(tmp_path);
+        return -1;
+    }
+
+    return 0;
+}
+
+long long upload_index_apply(UploadIndex* index, ArchiveManifest* manifest)
+{
+    if (!index || !manifest) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    long long skipped = 0;
+    size_t unchanged = 0;
+
+    for (size_t i = 0; i < manifest->count; i++) {
+        ArchiveManifestEntry* item = &manifest->entries[i];
+        struct stat st;
+
+        if (lstat(item->src_path, &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+
+        unsigned long long dev = (unsigned long long)st.st_dev;
+        unsigned long long ino = (unsigned long long)st.st_ino;
+        long long size = (long long)st.st_size;
+        UploadIndexEntry* entry = find_by_inode(index, dev, ino);
+
+        if (entry && !is_same_or_rotated(entry->path, item->src_path)) {
+            // Inode reused by an unrelated file
+            entry->offset = 0;
+            entry->generation = 0;
+        } else if (!entry) {
+            UploadIndexEntry* previous = find_by_path(index, item->src_path);
+            unsigned int generation = previous ? previous->generation + 1 : 0;
+            entry = index_add(index, item->src_path, dev, ino);
+            if (!entry) {
+                return -1;
+            }
+            entry->generation = generation;
+        } else if (size < entry->offset) {
+            // Truncated in place (copytruncate rotation)
+            RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                    "[%s:%d] %s shrank below its watermark, uploading it again\n",
+                    __FUNCTION__, __LINE__, item->src_path);
+            entry->offset = 0;
+            entry->generation++;
+        }
+
+        if (strcmp(entry->path, item->src_path) != 0) {
+            char* path_copy = strdup(item->src_path);
+            if (path_copy) {
+                free(entry->path);
+                entry->path = path_copy;
+            }
+        }
+
+        item->offset = (off_t)entry->offset;
+        item->length = (off_t)(size - entry->offset);
+        skipped += entry->offset;
+        if (item->length == 0) {
+            unchanged++;
+        }
+
+        // The watermark moves in upload_index_commit(), once the archive is written
+        entry->item = i;
+        entry->seen = true;
+    }
+
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] Incremental upload: %lld bytes already uploaded, %zu of %zu files unchanged\n",
+            __FUNCTION__, __LINE__, skipped, unchanged, manifest->count);
+    return skipped;
+}
+
+int upload_index_commit(UploadIndex* index, const ArchiveManifest* manifest)
+{
+    if (!index || !manifest) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    for (size_t i = 0; i < index->count; i++) {
+        UploadIndexEntry* entry = &index->entries[i];
+        if (!entry->seen || entry->item >= manifest->count) {
+            continue;
+        }
+        const ArchiveManifestEntry* item = &manifest->entries[entry->item];
+        if (item->length > 0) {
+            entry->offset = (long long)(item->offset + item->length);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,712 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file upload_multipart.c
+ * @brief S3 multipart upload of large archives
+ *
+ * Manifest format, one record per line:
+ *   upload_id <id>
+ *   object <url without query>
+ *   file <size> <mtime> <part_size> <path>
+ *   part <number> <etag>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "upload_multipart.h"
+#include "verification.h"
+#include "rdk_debug.h"
+
+#define MULTIPART_ETAG_MAX      128
+#define MULTIPART_ID_MAX        512
+#define MULTIPART_BODY_MAX      (64 * 1024)
+#define MULTIPART_LINE_MAX      (MAX_URL_LENGTH + MAX_PATH_LENGTH + 64)
+#define MULTIPART_URL_MAX       (MAX_URL_LENGTH + MULTIPART_ID_MAX * 3 + 64)
+
+/**
+ * @brief Upload being worked on, as stored in the manifest
+ */
+typedef struct {
+    char upload_id[MULTIPART_ID_MAX];
+    char object[MAX_URL_LENGTH];            /* URL without query */
+    char file[MAX_PATH_LENGTH];
+    long long size;
+    long long mtime;
+    long long part_size;
+    int part_count;
+    char (*etags)[MULTIPART_ETAG_MAX];      /* "" = part not uploaded yet */
+} MultipartState;
+
+/**
+ * @brief One part in flight
+ */
+typedef struct {
+    CURL* curl;
+    int fd;
+    int part;                               /* 0-based part index */
+    long long offset;
+    long long length;
+    long long sent;
+    char etag[MULTIPART_ETAG_MAX];
+    int retry_after;
+} PartTransfer;
+
+typedef struct {
+    char* data;
+    size_t len;
+} ResponseBody;
+
+static void state_free(MultipartState* state)
+{
+    free(state->etags);
+    memset(state, 0, sizeof(*state));
+}
+
+static bool state_init_parts(MultipartState* state)
+{
+    if (state->size <= 0 || state->part_size <= 0) {
+        return false;
+    }
+    long long count = (state->size + state->part_size - 1) / state->part_size;
+    if (count > MULTIPART_MAX_PARTS) {
+        return false;
+    }
+    state->part_count = (int)count;
+    state->etags = calloc((size_t)count, sizeof(*state->etags));
+    return state->etags != NULL;
+}
+
+static void url_object(const char* url, char* object, size_t object_size)
+{
+    size_t len = strcspn(url, "?#");
+    if (len >= object_size) {
+        len = object_size - 1;
+    }
+    memcpy(object, url, len);
+    object[len] = '\0';
+}
+
+static bool build_url(char* out, size_t out_size, const char* url, const char* query)
+{
+    int written = snprintf(out, out_size, "%s%c%s", url, strchr(url, '?') ? '&' : '?', query);
+    return written > 0 && written < (int)out_size;
+}
+
+/**
+ * @brief Copy a manifest field, false if it does not fit
+ */
+static bool copy_field(char* dst, size_t dst_size, const char* src)
+{
+    size_t len = strlen(src);
+    if (len >= dst_size) {
+        return false;
+    }
+    memcpy(dst, src, len + 1);
+    return true;
+}
+
+static bool manifest_load(const char* path, MultipartState* state)
+{
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        return false;
+    }
+
+    char line[MULTIPART_LINE_MAX];
+    bool valid = true;
+    while (valid && fgets(line, sizeof(line), fp)) {
+        int consumed = 0;
+        int number = 0;
+
+        line[strcspn(line, "\r\n")] = '\0';
+        if (strncmp(line, "upload_id ", 10) == 0) {
+            valid = copy_field(state->upload_id, sizeof(state->upload_id), line + 10);
+        } else if (strncmp(line, "object ", 7) == 0) {
+            valid = copy_field(state->object, sizeof(state->object), line + 7);
+        } else if (!state->etags &&
+                   sscanf(line, "file %lld %lld %lld %n", &state->size, &state->mtime,
+                          &state->part_size, &consumed) == 3 && consumed > 0) {
+            valid = copy_field(state->file, sizeof(state->file), line + consumed) &&
+                    state_init_parts(state);
+        } else if (state->etags && sscanf(line, "part %d %n", &number, &consumed) == 1 &&
+                   consumed > 0 && number >= 1 && number <= state->part_count) {
+            valid = copy_field(state->etags[number - 1], MULTIPART_ETAG_MAX, line + consumed);
+        }
+    }
+    fclose(fp);
+
+    // A field cut short would resume against the wrong upload; start over
+    if (!valid || !state->etags || state->upload_id[0] == '\0' || state->object[0] == '\0') {
+        state_free(state);
+        return false;
+    }
+    return true;
+}
+
+static int manifest_save(const char* path, const MultipartState* state)
+{
+    char tmp_path[MAX_PATH_LENGTH];
+    int written = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    if (written < 0 || written >= (int)sizeof(tmp_path)) {
+        return -1;
+    }
+
+    FILE* fp = fopen(tmp_path, "w");
+    if (!fp) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to create %s (errno=%d)\n", __FUNCTION__, __LINE__, tmp_path, errno);
+        return -1;
+    }
+
+    fprintf(fp, "upload_id %s\nobject %s\nfile %lld %lld %lld %s\n", state->upload_id, state->object,
+            state->size, state->mtime, state->part_size, state->file);
+    for (int i = 0; i < state->part_count; i++) {
+        if (state->etags[i][0] != '\0') {
+            fprintf(fp, "part %d %s\n", i + 1, state->etags[i]);
+        }
+    }
+
+    // Write, flush and rename so a power cut leaves either manifest intact
+    bool ok = (fflush(fp) == 0 && fsync(fileno(fp)) == 0);
+    if (fclose(fp) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(tmp_path, path) != 0) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Failed to commit part manifest %s (errno=%d)\n", __FUNCTION__, __LINE__, path, errno);
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+static size_t collect_body(char* ptr, size_t size, size_t nmemb, void* userdata)
+{
+    ResponseBody* body = (ResponseBody*)userdata;
+    size_t len = size * nmemb;
+    size_t keep = len;
+
+    if (body->len + keep > MULTIPART_BODY_MAX) {
+        keep = MULTIPART_BODY_MAX - body->len;
+    }
+    if (keep > 0) {
+        char* data = realloc(body->data, body->len + keep + 1);
+        if (!data) {
+            return 0;
+        }
+        memcpy(data + body->len, ptr, keep);
+        body->data = data;
+        body->len += keep;
+        body->data[body->len] = '\0';
+    }
+    return len;
+}
+
+static size_t discard_response(char* ptr, size_t size, size_t nmemb, void* userdata)
+{
+    (void)ptr;
+    (void)userdata;
+    return size * nmemb;
+}
+
+/**
+ * @brief Copy the text of the first <tag>...</tag> element of an XML response
+ */
+static bool xml_value(const char* xml, const char* tag, char* out, size_t out_size)
+{
+    char open_tag[64];
+    char close_tag[64];
+    snprintf(open_tag, sizeof(open_tag), "<%s>", tag);
+    snprintf(close_tag, sizeof(close_tag), "</%s>", tag);
+
+    const char* start = xml ? strstr(xml, open_tag) : NULL;
+    if (!start) {
+        return false;
+    }
+    start += strlen(open_tag);
+    const char* end = strstr(start, close_tag);
+    if (!end || end == start || (size_t)(end - start) >= out_size) {
+        return false;
+    }
+    memcpy(out, start, (size_t)(end - start));
+    out[end - start] = '\0';
+    return true;
+}
+
+/**
+ * @brief POST a (possibly empty) XML body and collect the response
+ */
+static CURLcode post_request(const char* request_url, const char* xml, const UploadHttpCert* cert,
+                             bool ocsp, int connect_timeout_s, ResponseBody* body, UploadResponse* resp)
+{
+    CURL* curl = upload_http_acquire();
+    if (!curl) {
+        return CURLE_FAILED_INIT;
+    }
+
+    struct curl_slist* headers = curl_slist_append(NULL, "Content-Type: application/xml");
+    curl_easy_setopt(curl, CURLOPT_URL, request_url);
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, xml ? xml : "");
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, xml ? (long)strlen(xml) : 0L);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, collect_body);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, body);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, upload_http_retry_after_header);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &resp->retry_after);
+    upload_http_set_transfer_opts(curl, cert, ocsp, connect_timeout_s);
+
+    CURLcode rc = curl_easy_perform(curl);
+    long http_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    upload_http_release(curl);
+    curl_slist_free_all(headers);
+
+    resp->http_code = (int)http_code;
+    resp->curl_code = (int)rc;
+    return rc;
+}
+
+static MultipartResult create_upload(const char* url, const UploadHttpCert* cert, bool ocsp,
+                                     int connect_timeout_s, MultipartState* state, UploadResponse* resp)
+{
+    char request_url[MULTIPART_URL_MAX];
+    if (!build_url(request_url, sizeof(request_url), url, "uploads")) {
+        return MULTIPART_UNSUPPORTED;
+    }
+
+    ResponseBody body = { NULL, 0 };
+    CURLcode rc = post_request(request_url, NULL, cert, ocsp, connect_timeout_s, &body, resp);
+    MultipartResult result = MULTIPART_FAILED;
+
+    if (rc == CURLE_OK && resp->http_code == 200 &&
+        xml_value(body.data, "UploadId", state->upload_id, sizeof(state->upload_id))) {
+        result = MULTIPART_OK;
+    } else if (rc == CURLE_OK && (resp->http_code == 200 ||
+               (resp->http_code >= 400 && resp->http_code < 500 &&
+                resp->http_code != 408 && !is_throttled_response(resp->http_code)))) {
+        // Accepted without an UploadId, or refused outright: not a multipart endpoint
+        result = MULTIPART_UNSUPPORTED;
+    }
+
+    RDK_LOG(result == MULTIPART_OK ? RDK_LOG_INFO : RDK_LOG_WARN, LOG_UPLOADSTB,
+            "[%s:%d] CreateMultipartUpload: HTTP %d, curl %d, %d parts of %lld bytes\n",
+            __FUNCTION__, __LINE__, resp->http_code, (int)rc, state->part_count, state->part_size);
+    free(body.data);
+    return result;
+}
+
+static MultipartResult complete_upload(const char* url, const UploadHttpCert* cert, bool ocsp,
+                                       int connect_timeout_s, const MultipartState* state,
+                                       UploadResponse* resp)
+{
+    char query[MULTIPART_ID_MAX * 3 + 16];
+    char* escaped = curl_easy_escape(NULL, state->upload_id, 0);
+    if (!escaped) {
+        return MULTIPART_FAILED;
+    }
+    snprintf(query, sizeof(query), "uploadId=%s", escaped);
+    curl_free(escaped);
+
+    char request_url[MULTIPART_URL_MAX];
+    size_t xml_size = 64 + (size_t)state->part_count * (64 + MULTIPART_ETAG_MAX);
+    char* xml = malloc(xml_size);
+    if (!xml || !build_url(request_url, sizeof(request_url), url, query)) {
+        free(xml);
+        return MULTIPART_FAILED;
+    }
+
+    size_t len = (size_t)snprintf(xml, xml_size, "<CompleteMultipartUpload>");
+    for (int i = 0; i < state->part_count; i++) {
+        len += (size_t)snprintf(xml + len, xml_size - len,
+                                "<Part><PartNumber>%d</PartNumber><ETag>%s</ETag></Part>",
+                                i + 1, state->etags[i]);
+    }
+    snprintf(xml + len, xml_size - len, "</CompleteMultipartUpload>");
+
+    ResponseBody body = { NULL, 0 };
+    CURLcode rc = post_request(request_url, xml, cert, ocsp, connect_timeout_s, &body, resp);
+    free(xml);
+
+    // S3 can answer 200 and still report a failure in the body
+    bool ok = (rc == CURLE_OK && resp->http_code == 200 && !(body.data && strstr(body.data, "<Error>")));
+    if (!ok && resp->http_code == 200) {
+        resp->http_code = 500;
+    }
+    RDK_LOG(ok ? RDK_LOG_INFO : RDK_LOG_ERROR, LOG_UPLOADSTB,
+            "[%s:%d] CompleteMultipartUpload: HTTP %d, curl %d\n",
+            __FUNCTION__, __LINE__, resp->http_code, (int)rc);
+    free(body.data);
+    return ok ? MULTIPART_OK : MULTIPART_FAILED;
+}
+
+static size_t part_read(char* buffer, size_t size, size_t nitems, void* userdata)
+{
+    PartTransfer* t = (PartTransfer*)userdata;
+    long long left = t->length - t->sent;
+    size_t want = size * nitems;
+
+    if ((long long)want > left) {
+        want = (size_t)left;
+    }
+    if (want == 0) {
+        return 0;
+    }
+    // Sleeping here holds up the other parts too, which draw from the same bucket anyway
+    want = upload_http_throttle(t->curl, want);
+    ssize_t n = pread(t->fd, buffer, want, (off_t)(t->offset + t->sent));
+    if (n < 0) {
+        return CURL_READFUNC_ABORT;
+    }
+    t->sent += n;
+    return (size_t)n;
+}
+
+static int part_seek(void* userdata, curl_off_t offset, int origin)
+{
+    PartTransfer* t = (PartTransfer*)userdata;
+    if (origin != SEEK_SET || offset < 0 || offset > t->length) {
+        return CURL_SEEKFUNC_FAIL;
+    }
+    t->sent = offset;
+    return CURL_SEEKFUNC_OK;
+}
+
+static size_t part_header(char* buffer, size_t size, size_t nitems, void* userdata)
+{
+    PartTransfer* t = (PartTransfer*)userdata;
+    size_t len = size * nitems;
+
+    upload_http_retry_after_header(buffer, size, nitems, &t->retry_after);
+    if (len > 5 && strncasecmp(buffer, "ETag:", 5) == 0) {
+        const char* value = buffer + 5;
+        size_t value_len = len - 5;
+        while (value_len > 0 && isspace((unsigned char)*value)) {
+            value++;
+            value_len--;
+        }
+        while (value_len > 0 && isspace((unsigned char)value[value_len - 1])) {
+            value_len--;
+        }
+        if (value_len > 0 && value_len < sizeof(t->etag)) {
+            memcpy(t->etag, value, value_len);
+            t->etag[value_len] = '\0';
+        }
+    }
+    return len;
+}
+
+static bool start_part(PartTransfer* t, int part, int fd, const char* url, const char* id_query,
+                       const MultipartState* state, const UploadHttpCert* cert, bool ocsp,
+                       int connect_timeout_s, const UploadHttpCancel* cancel)
+{
+    char query[MULTIPART_ID_MAX * 3 + 48];
+    char request_url[MULTIPART_URL_MAX];
+    snprintf(query, sizeof(query), "partNumber=%d&%s", part + 1, id_query);
+    if (!build_url(request_url, sizeof(request_url), url, query)) {
+        return false;
+    }
+
+    memset(t, 0, sizeof(*t));
+    t->fd = fd;
+    t->part = part;
+    t->offset = (long long)part * state->part_size;
+    t->length = state->size - t->offset;
+    if (t->length > state->part_size) {
+        t->length = state->part_size;
+    }
+
+    t->curl = upload_http_acquire();
+    if (!t->curl) {
+        return false;
+    }
+    curl_easy_setopt(t->curl, CURLOPT_URL, request_url);
+    curl_easy_setopt(t->curl, CURLOPT_UPLOAD, 1L);
+    curl_easy_setopt(t->curl, CURLOPT_READFUNCTION, part_read);
+    curl_easy_setopt(t->curl, CURLOPT_READDATA, t);
+    curl_easy_setopt(t->curl, CURLOPT_SEEKFUNCTION, part_seek);
+    curl_easy_setopt(t->curl, CURLOPT_SEEKDATA, t);
+    curl_easy_setopt(t->curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)t->length);
+    curl_easy_setopt(t->curl, CURLOPT_HEADERFUNCTION, part_header);
+    curl_easy_setopt(t->curl, CURLOPT_HEADERDATA, t);
+    curl_easy_setopt(t->curl, CURLOPT_WRITEFUNCTION, discard_response);
+    upload_http_set_transfer_opts(t->curl, cert, ocsp, connect_timeout_s);
+    upload_http_set_cancel(t->curl, cancel);
+    return true;
+}
+
+/**
+ * @brief Upload every part without an ETag, config->parallel at a time
+ */
+static MultipartResult upload_parts(const char* url, const char* src_file, const UploadHttpCert* cert,
+                                    bool ocsp, int connect_timeout_s, const MultipartConfig* config,
+                                    MultipartState* state, UploadResponse* resp)
+{
+    int parallel = config->parallel < 1 ? 1 : config->parallel;
+    if (parallel > MULTIPART_MAX_PARALLEL) {
+        parallel = MULTIPART_MAX_PARALLEL;
+    }
+    int max_attempts = config->part_attempts < 1 ? 1 : config->part_attempts;
+
+    char id_query[MULTIPART_ID_MAX * 3 + 16];
+    char* escaped = curl_easy_escape(NULL, state->upload_id, 0);
+    if (!escaped) {
+        return MULTIPART_FAILED;
+    }
+    snprintf(id_query, sizeof(id_query), "uploadId=%s", escaped);
+    curl_free(escaped);
+
+    int fd = open(src_file, O_RDONLY);
+    int* queue = calloc((size_t)state->part_count, sizeof(int));
+    int* attempts = calloc((size_t)state->part_count, sizeof(int));
+    CURLM* multi = curl_multi_init();
+    if (fd < 0 || !queue || !attempts || !multi) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Cannot start part uploads for %s (errno=%d)\n", __FUNCTION__, __LINE__, src_file, errno);
+        if (fd >= 0) {
+            close(fd);
+        }
+        free(queue);
+        free(attempts);
+        if (multi) {
+            curl_multi_cleanup(multi);
+        }
+        return MULTIPART_FAILED;
+    }
+
+    // Ring of parts waiting for a slot; a part is either queued, in flight or done
+    int head = 0;
+    int queued = 0;
+    for (int i = 0; i < state->part_count; i++) {
+        if (state->etags[i][0] == '\0') {
+            queue[queued++] = i;
+        }
+    }
+
+    PartTransfer slots[MULTIPART_MAX_PARALLEL];
+    memset(slots, 0, sizeof(slots));
+    int active = 0;
+    bool failed = false;
+    bool stale = false;
+
+    // After a failure no new part is started, but the ones in flight may still
+    // finish and be recorded for the next attempt
+    while (!stale && ((!failed && queued > 0) || active > 0)) {
+        for (int i = 0; i < parallel && queued > 0 && !failed; i++) {
+            if (slots[i].curl) {
+                continue;
+            }
+            int part = queue[head];
+            head = (head + 1) % state->part_count;
+            queued--;
+            if (!start_part(&slots[i], part, fd, url, id_query, state, cert, ocsp, connect_timeout_s,
+                            config->cancel)) {
+                failed = true;
+                break;
+            }
+            curl_multi_add_handle(multi, slots[i].curl);
+            active++;
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        CURLMsg* msg;
+        int pending = 0;
+        while ((msg = curl_multi_info_read(multi, &pending)) != NULL) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            CURL* easy = msg->easy_handle;
+            CURLcode rc = msg->data.result;
+            PartTransfer* t = NULL;
+            for (int i = 0; i < parallel; i++) {
+                if (slots[i].curl == easy) {
+                    t = &slots[i];
+                }
+            }
+            long http_code = 0;
+            curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &http_code);
+            curl_multi_remove_handle(multi, easy);
+            upload_http_release(easy);
+            active--;
+            if (!t) {
+                continue;
+            }
+            t->curl = NULL;
+
+            // Report the request that decided the outcome, not a part finishing later
+            if (!failed) {
+                resp->http_code = (int)http_code;
+                resp->curl_code = (int)rc;
+            }
+            if (t->retry_after > resp->retry_after) {
+                resp->retry_after = t->retry_after;
+            }
+
+            if (rc == CURLE_OK && http_code >= 200 && http_code < 300 && t->etag[0] != '\0') {
+                strcpy(state->etags[t->part], t->etag);
+                resp->bytes += t->length;
+                if (!stale) {
+                    manifest_save(config->manifest_path, state);
+                }
+                RDK_LOG(RDK_LOG_DEBUG, LOG_UPLOADSTB, "[%s:%d] Part %d/%d uploaded (%lld bytes)\n",
+                        __FUNCTION__, __LINE__, t->part + 1, state->part_count, t->length);
+            } else if (rc == CURLE_ABORTED_BY_CALLBACK) {
+                // Cancelled by the caller: no retry, finished parts stay in the manifest
+                failed = true;
+            } else if (http_code == 404 || is_throttled_response((int)http_code)) {
+                // Upload id gone, or the server asks us to back off: leave it to the caller
+                RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, "[%s:%d] Part %d: HTTP %ld, stopping\n",
+                        __FUNCTION__, __LINE__, t->part + 1, http_code);
+                if (http_code == 404) {
+                    unlink(config->manifest_path);
+                    stale = true;
+                }
+                failed = true;
+            } else if (++attempts[t->part] < max_attempts) {
+                RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                        "[%s:%d] Part %d failed (HTTP %ld, curl %d), retrying (%d/%d)\n",
+                        __FUNCTION__, __LINE__, t->part + 1, http_code, (int)rc,
+                        attempts[t->part] + 1, max_attempts);
+                queue[(head + queued) % state->part_count] = t->part;
+                queued++;
+            } else {
+                RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                        "[%s:%d] Part %d failed %d times (HTTP %ld, curl %d)\n",
+                        __FUNCTION__, __LINE__, t->part + 1, max_attempts, http_code, (int)rc);
+                failed = true;
+            }
+        }
+
+        if (!stale && active > 0) {
+            curl_multi_wait(multi, NULL, 0, 1000, NULL);
+        }
+    }
+
+    // Drop the parts still in flight; the manifest keeps what was finished
+    for (int i = 0; i < parallel; i++) {
+        if (slots[i].curl) {
+            curl_multi_remove_handle(multi, slots[i].curl);
+            upload_http_release(slots[i].curl);
+        }
+    }
+    curl_multi_cleanup(multi);
+    free(queue);
+    free(attempts);
+    close(fd);
+    return failed ? MULTIPART_FAILED : MULTIPART_OK;
+}
+
+MultipartResult upload_multipart_put(const char* url, const char* src_file, const UploadHttpCert* cert,
+                                     bool ocsp, int connect_timeout_s, const MultipartConfig* config,
+                                     UploadResponse* resp)
+{
+    if (!url || !src_file || !config || !config->manifest_path || !resp) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return MULTIPART_UNSUPPORTED;
+    }
+
+    resp->http_code = 0;
+    resp->curl_code = 0;
+    resp->elapsed_ms = 0;
+    resp->retry_after = 0;
+    resp->bytes = 0;
+
+    struct stat st;
+    if (stat(src_file, &st) != 0 || st.st_size <= 0) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Cannot stat %s (errno=%d)\n", __FUNCTION__, __LINE__, src_file, errno);
+        return MULTIPART_UNSUPPORTED;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // Grow the part size to stay within the S3 part count limit
+    long long part_size = config->part_size;
+    if (part_size < (long long)MULTIPART_MIN_PART_MB * 1024 * 1024) {
+        part_size = (long long)MULTIPART_MIN_PART_MB * 1024 * 1024;
+    }
+    while ((st.st_size + part_size - 1) / part_size > MULTIPART_MAX_PARTS) {
+        part_size *= 2;
+    }
+
+    char object[MAX_URL_LENGTH];
+    url_object(url, object, sizeof(object));
+
+    MultipartState state;
+    memset(&state, 0, sizeof(state));
+    bool resumed = manifest_load(config->manifest_path, &state) &&
+                   strcmp(state.object, object) == 0 && strcmp(state.file, src_file) == 0 &&
+                   state.size == (long long)st.st_size && state.mtime == (long long)st.st_mtime;
+
+    MultipartResult result = MULTIPART_OK;
+    if (resumed) {
+        int done = 0;
+        for (int i = 0; i < state.part_count; i++) {
+            done += (state.etags[i][0] != '\0');
+        }
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                "[%s:%d] Resuming multipart upload of %s: %d of %d parts already uploaded\n",
+                __FUNCTION__, __LINE__, src_file, done, state.part_count);
+    } else {
+        state_free(&state);
+        snprintf(state.object, sizeof(state.object), "%s", object);
+        snprintf(state.file, sizeof(state.file), "%s", src_file);
+        state.size = (long long)st.st_size;
+        state.mtime = (long long)st.st_mtime;
+        state.part_size = part_size;
+        if (!state_init_parts(&state)) {
+            result = MULTIPART_UNSUPPORTED;
+        } else {
+            result = create_upload(url, cert, ocsp, connect_timeout_s, &state, resp);
+        }
+        if (result == MULTIPART_OK) {
+            manifest_save(config->manifest_path, &state);
+        }
+    }
+
+    if (result == MULTIPART_OK) {
+        result = upload_parts(url, src_file, cert, ocsp, connect_timeout_s, config, &state, resp);
+    }
+    if (result == MULTIPART_OK) {
+        result = complete_upload(url, cert, ocsp, connect_timeout_s, &state, resp);
+        if (result == MULTIPART_OK || resp->http_code == 404) {
+            unlink(config->manifest_path);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    resp->elapsed_ms = (long)(end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] Multipart upload of %lld bytes: result %d, HTTP %d, %ld ms\n",
+            __FUNCTION__, __LINE__, state.size, (int)result, resp->http_code, resp->elapsed_ms);
+    state_free(&state);
+    return result;
+}
@@ -0,0 +1,494 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file upload_spool.c
+ * @brief On-disk spool of archives whose upload failed
+ *
+ * Each archive <name> has a record <name>.meta of key=value lines:
+ *   strategy, spooled, next_try, attempts, md5, sha256
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "upload_spool.h"
+#include "upload_engine.h"
+#include "strategy_selector.h"
+#include "retry_logic.h"
+#include "rdk_debug.h"
+
+static bool has_suffix(const char* name, const char* suffix)
+{
+    size_t len = strlen(name);
+    size_t suffix_len = strlen(suffix);
+    return len > suffix_len && strcmp(name + len - suffix_len, suffix) == 0;
+}
+
+static bool record_path(const char* archive, char* buffer, size_t buffer_size)
+{
+    int written = snprintf(buffer, buffer_size, "%s%s", archive, SPOOL_META_EXT);
+    return written > 0 && (size_t)written < buffer_size;
+}
+
+static void fsync_dir(const char* dir)
+{
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+/**
+ * @brief Copy a file and sync it to disk
+ * @return 0 on success, -1 on failure (dest is removed)
+ */
+static int copy_synced(const char* src, const char* dest)
+{
+    int in = open(src, O_RDONLY);
+    if (in < 0) {
+        return -1;
+    }
+    int out = open(dest, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (out < 0) {
+        close(in);
+        return -1;
+    }
+
+    char buffer[65536];
+    ssize_t n;
+    int ret = 0;
+    while ((n = read(in, buffer, sizeof(buffer))) > 0) {
+        ssize_t off = 0;
+        while (off < n) {
+            ssize_t w = write(out, buffer + off, (size_t)(n - off));
+            if (w < 0) {
+                ret = -1;
+                break;
+            }
+            off += w;
+        }
+        if (ret != 0) {
+            break;
+        }
+    }
+    if (n < 0 || fsync(out) != 0) {
+        ret = -1;
+    }
+    close(in);
+    if (close(out) != 0) {
+        ret = -1;
+    }
+    if (ret != 0) {
+        unlink(dest);
+    }
+    return ret;
+}
+
+/**
+ * @brief Move a file into the spool, copying when it is on another file system
+ */
+static int move_into_spool(const char* src, const char* dest)
+{
+    if (rename(src, dest) == 0) {
+        return 0;
+    }
+    if (errno != EXDEV) {
+        return -1;
+    }
+
+    // Copy under a temporary name so a crash never leaves a partial archive
+    char tmp[MAX_PATH_LENGTH + 8];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", dest);
+    if (copy_synced(src, tmp) != 0) {
+        return -1;
+    }
+    if (rename(tmp, dest) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+    unlink(src);
+    return 0;
+}
+
+/**
+ * @brief Write an entry's record with a rename, so it is replaced as a whole
+ */
+static int write_record(const SpoolEntry* entry)
+{
+    char path[MAX_PATH_LENGTH + 8];
+    char tmp[MAX_PATH_LENGTH + 16];
+    if (!record_path(entry->archive, path, sizeof(path))) {
+        return -1;
+    }
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    FILE* fp = fopen(tmp, "w");
+    if (!fp) {
+        return -1;
+    }
+    fprintf(fp, "strategy=%d\nspooled=%lld\nnext_try=%lld\nattempts=%d\nmd5=%s\nsha256=%s\n",
+            (int)entry->strategy, (long long)entry->spooled, (long long)entry->next_try,
+            entry->attempts, entry->md5, entry->sha256);
+    bool ok = (fflush(fp) == 0 && fsync(fileno(fp)) == 0);
+    if (fclose(fp) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read an entry's record; the archive path must be set
+ */
+static bool read_record(const char* path, SpoolEntry* entry)
+{
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        return false;
+    }
+
+    char line[128];
+    bool have_strategy = false;
+    bool have_spooled = false;
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char* value = strchr(line, '=');
+        if (!value) {
+            continue;
+        }
+        *value++ = '\0';
+
+        if (strcmp(line, "strategy") == 0) {
+            int strategy = atoi(value);
+            have_strategy = (strategy >= STRAT_RRD && strategy <= STRAT_DCM);
+            entry->strategy = (Strategy)strategy;
+        } else if (strcmp(line, "spooled") == 0) {
+            entry->spooled = (time_t)strtoll(value, NULL, 10);
+            have_spooled = true;
+        } else if (strcmp(line, "next_try") == 0) {
+            entry->next_try = (time_t)strtoll(value, NULL, 10);
+        } else if (strcmp(line, "attempts") == 0) {
+            entry->attempts = atoi(value) > 0 ? atoi(value) : 0;
+        } else if (strcmp(line, "md5") == 0 && strlen(value) < sizeof(entry->md5)) {
+            strcpy(entry->md5, value);
+        } else if (strcmp(line, "sha256") == 0 && strlen(value) < sizeof(entry->sha256)) {
+            strcpy(entry->sha256, value);
+        }
+    }
+    fclose(fp);
+    return have_strategy && have_spooled;
+}
+
+/**
+ * @brief Remove a spooled archive and its record
+ */
+static void drop_entry(const SpoolEntry* entry)
+{
+    char path[MAX_PATH_LENGTH + 8];
+    unlink(entry->archive);
+    if (record_path(entry->archive, path, sizeof(path))) {
+        unlink(path);
+    }
+}
+
+static int compare_entries(const void* a, const void* b)
+{
+    const SpoolEntry* ea = (const SpoolEntry*)a;
+    const SpoolEntry* eb = (const SpoolEntry*)b;
+    if (ea->spooled != eb->spooled) {
+        return ea->spooled < eb->spooled ? -1 : 1;
+    }
+    return strcmp(ea->archive, eb->archive);
+}
+
+long upload_spool_backoff_s(int attempts)
+{
+    long delay = SPOOL_RETRY_BASE_S;
+    for (int i = 1; i < attempts && delay < SPOOL_RETRY_CAP_S; i++) {
+        delay *= 2;
+    }
+    return delay < SPOOL_RETRY_CAP_S ? delay : SPOOL_RETRY_CAP_S;
+}
+
+int upload_spool_list(const char* dir, SpoolEntry** entries)
+{
+    if (!dir || !entries) {
+        return -1;
+    }
+    *entries = NULL;
+
+    DIR* d = opendir(dir);
+    if (!d) {
+        return (errno == ENOENT) ? 0 : -1;
+    }
+
+    SpoolEntry* list = NULL;
+    int count = 0;
+    int capacity = 0;
+    struct dirent* de;
+    while ((de = readdir(d)) != NULL) {
+        if (de->d_name[0] == '.') {
+            continue;
+        }
+
+        char path[MAX_PATH_LENGTH];
+        int written = snprintf(path, sizeof(path), "%s/%s", dir, de->d_name);
+        if (written < 0 || (size_t)written >= sizeof(path)) {
+            continue;
+        }
+
+        // Leftovers of an interrupted move or record update
+        if (has_suffix(de->d_name, ".tmp")) {
+            unlink(path);
+            continue;
+        }
+
+        struct stat st;
+        if (has_suffix(de->d_name, SPOOL_META_EXT)) {
+            path[strlen(path) - strlen(SPOOL_META_EXT)] = '\0';
+            if (stat(path, &st) != 0) {
+                strcat(path, SPOOL_META_EXT);
+                unlink(path);
+            }
+            continue;
+        }
+
+        char record[MAX_PATH_LENGTH + 8];
+        if (!record_path(path, record, sizeof(record)) || stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+
+        SpoolEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        strcpy(entry.archive, path);
+        entry.size = (long long)st.st_size;
+        if (!read_record(record, &entry)) {
+            RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                    "[%s:%d] Dropping spooled archive without a valid record: %s\n",
+                    __FUNCTION__, __LINE__, path);
+            drop_entry(&entry);
+            continue;
+        }
+
+        if (count == capacity) {
+            int new_capacity = capacity ? capacity * 2 : 8;
+            SpoolEntry* grown = realloc(list, (size_t)new_capacity * sizeof(SpoolEntry));
+            if (!grown) {
+                free(list);
+                closedir(d);
+                return -1;
+            }
+            list = grown;
+            capacity = new_capacity;
+        }
+        list[count++] = entry;
+    }
+    closedir(d);
+
+    if (count > 1) {
+        qsort(list, (size_t)count, sizeof(SpoolEntry), compare_entries);
+    }
+    *entries = list;
+    return count;
+}
+
+int upload_spool_evict(const char* dir, long long max_bytes, long max_age_s, time_t now)
+{
+    SpoolEntry* entries = NULL;
+    int count = upload_spool_list(dir, &entries);
+    if (count < 0) {
+        return -1;
+    }
+
+    long long total = 0;
+    for (int i = 0; i < count; i++) {
+        total += entries[i].size;
+    }
+
+    // Oldest first: expired archives, then whatever keeps the spool over its size
+    int dropped = 0;
+    for (int i = 0; i < count; i++) {
+        bool expired = (max_age_s > 0 && now - entries[i].spooled > max_age_s);
+        if (!expired && total <= max_bytes && max_bytes > 0) {
+            continue;
+        }
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] Dropping spooled archive %s (%s, %lld bytes)\n",
+                __FUNCTION__, __LINE__, entries[i].archive,
+                expired ? "expired" : "spool full", entries[i].size);
+        drop_entry(&entries[i]);
+        total -= entries[i].size;
+        dropped++;
+    }
+
+    free(entries);
+    return dropped;
+}
+
+int upload_spool_add(const RuntimeContext* ctx, const SessionState* session, const char* archive_path)
+{
+    if (!ctx || !session || !archive_path || archive_path[0] == '\0') {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+    if (ctx->spool_max_mb <= 0) {
+        return -1;
+    }
+
+    long long max_bytes = (long long)ctx->spool_max_mb * 1024 * 1024;
+    struct stat st;
+    if (stat(archive_path, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return -1;
+    }
+    if ((long long)st.st_size > max_bytes) {
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] Archive %s (%lld bytes) does not fit the %d MB spool\n",
+                __FUNCTION__, __LINE__, archive_path, (long long)st.st_size, ctx->spool_max_mb);
+        return -1;
+    }
+
+    if (mkdir(UPLOAD_SPOOL_DIR, 0700) != 0 && errno != EEXIST) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Cannot create %s (errno=%d)\n", __FUNCTION__, __LINE__, UPLOAD_SPOOL_DIR, errno);
+        return -1;
+    }
+
+    const char* name = strrchr(archive_path, '/');
+    name = name ? name + 1 : archive_path;
+
+    SpoolEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    int written = snprintf(entry.archive, sizeof(entry.archive), "%s/%s", UPLOAD_SPOOL_DIR, name);
+    // The retry passes the path in SessionState.archive_file
+    if (written < 0 || written >= MAX_FILENAME_LENGTH || name[0] == '\0' || name[0] == '.' ||
+        has_suffix(name, SPOOL_META_EXT) || has_suffix(name, ".tmp")) {
+        return -1;
+    }
+    entry.strategy = session->strategy;
+    entry.spooled = time(NULL);
+    entry.next_try = entry.spooled;
+    entry.size = (long long)st.st_size;
+    snprintf(entry.md5, sizeof(entry.md5), "%s", session->archive_md5);
+    snprintf(entry.sha256, sizeof(entry.sha256), "%s", session->archive_sha256);
+
+    if (move_into_spool(archive_path, entry.archive) != 0) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Cannot move %s into the spool (errno=%d)\n", __FUNCTION__, __LINE__, archive_path, errno);
+        return -1;
+    }
+    if (write_record(&entry) != 0) {
+        // Without a record the archive is removed by the next listing
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB,
+                "[%s:%d] Cannot record spooled archive %s\n", __FUNCTION__, __LINE__, entry.archive);
+        unlink(entry.archive);
+        return -1;
+    }
+    fsync_dir(UPLOAD_SPOOL_DIR);
+
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] Spooled %s for a later retry (%lld bytes)\n",
+            __FUNCTION__, __LINE__, entry.archive, entry.size);
+
+    upload_spool_evict(UPLOAD_SPOOL_DIR, max_bytes, (long)ctx->spool_max_days * 24 * 3600, entry.spooled);
+    return 0;
+}
+
+int upload_spool_drain(RuntimeContext* ctx)
+{
+    if (!ctx) {
+        RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, "[%s:%d] Invalid parameters\n", __FUNCTION__, __LINE__);
+        return -1;
+    }
+
+    time_t now = time(NULL);
+
+    // Same rule as execute_upload_cycle: a throttling server is left alone
+    if (ctx->trigger_type != TRIGGER_ONDEMAND && ctx->trigger_type != TRIGGER_MANUAL &&
+        upload_deferred(UPLOAD_NOT_BEFORE_FILE, now, NULL)) {
+        return 0;
+    }
+
+    if (ctx->spool_max_days > 0) {
+        upload_spool_evict(UPLOAD_SPOOL_DIR, LLONG_MAX, (long)ctx->spool_max_days * 24 * 3600, now);
+    }
+
+    SpoolEntry* entries = NULL;
+    int count = upload_spool_list(UPLOAD_SPOOL_DIR, &entries);
+    if (count <= 0) {
+        return count;
+    }
+
+    RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+            "[%s:%d] %d archive(s) in the upload spool\n", __FUNCTION__, __LINE__, count);
+
+    int uploaded = 0;
+    for (int i = 0; i < count; i++) {
+        SpoolEntry* entry = &entries[i];
+
+        // A schedule further out than the longest delay was made with a wrong clock
+        if (entry->next_try > now && entry->next_try - now <= SPOOL_RETRY_CAP_S) {
+            continue;
+        }
+        if (strlen(entry->archive) >= MAX_FILENAME_LENGTH) {
+            drop_entry(entry);
+            continue;
+        }
+
+        SessionState session;
+        memset(&session, 0, sizeof(session));
+        session.strategy = entry->strategy;
+        strcpy(session.archive_file, entry->archive);
+        strcpy(session.archive_md5, entry->md5);
+        strcpy(session.archive_sha256, entry->sha256);
+        decide_paths(ctx, &session);
+
+        RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB,
+                "[%s:%d] Retrying spooled archive %s (attempt %d)\n",
+                __FUNCTION__, __LINE__, entry->archive, entry->attempts + 1);
+
+        if (attempt_upload_once(ctx, &session, session.primary) == UPLOADSTB_SUCCESS) {
+            drop_entry(entry);
+            uploaded++;
+            continue;
+        }
+
+        entry->attempts++;
+        entry->next_try = now + upload_spool_backoff_s(entry->attempts);
+        write_record(entry);
+        RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB,
+                "[%s:%d] Spooled archive %s failed again, next retry in %ld s\n",
+                __FUNCTION__, __LINE__, entry->archive, upload_spool_backoff_s(entry->attempts));
+        break;
+    }
+
+    free(entries);
+    return uploaded;
+}
@@ -243,12 +243,17 @@ int execute_uploadlogsnow_workflow(RuntimeContext* ctx)
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
             "[%s:%d] Uploading Logs through SNMP/TR69 Upload\n", __FUNCTION__, __LINE__);
     
-    // Add timestamps to files (using UploadLogsNow-specific exclusions)
-    if (add_timestamp_to_files_uploadlogsnow(dcm_log_path) != 0) {
+    // Timestamp member names inside the archive (UploadLogsNow-specific exclusions)
+    static const char* const keep_names[] = {"reboot.log", "ABLReason.txt", NULL};
+    ArchiveNameRule rule;
+    if (!archive_name_rule_init(&rule, time(NULL))) {
         RDK_LOG(RDK_LOG_WARN, LOG_UPLOADSTB, 
-                "[%s:%d] Failed to add timestamps to some files\n", __FUNCTION__, __LINE__);
+                "[%s:%d] Failed to prepare timestamp prefix\n", __FUNCTION__, __LINE__);
         // Continue - not critical for upload
     }
+    rule.skip_backups = false;
+    rule.skip_stamped = true;
+    rule.keep_names = keep_names;
     
     // Use existing archive creation function
     RDK_LOG(RDK_LOG_INFO, LOG_UPLOADSTB, 
@@ -264,8 +269,8 @@ int execute_uploadlogsnow_workflow(RuntimeContext* ctx)
     strncpy(ctx->dcm_log_path, dcm_log_path, sizeof(ctx->dcm_log_path) - 1);
     ctx->dcm_log_path[sizeof(ctx->dcm_log_path) - 1] = '\0';
     
-    // Use existing create_archive function
-    if (create_archive(ctx, &session, dcm_log_path) != 0) {
+    // Create archive; copied files keep their names on disk
+    if (create_archive_with_rule(ctx, &session, dcm_log_path, &rule, NULL) != 0) {
         RDK_LOG(RDK_LOG_ERROR, LOG_UPLOADSTB, 
                 "[%s:%d] Failed to create log archive\n", __FUNCTION__, __LINE__);
         write_upload_status("Failed");
@@ -35,6 +35,7 @@
 #include <errno.h>
 #include <time.h>
 #include <dirent.h>
+#include <signal.h>
 #include "common_device_api.h"
 
 #include "uploadstblogs.h"
@@ -45,6 +46,8 @@
 #include "strategy_handler.h"
 #include "archive_manager.h"
 #include "upload_engine.h"
+#include "retry_logic.h"
+#include "upload_http.h"
 #include "file_operations.h"
 #include "cleanup_handler.h"
 #include "event_manager.h"
@@ -217,6 +220,11 @@ void release_lock(void)
     }
 }
 
+void uploadstblogs_cancel(void)
+{
+    retry_wait_cancel();
+}
+
 bool is_maintenance_enabled(void)
 {
     // Check if maintenance mode is enabled from /etc/device.properties
@@ -250,6 +258,9 @@ int uploadstblogs_run(const UploadSTBLogsParams* params)
         return 1;
     }
 
+    /* Forget a cancel aimed at a previous upload */
+    retry_wait_reset();
+
     /* Initialize telemetry system */
 #ifdef T2_EVENT_ENABLED
     t2_init("uploadstblogs");
@@ -342,6 +353,9 @@ int uploadstblogs_run(const UploadSTBLogsParams* params)
     /* Cleanup IARM connection */
     cleanup_iarm_connection();
 
+    /* Drop pooled upload connections and TLS sessions */
+    upload_http_cleanup();
+
     /* Release lock and exit */
     release_lock();
     return ret;
@@ -366,6 +380,9 @@ int uploadstblogs_execute(int argc, char** argv)
         return 1;
     }
 
+    /* Forget a cancel aimed at a previous upload */
+    retry_wait_reset();
+
     /* Initialize telemetry system (matches rdm-agent pattern) */
 #ifdef T2_EVENT_ENABLED
     t2_init("uploadstblogs");
@@ -475,6 +492,9 @@ int uploadstblogs_execute(int argc, char** argv)
 
     /* Cleanup IARM connection */
     cleanup_iarm_connection();
+
+    /* Drop pooled upload connections and TLS sessions */
+    upload_http_cleanup();
     // Log total time from boot to upload completion
     double uptime_seconds = 0.0;
     if (get_system_uptime(&uptime_seconds)) {
@@ -486,6 +506,15 @@ int uploadstblogs_execute(int argc, char** argv)
 }
 
 #ifdef UPLOADSTBLOGS_BUILD_BINARY
+/**
+ * @brief SIGTERM/SIGINT handler for the standalone binary
+ */
+static void cancel_handler(int sig)
+{
+    (void)sig;
+    uploadstblogs_cancel();
+}
+
 /**
  * @brief Main entry point for standalone binary
  * 
@@ -494,6 +523,16 @@ int uploadstblogs_execute(int argc, char** argv)
  */
 int main(int argc, char** argv)
 {
+    /* First SIGTERM/SIGINT stops retrying and lets the upload finish up,
+     * SA_RESETHAND makes a second one terminate as before */
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = cancel_handler;
+    sa.sa_flags = SA_RESETHAND;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+
     return uploadstblogs_execute(argc, argv);
 }
 #endif /* UPLOADSTBLOGS_BUILD_BINARY */
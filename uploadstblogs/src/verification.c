@@ -103,6 +103,20 @@ bool is_terminal_failure(int http_code)
     return (http_code == 404);
 }
 
+/**
+ * @brief Check if HTTP status code indicates server-side throttling
+ *
+ * Throttled attempts are still retried, but no sooner than the server
+ * asked (Retry-After) or, without that header, at the backoff cap.
+ *
+ * @param http_code HTTP response code
+ * @return true for 429 and 503, false otherwise
+ */
+bool is_throttled_response(int http_code)
+{
+    return (http_code == 429 || http_code == 503);
+}
+
 /**
  * @brief Check if curl code indicates success
  * 
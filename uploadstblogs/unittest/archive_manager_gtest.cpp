@@ -20,9 +20,11 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <memory>
+#include <vector>
 #include <stdio.h>
 #include <time.h>
 #include <dlfcn.h>
+#include <zlib.h>
 
 #define GTEST_DEFAULT_RESULT_FILEPATH "/tmp/Gtest_Report/"
 #define GTEST_DEFAULT_RESULT_FILENAME "archive_manager_gtest_report.json"
@@ -52,9 +54,6 @@ struct dirent {
 
 // Mock system functions that archive_manager depends on
 extern "C" {
-// Forward declare gzFile type from zlib
-typedef struct gzFile_s *gzFile;
-
 // Mock functions for file operations
 FILE* fopen(const char* filename, const char* mode);
 int fclose(FILE* stream);
@@ -68,14 +67,16 @@ int system(const char* command);
 time_t time(time_t* tloc);
 struct tm* localtime(const time_t* timep);
 
-// Mock zlib functions
-gzFile gzopen(const char* path, const char* mode);
-int gzwrite(gzFile file, const void* buf, unsigned len);
-int gzclose(gzFile file);
+// zlib functions observed on the way to the real library
+int deflateInit2_(z_streamp strm, int level, int method, int windowBits,
+                  int memLevel, int strategy, const char* version, int stream_size);
+int deflateParams(z_streamp strm, int level, int strategy);
+bool build_gz_mode(char* buffer, size_t buffer_size, int level, int strategy);
 
 // Global mock variables
 static FILE* mock_file_ptr = (FILE*)0x12345678;
-static gzFile mock_gz_ptr = (gzFile)0xABCDEF01;
+static char g_last_gz_mode[8];             // gzopen()-style mode of the last gzip stream
+static std::string g_deflate_params_levels;   // One digit per deflateParams() call
 static struct stat mock_stat_buf;
 static DIR* mock_dir_ptr = (DIR*)0x87654321;
 static struct dirent mock_dirent_buf;
@@ -84,6 +85,7 @@ static struct tm mock_tm_buf = {0, 0, 14, 21, 0, 122, 5, 20, 0, 0, 0}; // 2022-0
 static int g_readdir_call_count = 0; // Global counter for readdir calls
 static int g_opendir_call_count = 0; // Global counter for opendir calls
 static int g_fread_call_count = 0; // Global counter for fread calls per file
+static void (*g_fread_hook)(FILE*) = nullptr; // Runs once before the next real fread
 
 // Helper function to detect if this is a test-related file we should mock
 // Mock implementations
@@ -117,7 +119,19 @@ int fclose(FILE* stream) {
 }
 
 size_t fread(void* ptr, size_t size, size_t nmemb, FILE* stream) {
-    if (stream != mock_file_ptr || !ptr) return 0;
+    if (!ptr) return 0;
+    if (stream != mock_file_ptr) {
+        // Real handles come from fdopen() on files the test created
+        if (g_fread_hook) {
+            void (*hook)(FILE*) = g_fread_hook;
+            g_fread_hook = nullptr;
+            hook(stream);
+        }
+        typedef size_t (*real_fread_t)(void*, size_t, size_t, FILE*);
+        static real_fread_t real_fread = nullptr;
+        if (!real_fread) real_fread = (real_fread_t)dlsym(RTLD_NEXT, "fread");
+        return (real_fread && stream) ? real_fread(ptr, size, nmemb, stream) : 0;
+    }
     
     g_fread_call_count++;
     if (g_fread_call_count > 1) {
@@ -227,22 +241,26 @@ struct tm* localtime(const time_t* timep) {
     return (timep && *timep == mock_time_value) ? &mock_tm_buf : nullptr;
 }
 
-// Mock zlib functions implementations
-gzFile gzopen(const char* path, const char* mode) {
-    if (!path || !mode || strstr(path, "fail")) return nullptr;
-    g_fread_call_count = 0; // Reset read counter for new archive
-    return mock_gz_ptr;
-}
-
-int gzwrite(gzFile file, const void* buf, unsigned len) {
-    if (file != mock_gz_ptr || !buf || len == 0) return 0;
-    return len; // Pretend we wrote everything
+// zlib wrappers: record the parameters, then compress for real
+int deflateInit2_(z_streamp strm, int level, int method, int windowBits,
+                  int memLevel, int strategy, const char* version, int stream_size) {
+    typedef int (*real_init_t)(z_streamp, int, int, int, int, int, const char*, int);
+    static real_init_t real_init = nullptr;
+    if (!real_init) real_init = (real_init_t)dlsym(RTLD_NEXT, "deflateInit2_");
+    // Only the single-stream gzip writer uses a gzip wrapper (15 + 16)
+    if (windowBits == 31) {
+        g_fread_call_count = 0; // Reset read counter for new archive
+        build_gz_mode(g_last_gz_mode, sizeof(g_last_gz_mode), level, strategy);
+    }
+    return real_init(strm, level, method, windowBits, memLevel, strategy, version, stream_size);
 }
 
-int gzclose(gzFile file) {
-    if (file != mock_gz_ptr) return -1;
-    g_fread_call_count = 0; // Reset on close
-    return 0; // Z_OK
+int deflateParams(z_streamp strm, int level, int strategy) {
+    typedef int (*real_params_t)(z_streamp, int, int);
+    static real_params_t real_params = nullptr;
+    if (!real_params) real_params = (real_params_t)dlsym(RTLD_NEXT, "deflateParams");
+    g_deflate_params_levels += (char)('0' + level);
+    return real_params(strm, level, strategy);
 }
 
 bool collect_logs_for_strategy(RuntimeContext* ctx, SessionState* session, const char* target_dir) {
@@ -275,6 +293,9 @@ int execute_strategy_workflow(RuntimeContext* ctx, SessionState* session) {
 // Include the actual archive_manager implementation
 #include "archive_manager.h"
 #include "../src/archive_manager.c"
+#include "../src/parallel_gzip.c"
+#include "../src/archive_codec.c"
+#include "../src/md5_utils.c"
 
 using namespace testing;
 using namespace std;
@@ -695,6 +716,783 @@ TEST_F(ArchiveManagerTest, CollectDriLogs_Success) {
     EXPECT_GE(result, 0);
 }
 
+// Test archive manifest functions
+TEST_F(ArchiveManagerTest, Manifest_AddAndFree) {
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+    EXPECT_EQ(manifest.count, 0u);
+
+    EXPECT_EQ(archive_manifest_add(&manifest, "/opt/logs/messages.txt", "11-25-25-02-30PM-messages.txt"), 0);
+    EXPECT_EQ(archive_manifest_add(&manifest, "/opt/logs/batch/a.log", "batch/a.log"), 0);
+    ASSERT_EQ(manifest.count, 2u);
+    EXPECT_STREQ(manifest.entries[0].src_path, "/opt/logs/messages.txt");
+    EXPECT_STREQ(manifest.entries[0].arcname, "11-25-25-02-30PM-messages.txt");
+
+    archive_manifest_free(&manifest);
+    EXPECT_EQ(manifest.count, 0u);
+    EXPECT_EQ(manifest.entries, nullptr);
+}
+
+TEST_F(ArchiveManagerTest, Manifest_AddDefaultsToWholeFile) {
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+    ASSERT_EQ(archive_manifest_add(&manifest, "/opt/logs/a.log", "a.log"), 0);
+    EXPECT_EQ(manifest.entries[0].offset, 0);
+    EXPECT_EQ(manifest.entries[0].length, -1);
+    archive_manifest_free(&manifest);
+}
+
+// add_file_to_tar() with a byte range passed by value
+static int AddRange(TarWriter* tar, const char* src, const char* arcname,
+                    off_t offset, off_t length, off_t omitted)
+{
+    return add_file_to_tar(tar, src, arcname, &offset, &length, omitted);
+}
+
+TEST_F(ArchiveManagerTest, AddFileToTar_ArchivesRequestedRange) {
+    const char* src = "/tmp/am_range_src.log";
+    const char* out = "/tmp/am_range_test.tgz";
+    int fd = open(src, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, "0123456789abcdef", 16), 16);
+    ::close(fd);
+
+    ArchiveWriter* writer = archive_writer_open(ARCHIVE_CODEC_GZIP, out, 6, Z_DEFAULT_STRATEGY, 2);
+    ASSERT_NE(writer, nullptr);
+    TarWriter tar = { writer };
+    EXPECT_EQ(AddRange(&tar, src, "range.log", 10, -1, 0), 0);
+    EXPECT_EQ(AddRange(&tar, src, "head.log", 0, 4, 0), 0);
+    // Offset past the end: the file was truncated, send it whole
+    off_t offset = 100;
+    off_t length = 5;
+    EXPECT_EQ(add_file_to_tar(&tar, src, "whole.log", &offset, &length, 0), 0);
+    EXPECT_EQ(offset, 0);
+    EXPECT_EQ(length, 16);
+    ASSERT_EQ(archive_writer_close(writer, NULL, 0, NULL, 0), 0);
+
+    char content[64] = {0};
+    FILE* pp = popen("gzip -dc /tmp/am_range_test.tgz | tar -xOf - range.log head.log whole.log", "r");
+    ASSERT_NE(pp, nullptr);
+    size_t n = ::fread(content, 1, sizeof(content) - 1, pp);
+    pclose(pp);
+    EXPECT_EQ(std::string(content, n), "abcdef0123" "0123456789abcdef");
+
+    unlink(src);
+    unlink(out);
+}
+
+// Changes made to the source file between its fstat() and its read
+#define AM_SNAP_SRC "/tmp/am_snapshot_src.log"
+#define AM_SNAP_OUT "/tmp/am_snapshot_test.tgz"
+
+static void TruncateSource(FILE* stream) {
+    ASSERT_EQ(truncate(AM_SNAP_SRC, 0), 0);
+}
+
+static void GrowSource(FILE* stream) {
+    int fd = open(AM_SNAP_SRC, O_WRONLY | O_APPEND);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, "appended", 8), 8);
+    ::close(fd);
+}
+
+static void RotateSource(FILE* stream) {
+    ASSERT_EQ(rename(AM_SNAP_SRC, AM_SNAP_SRC ".1"), 0);
+    int fd = open(AM_SNAP_SRC, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, "new file", 8), 8);
+    ::close(fd);
+}
+
+// Archive AM_SNAP_SRC with hook applied mid-way, return the extracted member
+static std::string ArchiveSnapshot(void (*hook)(FILE*), TarWriter* tar) {
+    int fd = open(AM_SNAP_SRC, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    EXPECT_GE(fd, 0);
+    EXPECT_EQ(write(fd, "0123456789abcdef", 16), 16);
+    ::close(fd);
+
+    memset(tar, 0, sizeof(*tar));
+    tar->out = archive_writer_open(ARCHIVE_CODEC_GZIP, AM_SNAP_OUT, 6, Z_DEFAULT_STRATEGY, 2);
+    EXPECT_NE(tar->out, nullptr);
+    g_fread_hook = hook;
+    EXPECT_EQ(AddRange(tar, AM_SNAP_SRC, "snap.log", 0, -1, 0), 0);
+    g_fread_hook = nullptr;
+    // A second member shows the stream is still aligned
+    EXPECT_EQ(AddRange(tar, AM_SNAP_SRC, "after.log", 0, 3, 0), 0);
+    EXPECT_EQ(archive_writer_close(tar->out, NULL, 0, NULL, 0), 0);
+
+    char content[64];
+    FILE* pp = popen("gzip -dc " AM_SNAP_OUT " | tar -xOf - snap.log after.log", "r");
+    EXPECT_NE(pp, nullptr);
+    size_t n = ::fread(content, 1, sizeof(content), pp);
+    pclose(pp);
+    unlink(AM_SNAP_SRC);
+    unlink(AM_SNAP_SRC ".1");
+    unlink(AM_SNAP_OUT);
+    return std::string(content, n);
+}
+
+TEST_F(ArchiveManagerTest, AddFileToTar_TruncatedFileZeroFilled) {
+    TarWriter tar;
+    std::string content = ArchiveSnapshot(TruncateSource, &tar);
+    EXPECT_EQ(content, std::string(16, '\0'));
+    EXPECT_EQ(tar.shrank, 1);
+    EXPECT_EQ(tar.padded_bytes, 16);
+}
+
+TEST_F(ArchiveManagerTest, AddFileToTar_GrowingFileStopsAtSnapshot) {
+    TarWriter tar;
+    std::string content = ArchiveSnapshot(GrowSource, &tar);
+    EXPECT_EQ(content, "0123456789abcdef" "012");
+    EXPECT_GE(tar.grew, 1);
+    EXPECT_EQ(tar.shrank, 0);
+}
+
+TEST_F(ArchiveManagerTest, AddFileToTar_RotatedFileReadFromOpenFd) {
+    TarWriter tar;
+    std::string content = ArchiveSnapshot(RotateSource, &tar);
+    EXPECT_EQ(content, "0123456789abcdef" "new");
+    EXPECT_EQ(tar.rotated, 1);
+}
+
+// system() is mocked above; run real shell commands through popen()
+static int RunShell(const char* cmd) {
+    FILE* pp = popen(cmd, "r");
+    if (!pp) return -1;
+    char buf[256];
+    while (::fread(buf, 1, sizeof(buf), pp) > 0) {
+    }
+    return pclose(pp);
+}
+
+// Write size bytes of fill to path
+static void WriteSizedFile(const char* path, size_t size, char fill) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    std::string data(size, fill);
+    ASSERT_EQ(write(fd, data.data(), size), (ssize_t)size);
+    ::close(fd);
+}
+
+TEST_F(ArchiveManagerTest, Limits_DefaultsFollowEndpoint) {
+    long long budget = 0;
+    long long file_cap = 0;
+
+    get_archive_limits(&ctx, &budget, &file_cap);
+    EXPECT_EQ(budget, (long long)ARCHIVE_BUDGET_DIRECT_MB * 1024 * 1024);
+    EXPECT_EQ(file_cap, (long long)ARCHIVE_FILE_CAP_MB * 1024 * 1024);
+
+    ctx.direct_blocked = true;
+    get_archive_limits(&ctx, &budget, &file_cap);
+    EXPECT_EQ(budget, (long long)ARCHIVE_BUDGET_CODEBIG_MB * 1024 * 1024);
+
+    ctx.archive_budget_mb = 10;
+    ctx.archive_file_cap_mb = ARCHIVE_LIMIT_NONE;
+    get_archive_limits(&ctx, &budget, &file_cap);
+    EXPECT_EQ(budget, 10LL * 1024 * 1024);
+    EXPECT_EQ(file_cap, -1);
+}
+
+TEST_F(ArchiveManagerTest, Limits_FileCapKeepsTail) {
+    mkdir("/tmp/am_limits_test", 0755);
+    WriteSizedFile("/tmp/am_limits_test/big.log", 200 * 1024, 'x');
+
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+    archive_manifest_add(&manifest, "/tmp/am_limits_test/big.log", "big.log");
+
+    EXPECT_EQ(archive_manifest_apply_limits(&manifest, -1, 64 * 1024), 1);
+    EXPECT_EQ(manifest.entries[0].offset, 136 * 1024);
+    EXPECT_EQ(manifest.entries[0].length, 64 * 1024);
+    EXPECT_EQ(manifest.entries[0].omitted, 136 * 1024);
+
+    archive_manifest_free(&manifest);
+    RunShell("rm -rf /tmp/am_limits_test");
+}
+
+TEST_F(ArchiveManagerTest, Limits_FileCapKeepHeadReportsArchivedRange) {
+    EXPECT_CALL(*g_mockFileOperations, dir_exists(_))
+        .WillRepeatedly(Return(true));
+    mkdir("/tmp/am_limits_test", 0755);
+    WriteSizedFile("/tmp/am_limits_test/big.log", 3 * 1024 * 1024, 'x');
+    WriteSizedFile("/tmp/am_limits_test/gone.log", 1024, 'g');
+
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+    manifest.keep_head = true;
+    archive_manifest_add(&manifest, "/tmp/am_limits_test/big.log", "big.log");
+    archive_manifest_add(&manifest, "/tmp/am_limits_test/gone.log", "gone.log");
+    manifest.entries[0].offset = 1024;
+    unlink("/tmp/am_limits_test/gone.log");
+    ctx.archive_file_cap_mb = 1;
+
+    ASSERT_EQ(create_archive_from_manifest(&ctx, &session, &manifest, "/tmp/am_limits_test"), 0);
+    // Incremental: the first MB after the watermark went, the rest waits
+    EXPECT_EQ(manifest.entries[0].offset, 1024);
+    EXPECT_EQ(manifest.entries[0].length, 1024 * 1024);
+    EXPECT_EQ(manifest.entries[0].omitted, 0);
+    EXPECT_EQ(manifest.entries[1].length, 0);
+
+    archive_manifest_free(&manifest);
+    RunShell("rm -rf /tmp/am_limits_test");
+}
+
+TEST_F(ArchiveManagerTest, Limits_BudgetKeepsByPriority) {
+    mkdir("/tmp/am_limits_test", 0755);
+    WriteSizedFile("/tmp/am_limits_test/app.log.1", 100 * 1024, 'r');
+    WriteSizedFile("/tmp/am_limits_test/messages.log", 100 * 1024, 'm');
+    WriteSizedFile("/tmp/am_limits_test/notes.dat", 100 * 1024, 'n');
+    WriteSizedFile("/tmp/am_limits_test/app_crash.dmp", 100 * 1024, 'c');
+
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+    archive_manifest_add(&manifest, "/tmp/am_limits_test/app.log.1", "app.log.1");
+    archive_manifest_add(&manifest, "/tmp/am_limits_test/messages.log", "messages.log");
+    archive_manifest_add(&manifest, "/tmp/am_limits_test/notes.dat", "notes.dat");
+    archive_manifest_add(&manifest, "/tmp/am_limits_test/app_crash.dmp", "app_crash.dmp");
+
+    // Room for two files and part of a third
+    EXPECT_EQ(archive_manifest_apply_limits(&manifest, 300 * 1024, -1), 2);
+    ASSERT_EQ(manifest.count, 4u);
+    EXPECT_STREQ(manifest.entries[0].arcname, "app_crash.dmp");
+    EXPECT_STREQ(manifest.entries[1].arcname, "messages.log");
+    EXPECT_STREQ(manifest.entries[2].arcname, "notes.dat");
+    EXPECT_STREQ(manifest.entries[3].arcname, "app.log.1");
+    EXPECT_EQ(manifest.entries[0].length, 100 * 1024);
+    EXPECT_EQ(manifest.entries[1].length, 100 * 1024);
+    EXPECT_GT(manifest.entries[2].length, 0);
+    EXPECT_LT(manifest.entries[2].length, 100 * 1024);
+    EXPECT_EQ(manifest.entries[2].offset, manifest.entries[2].omitted);
+    EXPECT_EQ(manifest.entries[3].length, 0);
+
+    archive_manifest_free(&manifest);
+    RunShell("rm -rf /tmp/am_limits_test");
+}
+
+TEST_F(ArchiveManagerTest, Limits_UnderBudgetKeepsOrder) {
+    mkdir("/tmp/am_limits_test", 0755);
+    WriteSizedFile("/tmp/am_limits_test/app.log.1", 1024, 'r');
+    WriteSizedFile("/tmp/am_limits_test/core.1234", 1024, 'c');
+
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+    archive_manifest_add(&manifest, "/tmp/am_limits_test/app.log.1", "app.log.1");
+    archive_manifest_add(&manifest, "/tmp/am_limits_test/core.1234", "core.1234");
+
+    EXPECT_EQ(archive_manifest_apply_limits(&manifest, 1024 * 1024, 1024 * 1024), 0);
+    EXPECT_STREQ(manifest.entries[0].arcname, "app.log.1");
+    EXPECT_EQ(manifest.entries[0].length, 1024);
+    EXPECT_EQ(manifest.entries[0].omitted, 0);
+
+    archive_manifest_free(&manifest);
+    RunShell("rm -rf /tmp/am_limits_test");
+}
+
+TEST_F(ArchiveManagerTest, AddFileToTar_OmittedBytesMarked) {
+    const char* src = "/tmp/am_marker_src.log";
+    const char* out = "/tmp/am_marker_test.tgz";
+    int fd = open(src, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, "0123456789tail\n", 15), 15);
+    ::close(fd);
+
+    ArchiveWriter* writer = archive_writer_open(ARCHIVE_CODEC_GZIP, out, 6, Z_DEFAULT_STRATEGY, 2);
+    ASSERT_NE(writer, nullptr);
+    TarWriter tar = { writer };
+    EXPECT_EQ(AddRange(&tar, src, "marked.log", 10, 5, 10), 0);
+    ASSERT_EQ(archive_writer_close(writer, NULL, 0, NULL, 0), 0);
+
+    char content[512] = {0};
+    FILE* pp = popen("gzip -dc /tmp/am_marker_test.tgz | tar -xOf - marked.log", "r");
+    ASSERT_NE(pp, nullptr);
+    size_t n = ::fread(content, 1, sizeof(content) - 1, pp);
+    pclose(pp);
+    std::string member(content, n);
+    EXPECT_EQ(member.find("[uploadstblogs] 10 bytes omitted from the start of /tmp/am_marker_src.log"), 0u);
+    EXPECT_EQ(member.substr(member.size() - 5), "tail\n");
+
+    unlink(src);
+    unlink(out);
+}
+
+TEST_F(ArchiveManagerTest, AddFileToTar_OmittedBytesNotedBesideBinary) {
+    const char* src = "/tmp/am_marker_src.pcap";
+    const char* out = "/tmp/am_marker_test.tgz";
+    const char data[] = "0123456789\0\1\2\3\4";
+    int fd = open(src, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, data, 15), 15);
+    ::close(fd);
+
+    ArchiveWriter* writer = archive_writer_open(ARCHIVE_CODEC_GZIP, out, 6, Z_DEFAULT_STRATEGY, 2);
+    ASSERT_NE(writer, nullptr);
+    TarWriter tar = { writer };
+    EXPECT_EQ(AddRange(&tar, src, "capture.pcap", 10, 5, 10), 0);
+    ASSERT_EQ(archive_writer_close(writer, NULL, 0, NULL, 0), 0);
+
+    // The member holds only the file's bytes
+    char content[512] = {0};
+    FILE* pp = popen("gzip -dc /tmp/am_marker_test.tgz | tar -xOf - capture.pcap", "r");
+    ASSERT_NE(pp, nullptr);
+    size_t n = ::fread(content, 1, sizeof(content) - 1, pp);
+    pclose(pp);
+    EXPECT_EQ(std::string(content, n), std::string(data + 10, 5));
+
+    pp = popen("gzip -dc /tmp/am_marker_test.tgz | tar -xOf - capture.pcap.truncated", "r");
+    ASSERT_NE(pp, nullptr);
+    n = ::fread(content, 1, sizeof(content) - 1, pp);
+    pclose(pp);
+    EXPECT_EQ(std::string(content, n).find("[uploadstblogs] 10 bytes omitted from the start of /tmp/am_marker_src.pcap"), 0u);
+
+    unlink(src);
+    unlink(out);
+}
+
+TEST_F(ArchiveManagerTest, Manifest_InvalidParameters) {
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+
+    EXPECT_EQ(archive_manifest_add(nullptr, "/opt/logs/a.log", "a.log"), -1);
+    EXPECT_EQ(archive_manifest_add(&manifest, nullptr, "a.log"), -1);
+    EXPECT_EQ(archive_manifest_add(&manifest, "/opt/logs/a.log", ""), -1);
+    EXPECT_EQ(archive_manifest_add_dir(&manifest, nullptr, "batch"), -1);
+    EXPECT_EQ(manifest.count, 0u);
+}
+
+TEST_F(ArchiveManagerTest, Manifest_HasDir) {
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+    archive_manifest_add(&manifest, "/opt/logs/batch1/a.log", "batch1/a.log");
+
+    EXPECT_TRUE(archive_manifest_has_dir(&manifest, "batch1"));
+    EXPECT_FALSE(archive_manifest_has_dir(&manifest, "batch"));
+    EXPECT_FALSE(archive_manifest_has_dir(&manifest, "a.log"));
+
+    archive_manifest_free(&manifest);
+}
+
+TEST_F(ArchiveManagerTest, CollectPcapToManifest_NotEnabled) {
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+    ctx.include_pcap = false;
+
+    EXPECT_EQ(collect_pcap_to_manifest(nullptr, &manifest), -1);
+    EXPECT_EQ(collect_pcap_to_manifest(&ctx, &manifest), 0);
+    EXPECT_EQ(manifest.count, 0u);
+}
+
+TEST_F(ArchiveManagerTest, CreateArchiveFromManifest_NullParams) {
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+
+    EXPECT_EQ(create_archive_from_manifest(nullptr, &session, &manifest, "/tmp"), -1);
+    EXPECT_EQ(create_archive_from_manifest(&ctx, nullptr, &manifest, "/tmp"), -1);
+    EXPECT_EQ(create_archive_from_manifest(&ctx, &session, nullptr, "/tmp"), -1);
+    EXPECT_EQ(create_archive_from_manifest(&ctx, &session, &manifest, nullptr), -1);
+}
+
+TEST_F(ArchiveManagerTest, CreateArchiveFromManifest_OutputDirMissing) {
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+
+    EXPECT_CALL(*g_mockFileOperations, dir_exists(_))
+        .WillOnce(Return(false));
+
+    EXPECT_EQ(create_archive_from_manifest(&ctx, &session, &manifest, "/tmp/dcm"), -1);
+}
+
+// Test archive member name rules
+TEST_F(ArchiveManagerTest, NameRule_InitUsesScriptTimestamp) {
+    ArchiveNameRule rule;
+    time_t ref = 1764081000; // 2025-11-25 14:30:00 UTC
+
+    EXPECT_TRUE(archive_name_rule_init(&rule, ref));
+    EXPECT_STREQ(rule.prefix, "11-25-25-02-30PM-");
+    EXPECT_TRUE(rule.skip_backups);
+    EXPECT_FALSE(rule.skip_stamped);
+    EXPECT_FALSE(archive_name_rule_init(nullptr, ref));
+}
+
+TEST_F(ArchiveManagerTest, NameRule_PrefixesTopLevelNames) {
+    ArchiveNameRule rule;
+    archive_name_rule_init(&rule, 1764081000);
+    char name[MAX_FILENAME_LENGTH];
+
+    EXPECT_TRUE(archive_name_rule_apply(&rule, "messages.txt", name, sizeof(name)));
+    EXPECT_STREQ(name, "11-25-25-02-30PM-messages.txt");
+
+    // Hidden, backup and already-prefixed names are kept
+    EXPECT_TRUE(archive_name_rule_apply(&rule, ".hidden", name, sizeof(name)));
+    EXPECT_STREQ(name, ".hidden");
+    EXPECT_TRUE(archive_name_rule_apply(&rule, "bak1_messages.txt", name, sizeof(name)));
+    EXPECT_STREQ(name, "bak1_messages.txt");
+    EXPECT_TRUE(archive_name_rule_apply(&rule, "11-25-25-02-30PM-core.log", name, sizeof(name)));
+    EXPECT_STREQ(name, "11-25-25-02-30PM-core.log");
+
+    // NULL rule keeps names unchanged
+    EXPECT_TRUE(archive_name_rule_apply(nullptr, "messages.txt", name, sizeof(name)));
+    EXPECT_STREQ(name, "messages.txt");
+}
+
+TEST_F(ArchiveManagerTest, NameRule_UploadLogsNowSkips) {
+    static const char* const keep_names[] = {"reboot.log", "ABLReason.txt", NULL};
+    ArchiveNameRule rule;
+    archive_name_rule_init(&rule, 1764081000);
+    rule.skip_backups = false;
+    rule.skip_stamped = true;
+    rule.keep_names = keep_names;
+    char name[MAX_FILENAME_LENGTH];
+
+    EXPECT_TRUE(archive_name_rule_apply(&rule, "reboot.log", name, sizeof(name)));
+    EXPECT_STREQ(name, "reboot.log");
+    EXPECT_TRUE(archive_name_rule_apply(&rule, "ABLReason.txt", name, sizeof(name)));
+    EXPECT_STREQ(name, "ABLReason.txt");
+    EXPECT_TRUE(archive_name_rule_apply(&rule, "ui-11-24-25-09-15AM-log.txt", name, sizeof(name)));
+    EXPECT_STREQ(name, "ui-11-24-25-09-15AM-log.txt");
+    EXPECT_TRUE(archive_name_rule_apply(&rule, "bak1_messages.txt", name, sizeof(name)));
+    EXPECT_STREQ(name, "11-25-25-02-30PM-bak1_messages.txt");
+}
+
+TEST_F(ArchiveManagerTest, NameRule_Truncation) {
+    ArchiveNameRule rule;
+    archive_name_rule_init(&rule, 1764081000);
+    char name[8];
+
+    EXPECT_FALSE(archive_name_rule_apply(&rule, "messages.txt", name, sizeof(name)));
+    EXPECT_FALSE(archive_name_rule_apply(&rule, nullptr, name, sizeof(name)));
+}
+
+// Test compression settings
+TEST_F(ArchiveManagerTest, Compression_ParamsPerTrigger) {
+    int level = 0;
+    int strategy = -1;
+
+    // Unconfigured context keeps the historical level 9
+    get_compression_params(&ctx, &level, &strategy);
+    EXPECT_EQ(level, 9);
+    EXPECT_EQ(strategy, Z_DEFAULT_STRATEGY);
+
+    ctx.compression_level[TRIGGER_SCHEDULED] = 4;
+    ctx.compression_strategy[TRIGGER_SCHEDULED] = Z_FILTERED;
+    ctx.compression_level[TRIGGER_ONDEMAND] = COMPRESSION_LEVEL_AUTO;
+
+    ctx.trigger_type = TRIGGER_SCHEDULED;
+    get_compression_params(&ctx, &level, &strategy);
+    EXPECT_EQ(level, 4);
+    EXPECT_EQ(strategy, Z_FILTERED);
+
+    ctx.trigger_type = TRIGGER_ONDEMAND;
+    get_compression_params(&ctx, &level, &strategy);
+    EXPECT_EQ(level, COMPRESSION_LEVEL_AUTO);
+
+    ctx.trigger_type = 42;
+    get_compression_params(&ctx, &level, &strategy);
+    EXPECT_EQ(level, 9);
+}
+
+TEST_F(ArchiveManagerTest, Compression_BuildGzMode) {
+    char mode[8];
+
+    EXPECT_TRUE(build_gz_mode(mode, sizeof(mode), 9, Z_DEFAULT_STRATEGY));
+    EXPECT_STREQ(mode, "wb9");
+    EXPECT_TRUE(build_gz_mode(mode, sizeof(mode), 1, Z_RLE));
+    EXPECT_STREQ(mode, "wb1R");
+    EXPECT_TRUE(build_gz_mode(mode, sizeof(mode), 6, Z_FILTERED));
+    EXPECT_STREQ(mode, "wb6f");
+    EXPECT_FALSE(build_gz_mode(mode, sizeof(mode), 10, Z_DEFAULT_STRATEGY));
+    EXPECT_FALSE(build_gz_mode(mode, 3, 6, Z_DEFAULT_STRATEGY));
+}
+
+TEST_F(ArchiveManagerTest, Compression_AutoSelectsCheapestLevel) {
+    std::vector<unsigned char> sample(64 * 1024);
+
+    // Repetitive log text meets the target at level 1
+    const char* line = "2025 Nov 25 14:30:00 device[123]: heartbeat ok\n";
+    for (size_t i = 0; i < sample.size(); i++) {
+        sample[i] = line[i % strlen(line)];
+    }
+    EXPECT_EQ(select_compression_level(sample.data(), sample.size(), Z_DEFAULT_STRATEGY, 20), 1);
+
+    // Random data misses the target at both levels and stays cheap
+    srand(1);
+    for (size_t i = 0; i < sample.size(); i++) {
+        sample[i] = (unsigned char)(rand() & 0xff);
+    }
+    EXPECT_EQ(select_compression_level(sample.data(), sample.size(), Z_DEFAULT_STRATEGY, 20), 1);
+
+    EXPECT_EQ(select_compression_level(nullptr, 0, Z_DEFAULT_STRATEGY, 20), 6);
+}
+
+TEST_F(ArchiveManagerTest, Compression_ArchiveUsesTriggerMode) {
+    EXPECT_CALL(*g_mockFileOperations, dir_exists(_))
+        .WillRepeatedly(Return(true));
+
+    // The archive itself may fail in the mocked filesystem; the mode
+    // the gzip stream was opened with is what matters here
+    create_archive(&ctx, &session, "/tmp/test");
+    EXPECT_STREQ(g_last_gz_mode, "wb9");
+
+    ctx.trigger_type = TRIGGER_REBOOT;
+    ctx.compression_level[TRIGGER_REBOOT] = 1;
+    ctx.compression_strategy[TRIGGER_REBOOT] = Z_RLE;
+    create_archive(&ctx, &session, "/tmp/test");
+    EXPECT_STREQ(g_last_gz_mode, "wb1R");
+
+    // Auto mode resolves to a concrete level before the archive is opened
+    ctx.compression_level[TRIGGER_REBOOT] = COMPRESSION_LEVEL_AUTO;
+    ctx.compression_strategy[TRIGGER_REBOOT] = Z_DEFAULT_STRATEGY;
+    create_archive(&ctx, &session, "/tmp/test");
+    EXPECT_TRUE(strcmp(g_last_gz_mode, "wb1") == 0 || strcmp(g_last_gz_mode, "wb6") == 0);
+}
+
+TEST_F(ArchiveManagerTest, Compression_ParallelWriterAndFallback) {
+    EXPECT_CALL(*g_mockFileOperations, dir_exists(_))
+        .WillRepeatedly(Return(true));
+    ctx.compression_threads = 4;
+
+    // Unwritable output: parallel writer cannot open, zlib path is used
+    g_last_gz_mode[0] = '\0';
+    create_archive(&ctx, &session, "/nonexistent_pgz_dir");
+    EXPECT_STREQ(g_last_gz_mode, "wb9");
+
+    // Writable output: archive is produced without the single-stream writer
+    mkdir("/tmp/am_pgz_test", 0755);
+    g_last_gz_mode[0] = '\0';
+    EXPECT_EQ(create_archive(&ctx, &session, "/tmp/am_pgz_test"), 0);
+    EXPECT_STREQ(g_last_gz_mode, "");
+
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "/tmp/am_pgz_test/%s", session.archive_file);
+    struct stat st;
+    EXPECT_EQ(lstat(path, &st), 0);
+    unlink(path);
+    rmdir("/tmp/am_pgz_test");
+}
+
+TEST_F(ArchiveManagerTest, Codec_ParseAndExtension) {
+    ArchiveCodec codec = ARCHIVE_CODEC_GZIP;
+    EXPECT_TRUE(archive_codec_parse("ZSTD", &codec));
+    EXPECT_EQ(codec, ARCHIVE_CODEC_ZSTD);
+    EXPECT_TRUE(archive_codec_parse("lz4", &codec));
+    EXPECT_EQ(codec, ARCHIVE_CODEC_LZ4);
+    EXPECT_FALSE(archive_codec_parse("bzip2", &codec));
+    EXPECT_FALSE(archive_codec_parse(NULL, &codec));
+
+    EXPECT_STREQ(archive_codec_extension(ARCHIVE_CODEC_GZIP), ".tgz");
+    EXPECT_STREQ(archive_codec_extension(ARCHIVE_CODEC_ZSTD), ".tar.zst");
+    EXPECT_STREQ(archive_codec_extension(ARCHIVE_CODEC_LZ4), ".tar.lz4");
+    EXPECT_TRUE(archive_codec_available(ARCHIVE_CODEC_GZIP));
+
+    EXPECT_TRUE(archive_codec_is_archive_name("AA_Logs_01-01-25-10-00AM.tar.zst"));
+    EXPECT_TRUE(archive_codec_is_archive_name("AA_Logs_01-01-25-10-00AM.tgz"));
+    EXPECT_FALSE(archive_codec_is_archive_name("messages.txt"));
+    EXPECT_FALSE(archive_codec_is_archive_name(".tgz"));
+}
+
+TEST_F(ArchiveManagerTest, Codec_ArchiveNameFollowsCodec) {
+    EXPECT_CALL(*g_mockFileOperations, dir_exists(_))
+        .WillRepeatedly(Return(true));
+    mkdir("/tmp/am_codec_test", 0755);
+    ctx.compression_threads = 2;
+    ctx.archive_codec = ARCHIVE_CODEC_ZSTD;
+
+    EXPECT_EQ(create_archive(&ctx, &session, "/tmp/am_codec_test"), 0);
+    const char* ext = archive_codec_available(ARCHIVE_CODEC_ZSTD) ? ".tar.zst" : ".tgz";
+    size_t len = strlen(session.archive_file);
+    ASSERT_GT(len, strlen(ext));
+    EXPECT_STREQ(session.archive_file + len - strlen(ext), ext);
+
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "/tmp/am_codec_test/%s", session.archive_file);
+    unlink(path);
+    rmdir("/tmp/am_codec_test");
+}
+
+TEST_F(ArchiveManagerTest, Stored_DetectsPrecompressedContent) {
+    EXPECT_TRUE(is_precompressed_name("/opt/logs/old.tgz"));
+    EXPECT_TRUE(is_precompressed_name("/opt/logs/capture.PCAP.GZ"));
+    EXPECT_FALSE(is_precompressed_name("/opt/logs/messages.txt"));
+    EXPECT_FALSE(is_precompressed_name("gz"));
+
+    unsigned char noise[8192];
+    unsigned int seed = 3;
+    for (size_t i = 0; i < sizeof(noise); i++) {
+        seed = seed * 1103515245u + 12345u;
+        noise[i] = (unsigned char)(seed >> 16);
+    }
+    EXPECT_TRUE(looks_incompressible(noise, sizeof(noise)));
+
+    std::string text;
+    while (text.size() < sizeof(noise)) {
+        text += "2025 Nov 25 14:02:11 device[1234]: event 42 ok\n";
+    }
+    EXPECT_FALSE(looks_incompressible((const unsigned char*)text.data(), text.size()));
+    EXPECT_FALSE(looks_incompressible(noise, 0));
+}
+
+TEST_F(ArchiveManagerTest, Stored_GzipLevelSwitchedAroundMember) {
+    const char* src = "/tmp/am_stored_src.gz";
+    WriteSizedFile(src, 64 * 1024, 'z');
+
+    g_deflate_params_levels.clear();
+    ArchiveWriter* writer = archive_writer_open(ARCHIVE_CODEC_GZIP, "/tmp/am_stored.tgz", 6, Z_DEFAULT_STRATEGY, 0);
+    ASSERT_NE(writer, nullptr);
+    TarWriter tar = { writer };
+    EXPECT_EQ(AddRange(&tar, src, "old.gz", 0, -1, 0), 0);
+    EXPECT_EQ(g_deflate_params_levels, "06");
+    EXPECT_EQ(tar.stored_members, 1);
+    EXPECT_EQ(archive_writer_stored_bytes(writer), 64 * 1024);
+
+    // Small members are not worth a level switch
+    WriteSizedFile(src, 1024, 'z');
+    EXPECT_EQ(AddRange(&tar, src, "small.gz", 0, -1, 0), 0);
+    EXPECT_EQ(g_deflate_params_levels, "06");
+    EXPECT_EQ(archive_writer_close(writer, NULL, 0, NULL, 0), 0);
+
+    // Level switches stay inside one valid gzip stream
+    EXPECT_EQ(RunShell("gzip -t /tmp/am_stored.tgz"), 0);
+    unlink("/tmp/am_stored.tgz");
+    unlink(src);
+}
+
+TEST_F(ArchiveManagerTest, Stored_ParallelArchiveExtracts) {
+    EXPECT_CALL(*g_mockFileOperations, dir_exists(_))
+        .WillRepeatedly(Return(true));
+    mkdir("/tmp/am_stored_test", 0755);
+    mkdir("/tmp/am_stored_test/src", 0755);
+    std::string noise(200 * 1024, '\0');
+    unsigned int seed = 5;
+    for (size_t i = 0; i < noise.size(); i++) {
+        seed = seed * 1103515245u + 12345u;
+        noise[i] = (char)(seed >> 16);
+    }
+    int fd = open("/tmp/am_stored_test/src/core.bin", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, noise.data(), noise.size()), (ssize_t)noise.size());
+    ::close(fd);
+    WriteSizedFile("/tmp/am_stored_test/src/messages.txt", 64 * 1024, 'm');
+
+    ArchiveManifest manifest;
+    archive_manifest_init(&manifest);
+    archive_manifest_add(&manifest, "/tmp/am_stored_test/src/core.bin", "core.bin");
+    archive_manifest_add(&manifest, "/tmp/am_stored_test/src/messages.txt", "messages.txt");
+    ctx.compression_threads = 2;
+    ASSERT_EQ(create_archive_from_manifest(&ctx, &session, &manifest, "/tmp/am_stored_test"), 0);
+    archive_manifest_free(&manifest);
+
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "gzip -dc /tmp/am_stored_test/%s | tar -xOf - core.bin | cmp -s - "
+             "/tmp/am_stored_test/src/core.bin", session.archive_file);
+    EXPECT_EQ(RunShell(cmd), 0);
+    RunShell("rm -rf /tmp/am_stored_test");
+}
+
+TEST_F(ArchiveManagerTest, Digest_RecordedWhileWriting) {
+    EXPECT_CALL(*g_mockFileOperations, dir_exists(_))
+        .WillRepeatedly(Return(true));
+    mkdir("/tmp/am_digest_test", 0755);
+
+    // Parallel blocks and the single gzip stream
+    for (int threads : { 2, 1 }) {
+        SCOPED_TRACE(threads);
+        ctx.compression_threads = threads;
+        strcpy(session.archive_md5, "stale");
+
+        ASSERT_EQ(create_archive(&ctx, &session, "/tmp/am_digest_test"), 0);
+        EXPECT_EQ(strlen(session.archive_md5), 24u);
+        EXPECT_EQ(strlen(session.archive_sha256), 64u);
+
+        // Same values as hashing the finished file
+        char path[MAX_PATH_LENGTH];
+        snprintf(path, sizeof(path), "/tmp/am_digest_test/%s", session.archive_file);
+        int fd = open(path, O_RDONLY);
+        ASSERT_GE(fd, 0);
+        StreamDigest* digest = stream_digest_new();
+        unsigned char buf[4096];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) {
+            stream_digest_update(digest, buf, (size_t)n);
+        }
+        ::close(fd);
+        char md5[32];
+        char sha256[65];
+        ASSERT_TRUE(stream_digest_final(digest, md5, sizeof(md5), sha256, sizeof(sha256)));
+        stream_digest_free(digest);
+        EXPECT_STREQ(session.archive_md5, md5);
+        EXPECT_STREQ(session.archive_sha256, sha256);
+
+        unlink(path);
+    }
+    rmdir("/tmp/am_digest_test");
+}
+
+TEST_F(ArchiveManagerTest, Codec_FailedWriteFailsStream) {
+    ArchiveWriter* writer = archive_writer_open(ARCHIVE_CODEC_GZIP, "/dev/full", 6, Z_DEFAULT_STRATEGY, 1);
+    ASSERT_NE(writer, nullptr);
+
+    // Incompressible data forces output to the full device
+    std::vector<unsigned char> noise(256 * 1024);
+    unsigned int seed = 7;
+    for (size_t i = 0; i < noise.size(); i++) {
+        seed = seed * 1103515245u + 12345u;
+        noise[i] = (unsigned char)(seed >> 16);
+    }
+    EXPECT_EQ(archive_writer_write(writer, noise.data(), noise.size()), -1);
+
+    // Nothing later can make the stream whole again
+    char block[TAR_BLOCK_SIZE] = {0};
+    EXPECT_EQ(archive_writer_write(writer, block, sizeof(block)), -1);
+    EXPECT_EQ(archive_writer_set_stored(writer, true), -1);
+    char md5[32] = "stale";
+    EXPECT_EQ(archive_writer_close(writer, md5, sizeof(md5), NULL, 0), -1);
+    EXPECT_STREQ(md5, "");
+}
+
+TEST_F(ArchiveManagerTest, Digest_ClearedWhenArchiveFails) {
+    strcpy(session.archive_md5, "stale");
+    strcpy(session.archive_sha256, "stale");
+    EXPECT_CALL(*g_mockFileOperations, dir_exists(_))
+        .WillRepeatedly(Return(false));
+
+    EXPECT_EQ(create_archive(&ctx, &session, "/nonexistent_digest_dir"), -1);
+    EXPECT_STREQ(session.archive_md5, "");
+    EXPECT_STREQ(session.archive_sha256, "");
+}
+
+#if defined(HAVE_ZSTD) || defined(HAVE_LZ4)
+TEST_F(ArchiveManagerTest, Codec_WriterProducesFrameMagic) {
+    static const struct {
+        ArchiveCodec codec;
+        unsigned char magic[4];
+    } cases[] = {
+        { ARCHIVE_CODEC_ZSTD, { 0x28, 0xB5, 0x2F, 0xFD } },
+        { ARCHIVE_CODEC_LZ4,  { 0x04, 0x22, 0x4D, 0x18 } },
+    };
+    std::vector<char> data(200 * 1024, 'x');
+    for (const auto& c : cases) {
+        if (!archive_codec_available(c.codec)) {
+            continue;
+        }
+        const char* path = "/tmp/am_codec_magic.bin";
+        ArchiveWriter* writer = archive_writer_open(c.codec, path, 3, 0, 1);
+        ASSERT_NE(writer, nullptr);
+        EXPECT_EQ(archive_writer_write(writer, data.data(), data.size()), 0);
+        EXPECT_EQ(archive_writer_bytes_in(writer), (long)data.size());
+        char sha256[65];
+        EXPECT_EQ(archive_writer_close(writer, NULL, 0, sha256, sizeof(sha256)), 0);
+        EXPECT_EQ(strlen(sha256), 64u);
+
+        int fd = open(path, O_RDONLY);
+        ASSERT_GE(fd, 0);
+        unsigned char head[4] = {0};
+        EXPECT_EQ(read(fd, head, sizeof(head)), 4);
+        ::close(fd);
+        EXPECT_EQ(memcmp(head, c.magic, sizeof(head)), 0) << archive_codec_name(c.codec);
+        unlink(path);
+    }
+}
+#endif
+
 GTEST_API_ int main(int argc, char *argv[]){
     char testresults_fullfilepath[GTEST_REPORT_FILEPATH_SIZE];
     char buffer[GTEST_REPORT_FILEPATH_SIZE];
@@ -54,6 +54,7 @@ using ::testing::SetArgPointee;
 using ::testing::SetArrayArgument;
 using ::testing::DoAll;
 using ::testing::StrEq;
+using ::testing::StartsWith;
 using ::testing::Invoke;
 
 class ContextManagerTest : public ::testing::Test {
@@ -162,6 +163,12 @@ TEST_F(ContextManagerTest, LoadEnvironment_Success) {
     EXPECT_CALL(*g_mockRdkUtils, getDevicePropertyData(StrEq("PROXY_BUCKET"), _, _))
         .WillOnce(Return(UTILS_FAIL));
     
+    EXPECT_CALL(*g_mockRdkUtils, getIncludePropertyData(StartsWith("LOG_COMPRESSION"), _, _))
+        .WillRepeatedly(Return(UTILS_FAIL));
+    
+    EXPECT_CALL(*g_mockRdkUtils, getIncludePropertyData(StartsWith("LOG_UPLOAD_"), _, _))
+        .WillRepeatedly(Return(UTILS_FAIL));
+    
     EXPECT_CALL(*g_mockRdkUtils, getDevicePropertyData(StrEq("DEVICE_TYPE"), _, _))
         .WillOnce(DoAll(SetArrayArgument<1>("mediaclient", "mediaclient" + 11),
                        Return(UTILS_SUCCESS)));
@@ -204,8 +211,59 @@ TEST_F(ContextManagerTest, LoadEnvironment_DefaultValues) {
     EXPECT_STREQ(ctx.prev_log_path, "/opt/logs/PreviousLogs");
     EXPECT_EQ(ctx.direct_retry_delay, 86400);
     EXPECT_EQ(ctx.codebig_retry_delay, 1800);
-    EXPECT_EQ(ctx.direct_max_attempts, 3);
-    EXPECT_EQ(ctx.codebig_max_attempts, 1);
+    EXPECT_EQ(ctx.direct_retry.max_attempts, 3);
+    EXPECT_EQ(ctx.codebig_retry.max_attempts, 1);
+    EXPECT_EQ(ctx.direct_retry.base_ms, 60000);
+    EXPECT_EQ(ctx.codebig_retry.base_ms, 10000);
+    EXPECT_TRUE(ctx.direct_retry.jitter);
+}
+
+TEST_F(ContextManagerTest, LoadEnvironment_CompressionConfig) {
+    EXPECT_CALL(*g_mockRdkUtils, getIncludePropertyData(_, _, _))
+        .WillRepeatedly(Return(UTILS_FAIL));
+    EXPECT_CALL(*g_mockRdkUtils, getIncludePropertyData(StrEq("LOG_COMPRESSION"), _, _))
+        .WillOnce(DoAll(SetArrayArgument<1>("6", "6" + 2),
+                       Return(UTILS_SUCCESS)));
+    EXPECT_CALL(*g_mockRdkUtils, getIncludePropertyData(StrEq("LOG_COMPRESSION_CRON"), _, _))
+        .WillOnce(DoAll(SetArrayArgument<1>("auto:rle", "auto:rle" + 9),
+                       Return(UTILS_SUCCESS)));
+    EXPECT_CALL(*g_mockRdkUtils, getIncludePropertyData(StrEq("LOG_COMPRESSION_REBOOT"), _, _))
+        .WillOnce(DoAll(SetArrayArgument<1>("12", "12" + 3),
+                       Return(UTILS_SUCCESS)));
+    EXPECT_CALL(*g_mockRdkUtils, getIncludePropertyData(StrEq("LOG_COMPRESSION_CODEC"), _, _))
+        .WillOnce(DoAll(SetArrayArgument<1>("ZSTD", "ZSTD" + 5),
+                       Return(UTILS_SUCCESS)));
+    EXPECT_CALL(*g_mockRdkUtils, getDevicePropertyData(_, _, _))
+        .WillRepeatedly(Return(UTILS_FAIL));
+
+    EXPECT_TRUE(load_environment(&ctx));
+
+    EXPECT_EQ(ctx.compression_level[TRIGGER_ONDEMAND], 6);
+    EXPECT_EQ(ctx.compression_strategy[TRIGGER_ONDEMAND], Z_DEFAULT_STRATEGY);
+    EXPECT_EQ(ctx.compression_level[TRIGGER_SCHEDULED], COMPRESSION_LEVEL_AUTO);
+    EXPECT_EQ(ctx.compression_strategy[TRIGGER_SCHEDULED], Z_RLE);
+    // Invalid override keeps the global setting
+    EXPECT_EQ(ctx.compression_level[TRIGGER_REBOOT], 6);
+    EXPECT_EQ(ctx.archive_codec, ARCHIVE_CODEC_ZSTD);
+}
+
+TEST_F(ContextManagerTest, LoadEnvironment_ArchiveLimits) {
+    EXPECT_CALL(*g_mockRdkUtils, getIncludePropertyData(_, _, _))
+        .WillRepeatedly(Return(UTILS_FAIL));
+    EXPECT_CALL(*g_mockRdkUtils, getIncludePropertyData(StrEq("LOG_UPLOAD_MAX_ARCHIVE_MB"), _, _))
+        .WillOnce(DoAll(SetArrayArgument<1>("100", "100" + 4),
+                       Return(UTILS_SUCCESS)));
+    EXPECT_CALL(*g_mockRdkUtils, getIncludePropertyData(StrEq("LOG_UPLOAD_MAX_FILE_MB"), _, _))
+        .WillOnce(DoAll(SetArrayArgument<1>("0", "0" + 2),
+                       Return(UTILS_SUCCESS)));
+    EXPECT_CALL(*g_mockRdkUtils, getDevicePropertyData(_, _, _))
+        .WillRepeatedly(Return(UTILS_FAIL));
+
+    EXPECT_TRUE(load_environment(&ctx));
+
+    EXPECT_EQ(ctx.archive_budget_mb, 100);
+    // 0 turns the per-file cap off
+    EXPECT_EQ(ctx.archive_file_cap_mb, ARCHIVE_LIMIT_NONE);
 }
 
 TEST_F(ContextManagerTest, LoadEnvironment_OCSPEnabled) {
@@ -361,6 +361,26 @@ TEST_F(EventManagerTest, EmitUploadFailure_NullSession) {
     // Note: report_upload_failure not called by implementation
 }
 
+// Test emit_upload_result function
+TEST_F(EventManagerTest, EmitUploadResult_FollowsSessionOutcome) {
+    strcpy(test_ctx.device_type, "broadband");
+
+    test_session.success = true;
+    emit_upload_result(&test_ctx, &test_session);
+    EXPECT_EQ(mock_last_event_code, 0); // LOG_UPLOAD_SUCCESS
+
+    test_session.success = false;
+    emit_upload_result(&test_ctx, &test_session);
+    EXPECT_EQ(mock_last_event_code, 1); // LOG_UPLOAD_FAILED
+    EXPECT_EQ(mock_iarm_event_calls, 2);
+}
+
+TEST_F(EventManagerTest, EmitUploadResult_NullSession) {
+    emit_upload_result(&test_ctx, nullptr);
+
+    EXPECT_EQ(mock_iarm_event_calls, 0);
+}
+
 // Test emit_upload_aborted function
 TEST_F(EventManagerTest, EmitUploadAborted_Success) {
     emit_upload_aborted();
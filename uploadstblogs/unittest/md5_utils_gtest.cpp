@@ -401,6 +401,45 @@ TEST_F(MD5UtilsTest, CalculateFileSHA256_DifferentContent_DifferentHashes) {
     EXPECT_EQ(strlen(sha256_output2), 64);
 }
 
+TEST_F(MD5UtilsTest, StreamDigest_MatchesFileHashes) {
+    CreateTestFile("/tmp/md5_test_file.txt", "Hello World");
+
+    StreamDigest* digest = stream_digest_new();
+    ASSERT_NE(digest, nullptr);
+    EXPECT_TRUE(stream_digest_update(digest, "Hello ", 6));
+    EXPECT_TRUE(stream_digest_update(digest, "World", 5));
+
+    char md5_output[32];
+    char sha256_output[65];
+    EXPECT_TRUE(stream_digest_final(digest, md5_output, sizeof(md5_output),
+                                    sha256_output, sizeof(sha256_output)));
+
+    // Same values calculate_file_md5/sha256 give for the file
+    char file_md5[32];
+    char file_sha256[65];
+    EXPECT_TRUE(calculate_file_md5("/tmp/md5_test_file.txt", file_md5, sizeof(file_md5)));
+    EXPECT_TRUE(calculate_file_sha256("/tmp/md5_test_file.txt", file_sha256, sizeof(file_sha256)));
+    EXPECT_STREQ(md5_output, file_md5);
+    EXPECT_STREQ(sha256_output, file_sha256);
+
+    // Finalized digests cannot be fed or finished again
+    EXPECT_FALSE(stream_digest_update(digest, "x", 1));
+    EXPECT_FALSE(stream_digest_final(digest, md5_output, sizeof(md5_output), NULL, 0));
+    stream_digest_free(digest);
+}
+
+TEST_F(MD5UtilsTest, StreamDigest_InvalidParameters) {
+    EXPECT_FALSE(stream_digest_update(NULL, "x", 1));
+    EXPECT_FALSE(stream_digest_final(NULL, NULL, 0, NULL, 0));
+    stream_digest_free(NULL);
+
+    StreamDigest* digest = stream_digest_new();
+    ASSERT_NE(digest, nullptr);
+    char small[16];
+    EXPECT_FALSE(stream_digest_final(digest, small, sizeof(small), NULL, 0));
+    stream_digest_free(digest);
+}
+
 // Main test runner
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
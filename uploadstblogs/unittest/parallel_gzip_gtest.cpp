@@ -0,0 +1,214 @@
+/**
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstring>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Mock RDK_LOG before including other headers
+#ifdef GTEST_ENABLE
+#define RDK_LOG(level, module, ...) do {} while(0)
+#endif
+
+#include "uploadstblogs_types.h"
+
+// Include the source file to test internal functions
+extern "C" {
+#include "../src/parallel_gzip.c"
+}
+
+using namespace testing;
+using namespace std;
+
+#define PGZ_TEST_FILE "/tmp/parallel_gzip_test.gz"
+
+class ParallelGzipTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        unlink(PGZ_TEST_FILE);
+    }
+
+    void TearDown() override {
+        unlink(PGZ_TEST_FILE);
+    }
+
+    // Read the file back through zlib's own gzip reader
+    static bool ReadBack(std::vector<unsigned char>& out) {
+        gzFile gz = gzopen(PGZ_TEST_FILE, "rb");
+        if (!gz) {
+            return false;
+        }
+        unsigned char buf[65536];
+        int n;
+        while ((n = gzread(gz, buf, sizeof(buf))) > 0) {
+            out.insert(out.end(), buf, buf + n);
+        }
+        int err = Z_OK;
+        gzerror(gz, &err);
+        gzclose(gz);
+        return n == 0 && err == Z_OK;
+    }
+
+    static std::vector<unsigned char> LogLikeData(size_t size) {
+        std::vector<unsigned char> data;
+        data.reserve(size);
+        unsigned int seed = 7;
+        while (data.size() < size) {
+            char line[96];
+            seed = seed * 1103515245u + 12345u;
+            int len = snprintf(line, sizeof(line), "2025 Nov 25 14:%02u:%02u device[%u]: event %u ok\n",
+                               (seed >> 8) % 60, (seed >> 16) % 60, (seed >> 4) % 4096, seed % 100000);
+            data.insert(data.end(), line, line + len);
+        }
+        data.resize(size);
+        return data;
+    }
+};
+
+TEST_F(ParallelGzipTest, Open_InvalidParameters) {
+    EXPECT_EQ(parallel_gzip_open(nullptr, 6, Z_DEFAULT_STRATEGY, 4), nullptr);
+    EXPECT_EQ(parallel_gzip_open(PGZ_TEST_FILE, 10, Z_DEFAULT_STRATEGY, 4), nullptr);
+    EXPECT_EQ(parallel_gzip_open(PGZ_TEST_FILE, 6, Z_DEFAULT_STRATEGY, 1), nullptr);
+    EXPECT_EQ(parallel_gzip_open("/nonexistent_dir/out.gz", 6, Z_DEFAULT_STRATEGY, 2), nullptr);
+    EXPECT_EQ(parallel_gzip_write(nullptr, "x", 1), -1);
+    EXPECT_EQ(parallel_gzip_close(nullptr), -1);
+}
+
+TEST_F(ParallelGzipTest, EmptyStream_IsValidGzip) {
+    ParallelGzip* pgz = parallel_gzip_open(PGZ_TEST_FILE, 6, Z_DEFAULT_STRATEGY, 2);
+    ASSERT_NE(pgz, nullptr);
+    EXPECT_EQ(parallel_gzip_close(pgz), 0);
+
+    std::vector<unsigned char> out;
+    EXPECT_TRUE(ReadBack(out));
+    EXPECT_TRUE(out.empty());
+}
+
+TEST_F(ParallelGzipTest, MultiBlock_RoundTrip) {
+    // Several blocks plus a partial tail, written in odd-sized chunks
+    std::vector<unsigned char> data = LogLikeData(PARALLEL_GZIP_BLOCK_SIZE * 5 + 12345);
+
+    ParallelGzip* pgz = parallel_gzip_open(PGZ_TEST_FILE, 6, Z_DEFAULT_STRATEGY, 4);
+    ASSERT_NE(pgz, nullptr);
+    for (size_t off = 0; off < data.size(); off += 7001) {
+        size_t n = std::min<size_t>(7001, data.size() - off);
+        ASSERT_EQ(parallel_gzip_write(pgz, data.data() + off, n), 0);
+    }
+    EXPECT_EQ(parallel_gzip_bytes_in(pgz), (long)data.size());
+    ASSERT_EQ(parallel_gzip_close(pgz), 0);
+
+    std::vector<unsigned char> out;
+    ASSERT_TRUE(ReadBack(out));
+    EXPECT_TRUE(out == data);
+}
+
+TEST_F(ParallelGzipTest, ExactBlockBoundary_RoundTrip) {
+    std::vector<unsigned char> data = LogLikeData(PARALLEL_GZIP_BLOCK_SIZE * 2);
+
+    ParallelGzip* pgz = parallel_gzip_open(PGZ_TEST_FILE, 1, Z_RLE, 3);
+    ASSERT_NE(pgz, nullptr);
+    ASSERT_EQ(parallel_gzip_write(pgz, data.data(), data.size()), 0);
+    ASSERT_EQ(parallel_gzip_close(pgz), 0);
+
+    std::vector<unsigned char> out;
+    ASSERT_TRUE(ReadBack(out));
+    EXPECT_TRUE(out == data);
+}
+
+TEST_F(ParallelGzipTest, Dictionary_KeepsRatioCloseToSingleStream) {
+    std::vector<unsigned char> data = LogLikeData(PARALLEL_GZIP_BLOCK_SIZE * 4);
+
+    ParallelGzip* pgz = parallel_gzip_open(PGZ_TEST_FILE, 6, Z_DEFAULT_STRATEGY, 4);
+    ASSERT_NE(pgz, nullptr);
+    ASSERT_EQ(parallel_gzip_write(pgz, data.data(), data.size()), 0);
+    ASSERT_EQ(parallel_gzip_close(pgz), 0);
+
+    struct stat st;
+    ASSERT_EQ(stat(PGZ_TEST_FILE, &st), 0);
+
+    uLongf single = compressBound(data.size());
+    std::vector<unsigned char> buf(single);
+    ASSERT_EQ(compress2(buf.data(), &single, data.data(), data.size(), 6), Z_OK);
+
+    // Block splitting costs only a few sync markers when primed with the
+    // previous block's tail
+    EXPECT_LT((double)st.st_size, (double)single * 1.05);
+}
+
+static void CollectSink(void* arg, const void* buf, size_t len) {
+    std::vector<unsigned char>* seen = static_cast<std::vector<unsigned char>*>(arg);
+    const unsigned char* p = static_cast<const unsigned char*>(buf);
+    seen->insert(seen->end(), p, p + len);
+}
+
+TEST_F(ParallelGzipTest, Sink_SeesExactFileBytes) {
+    std::vector<unsigned char> data = LogLikeData(PARALLEL_GZIP_BLOCK_SIZE * 3 + 99);
+    std::vector<unsigned char> seen;
+
+    ParallelGzip* pgz = parallel_gzip_open(PGZ_TEST_FILE, 6, Z_DEFAULT_STRATEGY, 3);
+    ASSERT_NE(pgz, nullptr);
+    parallel_gzip_set_sink(pgz, CollectSink, &seen);
+    ASSERT_EQ(parallel_gzip_write(pgz, data.data(), data.size()), 0);
+    ASSERT_EQ(parallel_gzip_close(pgz), 0);
+
+    FILE* f = fopen(PGZ_TEST_FILE, "rb");
+    ASSERT_NE(f, nullptr);
+    std::vector<unsigned char> file;
+    unsigned char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        file.insert(file.end(), buf, buf + n);
+    }
+    fclose(f);
+    EXPECT_TRUE(seen == file);
+}
+
+TEST_F(ParallelGzipTest, SetLevel_StoredSpanRoundTrip) {
+    std::vector<unsigned char> text = LogLikeData(PARALLEL_GZIP_BLOCK_SIZE + 5000);
+    std::vector<unsigned char> noise(PARALLEL_GZIP_BLOCK_SIZE * 2);
+    unsigned int seed = 11;
+    for (size_t i = 0; i < noise.size(); i++) {
+        seed = seed * 1103515245u + 12345u;
+        noise[i] = (unsigned char)(seed >> 16);
+    }
+
+    ParallelGzip* pgz = parallel_gzip_open(PGZ_TEST_FILE, 6, Z_DEFAULT_STRATEGY, 2);
+    ASSERT_NE(pgz, nullptr);
+    EXPECT_EQ(parallel_gzip_set_level(pgz, 10), -1);
+    ASSERT_EQ(parallel_gzip_write(pgz, text.data(), text.size()), 0);
+    ASSERT_EQ(parallel_gzip_set_level(pgz, 0), 0);
+    ASSERT_EQ(parallel_gzip_write(pgz, noise.data(), noise.size()), 0);
+    ASSERT_EQ(parallel_gzip_set_level(pgz, 6), 0);
+    ASSERT_EQ(parallel_gzip_write(pgz, text.data(), text.size()), 0);
+    ASSERT_EQ(parallel_gzip_close(pgz), 0);
+
+    std::vector<unsigned char> expected(text);
+    expected.insert(expected.end(), noise.begin(), noise.end());
+    expected.insert(expected.end(), text.begin(), text.end());
+    std::vector<unsigned char> out;
+    ASSERT_TRUE(ReadBack(out));
+    EXPECT_TRUE(out == expected);
+}
+
+// Main test runner
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
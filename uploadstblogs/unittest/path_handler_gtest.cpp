@@ -34,6 +34,8 @@
 #include <dirent.h>
 #include <stdarg.h>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 // HTTP upload type constants (from uploadutil/codebig_upload.h)
 #define HTTP_SSR_DIRECT      0
@@ -92,7 +94,6 @@ void __uploadutil_get_status(long *http_code, int *curl_code);
 int performMetadataPostWithCertRotationEx(const char *upload_url, const char *outfile,
                                           const char *extra_fields, MtlsAuth_t *sec_out,
                                           long *http_code_out);
-int performS3PutWithCert(const char *s3_url, const char *src_file, MtlsAuth_t *sec);
 int performCodeBigMetadataPost(void *curl, const char *filepath,
                                const char *extra_fields, int server_type,
                                long *http_code_out);
@@ -101,6 +102,11 @@ int performS3PutUploadEx(const char* upload_url, const char* src_file,
                          MtlsAuth_t* auth, const char* md5_hash,
                          bool ocsp_enabled, UploadStatusDetail* status);
 int extractS3PresignedUrl(const char* httpresult_file, char* s3_url, size_t s3_url_size);
+
+// Mock upload_http shared-handle and multipart functions
+#include "upload_http.h"
+#include "upload_multipart.h"
+#include "upload_hedge.h"
 }
 
 #ifndef UTILS_SUCCESS
@@ -132,6 +138,7 @@ static int mock_fopen_calls = 0;
 static int mock_fgets_calls = 0;
 static int mock_t2_count_calls = 0;
 static int mock_t2_val_calls = 0;
+static int mock_throughput_calls = 0;
 
 // Mock implementations
 bool calculate_file_md5(const char* filepath, char* md5_hash, size_t hash_size) {
@@ -198,6 +205,9 @@ void t2_val_notify(char* marker, char* value) {
     if (marker && strcmp(marker, "certerr_split") == 0) {
         mock_report_cert_error_calls++;
     }
+    if (marker && strcmp(marker, "LUThroughput_split") == 0) {
+        mock_throughput_calls++;
+    }
 }
 
 void __uploadutil_set_ocsp(bool enabled) {
@@ -205,6 +215,7 @@ void __uploadutil_set_ocsp(bool enabled) {
 }
 
 static long mock_http_code_status = 200;
+static char mock_post_outfile[64] = "";
 static int mock_curl_code_status = 0;
 
 void __uploadutil_get_status(long *http_code, int *curl_code) {
@@ -216,6 +227,7 @@ int performMetadataPostWithCertRotationEx(const char *upload_url, const char *ou
                                           const char *extra_fields, MtlsAuth_t *sec_out,
                                           long *http_code_out) {
     mock_upload_mtls_calls++;
+    strncpy(mock_post_outfile, outfile ? outfile : "", sizeof(mock_post_outfile) - 1);
     if (http_code_out) {
         *http_code_out = mock_upload_status.http_code;
     }
@@ -227,11 +239,92 @@ int performMetadataPostWithCertRotationEx(const char *upload_url, const char *ou
     return mock_upload_function_result;
 }
 
-int performS3PutWithCert(const char *s3_url, const char *src_file, MtlsAuth_t *sec) {
+static int mock_put_retry_after = 0;
+static char mock_put_cert[256] = "";
+
+CURL* upload_http_acquire(void) {
+    return nullptr;  // The library creates its own handle
+}
+
+void upload_http_release(CURL* curl) {
+    (void)curl;
+}
+
+size_t upload_http_retry_after_header(char* buffer, size_t size, size_t nitems, void* userdata) {
+    return size * nitems;
+}
+
+static int mock_race_post_done_calls = 0;
+static bool mock_race_lost = false;
+
+void upload_race_post_done(struct UploadRacer* racer) {
+    if (racer) {
+        mock_race_post_done_calls++;
+    }
+}
+
+bool upload_race_lost(const struct UploadRacer* racer) {
+    return racer && mock_race_lost;
+}
+
+static int mock_prewarm_calls = 0;
+static char mock_prewarm_url[256] = "";
+static char mock_prewarm_cert[256] = "";
+
+void upload_http_prewarm(const char* url, const UploadHttpCert* cert, bool ocsp, int connect_timeout_s) {
+    mock_prewarm_calls++;
+    strncpy(mock_prewarm_url, url ? url : "", sizeof(mock_prewarm_url) - 1);
+    strncpy(mock_prewarm_cert, (cert && cert->cert_file) ? cert->cert_file : "", sizeof(mock_prewarm_cert) - 1);
+}
+
+static int mock_rate_limit_calls = 0;
+static long mock_rate_cap_bps = -1;
+static bool mock_rate_adaptive = false;
+static long long mock_put_bytes = 0;
+static long mock_put_elapsed_ms = 0;
+
+void upload_http_set_rate_limit(long cap_bps, bool adaptive) {
+    mock_rate_limit_calls++;
+    mock_rate_cap_bps = cap_bps;
+    mock_rate_adaptive = adaptive;
+}
+
+static bool mock_race_lost_during_put = false;
+
+int upload_http_put(const char* url, const char* src_file, const UploadHttpCert* cert,
+                    bool ocsp, int connect_timeout_s, const UploadHttpCancel* cancel,
+                    UploadResponse* resp) {
     mock_upload_s3_calls++;
+    if (mock_race_lost_during_put) {
+        mock_race_lost = true;
+        if (cancel && cancel->stop(cancel->arg)) {
+            resp->curl_code = 42;  // CURLE_ABORTED_BY_CALLBACK
+            return resp->curl_code;
+        }
+    }
+    resp->bytes = mock_put_bytes;
+    resp->elapsed_ms = mock_put_elapsed_ms;
+    strncpy(mock_put_cert, (cert && cert->cert_file) ? cert->cert_file : "", sizeof(mock_put_cert) - 1);
+    resp->http_code = (int)mock_http_code_status;
+    resp->curl_code = mock_upload_function_result;
+    resp->retry_after = mock_put_retry_after;
     return mock_upload_function_result;
 }
 
+static int mock_multipart_calls = 0;
+static MultipartResult mock_multipart_result = MULTIPART_OK;
+static long long mock_multipart_part_size = 0;
+
+MultipartResult upload_multipart_put(const char* url, const char* src_file, const UploadHttpCert* cert,
+                                     bool ocsp, int connect_timeout_s, const MultipartConfig* config,
+                                     UploadResponse* resp) {
+    mock_multipart_calls++;
+    mock_multipart_part_size = config->part_size;
+    resp->http_code = (mock_multipart_result == MULTIPART_OK) ? 200 : 500;
+    resp->curl_code = 0;
+    return mock_multipart_result;
+}
+
 static int mock_codebig_metadata_result = 0;
 static int mock_codebig_s3_result = 0;
 
@@ -356,6 +449,7 @@ protected:
 
         // Reset call tracking
         mock_calculate_md5_calls = 0;
+        mock_calculate_sha256_calls = 0;
         mock_report_mtls_calls = 0;
         mock_report_curl_error_calls = 0;
         mock_report_cert_error_calls = 0;
@@ -369,6 +463,16 @@ protected:
         mock_t2_count_calls = 0;
         mock_t2_val_calls = 0;
 
+        mock_race_post_done_calls = 0;
+        mock_race_lost = false;
+        mock_race_lost_during_put = false;
+        mock_rate_limit_calls = 0;
+        mock_rate_cap_bps = -1;
+        mock_rate_adaptive = false;
+        mock_put_bytes = 0;
+        mock_put_elapsed_ms = 0;
+        mock_throughput_calls = 0;
+
         // Reset CodeBig specific results
         mock_codebig_metadata_result = 0;
         mock_codebig_s3_result = 0;
@@ -384,13 +488,29 @@ protected:
         strcpy(test_ctx.device_type, "gateway");
         test_ctx.encryption_enable = false;
         test_ctx.ocsp_enabled = false;
+        test_ctx.multipart_threshold_mb = 0;
+        test_ctx.multipart_part_mb = MULTIPART_DEFAULT_PART_MB;
+        test_ctx.multipart_parallel = MULTIPART_DEFAULT_PARALLEL;
 
         // Set up default test session
         strcpy(test_session.archive_file, "/tmp/logs.tar.gz");
         test_session.strategy = STRAT_DCM;
         test_session.curl_code = 0;
         test_session.http_code = 0;
+        test_session.retry_after = 0;
+        test_session.racer = nullptr;
+        mock_put_retry_after = 0;
+        mock_http_code_status = 200;
+        mock_multipart_calls = 0;
+        mock_multipart_result = MULTIPART_OK;
+        mock_multipart_part_size = 0;
+        mock_put_cert[0] = '\0';
+        mock_prewarm_calls = 0;
+        mock_prewarm_url[0] = '\0';
+        mock_prewarm_cert[0] = '\0';
         test_session.success = false;
+        test_session.archive_md5[0] = '\0';
+        test_session.archive_sha256[0] = '\0';
     }
 
     void TearDown() override {}
@@ -413,6 +533,30 @@ TEST_F(PathHandlerTest, ExecuteDirectPath_Success) {
     EXPECT_EQ(test_session.http_code, 200);
 }
 
+TEST_F(PathHandlerTest, ExecuteDirectPath_ResponsesKeptInMemory) {
+    UploadResult result = execute_direct_path(&test_ctx, &test_session);
+
+    EXPECT_EQ(result, UPLOADSTB_SUCCESS);
+    EXPECT_STREQ(test_session.post.presigned_url, mock_file_content);
+    EXPECT_EQ(test_session.post.http_code, 200);
+    EXPECT_EQ(test_session.put.http_code, 200);
+    EXPECT_EQ(test_session.put.curl_code, 0);
+    EXPECT_GE(test_session.put.elapsed_ms, 0);
+    EXPECT_EQ(mock_fopen_calls, 0);  // No /tmp/logupload_curl_info or results re-read
+}
+
+TEST_F(PathHandlerTest, ExecuteDirectPath_PrivateResultsFileRemoved) {
+    execute_direct_path(&test_ctx, &test_session);
+    EXPECT_EQ(strncmp(mock_post_outfile, "/tmp/httpresults.", 17), 0);
+    EXPECT_STRNE(mock_post_outfile, "/tmp/httpresults.txt");
+    EXPECT_EQ(access(mock_post_outfile, F_OK), -1);
+
+    test_session.strategy = STRAT_RRD;
+    execute_direct_path(&test_ctx, &test_session);
+    EXPECT_EQ(strncmp(mock_post_outfile, "/tmp/rrd_httpresults.", 21), 0);
+    EXPECT_EQ(access(mock_post_outfile, F_OK), -1);
+}
+
 TEST_F(PathHandlerTest, ExecuteDirectPath_NullContext) {
     UploadResult result = execute_direct_path(nullptr, &test_session);
 
@@ -438,6 +582,31 @@ TEST_F(PathHandlerTest, ExecuteDirectPath_WithEncryption) {
     EXPECT_EQ(mock_upload_s3_calls, 1);   // S3 PUT
 }
 
+TEST_F(PathHandlerTest, ExecuteDirectPath_UsesDigestsFromArchiveCreation) {
+    test_ctx.encryption_enable = true;
+    strcpy(test_session.archive_md5, "c3RvcmVkTUQ1");
+    strcpy(test_session.archive_sha256, mock_sha256_hash);
+
+    UploadResult result = execute_direct_path(&test_ctx, &test_session);
+
+    EXPECT_EQ(result, UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_calculate_md5_calls, 0);
+    EXPECT_EQ(mock_calculate_sha256_calls, 0);
+}
+
+TEST_F(PathHandlerTest, ExecuteDirectPath_RrdArchiveHashedOnce) {
+    // RRD archives arrive without digests: hash once, reuse on retry
+    test_ctx.encryption_enable = true;
+
+    execute_direct_path(&test_ctx, &test_session);
+    execute_direct_path(&test_ctx, &test_session);
+    execute_codebig_path(&test_ctx, &test_session);
+
+    EXPECT_EQ(mock_calculate_md5_calls, 1);
+    EXPECT_EQ(mock_calculate_sha256_calls, 1);
+    EXPECT_STREQ(test_session.archive_md5, mock_md5_hash);
+}
+
 TEST_F(PathHandlerTest, ExecuteDirectPath_EncryptionMD5Failure) {
     test_ctx.encryption_enable = true;
     mock_calculate_md5_result = false;
@@ -496,7 +665,7 @@ TEST_F(PathHandlerTest, ExecuteDirectPath_ProxyFallback_MediaClient) {
     // Should attempt: metadata POST (succeeds), S3 PUT (fails), then proxy fallback
     EXPECT_EQ(mock_upload_mtls_calls, 1); // Metadata POST
     EXPECT_GE(mock_upload_s3_calls, 1);   // S3 PUT + proxy fallback attempt
-    EXPECT_GE(mock_fopen_calls, 1);       // Read httpresult.txt for S3 URL and proxy
+    EXPECT_EQ(mock_fopen_calls, 0);       // S3 URL for the proxy comes from memory
 }
 
 TEST_F(PathHandlerTest, ExecuteDirectPath_ProxyFallback_NoProxyBucket) {
@@ -669,6 +838,239 @@ TEST_F(PathHandlerTest, NonCertificateErrorCode_NotReported) {
     EXPECT_EQ(mock_report_curl_error_calls, 1); // Should still report general curl error
 }
 
+// Test the S3 PUT done over the shared handle
+TEST_F(PathHandlerTest, S3Put_UsesCertificateFromMetadataPost) {
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_upload_s3_calls, 1);
+    EXPECT_STREQ(mock_put_cert, "mock_cert.p12");
+}
+
+TEST_F(PathHandlerTest, S3Put_RetryHintReachesSession) {
+    mock_http_code_status = 503;
+    mock_put_retry_after = 45;
+    mock_verify_results[0] = UPLOADSTB_SUCCESS;  // Metadata POST
+    mock_verify_results[1] = UPLOADSTB_FAILED;   // S3 PUT
+    mock_verify_results[2] = UPLOADSTB_FAILED;   // Proxy fallback
+
+    execute_direct_path(&test_ctx, &test_session);
+
+    EXPECT_EQ(test_session.put.http_code, 503);
+    EXPECT_EQ(test_session.retry_after, 45);
+}
+
+// Test the switch to multipart upload for large archives
+// Metadata POST sent while the archive is written
+TEST_F(PathHandlerTest, EarlyPost_UsedByFirstAttempt) {
+    start_early_metadata_post(&test_ctx, &test_session, "/tmp/logs.tar.gz");
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_upload_mtls_calls, 1);
+    EXPECT_EQ(mock_upload_s3_calls, 1);
+    EXPECT_STREQ(test_session.post.presigned_url, mock_file_content);
+    EXPECT_STREQ(mock_put_cert, "mock_cert.p12");
+    EXPECT_EQ(mock_prewarm_calls, 1);
+    EXPECT_STREQ(mock_prewarm_url, mock_file_content);
+    EXPECT_STREQ(mock_prewarm_cert, "mock_cert.p12");
+
+    // Retries send their own POST
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_upload_mtls_calls, 2);
+}
+
+TEST_F(PathHandlerTest, EarlyPost_FailureIsTheAttemptResult) {
+    mock_verify_results[0] = UPLOADSTB_FAILED;
+    start_early_metadata_post(&test_ctx, &test_session, "/tmp/logs.tar.gz");
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_FAILED);
+    EXPECT_EQ(mock_upload_mtls_calls, 1);
+    EXPECT_EQ(mock_upload_s3_calls, 0);
+    EXPECT_EQ(mock_prewarm_calls, 0);
+}
+
+TEST_F(PathHandlerTest, EarlyPost_OtherArchiveIgnored) {
+    start_early_metadata_post(&test_ctx, &test_session, "/tmp/other.tar.gz");
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    // The other archive's POST is left running for its own upload
+    cancel_early_metadata_post();
+    EXPECT_EQ(mock_upload_mtls_calls, 2);
+    EXPECT_EQ(mock_upload_s3_calls, 1);
+}
+
+TEST_F(PathHandlerTest, EarlyPost_NotWithEncryption) {
+    test_ctx.encryption_enable = true;
+    start_early_metadata_post(&test_ctx, &test_session, "/tmp/logs.tar.gz");
+    cancel_early_metadata_post();
+
+    EXPECT_EQ(mock_upload_mtls_calls, 0);
+}
+
+// Hedged uploads: the racing session reports its POST and stops once the other path won
+TEST_F(PathHandlerTest, Race_DirectReportsPostAndPuts) {
+    test_session.racer = (struct UploadRacer*)&test_ctx;  // Only compared against NULL by the mocks
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_race_post_done_calls, 1);
+    EXPECT_EQ(mock_upload_s3_calls, 1);
+}
+
+TEST_F(PathHandlerTest, Race_LostSkipsDirectPut) {
+    test_session.racer = (struct UploadRacer*)&test_ctx;
+    mock_race_lost = true;
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_ABORTED);
+    EXPECT_EQ(mock_upload_mtls_calls, 1);
+    EXPECT_EQ(mock_upload_s3_calls, 0);
+}
+
+TEST_F(PathHandlerTest, Race_LostDuringPutStopsTransfer) {
+    test_session.racer = (struct UploadRacer*)&test_ctx;
+    strcpy(test_ctx.device_type, "mediaclient");
+    strcpy(test_ctx.proxy_bucket, "proxy.bucket.com");
+    mock_race_lost_during_put = true;
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_ABORTED);
+    // Stopped by the cancel check, and no proxy fallback afterwards
+    EXPECT_EQ(mock_upload_s3_calls, 1);
+    EXPECT_FALSE(test_session.success);
+}
+
+TEST_F(PathHandlerTest, Race_LostSkipsCodeBigPut) {
+    test_session.racer = (struct UploadRacer*)&test_ctx;
+    mock_race_lost = true;
+
+    EXPECT_EQ(execute_codebig_path(&test_ctx, &test_session), UPLOADSTB_ABORTED);
+    EXPECT_EQ(mock_race_post_done_calls, 1);
+    EXPECT_EQ(mock_upload_s3_calls, 0);
+}
+
+TEST_F(PathHandlerTest, Race_FailedPostNotReported) {
+    test_session.racer = (struct UploadRacer*)&test_ctx;
+    mock_codebig_metadata_result = 1;
+
+    EXPECT_EQ(execute_codebig_path(&test_ctx, &test_session), UPLOADSTB_FAILED);
+    EXPECT_EQ(mock_race_post_done_calls, 0);
+}
+
+TEST_F(PathHandlerTest, RateLimit_ScheduledCappedOnDemandNot) {
+    for (int i = 0; i < COMPRESSION_TRIGGER_SLOTS; i++) {
+        test_ctx.upload_rate_kbit[i] = UPLOAD_RATE_UNCAPPED;
+    }
+    test_ctx.upload_rate_kbit[TRIGGER_SCHEDULED] = 800;
+    test_ctx.upload_rate_adaptive = true;
+
+    test_ctx.trigger_type = TRIGGER_SCHEDULED;
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_rate_limit_calls, 1);
+    EXPECT_EQ(mock_rate_cap_bps, 100000);
+    EXPECT_TRUE(mock_rate_adaptive);
+
+    test_ctx.trigger_type = TRIGGER_ONDEMAND;
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_rate_cap_bps, 0);
+}
+
+TEST_F(PathHandlerTest, RateLimit_RrdUsesItsOwnCap) {
+    test_ctx.trigger_type = TRIGGER_SCHEDULED;
+    test_ctx.upload_rate_kbit[TRIGGER_SCHEDULED] = 800;
+    test_ctx.upload_rate_rrd_kbit = UPLOAD_RATE_UNCAPPED;
+    test_session.strategy = STRAT_RRD;
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_rate_cap_bps, 0);
+
+    test_ctx.upload_rate_rrd_kbit = 400;
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_rate_cap_bps, 50000);
+}
+
+TEST_F(PathHandlerTest, Throughput_ReportedAfterDirectPut) {
+    mock_put_bytes = 2000000;
+    mock_put_elapsed_ms = 4000;
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_throughput_calls, 1);
+}
+
+TEST_F(PathHandlerTest, Throughput_NotReportedWithoutBytes) {
+    mock_put_elapsed_ms = 4000;
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_throughput_calls, 0);
+}
+
+TEST_F(PathHandlerTest, EarlyPost_CancelledWhenUnused) {
+    start_early_metadata_post(&test_ctx, &test_session, "/tmp/logs.tar.gz");
+    cancel_early_metadata_post();
+    EXPECT_EQ(mock_upload_mtls_calls, 1);
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_upload_mtls_calls, 2);
+}
+
+class PathHandlerMultipartTest : public PathHandlerTest {
+protected:
+    void SetUp() override {
+        PathHandlerTest::SetUp();
+        // 2 MB sparse archive; fopen is mocked, so create it with open()
+        int fd = open(MP_TEST_ARCHIVE, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(ftruncate(fd, 2 * 1024 * 1024), 0);
+        close(fd);
+        strcpy(test_session.archive_file, MP_TEST_ARCHIVE);
+    }
+
+    void TearDown() override {
+        unlink(MP_TEST_ARCHIVE);
+    }
+
+    static constexpr const char* MP_TEST_ARCHIVE = "/tmp/path_handler_multipart.tgz";
+};
+
+TEST_F(PathHandlerMultipartTest, BelowThreshold_SinglePut) {
+    test_ctx.multipart_threshold_mb = 3;
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_multipart_calls, 0);
+    EXPECT_EQ(mock_upload_s3_calls, 1);
+}
+
+TEST_F(PathHandlerMultipartTest, DisabledByDefault) {
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_multipart_calls, 0);
+}
+
+TEST_F(PathHandlerMultipartTest, AboveThreshold_Multipart) {
+    test_ctx.multipart_threshold_mb = 2;
+    test_ctx.multipart_part_mb = 16;
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_multipart_calls, 1);
+    EXPECT_EQ(mock_multipart_part_size, 16LL * 1024 * 1024);
+    EXPECT_EQ(mock_upload_s3_calls, 0);
+    EXPECT_EQ(test_session.put.http_code, 200);
+}
+
+TEST_F(PathHandlerMultipartTest, Unsupported_FallsBackToSinglePut) {
+    test_ctx.multipart_threshold_mb = 1;
+    mock_multipart_result = MULTIPART_UNSUPPORTED;
+
+    EXPECT_EQ(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_multipart_calls, 1);
+    EXPECT_EQ(mock_upload_s3_calls, 1);
+}
+
+TEST_F(PathHandlerMultipartTest, Failed_NoSinglePutRetry) {
+    test_ctx.multipart_threshold_mb = 1;
+    mock_multipart_result = MULTIPART_FAILED;
+    mock_verify_results[0] = UPLOADSTB_SUCCESS;  // Metadata POST
+    mock_verify_results[1] = UPLOADSTB_FAILED;   // Multipart upload
+    mock_verify_results[2] = UPLOADSTB_FAILED;   // Proxy fallback
+
+    EXPECT_NE(execute_direct_path(&test_ctx, &test_session), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(mock_multipart_calls, 1);
+    EXPECT_EQ(test_session.put.http_code, 500);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     cout << "Starting Path Handler Unit Tests" << endl;
@@ -24,6 +24,13 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <algorithm>
+#include <climits>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define UPLOAD_NOT_BEFORE_FILE "/tmp/retry_logic_test_not_before"
 
 extern "C" {
 #include "uploadstblogs_types.h"
@@ -32,12 +39,15 @@ extern "C" {
 // External function declarations needed by retry_logic.c
 void report_upload_attempt(void);
 bool is_terminal_failure(int http_code);
+bool is_throttled_response(int http_code);
+bool upload_race_lost(const struct UploadRacer* racer);
 }
 
 // Mock implementation for external functions
 static bool g_mock_terminal_failure = false;
 static int g_upload_attempt_count = 0;
 static int g_t2_count_notify_calls = 0;
+static bool g_mock_race_lost = false;
 
 void report_upload_attempt(void) {
     g_upload_attempt_count++;
@@ -48,6 +58,10 @@ bool is_terminal_failure(int http_code) {
     return (http_code == 404) || g_mock_terminal_failure;
 }
 
+bool is_throttled_response(int http_code) {
+    return (http_code == 429) || (http_code == 503);
+}
+
 void t2_count_notify(char* marker) {
     g_t2_count_notify_calls++;
     if (marker && strcmp(marker, "SYST_INFO_LUattempt") == 0) {
@@ -55,6 +69,10 @@ void t2_count_notify(char* marker) {
     }
 }
 
+bool upload_race_lost(const struct UploadRacer* racer) {
+    return racer && g_mock_race_lost;
+}
+
 // Include the actual implementation for testing
 #ifdef GTEST_ENABLE
 #include "../src/retry_logic.c"
@@ -68,11 +86,12 @@ protected:
         g_upload_attempt_count = 0;
         g_t2_count_notify_calls = 0;
         g_mock_terminal_failure = false;
+        g_mock_race_lost = false;
 
         // Initialize test context
         memset(&ctx, 0, sizeof(ctx));
-        ctx.direct_max_attempts = 3;
-        ctx.codebig_max_attempts = 2;
+        ctx.direct_retry.max_attempts = 3;
+        ctx.codebig_retry.max_attempts = 2;
 
         // Initialize test session
         memset(&session, 0, sizeof(session));
@@ -83,6 +102,11 @@ protected:
         // Reset call counters
         upload_call_count = 0;
         last_upload_result = UPLOADSTB_FAILED;
+
+        // Zeroed policies retry without waiting
+        retry_wait_reset();
+        unlink(UPLOAD_NOT_BEFORE_FILE);
+        g_mock_retry_after = 0;
     }
 
     void TearDown() override {
@@ -123,6 +147,15 @@ protected:
         return last_upload_result;
     }
 
+    // Fails with a server retry hint
+    static int g_mock_retry_after;
+    static UploadResult mock_upload_throttled(RuntimeContext* ctx, SessionState* session, UploadPath path) {
+        upload_call_count++;
+        session->http_code = 429;
+        session->retry_after = g_mock_retry_after;
+        return UPLOADSTB_FAILED;
+    }
+
     static UploadResult mock_upload_succeed_on_nth_call(RuntimeContext* ctx, SessionState* session, UploadPath path) {
         upload_call_count++;
         if (upload_call_count >= 2) {
@@ -134,6 +167,7 @@ protected:
 
 // Initialize static members
 int RetryLogicTest::upload_call_count = 0;
+int RetryLogicTest::g_mock_retry_after = 0;
 UploadResult RetryLogicTest::last_upload_result = UPLOADSTB_FAILED;
 
 // Tests for retry_upload function
@@ -171,7 +205,7 @@ TEST_F(RetryLogicTest, RetryUpload_DirectPath_RetriesUntilMaxAttempts) {
     UploadResult result = retry_upload(&ctx, &session, PATH_DIRECT, mock_upload_fail);
 
     EXPECT_EQ(result, UPLOADSTB_FAILED);
-    EXPECT_EQ(upload_call_count, 3); // ctx.direct_max_attempts
+    EXPECT_EQ(upload_call_count, 3); // ctx.direct_retry.max_attempts
     EXPECT_EQ(session.direct_attempts, 3);
     EXPECT_EQ(session.codebig_attempts, 0);
 }
@@ -180,7 +214,7 @@ TEST_F(RetryLogicTest, RetryUpload_CodeBigPath_RetriesUntilMaxAttempts) {
     UploadResult result = retry_upload(&ctx, &session, PATH_CODEBIG, mock_upload_fail);
 
     EXPECT_EQ(result, UPLOADSTB_FAILED);
-    EXPECT_EQ(upload_call_count, 2); // ctx.codebig_max_attempts
+    EXPECT_EQ(upload_call_count, 2); // ctx.codebig_retry.max_attempts
     EXPECT_EQ(session.direct_attempts, 0);
     EXPECT_EQ(session.codebig_attempts, 2);
 }
@@ -262,7 +296,7 @@ TEST_F(RetryLogicTest, ShouldRetry_TerminalFailure_HTTP404_NoRetry) {
 
 TEST_F(RetryLogicTest, ShouldRetry_DirectPath_WithinAttemptLimit) {
     session.direct_attempts = 2;
-    ctx.direct_max_attempts = 3;
+    ctx.direct_retry.max_attempts = 3;
     session.http_code = 500; // Non-terminal failure
 
     bool result = should_retry(&ctx, &session, PATH_DIRECT, UPLOADSTB_FAILED);
@@ -271,7 +305,7 @@ TEST_F(RetryLogicTest, ShouldRetry_DirectPath_WithinAttemptLimit) {
 
 TEST_F(RetryLogicTest, ShouldRetry_DirectPath_ExceededAttemptLimit) {
     session.direct_attempts = 3;
-    ctx.direct_max_attempts = 3;
+    ctx.direct_retry.max_attempts = 3;
     session.http_code = 500; // Non-terminal failure
 
     bool result = should_retry(&ctx, &session, PATH_DIRECT, UPLOADSTB_FAILED);
@@ -280,7 +314,7 @@ TEST_F(RetryLogicTest, ShouldRetry_DirectPath_ExceededAttemptLimit) {
 
 TEST_F(RetryLogicTest, ShouldRetry_CodeBigPath_WithinAttemptLimit) {
     session.codebig_attempts = 1;
-    ctx.codebig_max_attempts = 2;
+    ctx.codebig_retry.max_attempts = 2;
     session.http_code = 500; // Non-terminal failure
 
     bool result = should_retry(&ctx, &session, PATH_CODEBIG, UPLOADSTB_FAILED);
@@ -289,7 +323,7 @@ TEST_F(RetryLogicTest, ShouldRetry_CodeBigPath_WithinAttemptLimit) {
 
 TEST_F(RetryLogicTest, ShouldRetry_CodeBigPath_ExceededAttemptLimit) {
     session.codebig_attempts = 2;
-    ctx.codebig_max_attempts = 2;
+    ctx.codebig_retry.max_attempts = 2;
     session.http_code = 500; // Non-terminal failure
 
     bool result = should_retry(&ctx, &session, PATH_CODEBIG, UPLOADSTB_FAILED);
@@ -298,7 +332,7 @@ TEST_F(RetryLogicTest, ShouldRetry_CodeBigPath_ExceededAttemptLimit) {
 
 TEST_F(RetryLogicTest, ShouldRetry_RetryResult_WithinLimit) {
     session.direct_attempts = 1;
-    ctx.direct_max_attempts = 3;
+    ctx.direct_retry.max_attempts = 3;
     session.http_code = 500; // Non-terminal failure
 
     bool result = should_retry(&ctx, &session, PATH_DIRECT, UPLOADSTB_RETRY);
@@ -406,8 +440,8 @@ TEST_F(RetryLogicTest, Integration_NetworkFailurePreventsRetry) {
 
 TEST_F(RetryLogicTest, Integration_MixedPathAttempts) {
     // Test that attempts are tracked separately for different paths
-    ctx.direct_max_attempts = 2;
-    ctx.codebig_max_attempts = 3;
+    ctx.direct_retry.max_attempts = 2;
+    ctx.codebig_retry.max_attempts = 3;
 
     // Try direct path first
     UploadResult result1 = retry_upload(&ctx, &session, PATH_DIRECT, mock_upload_fail);
@@ -423,6 +457,230 @@ TEST_F(RetryLogicTest, Integration_MixedPathAttempts) {
     EXPECT_EQ(session.codebig_attempts, 3);
 }
 
+// Tests for the backoff policy and cancellable wait
+TEST_F(RetryLogicTest, Backoff_GrowsAndCaps) {
+    RetryPolicy policy = {3, 1000, 2, 5000, false};
+
+    EXPECT_EQ(retry_backoff_ms(&policy, 1, NULL), 1000);
+    EXPECT_EQ(retry_backoff_ms(&policy, 2, NULL), 2000);
+    EXPECT_EQ(retry_backoff_ms(&policy, 3, NULL), 4000);
+    EXPECT_EQ(retry_backoff_ms(&policy, 4, NULL), 5000);
+    EXPECT_EQ(retry_backoff_ms(&policy, 1000, NULL), 5000);
+}
+
+TEST_F(RetryLogicTest, Backoff_InvalidInputsNoDelay) {
+    RetryPolicy policy = {3, 1000, 2, 5000, false};
+    RetryPolicy zero = {3, 0, 2, 5000, false};
+
+    EXPECT_EQ(retry_backoff_ms(NULL, 1, NULL), 0);
+    EXPECT_EQ(retry_backoff_ms(&policy, 0, NULL), 0);
+    EXPECT_EQ(retry_backoff_ms(&zero, 1, NULL), 0);
+}
+
+TEST_F(RetryLogicTest, Backoff_FullJitterStaysInBound) {
+    RetryPolicy policy = {3, 60000, 2, 300000, true};
+    unsigned int seed = 12345;
+    int min_seen = INT_MAX;
+    int max_seen = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        int delay = retry_backoff_ms(&policy, 2, &seed);
+        ASSERT_GE(delay, 0);
+        ASSERT_LE(delay, 120000);
+        min_seen = std::min(min_seen, delay);
+        max_seen = std::max(max_seen, delay);
+    }
+    // Spread over the whole range, not clustered at the bound
+    EXPECT_LT(min_seen, 12000);
+    EXPECT_GT(max_seen, 108000);
+}
+
+TEST_F(RetryLogicTest, GetRetryPolicy_PerPath) {
+    EXPECT_EQ(get_retry_policy(&ctx, PATH_DIRECT), &ctx.direct_retry);
+    EXPECT_EQ(get_retry_policy(&ctx, PATH_CODEBIG), &ctx.codebig_retry);
+    EXPECT_EQ(get_retry_policy(&ctx, PATH_NONE), nullptr);
+    EXPECT_EQ(get_retry_policy(NULL, PATH_DIRECT), nullptr);
+}
+
+TEST_F(RetryLogicTest, Wait_ElapsesWithoutCancel) {
+    EXPECT_TRUE(retry_wait(0));
+    EXPECT_TRUE(retry_wait(20));
+}
+
+static void* cancel_after_delay(void*) {
+    usleep(50 * 1000);
+    retry_wait_cancel();
+    return NULL;
+}
+
+TEST_F(RetryLogicTest, Wait_CancelWakesWaiter) {
+    pthread_t thread;
+    ASSERT_EQ(pthread_create(&thread, NULL, cancel_after_delay, NULL), 0);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    EXPECT_FALSE(retry_wait(60000));
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_join(thread, NULL);
+
+    EXPECT_LT(end.tv_sec - start.tv_sec, 5);
+}
+
+TEST_F(RetryLogicTest, Wait_CancelIsStickyUntilReset) {
+    retry_wait_cancel();
+    EXPECT_FALSE(retry_wait(60000));
+    EXPECT_FALSE(retry_wait(0));
+
+    retry_wait_reset();
+    EXPECT_TRUE(retry_wait(0));
+}
+
+TEST_F(RetryLogicTest, RetryUpload_CancelledBackoffAborts) {
+    ctx.direct_retry.max_attempts = 3;
+    ctx.direct_retry.base_ms = 60000;
+    ctx.direct_retry.multiplier = 2;
+    ctx.direct_retry.cap_ms = 60000;
+    retry_wait_cancel();
+
+    UploadResult result = retry_upload(&ctx, &session, PATH_DIRECT, mock_upload_fail);
+
+    EXPECT_EQ(result, UPLOADSTB_ABORTED);
+    EXPECT_EQ(upload_call_count, 1);
+}
+
+TEST_F(RetryLogicTest, RetryUpload_LostRaceEndsBackoff) {
+    ctx.direct_retry.max_attempts = 3;
+    ctx.direct_retry.base_ms = 60000;
+    ctx.direct_retry.multiplier = 2;
+    ctx.direct_retry.cap_ms = 60000;
+    session.racer = (struct UploadRacer*)&ctx;  // Only compared against NULL here
+    g_mock_race_lost = true;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    UploadResult result = retry_upload(&ctx, &session, PATH_DIRECT, mock_upload_fail);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    EXPECT_EQ(result, UPLOADSTB_ABORTED);
+    EXPECT_EQ(upload_call_count, 1);
+    EXPECT_LT(end.tv_sec - start.tv_sec, 5);
+}
+
+TEST_F(RetryLogicTest, RetryUpload_WaitsBackoffBetweenAttempts) {
+    ctx.codebig_retry.max_attempts = 3;
+    ctx.codebig_retry.base_ms = 20;
+    ctx.codebig_retry.multiplier = 2;
+    ctx.codebig_retry.cap_ms = 1000;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    UploadResult result = retry_upload(&ctx, &session, PATH_CODEBIG, mock_upload_fail);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    EXPECT_EQ(result, UPLOADSTB_FAILED);
+    EXPECT_EQ(upload_call_count, 3);
+    long elapsed_ms = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    EXPECT_GE(elapsed_ms, 60);  // 20 ms + 40 ms, no jitter
+}
+
+// Tests for server-directed backoff
+TEST_F(RetryLogicTest, ParseRetryAfter_DeltaSeconds) {
+    EXPECT_EQ(parse_retry_after("120", 1000), 120);
+    EXPECT_EQ(parse_retry_after(" 5\r\n", 1000), 5);
+    EXPECT_EQ(parse_retry_after("0", 1000), 0);
+    EXPECT_EQ(parse_retry_after("999999", 1000), RETRY_AFTER_MAX_S);
+}
+
+TEST_F(RetryLogicTest, ParseRetryAfter_EpochAndHttpDate) {
+    time_t now = 1700000000;  // Tue, 14 Nov 2023 22:13:20 GMT
+
+    EXPECT_EQ(parse_retry_after("1700000300", now), 300);
+    EXPECT_EQ(parse_retry_after("Tue, 14 Nov 2023 22:15:20 GMT", now), 120);
+    EXPECT_EQ(parse_retry_after("Tue, 14 Nov 2023 22:00:00 GMT", now), 0);
+}
+
+TEST_F(RetryLogicTest, ParseRetryAfter_Invalid) {
+    EXPECT_EQ(parse_retry_after(NULL, 0), -1);
+    EXPECT_EQ(parse_retry_after("soon", 0), -1);
+    EXPECT_EQ(parse_retry_after("12abc", 0), -1);
+}
+
+TEST_F(RetryLogicTest, Deferral_PersistedAndExpires) {
+    time_t until = 0;
+    time_t now = time(NULL);
+
+    EXPECT_FALSE(upload_deferred(UPLOAD_NOT_BEFORE_FILE, now, &until));
+    ASSERT_EQ(defer_upload(UPLOAD_NOT_BEFORE_FILE, now + 100), 0);
+    EXPECT_TRUE(upload_deferred(UPLOAD_NOT_BEFORE_FILE, now, &until));
+    EXPECT_EQ(until, now + 100);
+
+    // An earlier deadline does not shorten the deferral
+    ASSERT_EQ(defer_upload(UPLOAD_NOT_BEFORE_FILE, now + 10), 0);
+    EXPECT_TRUE(upload_deferred(UPLOAD_NOT_BEFORE_FILE, now, &until));
+    EXPECT_EQ(until, now + 100);
+
+    EXPECT_FALSE(upload_deferred(UPLOAD_NOT_BEFORE_FILE, now + 101, &until));
+    EXPECT_EQ(access(UPLOAD_NOT_BEFORE_FILE, F_OK), -1);
+}
+
+TEST_F(RetryLogicTest, Deferral_ImplausibleEntryDiscarded) {
+    time_t now = time(NULL);
+    ASSERT_EQ(defer_upload(UPLOAD_NOT_BEFORE_FILE, now + 10 * RETRY_AFTER_MAX_S), 0);
+
+    EXPECT_FALSE(upload_deferred(UPLOAD_NOT_BEFORE_FILE, now, NULL));
+}
+
+TEST_F(RetryLogicTest, RetryUpload_HonorsRetryAfter) {
+    ctx.direct_retry.max_attempts = 2;
+    g_mock_retry_after = 1;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    UploadResult result = retry_upload(&ctx, &session, PATH_DIRECT, mock_upload_throttled);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    EXPECT_EQ(result, UPLOADSTB_FAILED);
+    EXPECT_EQ(upload_call_count, 2);
+    long elapsed_ms = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    EXPECT_GE(elapsed_ms, 1000);
+}
+
+TEST_F(RetryLogicTest, RetryUpload_LongRetryAfterDefers) {
+    ctx.direct_retry.max_attempts = 3;
+    g_mock_retry_after = RETRY_AFTER_DEFER_S + 1;
+
+    UploadResult result = retry_upload(&ctx, &session, PATH_DIRECT, mock_upload_throttled);
+
+    EXPECT_EQ(result, UPLOADSTB_ABORTED);
+    EXPECT_EQ(upload_call_count, 1);
+    EXPECT_TRUE(upload_deferred(UPLOAD_NOT_BEFORE_FILE, time(NULL), NULL));
+}
+
+TEST_F(RetryLogicTest, RetryUpload_ExhaustedWithRetryAfterDefers) {
+    ctx.direct_retry.max_attempts = 1;
+    g_mock_retry_after = 30;
+
+    UploadResult result = retry_upload(&ctx, &session, PATH_DIRECT, mock_upload_throttled);
+
+    EXPECT_EQ(result, UPLOADSTB_FAILED);
+    EXPECT_TRUE(upload_deferred(UPLOAD_NOT_BEFORE_FILE, time(NULL), NULL));
+}
+
+TEST_F(RetryLogicTest, RetryUpload_ThrottledUsesCappedDelay) {
+    ctx.direct_retry.max_attempts = 2;
+    ctx.direct_retry.base_ms = 10;
+    ctx.direct_retry.multiplier = 2;
+    ctx.direct_retry.cap_ms = 300;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    retry_upload(&ctx, &session, PATH_DIRECT, mock_upload_throttled);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    long elapsed_ms = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    EXPECT_GE(elapsed_ms, 300);  // Cap, not the 10 ms first step
+}
+
 // Entry point for the test executable
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -26,6 +26,7 @@
 #include <gmock/gmock.h>
 #include <thread>
 #include <chrono>
+#include <mutex>
 
 extern "C" {
 #include "uploadstblogs_types.h"
@@ -39,7 +40,6 @@ extern "C" {
 
 // External function declarations needed by strategies.c
 bool dir_exists(const char* dirpath);
-int add_timestamp_to_files(const char* dirpath);
 int collect_pcap_logs(RuntimeContext* ctx, const char* target_dir);
 int create_archive(RuntimeContext* ctx, SessionState* session, const char* source_dir);
 int upload_archive(RuntimeContext* ctx, SessionState* session, const char* archive_path);
@@ -57,13 +57,13 @@ void emit_no_logs_reboot(const RuntimeContext* ctx);
 void emit_no_logs_ondemand(void);
 bool create_directory(const char* dirpath);
 int collect_logs(const RuntimeContext* ctx, const SessionState* session, const char* dest_dir);
-int remove_timestamp_from_files(const char* dirpath);
 int move_directory_contents(const char* source_dir, const char* dest_dir);
 int clean_directory(const char* dirpath);
 bool rbus_get_bool_param(const char* param_name, bool* value);
 bool generate_archive_name(char* buffer, size_t buffer_size, const char* type, const char* timestamp);
 int create_dri_archive(RuntimeContext* ctx, SessionState* session, const char* archive_path);
 void t2_count_notify(char* marker);
+void emit_upload_result(const RuntimeContext* ctx, const SessionState* session);
 int cleanup_old_log_backups(const char* log_path, int max_age_days);
 
 // Mock sleep function to avoid delays in tests
@@ -102,9 +102,11 @@ bool copy_file(const char* src, const char* dest) {
 #define ONDEMAND_TEMP_DIR "/tmp/log_on_demand"
 }
 
+#include "archive_manager.h"
+#include "upload_index.h"
+
 // Mock implementations for external functions
 static bool g_mock_dir_exists = true;
-static int g_mock_add_timestamp_result = 0;
 static int g_mock_collect_pcap_result = 0;
 static int g_mock_create_archive_result = 0;
 static int g_mock_upload_archive_result = 0;
@@ -126,7 +128,6 @@ static int g_mock_cmdExec_call_count = 0;
 static int g_mock_FreeJson_call_count = 0;
 
 // Call tracking
-static int g_add_timestamp_call_count = 0;
 static int g_collect_pcap_call_count = 0;
 static int g_create_archive_call_count = 0;
 static int g_upload_archive_call_count = 0;
@@ -136,18 +137,22 @@ static int g_sleep_call_count = 0;
 static unsigned int g_last_sleep_seconds = 0;
 
 // Parameter tracking
-static char g_last_timestamp_dir[MAX_PATH_LENGTH];
 static char g_last_pcap_target_dir[MAX_PATH_LENGTH];
 static char g_last_archive_source_dir[MAX_PATH_LENGTH];
 static char g_last_upload_archive_path[MAX_PATH_LENGTH];
+static bool g_last_upload_no_spool = false;
+static bool g_dri_upload_no_spool = false;
 static char g_last_clear_log_path[MAX_PATH_LENGTH];
 static char g_last_remove_directory[MAX_PATH_LENGTH];
 
-int add_timestamp_to_files(const char* dirpath) {
-    g_add_timestamp_call_count++;
-    strncpy(g_last_timestamp_dir, dirpath, sizeof(g_last_timestamp_dir) - 1);
-    return g_mock_add_timestamp_result;
-}
+// Concurrent DRI upload tracking (upload_archive runs on two threads)
+static std::mutex g_upload_archive_mutex;
+static const char* g_mock_upload_fail_match = nullptr;   // Fail uploads whose path contains this
+static int g_upload_archive_in_flight = 0;
+static int g_upload_archive_max_in_flight = 0;
+static int g_emit_result_success_count = 0;
+static int g_emit_result_failure_count = 0;
+static char g_emit_result_order[2][MAX_PATH_LENGTH];
 
 int collect_pcap_logs(RuntimeContext* ctx, const char* target_dir) {
     g_collect_pcap_call_count++;
@@ -155,6 +160,102 @@ int collect_pcap_logs(RuntimeContext* ctx, const char* target_dir) {
     return g_mock_collect_pcap_result;
 }
 
+// Manifest mocks: DCM strategy archives log sources in place
+static int g_manifest_entry_count = 0;
+
+void archive_manifest_init(ArchiveManifest* manifest) {
+    if (manifest) memset(manifest, 0, sizeof(*manifest));
+}
+
+void archive_manifest_free(ArchiveManifest* manifest) {
+    g_manifest_entry_count = 0;
+    if (manifest) memset(manifest, 0, sizeof(*manifest));
+}
+
+int archive_manifest_add(ArchiveManifest* manifest, const char* src_path, const char* arcname) {
+    g_manifest_entry_count++;
+    return 0;
+}
+
+int archive_manifest_add_dir(ArchiveManifest* manifest, const char* src_dir, const char* arc_prefix) {
+    return 0;
+}
+
+bool archive_manifest_has_dir(const ArchiveManifest* manifest, const char* arc_dir) {
+    return false;
+}
+
+int collect_pcap_to_manifest(const RuntimeContext* ctx, ArchiveManifest* manifest) {
+    g_collect_pcap_call_count++;
+    return g_mock_collect_pcap_result;
+}
+
+int create_archive_from_manifest(RuntimeContext* ctx, SessionState* session,
+                                 ArchiveManifest* manifest, const char* output_dir) {
+    g_create_archive_call_count++;
+    strncpy(g_last_archive_source_dir, output_dir, sizeof(g_last_archive_source_dir) - 1);
+    return g_mock_create_archive_result;
+}
+
+// Upload index mocks: incremental DCM uploads
+static int g_upload_index_load_result = 0;
+static int g_upload_index_apply_call_count = 0;
+static int g_upload_index_commit_call_count = 0;
+static int g_upload_index_save_call_count = 0;
+
+void upload_index_init(UploadIndex* index) {
+    if (index) memset(index, 0, sizeof(*index));
+}
+
+void upload_index_free(UploadIndex* index) {
+    if (index) memset(index, 0, sizeof(*index));
+}
+
+int upload_index_load(UploadIndex* index, const char* path) {
+    return g_upload_index_load_result;
+}
+
+long long upload_index_apply(UploadIndex* index, ArchiveManifest* manifest) {
+    g_upload_index_apply_call_count++;
+    index->count = 1;
+    return 0;
+}
+
+int upload_index_commit(UploadIndex* index, const ArchiveManifest* manifest) {
+    g_upload_index_commit_call_count++;
+    return 0;
+}
+
+int upload_index_save(const UploadIndex* index, const char* path) {
+    g_upload_index_save_call_count++;
+    return 0;
+}
+
+// Name rule mocks: reboot strategy timestamps member names inside the archive
+static int g_create_archive_with_rule_call_count = 0;
+
+bool archive_name_rule_init(ArchiveNameRule* rule, time_t ref_time) {
+    if (rule) {
+        memset(rule, 0, sizeof(*rule));
+        strcpy(rule->prefix, "11-25-25-02-30PM-");
+    }
+    return true;
+}
+
+bool archive_name_rule_apply(const ArchiveNameRule* rule, const char* name,
+                             char* buffer, size_t buffer_size) {
+    snprintf(buffer, buffer_size, "%s%s", rule ? rule->prefix : "", name);
+    return true;
+}
+
+int create_archive_with_rule(RuntimeContext* ctx, SessionState* session, const char* source_dir,
+                             const ArchiveNameRule* rule, const ArchiveManifest* extra) {
+    g_create_archive_call_count++;
+    g_create_archive_with_rule_call_count++;
+    strncpy(g_last_archive_source_dir, source_dir, sizeof(g_last_archive_source_dir) - 1);
+    return g_mock_create_archive_result;
+}
+
 int clear_old_packet_captures(const char* log_path) {
     g_clear_packet_captures_call_count++;
     strncpy(g_last_clear_log_path, log_path, sizeof(g_last_clear_log_path) - 1);
@@ -209,8 +310,17 @@ void emit_upload_aborted(void) {
     // No-op for tests
 }
 
-int remove_timestamp_from_files(const char* dirpath) {
-    return 0; // Success
+// Mock for emit_upload_result used by strategies.c after concurrent uploads
+void emit_upload_result(const RuntimeContext* ctx, const SessionState* session) {
+    int n = g_emit_result_success_count + g_emit_result_failure_count;
+    if (n < 2) {
+        strncpy(g_emit_result_order[n], session->archive_file, MAX_PATH_LENGTH - 1);
+    }
+    if (session->success) {
+        g_emit_result_success_count++;
+    } else {
+        g_emit_result_failure_count++;
+    }
 }
 
 int move_directory_contents(const char* source_dir, const char* dest_dir) {
@@ -321,7 +431,6 @@ protected:
     void SetUp() override {
         // Reset mock states
         g_mock_dir_exists = true;
-        g_mock_add_timestamp_result = 0;
         g_mock_collect_pcap_result = 0;
         g_mock_create_archive_result = 0;
         g_mock_upload_archive_result = 0;
@@ -329,14 +438,19 @@ protected:
         g_mock_remove_directory_result = true;
         
         // Reset call counters
-        g_add_timestamp_call_count = 0;
         g_collect_pcap_call_count = 0;
         g_create_archive_call_count = 0;
         g_upload_archive_call_count = 0;
+        g_last_upload_no_spool = false;
+        g_dri_upload_no_spool = false;
         g_clear_packet_captures_call_count = 0;
         g_remove_directory_call_count = 0;
         g_sleep_call_count = 0;
         g_last_sleep_seconds = 0;
+        g_upload_index_load_result = 0;
+        g_upload_index_apply_call_count = 0;
+        g_upload_index_commit_call_count = 0;
+        g_upload_index_save_call_count = 0;
         
         // Initialize test context
         memset(&ctx, 0, sizeof(ctx));
@@ -369,8 +483,21 @@ TEST_F(StrategyDcmTest, SetupPhase_Success) {
     
     int result = dcm_strategy_handler.setup_phase(&ctx, &session);
     EXPECT_EQ(result, 0);
-    EXPECT_EQ(g_add_timestamp_call_count, 1);
-    // Note: collect_pcap_logs is called in archive phase, not setup
+    // Note: collect_pcap_to_manifest is called in archive phase, not setup
+}
+
+TEST_F(StrategyDcmTest, ArchivePhase_WritesToDcmLogPath) {
+    int result = dcm_strategy_handler.archive_phase(&ctx, &session);
+    EXPECT_EQ(result, 0);
+    EXPECT_STREQ(g_last_archive_source_dir, "/tmp/dcm_logs");
+}
+
+TEST_F(StrategyDcmTest, CleanupPhase_ReleasesManifest) {
+    g_manifest_entry_count = 5;
+
+    int result = dcm_strategy_handler.cleanup_phase(&ctx, &session, true);
+    EXPECT_EQ(result, 0);
+    EXPECT_EQ(g_manifest_entry_count, 0);
 }
 
 TEST_F(StrategyDcmTest, ArchivePhase_Success) {
@@ -395,6 +522,53 @@ TEST_F(StrategyDcmTest, UploadPhase_Success) {
     EXPECT_EQ(result, 0);
     EXPECT_EQ(g_upload_archive_call_count, 1);
     EXPECT_TRUE(session.success);
+    EXPECT_FALSE(g_last_upload_no_spool);
+}
+
+TEST_F(StrategyDcmTest, SetupPhase_IncrementalAppliesIndex) {
+    ctx.incremental_upload = true;
+
+    int result = dcm_strategy_handler.setup_phase(&ctx, &session);
+    EXPECT_EQ(result, 0);
+    EXPECT_EQ(g_upload_index_apply_call_count, 1);
+    EXPECT_TRUE(dcm_manifest.keep_head);
+    dcm_strategy_handler.cleanup_phase(&ctx, &session, false);
+}
+
+TEST_F(StrategyDcmTest, SetupPhase_IndexLoadFailureUploadsFullLogs) {
+    ctx.incremental_upload = true;
+    g_upload_index_load_result = -1;
+
+    int result = dcm_strategy_handler.setup_phase(&ctx, &session);
+    EXPECT_EQ(result, 0);
+    EXPECT_EQ(g_upload_index_apply_call_count, 0);
+    EXPECT_EQ(dcm_index.count, 0u);
+    dcm_strategy_handler.cleanup_phase(&ctx, &session, false);
+}
+
+TEST_F(StrategyDcmTest, UploadPhase_CommitsIndexOnlyOnSuccess) {
+    ctx.incremental_upload = true;
+    dcm_strategy_handler.setup_phase(&ctx, &session);
+
+    g_mock_upload_archive_result = -1;
+    dcm_strategy_handler.upload_phase(&ctx, &session);
+    EXPECT_EQ(g_upload_index_commit_call_count, 0);
+    // The uncommitted index resends these logs, the archive is not spooled
+    EXPECT_TRUE(g_last_upload_no_spool);
+    EXPECT_EQ(g_upload_index_save_call_count, 0);
+
+    g_mock_upload_archive_result = 0;
+    int result = dcm_strategy_handler.upload_phase(&ctx, &session);
+    EXPECT_EQ(result, 0);
+    EXPECT_EQ(g_upload_index_commit_call_count, 1);
+    EXPECT_EQ(g_upload_index_save_call_count, 1);
+    dcm_strategy_handler.cleanup_phase(&ctx, &session, true);
+}
+
+TEST_F(StrategyDcmTest, UploadPhase_NoIndexWhenNotIncremental) {
+    int result = dcm_strategy_handler.upload_phase(&ctx, &session);
+    EXPECT_EQ(result, 0);
+    EXPECT_EQ(g_upload_index_save_call_count, 0);
 }
 
 TEST_F(StrategyDcmTest, CleanupPhase_Success) {
@@ -502,17 +676,38 @@ extern "C" {
         if (g_mock_file_ops) {
             return g_mock_file_ops->upload_archive(ctx, session, archive_path);
         }
-        g_upload_archive_call_count++;
-        strncpy(g_last_upload_archive_path, archive_path, sizeof(g_last_upload_archive_path) - 1);
+        int result = g_mock_upload_archive_result;
+        {
+            std::lock_guard<std::mutex> lock(g_upload_archive_mutex);
+            g_upload_archive_call_count++;
+            strncpy(g_last_upload_archive_path, archive_path, sizeof(g_last_upload_archive_path) - 1);
+            if (strstr(archive_path, "DRI_Logs")) {
+                g_dri_upload_no_spool = session && session->no_spool;
+            } else {
+                g_last_upload_no_spool = session && session->no_spool;
+            }
+            if (g_mock_upload_fail_match && strstr(archive_path, g_mock_upload_fail_match)) {
+                result = -1;
+            }
+            if (++g_upload_archive_in_flight > g_upload_archive_max_in_flight) {
+                g_upload_archive_max_in_flight = g_upload_archive_in_flight;
+            }
+        }
+        // Give a concurrent upload the chance to overlap
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        {
+            std::lock_guard<std::mutex> lock(g_upload_archive_mutex);
+            g_upload_archive_in_flight--;
+        }
         
         // Simulate execute_upload_cycle behavior: set session->success based on result
-        if (session && g_mock_upload_archive_result == 0) {
+        if (session && result == 0) {
             session->success = true;
         } else if (session) {
             session->success = false;
         }
         
-        return g_mock_upload_archive_result;
+        return result;
     }
     
     void emit_no_logs_ondemand(void) {
@@ -702,6 +897,17 @@ TEST_F(StrategyRebootTest, ArchivePhase_Success) {
     EXPECT_EQ(g_create_archive_call_count, 1);
 }
 
+TEST_F(StrategyRebootTest, ArchivePhase_TimestampsMemberNamesOnly) {
+    g_create_archive_with_rule_call_count = 0;
+
+    EXPECT_EQ(reboot_strategy_handler.setup_phase(&ctx, &session), 0);
+    EXPECT_EQ(reboot_strategy_handler.archive_phase(&ctx, &session), 0);
+
+    // PREV_LOG_PATH is archived in place with a name rule, never renamed
+    EXPECT_EQ(g_create_archive_with_rule_call_count, 1);
+    EXPECT_STREQ(g_last_archive_source_dir, "/opt/PreviousLogs");
+}
+
 TEST_F(StrategyRebootTest, UploadPhase_Success) {
     g_mock_upload_archive_result = 0;
     
@@ -711,6 +917,78 @@ TEST_F(StrategyRebootTest, UploadPhase_Success) {
     EXPECT_TRUE(session.success);
 }
 
+class StrategyRebootDriTest : public StrategyRebootTest {
+protected:
+    void SetUp() override {
+        StrategyRebootTest::SetUp();
+        ctx.include_dri = true;
+        strcpy(ctx.dri_log_path, "/opt/logs/drilogs");
+        g_upload_archive_call_count = 0;
+        g_last_upload_no_spool = false;
+        g_dri_upload_no_spool = false;
+        g_upload_archive_in_flight = 0;
+        g_upload_archive_max_in_flight = 0;
+        g_remove_directory_call_count = 0;
+        g_last_remove_directory[0] = '\0';
+        g_mock_remove_directory_result = true;
+        g_mock_upload_fail_match = nullptr;
+        g_emit_result_success_count = 0;
+        g_emit_result_failure_count = 0;
+        memset(g_emit_result_order, 0, sizeof(g_emit_result_order));
+    }
+
+    void TearDown() override {
+        g_mock_upload_fail_match = nullptr;
+        StrategyRebootTest::TearDown();
+    }
+};
+
+TEST_F(StrategyRebootDriTest, UploadPhase_DriUploadedAlongsideMainArchive) {
+    int result = reboot_strategy_handler.upload_phase(&ctx, &session);
+
+    EXPECT_EQ(result, 0);
+    EXPECT_EQ(g_upload_archive_call_count, 2);
+    EXPECT_EQ(g_upload_archive_max_in_flight, 2);
+    EXPECT_TRUE(session.success);
+    EXPECT_FALSE(session.defer_events);
+    EXPECT_STREQ(g_last_remove_directory, "/opt/logs/drilogs");
+}
+
+TEST_F(StrategyRebootDriTest, UploadPhase_EventsEmittedMainFirst) {
+    reboot_strategy_handler.upload_phase(&ctx, &session);
+
+    EXPECT_EQ(g_emit_result_success_count, 2);
+    EXPECT_EQ(g_emit_result_failure_count, 0);
+    EXPECT_STREQ(g_emit_result_order[0], "reboot_logs.tar.gz");
+    EXPECT_STREQ(g_emit_result_order[1], "test_DRI_Logs.tgz");
+}
+
+TEST_F(StrategyRebootDriTest, UploadPhase_DriFailureDoesNotAffectMainResult) {
+    g_mock_upload_fail_match = "DRI_Logs";
+
+    int result = reboot_strategy_handler.upload_phase(&ctx, &session);
+
+    EXPECT_EQ(result, 0);
+    EXPECT_TRUE(session.success);
+    EXPECT_EQ(g_emit_result_success_count, 1);
+    EXPECT_EQ(g_emit_result_failure_count, 1);
+    // DRI logs are kept for the next attempt, so their archive is not spooled
+    EXPECT_EQ(g_remove_directory_call_count, 0);
+    EXPECT_TRUE(g_dri_upload_no_spool);
+    EXPECT_FALSE(g_last_upload_no_spool);
+}
+
+TEST_F(StrategyRebootDriTest, UploadPhase_NoDriDirectory_SingleUpload) {
+    ctx.include_dri = false;
+
+    int result = reboot_strategy_handler.upload_phase(&ctx, &session);
+
+    EXPECT_EQ(result, 0);
+    EXPECT_EQ(g_upload_archive_call_count, 1);
+    // Without a DRI upload the engine emits the events itself
+    EXPECT_EQ(g_emit_result_success_count + g_emit_result_failure_count, 0);
+}
+
 // ==================== INTEGRATION TESTS ====================
 
 class StrategiesIntegrationTest : public ::testing::Test {
@@ -718,7 +996,6 @@ protected:
     void SetUp() override {
         // Reset all mock states
         g_mock_dir_exists = true;
-        g_mock_add_timestamp_result = 0;
         g_mock_collect_pcap_result = 0;
         g_mock_create_archive_result = 0;
         g_mock_upload_archive_result = 0;
@@ -726,10 +1003,11 @@ protected:
         g_mock_remove_directory_result = true;
         
         // Reset all call counters
-        g_add_timestamp_call_count = 0;
         g_collect_pcap_call_count = 0;
         g_create_archive_call_count = 0;
         g_upload_archive_call_count = 0;
+        g_last_upload_no_spool = false;
+        g_dri_upload_no_spool = false;
         g_clear_packet_captures_call_count = 0;
         g_remove_directory_call_count = 0;
         g_sleep_call_count = 0;
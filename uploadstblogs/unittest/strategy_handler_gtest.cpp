@@ -28,6 +28,10 @@
 extern "C" {
 #include "uploadstblogs_types.h"
 #include "strategy_handler.h"
+#include "upload_http.h"
+#include "archive_manager.h"
+#include "path_handler.h"
+#include "retry_logic.h"
 int cleanup_old_archives(const char* log_path);
 }
 
@@ -54,8 +58,12 @@ static int mock_setup_phase(RuntimeContext* ctx, SessionState* session) {
     return g_mock_setup_result;
 }
 
+static ArchiveNamedHook g_archive_hook = nullptr;
+static ArchiveNamedHook g_hook_during_archive = nullptr;
+
 static int mock_archive_phase(RuntimeContext* ctx, SessionState* session) {
     g_archive_call_count++;
+    g_hook_during_archive = g_archive_hook;
     g_last_ctx = ctx;
     g_last_session = session;
     return g_mock_archive_result;
@@ -103,6 +111,34 @@ extern "C" int cleanup_old_archives(const char* log_path) {
     return 0; // Success
 }
 
+// Mock early metadata POST hooks
+static int g_cancel_early_post_count = 0;
+static bool g_mock_deferred = false;
+
+extern "C" void set_archive_named_hook(ArchiveNamedHook hook) {
+    g_archive_hook = hook;
+}
+
+extern "C" void start_early_metadata_post(RuntimeContext* ctx, SessionState* session, const char* archive_path) {
+}
+
+extern "C" void cancel_early_metadata_post(void) {
+    g_cancel_early_post_count++;
+}
+
+extern "C" bool upload_deferred(const char* path, time_t now, time_t* until) {
+    return g_mock_deferred;
+}
+
+static int g_spool_drain_count = 0;
+static int g_spool_drain_cleanup_count = -1;
+
+extern "C" int upload_spool_drain(RuntimeContext* ctx) {
+    g_spool_drain_count++;
+    g_spool_drain_cleanup_count = g_cleanup_call_count;
+    return 0;
+}
+
 // Override the external strategy handlers
 const StrategyHandler ondemand_strategy_handler = mock_ondemand_handler;
 const StrategyHandler reboot_strategy_handler = mock_reboot_handler;
@@ -129,6 +165,13 @@ protected:
         g_upload_call_count = 0;
         g_cleanup_call_count = 0;
         
+        g_archive_hook = nullptr;
+        g_hook_during_archive = nullptr;
+        g_cancel_early_post_count = 0;
+        g_mock_deferred = false;
+        g_spool_drain_count = 0;
+        g_spool_drain_cleanup_count = -1;
+
         g_cleanup_upload_success = false;
         g_last_ctx = nullptr;
         g_last_session = nullptr;
@@ -213,6 +256,30 @@ TEST_F(StrategyHandlerTest, GetStrategyHandler_InvalidStrategy) {
 }
 
 // Tests for execute_strategy_workflow function
+TEST_F(StrategyHandlerTest, ExecuteWorkflow_DrainsSpoolAfterUpload) {
+    session.strategy = STRAT_DCM;
+    ctx.trigger_type = TRIGGER_SCHEDULED;
+    EXPECT_EQ(execute_strategy_workflow(&ctx, &session), 0);
+    EXPECT_EQ(g_spool_drain_count, 1);
+    EXPECT_EQ(g_spool_drain_cleanup_count, 1);
+}
+
+TEST_F(StrategyHandlerTest, ExecuteWorkflow_NoDrainAfterFailedUpload) {
+    session.strategy = STRAT_DCM;
+    ctx.trigger_type = TRIGGER_SCHEDULED;
+    g_mock_upload_result = -1;
+    execute_strategy_workflow(&ctx, &session);
+    EXPECT_EQ(g_spool_drain_count, 0);
+}
+
+TEST_F(StrategyHandlerTest, ExecuteWorkflow_NoDrainForUserTriggers) {
+    ctx.trigger_type = TRIGGER_ONDEMAND;
+    EXPECT_EQ(execute_strategy_workflow(&ctx, &session), 0);
+    ctx.trigger_type = TRIGGER_MANUAL;
+    EXPECT_EQ(execute_strategy_workflow(&ctx, &session), 0);
+    EXPECT_EQ(g_spool_drain_count, 0);
+}
+
 TEST_F(StrategyHandlerTest, ExecuteWorkflow_Success_AllPhases) {
     session.strategy = STRAT_ONDEMAND;
     
@@ -441,6 +508,54 @@ TEST_F(StrategyHandlerTest, ExecuteWorkflow_PhaseSequencing) {
     EXPECT_EQ(g_cleanup_call_count, 1);
 }
 
+TEST_F(StrategyHandlerTest, ExecuteWorkflow_EarlyPostHookDuringArchiveOnly) {
+    ctx.upload_early_post = true;
+
+    EXPECT_EQ(execute_strategy_workflow(&ctx, &session), 0);
+    EXPECT_EQ(g_hook_during_archive, start_early_metadata_post);
+    EXPECT_EQ(g_archive_hook, nullptr);
+    EXPECT_EQ(g_cancel_early_post_count, 1);
+}
+
+TEST_F(StrategyHandlerTest, ExecuteWorkflow_EarlyPostNeedsNoDigest) {
+    ctx.upload_early_post = true;
+    ctx.encryption_enable = true;
+
+    EXPECT_EQ(execute_strategy_workflow(&ctx, &session), 0);
+    EXPECT_EQ(g_hook_during_archive, nullptr);
+    EXPECT_EQ(g_cancel_early_post_count, 0);
+}
+
+TEST_F(StrategyHandlerTest, ExecuteWorkflow_EarlyPostOnlyForCertainUploads) {
+    ctx.upload_early_post = true;
+
+    // Upload flag off: ONDEMAND archives are not sent
+    ctx.flag = false;
+    execute_strategy_workflow(&ctx, &session);
+    EXPECT_EQ(g_hook_during_archive, nullptr);
+
+    // Reboot in DCM mode: the reboot reason decides later
+    session.strategy = STRAT_REBOOT;
+    ctx.dcm_flag = 1;
+    ctx.upload_on_reboot = 0;
+    execute_strategy_workflow(&ctx, &session);
+    EXPECT_EQ(g_hook_during_archive, nullptr);
+
+    ctx.upload_on_reboot = 1;
+    execute_strategy_workflow(&ctx, &session);
+    EXPECT_EQ(g_hook_during_archive, start_early_metadata_post);
+}
+
+TEST_F(StrategyHandlerTest, ExecuteWorkflow_EarlyPostSkippedWhileDeferred) {
+    ctx.upload_early_post = true;
+    session.strategy = STRAT_DCM;
+    ctx.trigger_type = TRIGGER_SCHEDULED;
+    g_mock_deferred = true;
+
+    execute_strategy_workflow(&ctx, &session);
+    EXPECT_EQ(g_hook_during_archive, nullptr);
+}
+
 // Entry point for the test executable
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
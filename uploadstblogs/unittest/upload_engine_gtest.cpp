@@ -37,9 +37,19 @@ UploadResult execute_codebig_path(RuntimeContext* ctx, SessionState* session);
 UploadResult retry_upload(RuntimeContext* ctx, SessionState* session, UploadPath path, 
                          UploadResult (*single_attempt)(RuntimeContext*, SessionState*, UploadPath));
 
+// Mock server deferral check from retry_logic
+bool upload_deferred(const char* path, time_t now, time_t* until);
+
 // Mock functions for event_manager
 void emit_upload_success(RuntimeContext* ctx, SessionState* session);
 void emit_upload_failure(RuntimeContext* ctx, SessionState* session);
+void emit_upload_result(const RuntimeContext* ctx, const SessionState* session);
+
+// Mock functions for upload_hedge
+#include "upload_hedge.h"
+
+// Mock functions for upload_spool
+int upload_spool_add(const RuntimeContext* ctx, const SessionState* session, const char* archive_path);
 
 // Mock functions for file_operations
 bool file_exists(const char* filepath);
@@ -55,10 +65,21 @@ UploadResult g_mock_path_result = UPLOADSTB_SUCCESS;
 UploadResult g_mock_retry_result = UPLOADSTB_SUCCESS;
 bool g_mock_file_exists = true;
 long g_mock_file_size = 1024;
+bool g_mock_upload_deferred = false;
+int g_mock_post_http_code = 0;
+int g_hedged_upload_calls = 0;
+long g_hedged_delay_ms = 0;
+UploadResult g_mock_hedged_result = UPLOADSTB_SUCCESS;
+int g_latency_record_calls = 0;
+UploadPath g_latency_record_path = PATH_NONE;
+long g_latency_record_ms = 0;
+int g_spool_add_calls = 0;
 
 // Mock implementations
 UploadResult execute_direct_path(RuntimeContext* ctx, SessionState* session) {
     g_execute_direct_called = true;
+    session->post.http_code = g_mock_post_http_code;
+    session->post.elapsed_ms = 1234;
     return g_mock_path_result;
 }
 
@@ -73,6 +94,13 @@ UploadResult retry_upload(RuntimeContext* ctx, SessionState* session, UploadPath
     return g_mock_retry_result;
 }
 
+bool upload_deferred(const char* path, time_t now, time_t* until) {
+    if (g_mock_upload_deferred && until) {
+        *until = now + 600;
+    }
+    return g_mock_upload_deferred;
+}
+
 void emit_upload_success(RuntimeContext* ctx, SessionState* session) {
     g_emit_success_called = true;
 }
@@ -81,6 +109,43 @@ void emit_upload_failure(RuntimeContext* ctx, SessionState* session) {
     g_emit_failure_called = true;
 }
 
+void emit_upload_result(const RuntimeContext* ctx, const SessionState* session) {
+    if (session->success) {
+        g_emit_success_called = true;
+    } else {
+        g_emit_failure_called = true;
+    }
+}
+
+int path_latency_load(const char* file, PathLatency stats[2]) {
+    return -1;
+}
+
+int path_latency_record(const char* file, UploadPath path, long sample_ms) {
+    g_latency_record_calls++;
+    g_latency_record_path = path;
+    g_latency_record_ms = sample_ms;
+    return 0;
+}
+
+long hedge_delay_ms(const RuntimeContext* ctx, const PathLatency* stats) {
+    return ctx->hedge_delay_ms > 0 ? ctx->hedge_delay_ms : 15000;
+}
+
+UploadResult hedged_upload(RuntimeContext* ctx, SessionState* session, long delay_ms,
+                           UploadResult (*attempt_func)(RuntimeContext*, SessionState*, UploadPath)) {
+    g_hedged_upload_calls++;
+    g_hedged_delay_ms = delay_ms;
+    // Both paths ran
+    session->used_fallback = true;
+    return g_mock_hedged_result;
+}
+
+int upload_spool_add(const RuntimeContext* ctx, const SessionState* session, const char* archive_path) {
+    g_spool_add_calls++;
+    return 0;
+}
+
 bool file_exists(const char* filepath) {
     return g_mock_file_exists;
 }
@@ -109,6 +174,15 @@ protected:
         g_mock_retry_result = UPLOADSTB_SUCCESS;
         g_mock_file_exists = true;
         g_mock_file_size = 1024;
+        g_mock_upload_deferred = false;
+        g_mock_post_http_code = 0;
+        g_hedged_upload_calls = 0;
+        g_hedged_delay_ms = 0;
+        g_mock_hedged_result = UPLOADSTB_SUCCESS;
+        g_latency_record_calls = 0;
+        g_latency_record_path = PATH_NONE;
+        g_latency_record_ms = 0;
+        g_spool_add_calls = 0;
         
         // Set up context and session
         memset(&ctx, 0, sizeof(RuntimeContext));
@@ -135,6 +209,25 @@ protected:
     SessionState session;
 };
 
+// Test the server-requested deferral
+TEST_F(UploadEngineTest, ExecuteUploadCycle_DeferredSkipsUpload) {
+    g_mock_upload_deferred = true;
+    ctx.trigger_type = TRIGGER_SCHEDULED;
+
+    EXPECT_FALSE(execute_upload_cycle(&ctx, &session));
+    EXPECT_FALSE(g_retry_upload_called);
+    EXPECT_TRUE(g_emit_failure_called);
+    EXPECT_FALSE(session.success);
+}
+
+TEST_F(UploadEngineTest, ExecuteUploadCycle_DeferralIgnoredOnDemand) {
+    g_mock_upload_deferred = true;
+    ctx.trigger_type = TRIGGER_ONDEMAND;
+
+    EXPECT_TRUE(execute_upload_cycle(&ctx, &session));
+    EXPECT_TRUE(g_retry_upload_called);
+}
+
 // Test execute_upload_cycle function
 TEST_F(UploadEngineTest, ExecuteUploadCycle_NullContext) {
     bool result = execute_upload_cycle(nullptr, &session);
@@ -159,6 +252,67 @@ TEST_F(UploadEngineTest, ExecuteUploadCycle_PrimarySuccess) {
     EXPECT_FALSE(g_emit_failure_called);
 }
 
+TEST_F(UploadEngineTest, ExecuteUploadCycle_DeferredEventsLeftToCaller) {
+    session.defer_events = true;
+
+    g_mock_retry_result = UPLOADSTB_SUCCESS;
+    EXPECT_TRUE(execute_upload_cycle(&ctx, &session));
+    g_mock_retry_result = UPLOADSTB_FAILED;
+    EXPECT_FALSE(execute_upload_cycle(&ctx, &session));
+
+    EXPECT_FALSE(g_emit_success_called);
+    EXPECT_FALSE(g_emit_failure_called);
+}
+
+TEST_F(UploadEngineTest, ExecuteUploadCycle_NotHedgedByDefault) {
+    EXPECT_TRUE(execute_upload_cycle(&ctx, &session));
+    EXPECT_EQ(g_hedged_upload_calls, 0);
+    EXPECT_TRUE(g_retry_upload_called);
+}
+
+TEST_F(UploadEngineTest, ExecuteUploadCycle_HedgedWhenConfigured) {
+    ctx.hedge_delay_ms = 4000;
+
+    EXPECT_TRUE(execute_upload_cycle(&ctx, &session));
+    EXPECT_EQ(g_hedged_upload_calls, 1);
+    EXPECT_EQ(g_hedged_delay_ms, 4000);
+    EXPECT_FALSE(g_retry_upload_called);
+    EXPECT_TRUE(g_emit_success_called);
+}
+
+TEST_F(UploadEngineTest, ExecuteUploadCycle_HedgedFailureSkipsSecondFallback) {
+    ctx.hedge_delay_ms = HEDGE_DELAY_AUTO;
+    g_mock_hedged_result = UPLOADSTB_FAILED;
+
+    EXPECT_FALSE(execute_upload_cycle(&ctx, &session));
+    EXPECT_EQ(g_hedged_upload_calls, 1);
+    EXPECT_EQ(g_hedged_delay_ms, 15000);
+    EXPECT_FALSE(g_retry_upload_called);
+    EXPECT_TRUE(g_emit_failure_called);
+}
+
+TEST_F(UploadEngineTest, ExecuteUploadCycle_NoHedgeWithoutFallback) {
+    ctx.hedge_delay_ms = 4000;
+    session.fallback = PATH_NONE;
+
+    EXPECT_TRUE(execute_upload_cycle(&ctx, &session));
+    EXPECT_EQ(g_hedged_upload_calls, 0);
+    EXPECT_TRUE(g_retry_upload_called);
+}
+
+TEST_F(UploadEngineTest, SingleAttempt_RecordsPostLatency) {
+    g_mock_post_http_code = 200;
+    single_attempt_upload(&ctx, &session, PATH_DIRECT);
+    EXPECT_EQ(g_latency_record_calls, 1);
+    EXPECT_EQ(g_latency_record_path, PATH_DIRECT);
+    EXPECT_EQ(g_latency_record_ms, 1234);
+
+    // No answer and no timeout: nothing was measured
+    g_mock_post_http_code = 0;
+    single_attempt_upload(&ctx, &session, PATH_DIRECT);
+    EXPECT_EQ(g_latency_record_calls, 1);
+}
+
 TEST_F(UploadEngineTest, ExecuteUploadCycle_PrimaryFailFallbackSuccess) {
     // Setup mock to return different results for consecutive calls
     static int call_count = 0;
@@ -237,6 +391,15 @@ TEST_F(UploadEngineTest, AttemptUpload_CodebigPath) {
     EXPECT_TRUE(g_retry_upload_called);
 }
 
+TEST_F(UploadEngineTest, AttemptUploadOnce_SkipsRetries) {
+    g_mock_path_result = UPLOADSTB_FAILED;
+
+    EXPECT_EQ(attempt_upload_once(&ctx, &session, PATH_DIRECT), UPLOADSTB_FAILED);
+    EXPECT_TRUE(g_execute_direct_called);
+    EXPECT_FALSE(g_retry_upload_called);
+    EXPECT_EQ(attempt_upload_once(nullptr, &session, PATH_DIRECT), UPLOADSTB_FAILED);
+}
+
 // Test should_fallback function
 TEST_F(UploadEngineTest, ShouldFallback_NullContext) {
     bool result = should_fallback(nullptr, &session, UPLOADSTB_FAILED);
@@ -363,6 +526,29 @@ TEST_F(UploadEngineTest, UploadArchive_UploadFails) {
     EXPECT_FALSE(g_emit_success_called);
 }
 
+TEST_F(UploadEngineTest, UploadArchive_FailureSpoolsArchive) {
+    g_mock_retry_result = UPLOADSTB_FAILED;
+    ctx.trigger_type = TRIGGER_SCHEDULED;
+    EXPECT_EQ(upload_archive(&ctx, &session, "/tmp/test.tar.gz"), -1);
+    EXPECT_EQ(g_spool_add_calls, 1);
+
+    // MEMCAPTURE archives stay where they are
+    ctx.trigger_type = TRIGGER_MEMCAPTURE;
+    EXPECT_EQ(upload_archive(&ctx, &session, "/tmp/test.tar.gz"), -1);
+    EXPECT_EQ(g_spool_add_calls, 1);
+
+    // Nor are archives whose sources the caller keeps
+    ctx.trigger_type = TRIGGER_SCHEDULED;
+    session.no_spool = true;
+    EXPECT_EQ(upload_archive(&ctx, &session, "/tmp/test.tar.gz"), -1);
+    EXPECT_EQ(g_spool_add_calls, 1);
+
+    g_mock_retry_result = UPLOADSTB_SUCCESS;
+    session.no_spool = false;
+    EXPECT_EQ(upload_archive(&ctx, &session, "/tmp/test.tar.gz"), 0);
+    EXPECT_EQ(g_spool_add_calls, 1);
+}
+
 // Test edge cases and integration scenarios
 TEST_F(UploadEngineTest, UploadCycle_AbortedResult) {
     g_mock_retry_result = UPLOADSTB_ABORTED;
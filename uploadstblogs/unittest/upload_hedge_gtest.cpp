@@ -0,0 +1,287 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <stdio.h>
+#include <unistd.h>
+
+// Mock RDK_LOG before including other headers
+#ifdef GTEST_ENABLE
+#define RDK_LOG(level, module, ...) do {} while(0)
+#endif
+
+#include "uploadstblogs_types.h"
+
+#define UPLOAD_LATENCY_FILE "/tmp/upload_hedge_test_latency"
+
+extern "C" {
+#include "../src/upload_hedge.c"
+}
+
+using namespace std;
+
+/**
+ * @brief Scripted behaviour of one path for the fake attempt function
+ */
+struct FakePath {
+    int post_ms;                    // Time until the metadata POST is answered
+    int put_ms;                     // Time of the S3 PUT after it
+    UploadResult result;
+    atomic<int> calls;
+    atomic<bool> stopped_lost;      // Saw the race lost before or during its PUT
+    atomic<bool> finished;
+};
+
+static FakePath g_paths[2];
+
+static UploadResult fake_attempt(RuntimeContext* ctx, SessionState* session, UploadPath path)
+{
+    FakePath& fake = g_paths[path];
+    int post_ms = fake.post_ms;
+    int put_ms = fake.put_ms;
+    UploadResult result = fake.result;
+    fake.calls++;
+    if (path == PATH_DIRECT) {
+        session->direct_attempts++;
+    } else {
+        session->codebig_attempts++;
+    }
+    session->http_code = (path == PATH_DIRECT) ? 201 : 202;
+
+    this_thread::sleep_for(chrono::milliseconds(post_ms));
+    if (result == UPLOADSTB_SUCCESS) {
+        upload_race_post_done(session->racer);
+    }
+    // The PUT polls the race like the transfer's cancel check does
+    for (int waited = 0; ; waited += 5) {
+        if (upload_race_lost(session->racer)) {
+            fake.stopped_lost = true;
+            fake.finished = true;
+            return UPLOADSTB_ABORTED;
+        }
+        if (waited >= put_ms) {
+            break;
+        }
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+    fake.finished = true;
+    return result;
+}
+
+class UploadHedgeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        unlink(UPLOAD_LATENCY_FILE);
+        memset(&ctx, 0, sizeof(ctx));
+        memset(&session, 0, sizeof(session));
+        session.primary = PATH_DIRECT;
+        session.fallback = PATH_CODEBIG;
+        for (FakePath& fake : g_paths) {
+            fake.post_ms = 0;
+            fake.put_ms = 0;
+            fake.result = UPLOADSTB_SUCCESS;
+            fake.calls = 0;
+            fake.stopped_lost = false;
+            fake.finished = false;
+        }
+    }
+
+    void TearDown() override {
+        unlink(UPLOAD_LATENCY_FILE);
+    }
+
+    RuntimeContext ctx;
+    SessionState session;
+};
+
+TEST_F(UploadHedgeTest, LatencyUpdate_FirstSampleAndSmoothing) {
+    PathLatency stats = {0, 0, 0};
+    path_latency_update(&stats, 1000);
+    EXPECT_EQ(stats.srtt_ms, 1000);
+    EXPECT_EQ(stats.rttvar_ms, 500);
+    EXPECT_EQ(stats.samples, 1);
+
+    path_latency_update(&stats, 2600);
+    EXPECT_EQ(stats.rttvar_ms, (3 * 500 + 1600) / 4);
+    EXPECT_EQ(stats.srtt_ms, (7 * 1000 + 2600) / 8);
+    EXPECT_EQ(stats.samples, 2);
+
+    path_latency_update(&stats, -1);
+    EXPECT_EQ(stats.samples, 2);
+}
+
+TEST_F(UploadHedgeTest, LatencyRecord_PersistsPerPath) {
+    PathLatency stats[2];
+    EXPECT_EQ(path_latency_load(UPLOAD_LATENCY_FILE, stats), -1);
+    EXPECT_EQ(stats[PATH_DIRECT].samples, 0);
+
+    EXPECT_EQ(path_latency_record(UPLOAD_LATENCY_FILE, PATH_DIRECT, 800), 0);
+    EXPECT_EQ(path_latency_record(UPLOAD_LATENCY_FILE, PATH_CODEBIG, 300), 0);
+    EXPECT_EQ(path_latency_record(UPLOAD_LATENCY_FILE, PATH_DIRECT, 800), 0);
+    EXPECT_EQ(path_latency_record(UPLOAD_LATENCY_FILE, PATH_NONE, 800), -1);
+
+    EXPECT_EQ(path_latency_load(UPLOAD_LATENCY_FILE, stats), 0);
+    EXPECT_EQ(stats[PATH_DIRECT].samples, 2);
+    EXPECT_EQ(stats[PATH_DIRECT].srtt_ms, 800);
+    EXPECT_EQ(stats[PATH_CODEBIG].samples, 1);
+    EXPECT_EQ(stats[PATH_CODEBIG].srtt_ms, 300);
+}
+
+TEST_F(UploadHedgeTest, LatencyLoad_IgnoresGarbage) {
+    FILE* fp = fopen(UPLOAD_LATENCY_FILE, "w");
+    ASSERT_NE(fp, nullptr);
+    fprintf(fp, "direct -5 10 3\ncodebig 400 100 4\n");
+    fclose(fp);
+
+    PathLatency stats[2];
+    EXPECT_EQ(path_latency_load(UPLOAD_LATENCY_FILE, stats), 0);
+    EXPECT_EQ(stats[PATH_DIRECT].samples, 0);
+    EXPECT_EQ(stats[PATH_CODEBIG].srtt_ms, 400);
+}
+
+TEST_F(UploadHedgeTest, Delay_FixedAutoAndBounds) {
+    PathLatency stats = {1000, 500, HEDGE_MIN_SAMPLES};
+
+    ctx.hedge_delay_ms = 750;
+    EXPECT_EQ(hedge_delay_ms(&ctx, &stats), 750);
+
+    ctx.hedge_delay_ms = HEDGE_DELAY_AUTO;
+    EXPECT_EQ(hedge_delay_ms(&ctx, &stats), 3000);
+    EXPECT_EQ(hedge_delay_ms(&ctx, NULL), HEDGE_DEFAULT_DELAY_MS);
+
+    stats.samples = HEDGE_MIN_SAMPLES - 1;
+    EXPECT_EQ(hedge_delay_ms(&ctx, &stats), HEDGE_DEFAULT_DELAY_MS);
+
+    PathLatency fast = {100, 20, 10};
+    EXPECT_EQ(hedge_delay_ms(&ctx, &fast), HEDGE_MIN_DELAY_MS);
+    PathLatency slow = {100000, 50000, 10};
+    EXPECT_EQ(hedge_delay_ms(&ctx, &slow), HEDGE_MAX_DELAY_MS);
+}
+
+TEST_F(UploadHedgeTest, Race_FastPrimaryNoHedge) {
+    g_paths[PATH_DIRECT].post_ms = 10;
+    g_paths[PATH_DIRECT].put_ms = 100;
+
+    EXPECT_EQ(hedged_upload(&ctx, &session, 50, fake_attempt), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(g_paths[PATH_CODEBIG].calls, 0);
+    EXPECT_FALSE(session.used_fallback);
+    EXPECT_EQ(session.direct_attempts, 1);
+    EXPECT_EQ(session.codebig_attempts, 0);
+    EXPECT_EQ(session.racer, nullptr);
+}
+
+TEST_F(UploadHedgeTest, Race_PrimaryFailsBeforeDeadline) {
+    g_paths[PATH_DIRECT].result = UPLOADSTB_FAILED;
+
+    EXPECT_EQ(hedged_upload(&ctx, &session, 500, fake_attempt), UPLOADSTB_FAILED);
+    EXPECT_EQ(g_paths[PATH_CODEBIG].calls, 0);
+    // The caller still gets to try the fallback path
+    EXPECT_FALSE(session.used_fallback);
+}
+
+TEST_F(UploadHedgeTest, Race_SlowPrimaryFallbackWins) {
+    g_paths[PATH_DIRECT].post_ms = 400;
+    g_paths[PATH_CODEBIG].post_ms = 10;
+
+    auto start = chrono::steady_clock::now();
+    EXPECT_EQ(hedged_upload(&ctx, &session, 50, fake_attempt), UPLOADSTB_SUCCESS);
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    // Returns once the slow Direct POST is answered, not HEDGE_JOIN_TIMEOUT_MS later
+    EXPECT_LT(elapsed, 1000);
+    EXPECT_EQ(g_paths[PATH_CODEBIG].calls, 1);
+    EXPECT_TRUE(session.used_fallback);
+    EXPECT_EQ(session.http_code, 202);
+    EXPECT_EQ(session.codebig_attempts, 1);
+    EXPECT_EQ(session.direct_attempts, 1);
+    EXPECT_EQ(session.primary, PATH_DIRECT);
+
+    // The slow Direct attempt noticed it lost and skipped its PUT before the return
+    EXPECT_TRUE(g_paths[PATH_DIRECT].finished);
+    EXPECT_TRUE(g_paths[PATH_DIRECT].stopped_lost);
+}
+
+TEST_F(UploadHedgeTest, Race_LoserPutAbortedBeforeReturn) {
+    g_paths[PATH_DIRECT].post_ms = 100;
+    g_paths[PATH_DIRECT].put_ms = 50;
+    g_paths[PATH_CODEBIG].post_ms = 10;
+    g_paths[PATH_CODEBIG].put_ms = 5000;
+
+    auto start = chrono::steady_clock::now();
+    EXPECT_EQ(hedged_upload(&ctx, &session, 20, fake_attempt), UPLOADSTB_SUCCESS);
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(session.http_code, 201);
+    // CodeBig was mid-PUT when Direct won: stopped, and joined before the return
+    EXPECT_TRUE(g_paths[PATH_CODEBIG].finished);
+    EXPECT_TRUE(g_paths[PATH_CODEBIG].stopped_lost);
+    EXPECT_LT(elapsed, 2000);
+}
+
+TEST_F(UploadHedgeTest, Race_SlowPrimaryStillWinsIfFirst) {
+    g_paths[PATH_DIRECT].post_ms = 80;
+    g_paths[PATH_CODEBIG].post_ms = 10;
+    g_paths[PATH_CODEBIG].put_ms = 400;
+
+    EXPECT_EQ(hedged_upload(&ctx, &session, 20, fake_attempt), UPLOADSTB_SUCCESS);
+    EXPECT_TRUE(session.used_fallback);
+    EXPECT_EQ(session.http_code, 201);
+}
+
+TEST_F(UploadHedgeTest, Race_BothFail) {
+    g_paths[PATH_DIRECT].post_ms = 100;
+    g_paths[PATH_DIRECT].result = UPLOADSTB_FAILED;
+    g_paths[PATH_CODEBIG].result = UPLOADSTB_FAILED;
+
+    EXPECT_EQ(hedged_upload(&ctx, &session, 20, fake_attempt), UPLOADSTB_FAILED);
+    EXPECT_EQ(g_paths[PATH_DIRECT].calls, 1);
+    EXPECT_EQ(g_paths[PATH_CODEBIG].calls, 1);
+    // Both paths were tried: no second fallback
+    EXPECT_TRUE(session.used_fallback);
+    EXPECT_EQ(session.direct_attempts, 1);
+    EXPECT_EQ(session.codebig_attempts, 1);
+}
+
+TEST_F(UploadHedgeTest, Race_FailedFallbackWaitsForPrimary) {
+    g_paths[PATH_DIRECT].post_ms = 150;
+    g_paths[PATH_CODEBIG].result = UPLOADSTB_FAILED;
+
+    EXPECT_EQ(hedged_upload(&ctx, &session, 20, fake_attempt), UPLOADSTB_SUCCESS);
+    EXPECT_EQ(session.http_code, 201);
+    EXPECT_EQ(session.codebig_attempts, 1);
+}
+
+TEST_F(UploadHedgeTest, Race_NullParameters) {
+    EXPECT_EQ(hedged_upload(NULL, &session, 20, fake_attempt), UPLOADSTB_FAILED);
+    EXPECT_EQ(hedged_upload(&ctx, NULL, 20, fake_attempt), UPLOADSTB_FAILED);
+    EXPECT_EQ(hedged_upload(&ctx, &session, 20, NULL), UPLOADSTB_FAILED);
+    upload_race_post_done(NULL);
+    EXPECT_FALSE(upload_race_lost(NULL));
+}
+
+// Main test runner
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
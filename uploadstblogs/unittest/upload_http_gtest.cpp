@@ -0,0 +1,428 @@
+/**
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstring>
+#include <stdio.h>
+#include <string>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// Mock RDK_LOG before including other headers
+#ifdef GTEST_ENABLE
+#define RDK_LOG(level, module, ...) do {} while(0)
+#endif
+
+#include "uploadstblogs_types.h"
+
+// Include the source file to test internal functions
+extern "C" {
+// Mock retry_logic header parsing
+int parse_retry_after(const char* value, time_t now) {
+    (void)now;
+    return (value && atoi(value) > 0) ? atoi(value) : -1;
+}
+
+#include "../src/upload_http.c"
+}
+
+using namespace testing;
+using namespace std;
+
+#define UHTTP_TEST_FILE "/tmp/upload_http_test_body"
+
+/**
+ * Minimal keep-alive HTTP/1.1 server on 127.0.0.1 answering every request
+ * with a fixed status and extra headers, recording bodies and connections.
+ */
+class LocalHttpServer {
+public:
+    LocalHttpServer() {
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr));
+        listen(listen_fd, 8);
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd, (struct sockaddr*)&addr, &len);
+        port = ntohs(addr.sin_port);
+        worker = thread(&LocalHttpServer::Run, this);
+    }
+
+    ~LocalHttpServer() {
+        stop = true;
+        worker.join();
+        for (auto& c : clients) {
+            close(c.first);
+        }
+        close(listen_fd);
+    }
+
+    string Url(const char* path = "/bucket/logs.tgz?sig=abc") const {
+        return "http://127.0.0.1:" + to_string(port) + path;
+    }
+
+    int status = 200;
+    string extra_headers;
+    atomic<int> accepts{0};
+    atomic<int> requests{0};
+    string last_body;
+
+private:
+    void Run() {
+        while (!stop) {
+            vector<struct pollfd> fds;
+            fds.push_back({listen_fd, POLLIN, 0});
+            for (auto& c : clients) {
+                fds.push_back({c.first, POLLIN, 0});
+            }
+            if (poll(fds.data(), fds.size(), 50) <= 0) {
+                continue;
+            }
+            if (fds[0].revents & POLLIN) {
+                int fd = accept(listen_fd, NULL, NULL);
+                if (fd >= 0) {
+                    clients[fd] = "";
+                    accepts++;
+                }
+            }
+            for (size_t i = 1; i < fds.size(); i++) {
+                if (fds[i].revents) {
+                    Serve(fds[i].fd);
+                }
+            }
+        }
+    }
+
+    void Serve(int fd) {
+        char buf[4096];
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            close(fd);
+            clients.erase(fd);
+            return;
+        }
+        string& in = clients[fd];
+        in.append(buf, n);
+
+        size_t hdr_end = in.find("\r\n\r\n");
+        if (hdr_end == string::npos) {
+            return;
+        }
+        string headers = in.substr(0, hdr_end);
+        size_t content_length = 0;
+        size_t pos = headers.find("Content-Length:");
+        if (pos != string::npos) {
+            content_length = strtoul(headers.c_str() + pos + 15, NULL, 10);
+        }
+        size_t body_have = in.size() - hdr_end - 4;
+        if (body_have < content_length) {
+            if (headers.find("100-continue") != string::npos && !continued[fd]) {
+                Send(fd, "HTTP/1.1 100 Continue\r\n\r\n");
+                continued[fd] = true;
+            }
+            return;
+        }
+
+        last_body = in.substr(hdr_end + 4, content_length);
+        in.erase(0, hdr_end + 4 + content_length);
+        continued[fd] = false;
+        requests++;
+        Send(fd, "HTTP/1.1 " + to_string(status) + " Test\r\nContent-Length: 0\r\n" + extra_headers + "\r\n");
+    }
+
+    static void Send(int fd, const string& data) {
+        send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+    }
+
+    int listen_fd = -1;
+    int port = 0;
+    atomic<bool> stop{false};
+    thread worker;
+    map<int, string> clients;
+    map<int, bool> continued;
+};
+
+class UploadHttpTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        FILE* fp = fopen(UHTTP_TEST_FILE, "w");
+        ASSERT_NE(fp, nullptr);
+        fputs("log archive payload", fp);
+        fclose(fp);
+        memset(&resp, 0, sizeof(resp));
+    }
+
+    void TearDown() override {
+        upload_http_set_rate_limit(0, false);
+        upload_http_cleanup();
+        unlink(UHTTP_TEST_FILE);
+    }
+
+    UploadResponse resp;
+};
+
+TEST_F(UploadHttpTest, Put_UploadsFileBody) {
+    LocalHttpServer server;
+
+    EXPECT_EQ(upload_http_put(server.Url().c_str(), UHTTP_TEST_FILE, NULL, false, 5, NULL, &resp), 0);
+    EXPECT_EQ(resp.http_code, 200);
+    EXPECT_EQ(resp.curl_code, 0);
+    EXPECT_EQ(resp.retry_after, 0);
+    EXPECT_EQ(server.last_body, "log archive payload");
+}
+
+TEST_F(UploadHttpTest, Put_SecondRequestReusesConnection) {
+    LocalHttpServer server;
+
+    ASSERT_EQ(upload_http_put(server.Url().c_str(), UHTTP_TEST_FILE, NULL, false, 5, NULL, &resp), 0);
+    ASSERT_EQ(upload_http_put(server.Url().c_str(), UHTTP_TEST_FILE, NULL, false, 5, NULL, &resp), 0);
+    EXPECT_EQ(server.requests, 2);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    EXPECT_EQ(server.accepts, 1);
+#endif
+}
+
+TEST_F(UploadHttpTest, Put_ThrottledResponseKeepsRetryHint) {
+    LocalHttpServer server;
+    server.status = 503;
+    server.extra_headers = "Retry-After: 30\r\n";
+
+    EXPECT_EQ(upload_http_put(server.Url().c_str(), UHTTP_TEST_FILE, NULL, false, 5, NULL, &resp), 0);
+    EXPECT_EQ(resp.http_code, 503);
+    EXPECT_EQ(resp.retry_after, 30);
+}
+
+static bool AlwaysStop(const void* arg) {
+    (*(int*)arg)++;
+    return true;
+}
+
+TEST_F(UploadHttpTest, Put_CancelStopsTransfer) {
+    LocalHttpServer server;
+    int checks = 0;
+    UploadHttpCancel cancel = { AlwaysStop, &checks };
+
+    EXPECT_EQ(upload_http_put(server.Url().c_str(), UHTTP_TEST_FILE, NULL, false, 5, &cancel, &resp),
+              CURLE_ABORTED_BY_CALLBACK);
+    EXPECT_GT(checks, 0);
+    EXPECT_EQ(server.requests, 0);
+}
+
+TEST_F(UploadHttpTest, Put_MissingFile) {
+    EXPECT_EQ(upload_http_put("http://127.0.0.1:1/", "/tmp/upload_http_no_such_file", NULL, false, 5, NULL, &resp),
+              CURLE_READ_ERROR);
+    EXPECT_EQ(resp.http_code, 0);
+    EXPECT_EQ(upload_http_put(NULL, UHTTP_TEST_FILE, NULL, false, 5, NULL, &resp), CURLE_BAD_FUNCTION_ARGUMENT);
+}
+
+TEST_F(UploadHttpTest, UrlOrigin) {
+    char origin[64];
+
+    ASSERT_TRUE(url_origin("https://s3.example.com:443/bucket/key?X-Amz=1", origin, sizeof(origin)));
+    EXPECT_STREQ(origin, "https://s3.example.com:443/");
+    ASSERT_TRUE(url_origin("https://s3.example.com?X-Amz=1", origin, sizeof(origin)));
+    EXPECT_STREQ(origin, "https://s3.example.com/");
+    EXPECT_FALSE(url_origin("s3.example.com/bucket", origin, sizeof(origin)));
+    EXPECT_FALSE(url_origin("https:///bucket", origin, sizeof(origin)));
+    EXPECT_FALSE(url_origin("https://a-very-long-host-name-that-does-not-fit.example.com/", origin, 16));
+}
+
+TEST_F(UploadHttpTest, Prewarm_ConnectionLeftInPool) {
+    LocalHttpServer server;
+
+    upload_http_prewarm(server.Url("/bucket/key?X-Amz=1").c_str(), NULL, false, 5);
+    for (int i = 0; i < 500 && server.requests < 1; i++) {
+        usleep(10 * 1000);
+    }
+    ASSERT_EQ(server.requests, 1);
+    prewarm_wait();
+
+    // The PUT does not wait for the pre-warm; a finished one has left its connection in the pool
+    ASSERT_EQ(upload_http_put(server.Url().c_str(), UHTTP_TEST_FILE, NULL, false, 5, NULL, &resp), 0);
+    EXPECT_EQ(resp.http_code, 200);
+    EXPECT_EQ(server.requests, 2);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    EXPECT_EQ(server.accepts, 1);
+#endif
+}
+
+TEST_F(UploadHttpTest, Prewarm_NoOriginDoesNothing) {
+    upload_http_prewarm(NULL, NULL, false, 5);
+    EXPECT_FALSE(prewarm_running);
+    upload_http_prewarm("not a url", NULL, false, 5);
+    EXPECT_FALSE(prewarm_running);
+}
+
+// Test the response header callback used for server retry hints
+TEST_F(UploadHttpTest, RetryAfterHeader_Recorded) {
+    char header[] = "Retry-After: 120\r\n";
+    size_t len = strlen(header);
+    int retry_after = 0;
+
+    EXPECT_EQ(upload_http_retry_after_header(header, 1, len, &retry_after), len);
+    EXPECT_EQ(retry_after, 120);
+}
+
+TEST_F(UploadHttpTest, RetryAfterHeader_CaseInsensitiveLargestWins) {
+    char retry_after_hdr[] = "retry-after: 30\r\n";
+    char reset[] = "X-RateLimit-Reset: 90\r\n";
+    char smaller[] = "RateLimit-Reset: 10\r\n";
+    int retry_after = 0;
+
+    upload_http_retry_after_header(retry_after_hdr, 1, strlen(retry_after_hdr), &retry_after);
+    upload_http_retry_after_header(reset, 1, strlen(reset), &retry_after);
+    upload_http_retry_after_header(smaller, 1, strlen(smaller), &retry_after);
+    EXPECT_EQ(retry_after, 90);
+}
+
+TEST_F(UploadHttpTest, RetryAfterHeader_OtherHeadersIgnored) {
+    char content_type[] = "Content-Type: text/plain\r\n";
+    char status[] = "HTTP/1.1 429 Too Many Requests\r\n";
+    int retry_after = 0;
+
+    upload_http_retry_after_header(content_type, 1, strlen(content_type), &retry_after);
+    upload_http_retry_after_header(status, 1, strlen(status), &retry_after);
+    EXPECT_EQ(retry_after, 0);
+}
+
+TEST_F(UploadHttpTest, RateTake_UncappedGrantsEverything) {
+    UploadRateLimit limit;
+    long wait_ms = -1;
+
+    upload_rate_init(&limit, 0, true, 0);
+    EXPECT_EQ(upload_rate_take(&limit, 1 << 20, 0, &wait_ms), (size_t)(1 << 20));
+    EXPECT_EQ(wait_ms, 0);
+    EXPECT_EQ(upload_rate_take(NULL, 100, 0, NULL), (size_t)100);
+}
+
+TEST_F(UploadHttpTest, RateTake_BurstThenPaced) {
+    UploadRateLimit limit;
+    long wait_ms = 0;
+
+    // 128 KB/s: a 32 KB burst, then 128 bytes per millisecond
+    upload_rate_init(&limit, 128 * 1024, false, 1000);
+    EXPECT_EQ(upload_rate_take(&limit, 64 * 1024, 1000, &wait_ms), (size_t)(32 * 1024));
+    EXPECT_EQ(upload_rate_take(&limit, 64 * 1024, 1000, &wait_ms), (size_t)0);
+    EXPECT_EQ(wait_ms, 125 + 1);
+
+    // Half a chunk of tokens is not enough to send
+    EXPECT_EQ(upload_rate_take(&limit, 64 * 1024, 1064, &wait_ms), (size_t)0);
+    EXPECT_EQ(wait_ms, 61 + 1);
+    EXPECT_EQ(upload_rate_take(&limit, 64 * 1024, 1126, &wait_ms), (size_t)(8388 + 8126));
+
+    // A small request only waits for its own size
+    EXPECT_EQ(upload_rate_take(&limit, 100, 1126, &wait_ms), (size_t)0);
+    EXPECT_EQ(upload_rate_take(&limit, 100, 1127, &wait_ms), (size_t)100);
+
+    // Idle time refills no more than the burst
+    EXPECT_EQ(upload_rate_take(&limit, 1 << 20, 60000, &wait_ms), (size_t)(32 * 1024));
+}
+
+TEST_F(UploadHttpTest, RateInit_RaisesTinyCap) {
+    UploadRateLimit limit;
+
+    upload_rate_init(&limit, 100, false, 0);
+    EXPECT_EQ(limit.cap_bps, UPLOAD_RATE_MIN_BPS);
+    upload_rate_init(&limit, -5, false, 0);
+    EXPECT_EQ(limit.cap_bps, 0);
+}
+
+TEST_F(UploadHttpTest, RateAdapt_BacksOffOnQueueingAndRecovers) {
+    UploadRateLimit limit;
+    long cap = 800 * 1024;
+
+    upload_rate_init(&limit, cap, true, 0);
+    upload_rate_adapt(&limit, 20000, UPLOAD_RATE_ADAPT_MS);
+    EXPECT_EQ(limit.base_rtt_us, 20000);
+    EXPECT_EQ(limit.rate_bps, cap);
+
+    // RTT well above its floor: a quarter off per interval, not more often
+    upload_rate_adapt(&limit, 20000 + UPLOAD_RATE_QUEUE_US + 1, 2 * UPLOAD_RATE_ADAPT_MS);
+    EXPECT_EQ(limit.rate_bps, cap - cap / 4);
+    upload_rate_adapt(&limit, 20000 + UPLOAD_RATE_QUEUE_US + 1, 2 * UPLOAD_RATE_ADAPT_MS + 10);
+    EXPECT_EQ(limit.rate_bps, cap - cap / 4);
+
+    // Queue drained: climbs back in eighths, never above the cap
+    upload_rate_adapt(&limit, 25000, 3 * UPLOAD_RATE_ADAPT_MS);
+    EXPECT_EQ(limit.rate_bps, cap - cap / 4 + cap / 8);
+    upload_rate_adapt(&limit, 25000, 4 * UPLOAD_RATE_ADAPT_MS);
+    upload_rate_adapt(&limit, 25000, 5 * UPLOAD_RATE_ADAPT_MS);
+    EXPECT_EQ(limit.rate_bps, cap);
+
+    // Never below the minimum
+    for (int i = 6; i < 40; i++) {
+        upload_rate_adapt(&limit, 1000000, i * UPLOAD_RATE_ADAPT_MS);
+    }
+    EXPECT_EQ(limit.rate_bps, UPLOAD_RATE_MIN_BPS);
+}
+
+TEST_F(UploadHttpTest, RateAdapt_IgnoredWhenNotAdaptive) {
+    UploadRateLimit limit;
+
+    upload_rate_init(&limit, 64 * 1024, false, 0);
+    upload_rate_adapt(&limit, 10000, 1000);
+    upload_rate_adapt(&limit, 900000, 2000);
+    EXPECT_EQ(limit.rate_bps, 64 * 1024);
+    EXPECT_EQ(limit.base_rtt_us, 0);
+}
+
+TEST_F(UploadHttpTest, Put_RateCapPacesBody) {
+    LocalHttpServer server;
+    string payload(48 * 1024, 'x');
+    FILE* fp = fopen(UHTTP_TEST_FILE, "w");
+    ASSERT_NE(fp, nullptr);
+    fwrite(payload.data(), 1, payload.size(), fp);
+    fclose(fp);
+
+    // 32 KB/s: the first 16 KB go out at once, the remaining 32 KB take a second
+    upload_http_set_rate_limit(32 * 1024, false);
+    auto start = chrono::steady_clock::now();
+    EXPECT_EQ(upload_http_put(server.Url().c_str(), UHTTP_TEST_FILE, NULL, false, 5, NULL, &resp), 0);
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(resp.http_code, 200);
+    EXPECT_EQ(resp.bytes, (long long)payload.size());
+    EXPECT_EQ(server.last_body, payload);
+    EXPECT_GE(elapsed, 900);
+    EXPECT_LT(elapsed, 5000);
+}
+
+TEST_F(UploadHttpTest, Put_UncappedReportsBytes) {
+    LocalHttpServer server;
+
+    EXPECT_EQ(upload_http_put(server.Url().c_str(), UHTTP_TEST_FILE, NULL, false, 5, NULL, &resp), 0);
+    EXPECT_EQ(resp.bytes, (long long)strlen("log archive payload"));
+}
+
+// Main test runner
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,282 @@
+/**
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstring>
+#include <stdio.h>
+#include <string>
+
+// Mock RDK_LOG before including other headers
+#ifdef GTEST_ENABLE
+#define RDK_LOG(level, module, ...) do {} while(0)
+#endif
+
+#include "uploadstblogs_types.h"
+
+// Include the source file to test internal functions
+extern "C" {
+#include "../src/upload_index.c"
+}
+
+using namespace testing;
+using namespace std;
+
+#define UIDX_TEST_DIR   "/tmp/upload_index_test"
+#define UIDX_TEST_INDEX UIDX_TEST_DIR "/index"
+#define UIDX_TEST_LOG   UIDX_TEST_DIR "/messages.log"
+
+class UploadIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        system("rm -rf " UIDX_TEST_DIR);
+        mkdir(UIDX_TEST_DIR, 0755);
+        upload_index_init(&index);
+        memset(&manifest, 0, sizeof(manifest));
+    }
+
+    void TearDown() override {
+        upload_index_free(&index);
+        ClearManifest();
+        system("rm -rf " UIDX_TEST_DIR);
+    }
+
+    static void Append(const char* path, const char* data) {
+        FILE* fp = fopen(path, "a");
+        ASSERT_NE(fp, nullptr);
+        fputs(data, fp);
+        fclose(fp);
+    }
+
+    // Build a one-entry manifest by hand, archive_manager.c is not linked
+    void SetManifest(const char* path) {
+        ClearManifest();
+        manifest.entries = (ArchiveManifestEntry*)calloc(1, sizeof(ArchiveManifestEntry));
+        manifest.entries[0].src_path = strdup(path);
+        manifest.entries[0].arcname = strdup("messages.log");
+        manifest.entries[0].offset = 0;
+        manifest.entries[0].length = -1;
+        manifest.count = 1;
+        manifest.capacity = 1;
+    }
+
+    void ClearManifest() {
+        for (size_t i = 0; i < manifest.count; i++) {
+            free(manifest.entries[i].src_path);
+            free(manifest.entries[i].arcname);
+        }
+        free(manifest.entries);
+        memset(&manifest, 0, sizeof(manifest));
+    }
+
+    // One upload cycle: load, apply, and commit as after a successful upload
+    long long Cycle(const char* path) {
+        SetManifest(path);
+        EXPECT_EQ(upload_index_load(&index, UIDX_TEST_INDEX), 0);
+        long long skipped = upload_index_apply(&index, &manifest);
+        EXPECT_EQ(upload_index_commit(&index, &manifest), 0);
+        EXPECT_EQ(upload_index_save(&index, UIDX_TEST_INDEX), 0);
+        return skipped;
+    }
+
+    UploadIndex index;
+    ArchiveManifest manifest;
+};
+
+TEST_F(UploadIndexTest, Load_MissingFileIsEmpty) {
+    EXPECT_EQ(upload_index_load(&index, UIDX_TEST_DIR "/missing"), 0);
+    EXPECT_EQ(index.count, 0u);
+}
+
+TEST_F(UploadIndexTest, Load_InvalidParameters) {
+    EXPECT_EQ(upload_index_load(NULL, UIDX_TEST_INDEX), -1);
+    EXPECT_EQ(upload_index_save(NULL, UIDX_TEST_INDEX), -1);
+    EXPECT_EQ(upload_index_apply(&index, NULL), -1);
+    EXPECT_EQ(upload_index_commit(&index, NULL), -1);
+}
+
+TEST_F(UploadIndexTest, Load_SkipsMalformedLines) {
+    FILE* fp = fopen(UIDX_TEST_INDEX, "w");
+    ASSERT_NE(fp, nullptr);
+    fputs("garbage\n", fp);
+    fputs("1 2 300 4 /opt/logs/messages.log\n", fp);
+    fputs("1 2 -5 0 /opt/logs/bad.log\n", fp);
+    fclose(fp);
+
+    EXPECT_EQ(upload_index_load(&index, UIDX_TEST_INDEX), 0);
+    ASSERT_EQ(index.count, 1u);
+    EXPECT_EQ(index.entries[0].ino, 2u);
+    EXPECT_EQ(index.entries[0].offset, 300);
+    EXPECT_EQ(index.entries[0].generation, 4u);
+    EXPECT_STREQ(index.entries[0].path, "/opt/logs/messages.log");
+}
+
+TEST_F(UploadIndexTest, Apply_FirstRunUploadsWholeFile) {
+    Append(UIDX_TEST_LOG, "0123456789");
+
+    EXPECT_EQ(Cycle(UIDX_TEST_LOG), 0);
+    EXPECT_EQ(manifest.entries[0].offset, 0);
+    EXPECT_EQ(manifest.entries[0].length, 10);
+}
+
+TEST_F(UploadIndexTest, Apply_UploadsOnlyAppendedBytes) {
+    Append(UIDX_TEST_LOG, "0123456789");
+    Cycle(UIDX_TEST_LOG);
+
+    Append(UIDX_TEST_LOG, "abcde");
+    EXPECT_EQ(Cycle(UIDX_TEST_LOG), 10);
+    EXPECT_EQ(manifest.entries[0].offset, 10);
+    EXPECT_EQ(manifest.entries[0].length, 5);
+}
+
+TEST_F(UploadIndexTest, Apply_UnchangedFileIsSkipped) {
+    Append(UIDX_TEST_LOG, "0123456789");
+    Cycle(UIDX_TEST_LOG);
+
+    Cycle(UIDX_TEST_LOG);
+    EXPECT_EQ(manifest.entries[0].length, 0);
+}
+
+TEST_F(UploadIndexTest, Apply_UnsavedIndexResendsData) {
+    Append(UIDX_TEST_LOG, "0123456789");
+    SetManifest(UIDX_TEST_LOG);
+    ASSERT_EQ(upload_index_load(&index, UIDX_TEST_INDEX), 0);
+    upload_index_apply(&index, &manifest);
+    // Upload failed: nothing saved
+
+    EXPECT_EQ(Cycle(UIDX_TEST_LOG), 0);
+    EXPECT_EQ(manifest.entries[0].length, 10);
+}
+
+TEST_F(UploadIndexTest, Apply_RotatedFileKeepsWatermark) {
+    Append(UIDX_TEST_LOG, "0123456789");
+    Cycle(UIDX_TEST_LOG);
+
+    ASSERT_EQ(rename(UIDX_TEST_LOG, UIDX_TEST_LOG ".1"), 0);
+    Append(UIDX_TEST_LOG ".1", "xyz");
+    EXPECT_EQ(Cycle(UIDX_TEST_LOG ".1"), 10);
+    EXPECT_EQ(manifest.entries[0].offset, 10);
+    EXPECT_EQ(manifest.entries[0].length, 3);
+}
+
+TEST_F(UploadIndexTest, Apply_RotatedTwiceKeepsWatermark) {
+    Append(UIDX_TEST_LOG, "0123456789");
+    Cycle(UIDX_TEST_LOG);
+
+    ASSERT_EQ(rename(UIDX_TEST_LOG, UIDX_TEST_LOG ".1"), 0);
+    Append(UIDX_TEST_LOG ".1", "xyz");
+    EXPECT_EQ(Cycle(UIDX_TEST_LOG ".1"), 10);
+
+    // The index now records the .1 name; the next rotation moves it on
+    ASSERT_EQ(rename(UIDX_TEST_LOG ".1", UIDX_TEST_LOG ".2"), 0);
+    Append(UIDX_TEST_LOG ".2", "uv");
+    EXPECT_EQ(Cycle(UIDX_TEST_LOG ".2"), 13);
+    EXPECT_EQ(manifest.entries[0].offset, 13);
+    EXPECT_EQ(manifest.entries[0].length, 2);
+}
+
+TEST_F(UploadIndexTest, Apply_InodeUnderUnrelatedNameStartsOver) {
+    Append(UIDX_TEST_LOG, "0123456789");
+    Cycle(UIDX_TEST_LOG);
+
+    ASSERT_EQ(rename(UIDX_TEST_LOG, UIDX_TEST_DIR "/messages.log2"), 0);
+    EXPECT_EQ(Cycle(UIDX_TEST_DIR "/messages.log2"), 0);
+    EXPECT_EQ(manifest.entries[0].length, 10);
+}
+
+TEST_F(UploadIndexTest, Apply_NewInodeAtSamePathBumpsGeneration) {
+    Append(UIDX_TEST_LOG, "0123456789");
+    Cycle(UIDX_TEST_LOG);
+
+    // Keep the old inode alive so it cannot be reused
+    ASSERT_EQ(rename(UIDX_TEST_LOG, UIDX_TEST_DIR "/old"), 0);
+    Append(UIDX_TEST_LOG, "new");
+    EXPECT_EQ(Cycle(UIDX_TEST_LOG), 0);
+    EXPECT_EQ(manifest.entries[0].length, 3);
+
+    ASSERT_EQ(upload_index_load(&index, UIDX_TEST_INDEX), 0);
+    ASSERT_EQ(index.count, 1u);
+    EXPECT_EQ(index.entries[0].generation, 1u);
+}
+
+TEST_F(UploadIndexTest, Apply_TruncatedFileStartsOver) {
+    Append(UIDX_TEST_LOG, "0123456789");
+    Cycle(UIDX_TEST_LOG);
+
+    ASSERT_EQ(truncate(UIDX_TEST_LOG, 0), 0);
+    Append(UIDX_TEST_LOG, "abc");
+    EXPECT_EQ(Cycle(UIDX_TEST_LOG), 0);
+    EXPECT_EQ(manifest.entries[0].offset, 0);
+    EXPECT_EQ(manifest.entries[0].length, 3);
+}
+
+TEST_F(UploadIndexTest, Commit_CappedFileAdvancesOnlyOverArchivedBytes) {
+    Append(UIDX_TEST_LOG, "0123456789");
+    SetManifest(UIDX_TEST_LOG);
+    ASSERT_EQ(upload_index_load(&index, UIDX_TEST_INDEX), 0);
+    upload_index_apply(&index, &manifest);
+    // The file cap let only the first 4 bytes into the archive
+    manifest.entries[0].length = 4;
+    EXPECT_EQ(upload_index_commit(&index, &manifest), 0);
+    EXPECT_EQ(upload_index_save(&index, UIDX_TEST_INDEX), 0);
+
+    ASSERT_EQ(upload_index_load(&index, UIDX_TEST_INDEX), 0);
+    ASSERT_EQ(index.count, 1u);
+    EXPECT_EQ(index.entries[0].offset, 4);
+
+    EXPECT_EQ(Cycle(UIDX_TEST_LOG), 4);
+    EXPECT_EQ(manifest.entries[0].offset, 4);
+    EXPECT_EQ(manifest.entries[0].length, 6);
+}
+
+TEST_F(UploadIndexTest, Commit_LeftOutFileKeepsWatermark) {
+    Append(UIDX_TEST_LOG, "0123456789");
+    Cycle(UIDX_TEST_LOG);
+
+    Append(UIDX_TEST_LOG, "abcde");
+    SetManifest(UIDX_TEST_LOG);
+    ASSERT_EQ(upload_index_load(&index, UIDX_TEST_INDEX), 0);
+    upload_index_apply(&index, &manifest);
+    // Over the budget: left out of the archive
+    manifest.entries[0].length = 0;
+    EXPECT_EQ(upload_index_commit(&index, &manifest), 0);
+    EXPECT_EQ(upload_index_save(&index, UIDX_TEST_INDEX), 0);
+
+    EXPECT_EQ(Cycle(UIDX_TEST_LOG), 10);
+    EXPECT_EQ(manifest.entries[0].length, 5);
+}
+
+TEST_F(UploadIndexTest, Save_DropsFilesNoLongerPresent) {
+    FILE* fp = fopen(UIDX_TEST_INDEX, "w");
+    ASSERT_NE(fp, nullptr);
+    fputs("1 2 300 0 /opt/logs/gone.log\n", fp);
+    fclose(fp);
+
+    Append(UIDX_TEST_LOG, "0123456789");
+    Cycle(UIDX_TEST_LOG);
+
+    ASSERT_EQ(upload_index_load(&index, UIDX_TEST_INDEX), 0);
+    ASSERT_EQ(index.count, 1u);
+    EXPECT_STREQ(index.entries[0].path, UIDX_TEST_LOG);
+    EXPECT_EQ(access(UIDX_TEST_INDEX ".tmp", F_OK), -1);
+}
+
+// Main test runner
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
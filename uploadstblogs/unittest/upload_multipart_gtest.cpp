@@ -0,0 +1,475 @@
+/**
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstring>
+#include <stdio.h>
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// Mock RDK_LOG before including other headers
+#ifdef GTEST_ENABLE
+#define RDK_LOG(level, module, ...) do {} while(0)
+#endif
+
+#include "uploadstblogs_types.h"
+
+// Include the source files to test internal functions
+extern "C" {
+// Mock retry_logic header parsing
+int parse_retry_after(const char* value, time_t now) {
+    (void)now;
+    return (value && atoi(value) > 0) ? atoi(value) : -1;
+}
+
+// Mock verification
+bool is_throttled_response(int http_code) {
+    return http_code == 429 || http_code == 503;
+}
+
+#include "../src/upload_http.c"
+#include "../src/upload_multipart.c"
+}
+
+using namespace testing;
+using namespace std;
+
+#define MP_TEST_FILE     "/tmp/upload_multipart_test.tgz"
+#define MP_TEST_MANIFEST "/tmp/upload_multipart_test_manifest"
+#define MP_PART_SIZE     (5 * 1024 * 1024)
+
+/**
+ * Keep-alive HTTP/1.1 stand-in for the S3 multipart protocol on 127.0.0.1
+ */
+class MultipartServer {
+public:
+    MultipartServer() {
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr));
+        listen(listen_fd, 16);
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd, (struct sockaddr*)&addr, &len);
+        port = ntohs(addr.sin_port);
+        worker = thread(&MultipartServer::Run, this);
+    }
+
+    ~MultipartServer() {
+        stop = true;
+        worker.join();
+        for (auto& c : clients) {
+            close(c.first);
+        }
+        close(listen_fd);
+    }
+
+    string Url() const {
+        return "http://127.0.0.1:" + to_string(port) + "/bucket/logs.tgz?X-Sig=abc";
+    }
+
+    string Assembled() {
+        lock_guard<mutex> lock(mtx);
+        return assembled;
+    }
+
+    int PartPuts(int part) {
+        lock_guard<mutex> lock(mtx);
+        return part_puts[part];
+    }
+
+    int create_status = 200;
+    int fail_part = 0;          // Part answered with fail_status ...
+    int fail_times = 0;         // ... this many times (-1 = always)
+    int fail_status = 500;
+    atomic<int> creates{0};
+    atomic<int> completes{0};
+    atomic<int> accepts{0};
+
+private:
+    void Run() {
+        while (!stop) {
+            vector<struct pollfd> fds;
+            fds.push_back({listen_fd, POLLIN, 0});
+            for (auto& c : clients) {
+                fds.push_back({c.first, POLLIN, 0});
+            }
+            if (poll(fds.data(), fds.size(), 50) <= 0) {
+                continue;
+            }
+            if (fds[0].revents & POLLIN) {
+                int fd = accept(listen_fd, NULL, NULL);
+                if (fd >= 0) {
+                    clients[fd] = "";
+                    accepts++;
+                }
+            }
+            for (size_t i = 1; i < fds.size(); i++) {
+                if (fds[i].revents) {
+                    Serve(fds[i].fd);
+                }
+            }
+        }
+    }
+
+    void Serve(int fd) {
+        char buf[65536];
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            close(fd);
+            clients.erase(fd);
+            return;
+        }
+        string& in = clients[fd];
+        in.append(buf, n);
+
+        size_t hdr_end = in.find("\r\n\r\n");
+        if (hdr_end == string::npos) {
+            return;
+        }
+        string headers = in.substr(0, hdr_end);
+        size_t content_length = 0;
+        size_t pos = headers.find("Content-Length:");
+        if (pos != string::npos) {
+            content_length = strtoul(headers.c_str() + pos + 15, NULL, 10);
+        }
+        if (in.size() - hdr_end - 4 < content_length) {
+            if (headers.find("100-continue") != string::npos && !continued[fd]) {
+                Send(fd, "HTTP/1.1 100 Continue\r\n\r\n");
+                continued[fd] = true;
+            }
+            return;
+        }
+
+        string body = in.substr(hdr_end + 4, content_length);
+        in.erase(0, hdr_end + 4 + content_length);
+        continued[fd] = false;
+        Respond(fd, headers.substr(0, headers.find(' ')), headers.substr(0, headers.find("\r\n")), body);
+    }
+
+    void Respond(int fd, const string& method, const string& request_line, const string& body) {
+        lock_guard<mutex> lock(mtx);
+        int status = 200;
+        string extra;
+        string payload;
+
+        size_t part_pos = request_line.find("partNumber=");
+        if (method == "POST" && request_line.find("&uploads") != string::npos) {
+            creates++;
+            status = create_status;
+            if (status == 200) {
+                payload = "<InitiateMultipartUploadResult><UploadId>id+1/x</UploadId></InitiateMultipartUploadResult>";
+            }
+        } else if (method == "PUT" && part_pos != string::npos &&
+                   request_line.find("uploadId=id%2B1%2Fx") != string::npos) {
+            int part = atoi(request_line.c_str() + part_pos + 11);
+            part_puts[part]++;
+            if (part == fail_part && fail_times != 0) {
+                if (fail_times > 0) {
+                    fail_times--;
+                }
+                status = fail_status;
+            } else {
+                parts[part] = body;
+                extra = "ETag: \"etag-" + to_string(part) + "\"\r\n";
+            }
+        } else if (method == "POST" && request_line.find("uploadId=id%2B1%2Fx") != string::npos) {
+            completes++;
+            assembled.clear();
+            for (auto& p : parts) {
+                if (body.find("<PartNumber>" + to_string(p.first) + "</PartNumber><ETag>\"etag-" +
+                              to_string(p.first) + "\"</ETag>") == string::npos) {
+                    status = 400;
+                }
+                assembled += p.second;
+            }
+            payload = "<CompleteMultipartUploadResult></CompleteMultipartUploadResult>";
+        } else {
+            status = 404;
+        }
+
+        Send(fd, "HTTP/1.1 " + to_string(status) + " Test\r\nContent-Length: " + to_string(payload.size()) +
+                 "\r\n" + extra + "\r\n" + payload);
+    }
+
+    static void Send(int fd, const string& data) {
+        send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+    }
+
+    int listen_fd = -1;
+    int port = 0;
+    atomic<bool> stop{false};
+    thread worker;
+    map<int, string> clients;
+    map<int, bool> continued;
+    mutex mtx;
+    map<int, string> parts;
+    map<int, int> part_puts;
+    string assembled;
+};
+
+class UploadMultipartTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        unlink(MP_TEST_MANIFEST);
+        // Two full parts and a short last one, each byte tagged with its part
+        content.clear();
+        for (int i = 0; i < 2 * MP_PART_SIZE + 1000; i++) {
+            content += (char)('a' + (i / MP_PART_SIZE) * 7 + i % 5);
+        }
+        WriteFile(content);
+        config.part_size = MP_PART_SIZE;
+        config.parallel = 3;
+        config.part_attempts = 2;
+        config.manifest_path = MP_TEST_MANIFEST;
+        config.cancel = NULL;
+        memset(&resp, 0, sizeof(resp));
+    }
+
+    void TearDown() override {
+        upload_http_cleanup();
+        unlink(MP_TEST_FILE);
+        unlink(MP_TEST_MANIFEST);
+    }
+
+    static void WriteFile(const string& data) {
+        FILE* fp = fopen(MP_TEST_FILE, "wb");
+        ASSERT_NE(fp, nullptr);
+        fwrite(data.data(), 1, data.size(), fp);
+        fclose(fp);
+    }
+
+    MultipartResult Put(MultipartServer& server) {
+        return upload_multipart_put(server.Url().c_str(), MP_TEST_FILE, NULL, false, 5, &config, &resp);
+    }
+
+    string content;
+    MultipartConfig config;
+    UploadResponse resp;
+};
+
+TEST_F(UploadMultipartTest, Upload_AssemblesParts) {
+    MultipartServer server;
+
+    EXPECT_EQ(Put(server), MULTIPART_OK);
+    EXPECT_EQ(resp.http_code, 200);
+    EXPECT_EQ(server.creates, 1);
+    EXPECT_EQ(server.completes, 1);
+    EXPECT_EQ(server.PartPuts(1), 1);
+    EXPECT_EQ(server.PartPuts(3), 1);
+    EXPECT_TRUE(server.Assembled() == content);
+    EXPECT_EQ(resp.bytes, (long long)content.size());
+    EXPECT_EQ(access(MP_TEST_MANIFEST, F_OK), -1);
+}
+
+TEST_F(UploadMultipartTest, Upload_PartsInParallel) {
+    MultipartServer server;
+
+    EXPECT_EQ(Put(server), MULTIPART_OK);
+    EXPECT_GE(server.accepts, 2);
+}
+
+TEST_F(UploadMultipartTest, Upload_RetriesOnlyFailedPart) {
+    MultipartServer server;
+    server.fail_part = 2;
+    server.fail_times = 1;
+
+    EXPECT_EQ(Put(server), MULTIPART_OK);
+    EXPECT_EQ(server.PartPuts(1), 1);
+    EXPECT_EQ(server.PartPuts(2), 2);
+    EXPECT_EQ(server.PartPuts(3), 1);
+    EXPECT_TRUE(server.Assembled() == content);
+}
+
+TEST_F(UploadMultipartTest, Upload_ResumesFromManifest) {
+    MultipartServer server;
+    server.fail_part = 3;
+    server.fail_times = -1;
+
+    EXPECT_EQ(Put(server), MULTIPART_FAILED);
+    EXPECT_EQ(resp.http_code, 500);
+    EXPECT_EQ(server.PartPuts(3), 2);
+    EXPECT_EQ(server.completes, 0);
+    ASSERT_EQ(access(MP_TEST_MANIFEST, F_OK), 0);
+
+    server.fail_times = 0;
+    EXPECT_EQ(Put(server), MULTIPART_OK);
+    EXPECT_EQ(server.creates, 1);
+    EXPECT_EQ(server.PartPuts(1), 1);
+    EXPECT_EQ(server.PartPuts(2), 1);
+    EXPECT_EQ(server.PartPuts(3), 3);
+    EXPECT_TRUE(server.Assembled() == content);
+    // Only the part sent by this run counts
+    EXPECT_LT(resp.bytes, (long long)content.size());
+    EXPECT_GT(resp.bytes, 0);
+    EXPECT_EQ(access(MP_TEST_MANIFEST, F_OK), -1);
+}
+
+TEST_F(UploadMultipartTest, Upload_ChangedFileStartsOver) {
+    MultipartServer server;
+    server.fail_part = 3;
+    server.fail_times = -1;
+    EXPECT_EQ(Put(server), MULTIPART_FAILED);
+
+    server.fail_times = 0;
+    content[0] = 'Z';
+    content += "more";
+    WriteFile(content);
+    EXPECT_EQ(Put(server), MULTIPART_OK);
+    EXPECT_EQ(server.creates, 2);
+    EXPECT_EQ(server.PartPuts(1), 2);
+}
+
+TEST_F(UploadMultipartTest, Upload_ThrottledPartStopsWithRetryHint) {
+    MultipartServer server;
+    server.fail_part = 1;
+    server.fail_times = -1;
+    server.fail_status = 503;
+
+    EXPECT_EQ(Put(server), MULTIPART_FAILED);
+    EXPECT_EQ(server.PartPuts(1), 1);
+    EXPECT_EQ(resp.http_code, 503);
+    EXPECT_EQ(access(MP_TEST_MANIFEST, F_OK), 0);
+}
+
+static bool AlwaysStop(const void* arg) {
+    (*(int*)arg)++;
+    return true;
+}
+
+TEST_F(UploadMultipartTest, Upload_CancelStopsPartsWithoutRetry) {
+    MultipartServer server;
+    int checks = 0;
+    UploadHttpCancel cancel = { AlwaysStop, &checks };
+    config.cancel = &cancel;
+
+    EXPECT_EQ(Put(server), MULTIPART_FAILED);
+    EXPECT_EQ(resp.curl_code, CURLE_ABORTED_BY_CALLBACK);
+    EXPECT_GT(checks, 0);
+    EXPECT_EQ(server.creates, 1);
+    EXPECT_EQ(server.completes, 0);
+    EXPECT_EQ(server.PartPuts(1) + server.PartPuts(2) + server.PartPuts(3), 0);
+}
+
+TEST_F(UploadMultipartTest, Upload_UnknownUploadIdDropsManifest) {
+    MultipartServer server;
+    server.fail_part = 2;
+    server.fail_times = -1;
+    server.fail_status = 404;
+
+    EXPECT_EQ(Put(server), MULTIPART_FAILED);
+    EXPECT_EQ(access(MP_TEST_MANIFEST, F_OK), -1);
+}
+
+TEST_F(UploadMultipartTest, Create_RefusedIsUnsupported) {
+    MultipartServer server;
+    server.create_status = 403;
+
+    EXPECT_EQ(Put(server), MULTIPART_UNSUPPORTED);
+    EXPECT_EQ(server.PartPuts(1), 0);
+    EXPECT_EQ(access(MP_TEST_MANIFEST, F_OK), -1);
+}
+
+TEST_F(UploadMultipartTest, Create_ServerErrorIsFailure) {
+    MultipartServer server;
+    server.create_status = 500;
+
+    EXPECT_EQ(Put(server), MULTIPART_FAILED);
+    EXPECT_EQ(resp.http_code, 500);
+}
+
+TEST_F(UploadMultipartTest, Manifest_RoundTrip) {
+    MultipartState state;
+    memset(&state, 0, sizeof(state));
+    strcpy(state.upload_id, "abc");
+    strcpy(state.object, "https://s3.example.com/bucket/key");
+    strcpy(state.file, "/opt/logs/with space.tgz");
+    state.size = 11 * 1024 * 1024;
+    state.mtime = 1700000000;
+    state.part_size = MP_PART_SIZE;
+    ASSERT_TRUE(state_init_parts(&state));
+    EXPECT_EQ(state.part_count, 3);
+    strcpy(state.etags[1], "\"e2\"");
+    ASSERT_EQ(manifest_save(MP_TEST_MANIFEST, &state), 0);
+
+    MultipartState loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    ASSERT_TRUE(manifest_load(MP_TEST_MANIFEST, &loaded));
+    EXPECT_STREQ(loaded.upload_id, "abc");
+    EXPECT_STREQ(loaded.object, state.object);
+    EXPECT_STREQ(loaded.file, state.file);
+    EXPECT_EQ(loaded.part_count, 3);
+    EXPECT_STREQ(loaded.etags[0], "");
+    EXPECT_STREQ(loaded.etags[1], "\"e2\"");
+    state_free(&state);
+    state_free(&loaded);
+}
+
+TEST_F(UploadMultipartTest, Manifest_GarbageIgnored) {
+    FILE* fp = fopen(MP_TEST_MANIFEST, "w");
+    ASSERT_NE(fp, nullptr);
+    fputs("part 1 \"x\"\nnonsense\n", fp);
+    fclose(fp);
+
+    MultipartState state;
+    memset(&state, 0, sizeof(state));
+    EXPECT_FALSE(manifest_load(MP_TEST_MANIFEST, &state));
+    EXPECT_EQ(state.etags, nullptr);
+}
+
+TEST_F(UploadMultipartTest, Manifest_OversizedFieldRejected) {
+    FILE* fp = fopen(MP_TEST_MANIFEST, "w");
+    ASSERT_NE(fp, nullptr);
+    fprintf(fp, "upload_id %s\nobject https://s3.example.com/bucket/key\n"
+                "file 1024 1700000000 1024 /opt/logs/a.tgz\n",
+            std::string(MULTIPART_ID_MAX, 'u').c_str());
+    fclose(fp);
+
+    // A truncated upload id must not be resumed
+    MultipartState state;
+    memset(&state, 0, sizeof(state));
+    EXPECT_FALSE(manifest_load(MP_TEST_MANIFEST, &state));
+    EXPECT_EQ(state.etags, nullptr);
+}
+
+TEST_F(UploadMultipartTest, XmlValue) {
+    char out[32];
+    EXPECT_TRUE(xml_value("<a><UploadId>xyz</UploadId></a>", "UploadId", out, sizeof(out)));
+    EXPECT_STREQ(out, "xyz");
+    EXPECT_FALSE(xml_value("<UploadId></UploadId>", "UploadId", out, sizeof(out)));
+    EXPECT_FALSE(xml_value("<UploadId>xyz", "UploadId", out, sizeof(out)));
+    EXPECT_FALSE(xml_value(NULL, "UploadId", out, sizeof(out)));
+}
+
+// Main test runner
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
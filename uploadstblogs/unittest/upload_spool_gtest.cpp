@@ -0,0 +1,328 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <cstring>
+#include <string>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// Mock RDK_LOG before including other headers
+#ifdef GTEST_ENABLE
+#define RDK_LOG(level, module, ...) do {} while(0)
+#endif
+
+#include "uploadstblogs_types.h"
+
+#define UPLOAD_SPOOL_DIR "/tmp/upload_spool_test"
+#define TEST_SRC_DIR     "/tmp/upload_spool_test_src"
+
+extern "C" {
+#include "upload_spool.h"
+
+// Mock dependencies of the drain
+static int g_decide_paths_calls = 0;
+static int g_upload_calls = 0;
+static bool g_upload_result = true;
+static bool g_deferred = false;
+static SessionState g_last_session;
+static UploadPath g_last_path = PATH_NONE;
+
+void decide_paths(const RuntimeContext* ctx, SessionState* session)
+{
+    g_decide_paths_calls++;
+    session->primary = PATH_DIRECT;
+    session->fallback = PATH_CODEBIG;
+}
+
+UploadResult attempt_upload_once(RuntimeContext* ctx, SessionState* session, UploadPath path)
+{
+    g_upload_calls++;
+    g_last_session = *session;
+    g_last_path = path;
+    return g_upload_result ? UPLOADSTB_SUCCESS : UPLOADSTB_FAILED;
+}
+
+bool upload_deferred(const char* path, time_t now, time_t* until)
+{
+    return g_deferred;
+}
+
+#include "../src/upload_spool.c"
+}
+
+using namespace std;
+
+static void write_file(const string& path, size_t size)
+{
+    FILE* fp = fopen(path.c_str(), "w");
+    ASSERT_NE(fp, nullptr);
+    string data(size, 'x');
+    fwrite(data.data(), 1, size, fp);
+    fclose(fp);
+}
+
+static bool exists(const string& path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+class UploadSpoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        clear_dir(UPLOAD_SPOOL_DIR);
+        clear_dir(TEST_SRC_DIR);
+        mkdir(TEST_SRC_DIR, 0700);
+        memset(&ctx, 0, sizeof(ctx));
+        memset(&session, 0, sizeof(session));
+        memset(&g_last_session, 0, sizeof(g_last_session));
+        ctx.spool_max_mb = SPOOL_DEFAULT_MB;
+        ctx.spool_max_days = SPOOL_DEFAULT_DAYS;
+        ctx.trigger_type = TRIGGER_SCHEDULED;
+        session.strategy = STRAT_DCM;
+        strcpy(session.archive_md5, "bWQ1");
+        strcpy(session.archive_sha256, "abcdef");
+        g_decide_paths_calls = 0;
+        g_upload_calls = 0;
+        g_upload_result = true;
+        g_deferred = false;
+        g_last_path = PATH_NONE;
+    }
+
+    void TearDown() override {
+        clear_dir(UPLOAD_SPOOL_DIR);
+        clear_dir(TEST_SRC_DIR);
+    }
+
+    static void clear_dir(const char* dir) {
+        string cmd = string("rm -rf ") + dir;
+        system(cmd.c_str());
+    }
+
+    // Spool a fresh archive and backdate its record
+    void spool(const string& name, size_t size, time_t spooled, time_t next_try, int attempts = 0) {
+        string src = string(TEST_SRC_DIR) + "/" + name;
+        write_file(src, size);
+        ASSERT_EQ(upload_spool_add(&ctx, &session, src.c_str()), 0);
+
+        SpoolEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        snprintf(entry.archive, sizeof(entry.archive), "%s/%s", UPLOAD_SPOOL_DIR, name.c_str());
+        entry.strategy = session.strategy;
+        entry.spooled = spooled;
+        entry.next_try = next_try;
+        entry.attempts = attempts;
+        strcpy(entry.md5, session.archive_md5);
+        strcpy(entry.sha256, session.archive_sha256);
+        ASSERT_EQ(write_record(&entry), 0);
+    }
+
+    RuntimeContext ctx;
+    SessionState session;
+};
+
+TEST_F(UploadSpoolTest, Backoff_DoublesUpToCap) {
+    EXPECT_EQ(upload_spool_backoff_s(0), SPOOL_RETRY_BASE_S);
+    EXPECT_EQ(upload_spool_backoff_s(1), SPOOL_RETRY_BASE_S);
+    EXPECT_EQ(upload_spool_backoff_s(2), 2 * SPOOL_RETRY_BASE_S);
+    EXPECT_EQ(upload_spool_backoff_s(4), 8 * SPOOL_RETRY_BASE_S);
+    EXPECT_EQ(upload_spool_backoff_s(10), SPOOL_RETRY_CAP_S);
+    EXPECT_EQ(upload_spool_backoff_s(1000), SPOOL_RETRY_CAP_S);
+}
+
+TEST_F(UploadSpoolTest, Add_MovesArchiveAndRecordsDigests) {
+    string src = string(TEST_SRC_DIR) + "/logs.tgz";
+    write_file(src, 1000);
+
+    EXPECT_EQ(upload_spool_add(&ctx, &session, src.c_str()), 0);
+    EXPECT_FALSE(exists(src));
+    EXPECT_TRUE(exists(UPLOAD_SPOOL_DIR "/logs.tgz"));
+    EXPECT_TRUE(exists(UPLOAD_SPOOL_DIR "/logs.tgz" SPOOL_META_EXT));
+
+    SpoolEntry* entries = NULL;
+    ASSERT_EQ(upload_spool_list(UPLOAD_SPOOL_DIR, &entries), 1);
+    EXPECT_STREQ(entries[0].archive, UPLOAD_SPOOL_DIR "/logs.tgz");
+    EXPECT_EQ(entries[0].strategy, STRAT_DCM);
+    EXPECT_EQ(entries[0].size, 1000);
+    EXPECT_EQ(entries[0].attempts, 0);
+    EXPECT_EQ(entries[0].next_try, entries[0].spooled);
+    EXPECT_STREQ(entries[0].md5, "bWQ1");
+    EXPECT_STREQ(entries[0].sha256, "abcdef");
+    free(entries);
+}
+
+TEST_F(UploadSpoolTest, Add_DisabledOrTooLargeLeavesArchive) {
+    string src = string(TEST_SRC_DIR) + "/logs.tgz";
+    write_file(src, 2 * 1024 * 1024 + 1);
+
+    ctx.spool_max_mb = 0;
+    EXPECT_EQ(upload_spool_add(&ctx, &session, src.c_str()), -1);
+    EXPECT_TRUE(exists(src));
+
+    ctx.spool_max_mb = 2;
+    EXPECT_EQ(upload_spool_add(&ctx, &session, src.c_str()), -1);
+    EXPECT_TRUE(exists(src));
+
+    EXPECT_EQ(upload_spool_add(&ctx, &session, TEST_SRC_DIR "/missing.tgz"), -1);
+    EXPECT_EQ(upload_spool_add(NULL, &session, src.c_str()), -1);
+    EXPECT_EQ(upload_spool_add(&ctx, NULL, src.c_str()), -1);
+    EXPECT_EQ(upload_spool_add(&ctx, &session, NULL), -1);
+}
+
+TEST_F(UploadSpoolTest, Add_EvictsOldestOverSize) {
+    ctx.spool_max_mb = 1;
+    time_t now = time(NULL);
+    spool("a.tgz", 400 * 1024, now - 300, now - 300);
+    spool("b.tgz", 400 * 1024, now - 200, now - 200);
+
+    string src = string(TEST_SRC_DIR) + "/c.tgz";
+    write_file(src, 400 * 1024);
+    EXPECT_EQ(upload_spool_add(&ctx, &session, src.c_str()), 0);
+
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/a.tgz"));
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/a.tgz" SPOOL_META_EXT));
+    EXPECT_TRUE(exists(UPLOAD_SPOOL_DIR "/b.tgz"));
+    EXPECT_TRUE(exists(UPLOAD_SPOOL_DIR "/c.tgz"));
+}
+
+TEST_F(UploadSpoolTest, List_OldestFirstAndRemovesLeftovers) {
+    time_t now = time(NULL);
+    spool("new.tgz", 10, now - 10, now);
+    spool("old.tgz", 10, now - 100, now);
+
+    write_file(UPLOAD_SPOOL_DIR "/orphan.tgz", 10);
+    write_file(UPLOAD_SPOOL_DIR "/gone.tgz" SPOOL_META_EXT, 10);
+    write_file(UPLOAD_SPOOL_DIR "/partial.tgz.tmp", 10);
+    write_file(UPLOAD_SPOOL_DIR "/bad.tgz", 10);
+    write_file(UPLOAD_SPOOL_DIR "/bad.tgz" SPOOL_META_EXT, 10);
+
+    SpoolEntry* entries = NULL;
+    ASSERT_EQ(upload_spool_list(UPLOAD_SPOOL_DIR, &entries), 2);
+    EXPECT_STREQ(entries[0].archive, UPLOAD_SPOOL_DIR "/old.tgz");
+    EXPECT_STREQ(entries[1].archive, UPLOAD_SPOOL_DIR "/new.tgz");
+    free(entries);
+
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/orphan.tgz"));
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/gone.tgz" SPOOL_META_EXT));
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/partial.tgz.tmp"));
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/bad.tgz"));
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/bad.tgz" SPOOL_META_EXT));
+}
+
+TEST_F(UploadSpoolTest, List_MissingDirIsEmpty) {
+    SpoolEntry* entries = NULL;
+    EXPECT_EQ(upload_spool_list(UPLOAD_SPOOL_DIR "/none", &entries), 0);
+    EXPECT_EQ(entries, nullptr);
+    EXPECT_EQ(upload_spool_list(NULL, &entries), -1);
+}
+
+TEST_F(UploadSpoolTest, Evict_ByAgeThenSize) {
+    time_t now = time(NULL);
+    spool("older.tgz", 100, now - 3600, now);
+    spool("newer.tgz", 100, now - 60, now);
+    // Last, since adding applies the limits too
+    spool("expired.tgz", 100, now - 8 * 24 * 3600, now);
+
+    EXPECT_EQ(upload_spool_evict(UPLOAD_SPOOL_DIR, 1000, 7 * 24 * 3600, now), 1);
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/expired.tgz"));
+
+    EXPECT_EQ(upload_spool_evict(UPLOAD_SPOOL_DIR, 150, 0, now), 1);
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/older.tgz"));
+    EXPECT_TRUE(exists(UPLOAD_SPOOL_DIR "/newer.tgz"));
+}
+
+TEST_F(UploadSpoolTest, Drain_UploadsDueArchivesOldestFirst) {
+    time_t now = time(NULL);
+    spool("first.tgz", 10, now - 200, now - 1);
+    spool("second.tgz", 10, now - 100, now - 1);
+
+    EXPECT_EQ(upload_spool_drain(&ctx), 2);
+    EXPECT_EQ(g_upload_calls, 2);
+    EXPECT_EQ(g_decide_paths_calls, 2);
+    EXPECT_STREQ(g_last_session.archive_file, UPLOAD_SPOOL_DIR "/second.tgz");
+    EXPECT_EQ(g_last_session.strategy, STRAT_DCM);
+    EXPECT_EQ(g_last_path, PATH_DIRECT);
+    EXPECT_STREQ(g_last_session.archive_md5, "bWQ1");
+    EXPECT_STREQ(g_last_session.archive_sha256, "abcdef");
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/first.tgz"));
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/second.tgz" SPOOL_META_EXT));
+}
+
+TEST_F(UploadSpoolTest, Drain_FailureReschedulesAndStops) {
+    time_t now = time(NULL);
+    spool("first.tgz", 10, now - 200, now - 1, 2);
+    spool("second.tgz", 10, now - 100, now - 1);
+    g_upload_result = false;
+
+    EXPECT_EQ(upload_spool_drain(&ctx), 0);
+    EXPECT_EQ(g_upload_calls, 1);
+
+    SpoolEntry* entries = NULL;
+    ASSERT_EQ(upload_spool_list(UPLOAD_SPOOL_DIR, &entries), 2);
+    EXPECT_EQ(entries[0].attempts, 3);
+    EXPECT_GE(entries[0].next_try, now + upload_spool_backoff_s(3));
+    EXPECT_EQ(entries[1].attempts, 0);
+    free(entries);
+}
+
+TEST_F(UploadSpoolTest, Drain_SkipsArchivesNotDue) {
+    time_t now = time(NULL);
+    spool("later.tgz", 10, now - 200, now + 600);
+    // Scheduled beyond the longest delay: the clock was wrong, retry now
+    spool("skewed.tgz", 10, now - 100, now + 10 * SPOOL_RETRY_CAP_S);
+
+    EXPECT_EQ(upload_spool_drain(&ctx), 1);
+    EXPECT_EQ(g_upload_calls, 1);
+    EXPECT_TRUE(exists(UPLOAD_SPOOL_DIR "/later.tgz"));
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/skewed.tgz"));
+}
+
+TEST_F(UploadSpoolTest, Drain_HonoursServerDeferral) {
+    time_t now = time(NULL);
+    spool("logs.tgz", 10, now - 200, now - 1);
+    g_deferred = true;
+
+    EXPECT_EQ(upload_spool_drain(&ctx), 0);
+    EXPECT_EQ(g_upload_calls, 0);
+
+    // On-demand uploads are not deferred
+    ctx.trigger_type = TRIGGER_ONDEMAND;
+    EXPECT_EQ(upload_spool_drain(&ctx), 1);
+    EXPECT_EQ(g_upload_calls, 1);
+}
+
+TEST_F(UploadSpoolTest, Drain_DropsExpiredAndHandlesEmpty) {
+    EXPECT_EQ(upload_spool_drain(&ctx), 0);
+    EXPECT_EQ(upload_spool_drain(NULL), -1);
+
+    time_t now = time(NULL);
+    spool("stale.tgz", 10, now - 30 * 24 * 3600, now - 1);
+    EXPECT_EQ(upload_spool_drain(&ctx), 0);
+    EXPECT_EQ(g_upload_calls, 0);
+    EXPECT_FALSE(exists(UPLOAD_SPOOL_DIR "/stale.tgz"));
+}
+
+// Main test runner
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -40,9 +40,10 @@
 // Mock only application-specific functions, not standard library functions
 extern "C" {
 
+#include "archive_manager.h"
+
 // Mock functions for uploadlogsnow module dependencies
 bool remove_directory(const char* path);
-int add_timestamp_to_files_uploadlogsnow(const char* dir_path);
 bool copy_file(const char* src, const char* dest);
 bool create_directory(const char* path);
 bool file_exists(const char* path);
@@ -88,8 +89,9 @@ bool remove_directory(const char* path) {
     return g_remove_directory_should_fail ? false : true;
 }
 
-int add_timestamp_to_files_uploadlogsnow(const char* dir_path) {
-    return g_add_timestamp_should_fail ? -1 : 0;
+bool archive_name_rule_init(ArchiveNameRule* rule, time_t ref_time) {
+    if (rule) memset(rule, 0, sizeof(*rule));
+    return g_add_timestamp_should_fail ? false : true;
 }
 
 int create_archive(RuntimeContext* ctx, SessionState* session, const char* source_dir) {
@@ -104,6 +106,11 @@ int create_archive(RuntimeContext* ctx, SessionState* session, const char* sourc
     return 0;
 }
 
+int create_archive_with_rule(RuntimeContext* ctx, SessionState* session, const char* source_dir,
+                             const ArchiveNameRule* rule, const ArchiveManifest* extra) {
+    return create_archive(ctx, session, source_dir);
+}
+
 void decide_paths(RuntimeContext* ctx, SessionState* session) {
     // Mock implementation - just set session state
     if (session) {
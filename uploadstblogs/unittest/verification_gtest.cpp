@@ -141,6 +141,15 @@ TEST_F(VerificationTest, IsTerminalFailure_Retryable) {
     EXPECT_FALSE(is_terminal_failure(403));
 }
 
+// Test is_throttled_response function
+TEST_F(VerificationTest, IsThrottledResponse) {
+    EXPECT_TRUE(is_throttled_response(429));
+    EXPECT_TRUE(is_throttled_response(503));
+    EXPECT_FALSE(is_throttled_response(500));
+    EXPECT_FALSE(is_throttled_response(200));
+    EXPECT_FALSE(is_throttled_response(0));
+}
+
 // Test is_curl_success function  
 TEST_F(VerificationTest, IsCurlSuccess_Success) {
     EXPECT_TRUE(is_curl_success(0)); // CURLE_OK